@@ -10,6 +10,8 @@ public class DestructionTerrain : ModuleRules
 	
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "ProceduralMeshComponent","Json", "JsonUtilities" });
 
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore", "RHI", "Renderer", "DestructionTerrainShaders" });
+
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 		
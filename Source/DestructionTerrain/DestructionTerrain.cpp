@@ -3,4 +3,21 @@
 #include "DestructionTerrain.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogDestructionTerrain);
+
+DEFINE_STAT(STAT_TerrainDig);
+DEFINE_STAT(STAT_TerrainDensity);
+DEFINE_STAT(STAT_TerrainMarch);
+DEFINE_STAT(STAT_TerrainUpload);
+
+DEFINE_STAT(STAT_TerrainVoxelsModified);
+DEFINE_STAT(STAT_TerrainVoxelsGenerated);
+DEFINE_STAT(STAT_TerrainGradientsEvaluated);
+DEFINE_STAT(STAT_TerrainBricksSkipped);
+DEFINE_STAT(STAT_TerrainVerticesUploaded);
+DEFINE_STAT(STAT_TerrainTrianglesUploaded);
+DEFINE_STAT(STAT_TerrainChunksRemeshed);
+
+UE_TRACE_CHANNEL_DEFINE(TerrainChannel);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, DestructionTerrain, "DestructionTerrain" );
@@ -4,4 +4,35 @@
 
 #include "CoreMinimal.h"
 #include "ProceduralMeshComponent.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogDestructionTerrain, Log, All);
+
+// stat DestructionTerrain: per-stage timings and counts of the voxel terrain pipeline.
+DECLARE_STATS_GROUP(TEXT("DestructionTerrain"), STATGROUP_DestructionTerrain, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dig"), STAT_TerrainDig, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Density"), STAT_TerrainDensity, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("March"), STAT_TerrainMarch, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Upload"), STAT_TerrainUpload, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Voxels Modified"), STAT_TerrainVoxelsModified, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Voxels Generated"), STAT_TerrainVoxelsGenerated, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Gradients Evaluated"), STAT_TerrainGradientsEvaluated, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bricks Skipped"), STAT_TerrainBricksSkipped, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Vertices Uploaded"), STAT_TerrainVerticesUploaded, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles Uploaded"), STAT_TerrainTrianglesUploaded, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Chunks Remeshed After Edits"), STAT_TerrainChunksRemeshed, STATGROUP_DestructionTerrain, DESTRUCTIONTERRAIN_API);
+
+// Unreal Insights: CPU events of the terrain stages on their own channel (-trace=cpu,terrain), named "Terrain.<Stage>":
+// Density, Gradient (neighbour halo), March, Upload, Cook and IO.*. Worker and game-thread events carry the chunk name.
+UE_TRACE_CHANNEL_EXTERN(TerrainChannel, DESTRUCTIONTERRAIN_API);
+
+#define TERRAIN_TRACE_SCOPE(Stage) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("Terrain." #Stage, TerrainChannel)
+
+// Same, followed by the name of a chunk (an FName, e.g. "Terrain.Extract Chunk_1_2_0"); only formatted while the channel is traced.
+#define TERRAIN_TRACE_CHUNK_SCOPE(Stage, ChunkName) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(UE_TRACE_CHANNELEXPR_IS_ENABLED(TerrainChannel) \
+		? *FString::Printf(TEXT("Terrain.%s %s"), TEXT(#Stage), *(ChunkName).ToString()) : TEXT("Terrain." #Stage), TerrainChannel)
@@ -2,14 +2,202 @@
 
 
 #include "ProceduralTerrain.h"
-#include "MarchingCubesTables.h"
+#include "DestructionTerrain.h"
+#include "TerrainGPUGenerator.h"
+#include "TerrainMesher.h"
+#include "TerrainUploadQueue.h"
+#include "TerrainVoxelAccess.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Tasks/Pipe.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonWriter.h"
 #include "Dom/JsonObject.h"
 
+namespace
+{
+	/** Digs replayed by a GPU remesh; past it, the chunk goes back to the CPU mesher. */
+	constexpr int32 MaxGPUBrushes = 256;
+
+	/**
+	 * Runs the engine call submitting a mesh section. It cooks the section's collision inside the same call, which
+	 * cannot be traced apart: hidden collision sections are traced as Terrain.Cook, the drawn ones as Terrain.Upload.
+	 */
+	template <typename CallableType>
+	void SubmitMeshSection(bool bCollisionOnly, CallableType&& Submit)
+	{
+		if (bCollisionOnly)
+		{
+			TERRAIN_TRACE_SCOPE(Cook);
+			Submit();
+		}
+		else
+		{
+			TERRAIN_TRACE_SCOPE(Upload);
+			Submit();
+		}
+	}
+
+	/**
+	 * Runs Finish on the game thread. Full rebuilds (generation, loads) may be throttled by the owner's upload queue;
+	 * partial rebuilds after edits are always uploaded right away.
+	 */
+	void DispatchFinish(TWeakObjectPtr<UProceduralTerrain> WeakThis, TSharedRef<std::atomic<uint32>, ESPMode::ThreadSafe> SerialCounter,
+		uint32 Serial, bool bFullRebuild, TFunction<void()> Finish)
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, SerialCounter, Serial, bFullRebuild, Finish = MoveTemp(Finish)]() mutable
+		{
+			UProceduralTerrain* Terrain = WeakThis.Get();
+			if (!Terrain)
+				return;
+
+			if (bFullRebuild && Terrain->UploadQueue.IsValid() && SerialCounter->load() == Serial)
+			{
+				Terrain->QueuedUploadSerial = Serial;
+				Terrain->UploadQueue->Enqueue(MoveTemp(Finish));
+			}
+			else
+			{
+				Finish();
+			}
+		});
+	}
+
+	/**
+	 * Chunk saves run one after the other, off the game thread: two saves never write the same file at once,
+	 * and the latest snapshot of a chunk always lands last.
+	 */
+	UE::Tasks::FPipe& GetChunkSavePipe()
+	{
+		static UE::Tasks::FPipe Pipe(TEXT("TerrainChunkSaves"));
+		return Pipe;
+	}
+
+	/** Faces (bit i = FTerrainDensityHalo::Faces[i]) for which a halo holds neighbour samples. */
+	uint8 GetHaloFaceMask(const FTerrainDensityHalo* Halo)
+	{
+		uint8 FaceMask = 0;
+		for (int32 Face = 0; Halo && Face < 6; Face++)
+		{
+			if (!Halo->Faces[Face].IsEmpty())
+				FaceMask |= 1 << Face;
+		}
+		return FaceMask;
+	}
+
+	/** Identifies the mesh of Density extracted with Settings (see bCacheMeshInSaves). */
+	uint32 GetMeshCacheHash(const FTerrainDensityStorage& Density, const FTerrainMeshSettings& Settings)
+	{
+		return HashCombine(Density.GetContentHash(), Settings.GetHash());
+	}
+
+	/**
+	 * Thread-safe: extracts the whole mesh of a saved density into OutMesh and keys it in Header.
+	 * @return The mesh to cache in the save, or null if the extraction failed (the save is then written without it).
+	 */
+	const TArray<FTerrainMeshBlock>* ExtractCachedMesh(const FTerrainDensityStorage& Density, const FTerrainMeshSettings& Settings,
+		const FTerrainDensityHalo* Halo, FTerrainChunkHeader& Header, TArray<FTerrainMeshBlock>& OutMesh)
+	{
+		const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(Density.GetSize(), Settings.BlockSize);
+		TArray<int32> BlockIndices;
+		for (int32 i = 0; i < NumBlocks * NumBlocks * NumBlocks; i++)
+			BlockIndices.Add(i);
+
+		if (!UProceduralTerrain::ExtractChunkMesh(Density, Settings, BlockIndices, OutMesh, [] { return false; }, Halo))
+			return nullptr;
+
+		Header.MeshHash = GetMeshCacheHash(Density, Settings);
+		Header.MeshHaloFaceMask = GetHaloFaceMask(Halo);
+		return &OutMesh;
+	}
+
+	/** Thread-safe: reads the mesh cached in a chunk file into OutBlocks, if it was extracted from Density with Settings. */
+	bool ReadCachedMesh(const TArray<uint8>& Bytes, const FTerrainChunkHeader& Header, const FTerrainDensityStorage& Density,
+		const FTerrainMeshSettings& Settings, TArray<FTerrainMeshBlock>& OutBlocks)
+	{
+		if (Header.MeshBytes == 0 || Header.MeshHash != GetMeshCacheHash(Density, Settings))
+			return false;
+
+		FTerrainChunkHeader MeshHeader;
+		return TerrainChunkFormat::ReadMesh(Bytes, MeshHeader, OutBlocks, Density.GetSize());
+	}
+
+	/**
+	 * Thread-safe: encodes the bricks of a snapshot that differ from its baseline (the whole density without baseline).
+	 * @param OutNumBricks - Bricks in the delta; 0 if nothing differs (OutBytes stays empty), INDEX_NONE for a full file.
+	 */
+	bool EncodeChunkSave(const FTerrainChunkSave& Save, TArray<uint8>& OutBytes, int32& OutNumBricks)
+	{
+		TERRAIN_TRACE_SCOPE(IO.Encode);
+
+		const FTerrainDensityStorage& Density = Save.Density;
+		const FTerrainBaselineSettings& Baseline = Save.Baseline;
+
+		// The mesh is only extracted for saves that write a file.
+		FTerrainChunkHeader Header = Save.Header;
+		TArray<FTerrainMeshBlock> Mesh;
+
+		if (!Baseline.IsValid() || Baseline.Size != Density.GetSize())
+		{
+			TArray<float> Dense;
+			Density.ToDense(Dense);
+			OutNumBricks = INDEX_NONE;
+			const TArray<FTerrainMeshBlock>* CachedMesh = Save.bCacheMesh ? ExtractCachedMesh(Density, Save.MeshSettings, Save.Halo.Get(), Header, Mesh) : nullptr;
+			return TerrainChunkFormat::Write(Header, Dense, OutBytes, CachedMesh);
+		}
+
+		// Bricks are compared with the procedural density in the same in-memory encoding; float fields allow
+		// for the rounding of the GPU noise (see bGPUGeneration).
+		FTerrainDensityStorage Generated;
+		Generated.SetEncoding(Density.GetEncoding(), Baseline.Truncation);
+		{
+			TArray<float> Dense;
+			UProceduralTerrain::GenerateDensity(Baseline.Origin, Baseline.Size, Baseline.Scale, Baseline.NoiseScale,
+				Baseline.HeightBias, Baseline.NoiseStrength, Dense, Baseline.Truncation, Baseline.Noise, Save.bParallel);
+			Generated.SetFromDense(Baseline.Size, Dense);
+		}
+		const float Tolerance = Density.GetEncoding() == ETerrainDensityEncoding::Float32 ? KINDA_SMALL_NUMBER : Density.GetQuantizationStep() * 0.5f;
+
+		FTerrainChunkDelta Delta;
+		for (int32 BrickIndex = 0; BrickIndex < Density.GetNumBricks(); BrickIndex++)
+		{
+			if (Density.IsBrickEqual(BrickIndex, Generated, Tolerance))
+				continue;
+
+			Delta.BrickIndices.Add(BrickIndex);
+			const int32 Offset = Delta.Samples.AddUninitialized(FTerrainChunkDelta::SamplesPerBrick);
+			Density.GetBrickSamples(BrickIndex, &Delta.Samples[Offset]);
+		}
+
+		OutNumBricks = Delta.BrickIndices.Num();
+		if (OutNumBricks == 0)
+			return true;
+
+		Header.BaselineHash = Baseline.GetHash();
+		const TArray<FTerrainMeshBlock>* CachedMesh = Save.bCacheMesh ? ExtractCachedMesh(Density, Save.MeshSettings, Save.Halo.Get(), Header, Mesh) : nullptr;
+		return TerrainChunkFormat::WriteDelta(Header, Delta, OutBytes, CachedMesh);
+	}
+
+	/**
+	 * Thread-safe: writes an encoded save next to its file, then moves it over the previous save, so that a crash
+	 * mid-write keeps the previous one. Empty bytes delete the save (the chunk is regenerated next time).
+	 */
+	bool WriteChunkSave(const FString& SavePath, const TArray<uint8>& Bytes)
+	{
+		TERRAIN_TRACE_SCOPE(IO.Write);
+
+		IFileManager& FileManager = IFileManager::Get();
+		if (Bytes.IsEmpty())
+			return !FileManager.FileExists(*SavePath) || FileManager.Delete(*SavePath);
+
+		const FString TempPath = SavePath + TEXT(".tmp");
+		return FFileHelper::SaveArrayToFile(Bytes, *TempPath) && FileManager.Move(*SavePath, *TempPath, true);
+	}
+}
 
 void UProceduralTerrain::CreateProceduralTerrain(int32 Height, int32 Width, float NoiseScale, float MaxHeight,
                                                  float Scale)
@@ -81,7 +269,7 @@ void UProceduralTerrain::CreateProceduralTerrain(int32 Height, int32 Width, floa
 
 void UProceduralTerrain::CreateProceduralTerrain3D(int32 Size, float Scale, float NoiseScale, float HeightBias, float NoiseStrength, float IsoLevel)
 {
-	UE_LOG(LogTemp, Warning, TEXT("▶️ Génération terrain : Size=%d, Scale=%.2f, NoiseScale=%.3f, HeightBias=%.2f, Strength=%.2f, Iso=%.2f"),
+	UE_LOG(LogDestructionTerrain, Warning, TEXT("▶️ Génération terrain : Size=%d, Scale=%.2f, NoiseScale=%.3f, HeightBias=%.2f, Strength=%.2f, Iso=%.2f"),
 		Size, Scale, NoiseScale, HeightBias, NoiseStrength, IsoLevel);
 
 	// Sauvegarde des paramètres courants
@@ -90,7 +278,8 @@ void UProceduralTerrain::CreateProceduralTerrain3D(int32 Size, float Scale, floa
 	CurrentIsoLevel = IsoLevel;
 
 	// Initialisation du champ de densité
-	Density.SetNum(Size * Size * Size);
+	TArray<float> Dense;
+	Dense.SetNum(Size * Size * Size);
 
 	auto GetIndex = [&](int32 x, int32 y, int32 z)
 	{
@@ -98,20 +287,26 @@ void UProceduralTerrain::CreateProceduralTerrain3D(int32 Size, float Scale, floa
 	};
 
 	// ─────────── GÉNÉRATION DU CHAMP DE DENSITÉ ───────────
-	for (int32 z = 0; z < Size; z++)
+	ParallelFor(Size, [&](int32 z)
+	{
 		for (int32 y = 0; y < Size; y++)
 			for (int32 x = 0; x < Size; x++)
 			{
 				FVector Pos(x, y, z);
 				float Noise = FMath::PerlinNoise3D(Pos * NoiseScale);
 				float DensityValue = (z - HeightBias) + (Noise * NoiseStrength);
-				Density[GetIndex(x, y, z)] = DensityValue;
+				if (DensityTruncation > 0.0f)
+					DensityValue = FMath::Clamp(DensityValue, -DensityTruncation, DensityTruncation);
+				Dense[GetIndex(x, y, z)] = DensityValue;
 			}
+	}, !bParallelBuild);
+	ResetDensityStorage(Density);
+	Density.SetFromDense(Size, Dense);
 
 	// ─────────── CONSTRUCTION DU MESH À PARTIR DE DENSITY ───────────
 	RebuildMeshFromCurrentDensity();
 
-	UE_LOG(LogTemp, Warning, TEXT("✅ Terrain 3D généré (%d³ voxels)"), Size);
+	UE_LOG(LogDestructionTerrain, Warning, TEXT("✅ Terrain 3D généré (%d³ voxels)"), Size);
 }
 
 void UProceduralTerrain::ClearMesh()
@@ -125,82 +320,105 @@ void UProceduralTerrain::ClearMesh()
 
 		if (bDeleted)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("🗑️ Deleted terrain save file: %s"), *FilePath);
+			UE_LOG(LogDestructionTerrain, Warning, TEXT("🗑️ Deleted terrain save file: %s"), *FilePath);
 		}
 		else
 		{
-			UE_LOG(LogTemp, Error, TEXT("❌ Failed to delete terrain file: %s"), *FilePath);
+			UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to delete terrain file: %s"), *FilePath);
 		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("⚠️ File not found, nothing to delete: %s"), *FilePath);
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("⚠️ File not found, nothing to delete: %s"), *FilePath);
 	}
 	ClearAllMeshSections();
 }
 
 void UProceduralTerrain::DigSphere(FVector WorldPosition, float Radius, float Strength)
 {
-	UE_LOG(LogTemp, Warning, TEXT("🟢 DigSphere called on: %s"), *GetOwner()->GetName());
-	if (Density.Num() == 0 || CurrentSize <= 0 || FMath::IsNearlyZero(CurrentScale))
-		return;
-
-	const FTransform ComponentTransform = GetComponentTransform();
-
-	const FVector LocalPositionUnits = ComponentTransform.InverseTransformPosition(WorldPosition);
-	const FVector LocalVoxelPosition = LocalPositionUnits / CurrentScale;
-	int32 XCenter = FMath::RoundToInt(LocalVoxelPosition.X);
-	int32 YCenter = FMath::RoundToInt(LocalVoxelPosition.Y);
-	int32 ZCenter = FMath::RoundToInt(LocalVoxelPosition.Z);
-	const FVector ComponentScale = ComponentTransform.GetScale3D();
-	const float UniformScale = FMath::Max(ComponentScale.GetAbsMax(), KINDA_SMALL_NUMBER);
-	const float LocalRadiusUnits = Radius / UniformScale;
-	int32 RadiusVoxels = FMath::CeilToInt(LocalRadiusUnits / CurrentScale);
-	auto GetIndex = [&](int32 X, int32 Y, int32 Z)
-	{
-		return X + Y * CurrentSize + Z * CurrentSize * CurrentSize;
-	};
-
-	// Parcourt tous les voxels dans une sphère locale
-	for (int32 z = ZCenter - RadiusVoxels; z <= ZCenter + RadiusVoxels; z++)
-		for (int32 y = YCenter - RadiusVoxels; y <= YCenter + RadiusVoxels; y++)
-			for (int32 x = XCenter - RadiusVoxels; x <= XCenter + RadiusVoxels; x++)
-			{
-				if (x < 0 || y < 0 || z < 0 || x >= CurrentSize || y >= CurrentSize || z >= CurrentSize)
-					continue;
+	UE_LOG(LogDestructionTerrain, Verbose, TEXT("🟢 DigSphere called on: %s"), *GetOwner()->GetName());
+	ApplyBrush(FTerrainBrush::MakeSphere(WorldPosition, Radius, Strength));
+}
 
-				FVector VoxelPos(x, y, z);
-				float Dist = FVector::Dist(VoxelPos, LocalVoxelPosition);
+int32 UProceduralTerrain::ApplyBrush(const FTerrainBrush& Brush)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerrainDig);
+	if (Density.IsEmpty() || CurrentSize <= 0 || FMath::IsNearlyZero(CurrentScale))
+		return 0;
+
+	const FTerrainVoxelBrush VoxelBrush = FTerrainVoxelBrush::FromWorld(Brush, GetVoxelToWorld());
+	FTerrainBrushDelta Delta;
+	const bool bChanged = TerrainBrush::Evaluate(VoxelBrush, FIntVector::ZeroValue, FIntVector(CurrentSize - 1),
+		[this](const FIntVector& Voxel, float& OutValue)
+		{
+			if (Voxel.GetMin() < 0 || Voxel.GetMax() >= CurrentSize)
+				return false;
+			OutValue = Density.Get(Voxel.X, Voxel.Y, Voxel.Z);
+			return true;
+		},
+		Delta);
+	if (!bChanged)
+		return 0;
+
+	const int32 Modified = AddBrushDelta(Delta, FIntVector::ZeroValue);
+	INC_DWORD_STAT_BY(STAT_TerrainVoxelsModified, Modified);
+
+	// Only the blocks around the voxels actually changed need remeshing.
+	QueueGPUBrush(VoxelBrush);
+	MarkDirtyRegion(Delta.DirtyMin, Delta.DirtyMax);
+	RebuildDirtyRegionAsync();
+	return Modified;
+}
 
-				if (Dist <= RadiusVoxels)
-				{
-					int32 Idx = GetIndex(x, y, z);
-					Density[Idx] += Strength * (1.0f - (Dist / RadiusVoxels)); // atténuation
-				}
-			}
-	float MinD = FLT_MAX;
-	float MaxD = -FLT_MAX;
-	for (float V : Density)
+int32 UProceduralTerrain::AddBrushDelta(const FTerrainBrushDelta& Delta, const FIntVector& ChunkOrigin)
+{
+	if (Delta.IsEmpty() || CurrentSize <= 0)
+		return 0;
+
+	// Changed voxels of the brush that this chunk stores.
+	const FIntVector Min(
+		FMath::Max(Delta.DirtyMin.X, ChunkOrigin.X),
+		FMath::Max(Delta.DirtyMin.Y, ChunkOrigin.Y),
+		FMath::Max(Delta.DirtyMin.Z, ChunkOrigin.Z));
+	const FIntVector Max(
+		FMath::Min(Delta.DirtyMax.X, ChunkOrigin.X + CurrentSize - 1),
+		FMath::Min(Delta.DirtyMax.Y, ChunkOrigin.Y + CurrentSize - 1),
+		FMath::Min(Delta.DirtyMax.Z, ChunkOrigin.Z + CurrentSize - 1));
+
+	int32 Modified = 0;
+	for (int32 z = Min.Z; z <= Max.Z; z++)
+	for (int32 y = Min.Y; y <= Max.Y; y++)
+	for (int32 x = Min.X; x <= Max.X; x++)
 	{
-		MinD = FMath::Min(MinD, V);
-		MaxD = FMath::Max(MaxD, V);
+		const float Value = Delta.Get(x, y, z);
+		if (Value != 0.0f)
+		{
+			AddDensity(x - ChunkOrigin.X, y - ChunkOrigin.Y, z - ChunkOrigin.Z, Value);
+			++Modified;
+		}
 	}
-	UE_LOG(LogTemp, Warning, TEXT("📊 Densité globale : Min=%.2f  Max=%.2f  Iso=%.2f"), MinD, MaxD, CurrentIsoLevel);
+	return Modified;
+}
 
-	RebuildMeshFromCurrentDensity();
+FTransform UProceduralTerrain::GetVoxelToWorld() const
+{
+	return FTransform(FQuat::Identity, FVector::ZeroVector, FVector(CurrentScale)) * GetComponentTransform();
 }
 
 void UProceduralTerrain::SaveDensityToJSON(const FString& FileName)
 {
-	if (Density.Num() == 0)
+	if (Density.IsEmpty())
 	{
-		UE_LOG(LogTemp, Warning, TEXT("❌ No density data to save."));
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("❌ No density data to save."));
 		return;
 	}
 
+	TArray<float> Dense;
+	Density.ToDense(Dense);
+
 	TArray<TSharedPtr<FJsonValue>> DensityArray;
-	DensityArray.Reserve(Density.Num());
-	for (float Value : Density)
+	DensityArray.Reserve(Dense.Num());
+	for (float Value : Dense)
 	{
 		DensityArray.Add(MakeShareable(new FJsonValueNumber(Value)));
 	}
@@ -218,11 +436,11 @@ void UProceduralTerrain::SaveDensityToJSON(const FString& FileName)
 	const FString SavePath = FPaths::ProjectSavedDir() / FileName;
 	if (FFileHelper::SaveStringToFile(OutputString, *SavePath))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("💾 Terrain saved to JSON: %s"), *SavePath);
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("💾 Terrain saved to JSON: %s"), *SavePath);
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("❌ Failed to save terrain JSON: %s"), *SavePath);
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to save terrain JSON: %s"), *SavePath);
 	}
 }
 
@@ -233,7 +451,7 @@ void UProceduralTerrain::LoadDensityFromJSON(const FString& FileName)
 
 	if (!FFileHelper::LoadFileToString(JsonContent, *LoadPath))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("⚠️ No JSON file found: %s"), *LoadPath);
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("⚠️ No JSON file found: %s"), *LoadPath);
 		return;
 	}
 
@@ -241,7 +459,7 @@ void UProceduralTerrain::LoadDensityFromJSON(const FString& FileName)
 	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonContent);
 	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
 	{
-		UE_LOG(LogTemp, Error, TEXT("❌ Failed to parse terrain JSON file."));
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to parse terrain JSON file."));
 		return;
 	}
 
@@ -252,16 +470,344 @@ void UProceduralTerrain::LoadDensityFromJSON(const FString& FileName)
 	const TArray<TSharedPtr<FJsonValue>>* DensityArray;
 	if (JsonObject->TryGetArrayField(TEXT("Density"), DensityArray))
 	{
-		Density.SetNum(DensityArray->Num());
+		if (CurrentSize <= 0 || DensityArray->Num() != CurrentSize * CurrentSize * CurrentSize)
+		{
+			UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Terrain JSON has %d samples for Size=%d."), DensityArray->Num(), CurrentSize);
+			return;
+		}
+
+		TArray<float> Dense;
+		Dense.SetNum(DensityArray->Num());
 		for (int32 i = 0; i < DensityArray->Num(); i++)
 		{
-			Density[i] = (*DensityArray)[i]->AsNumber();
+			Dense[i] = (*DensityArray)[i]->AsNumber();
 		}
+		ResetDensityStorage(Density);
+		Density.SetFromDense(CurrentSize, Dense);
+
+		// Legacy saves are rewritten in the binary format by the next save.
+		bUnsavedEdits = true;
+		++EditSerial;
+		RebuildMeshAsync();
+
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("✅ Terrain loaded from JSON (%d voxels)"), Density.Num());
+	}
+}
+
+bool UProceduralTerrain::SaveDensityToFile(const FString& FileName, ETerrainDensityEncoding Encoding,
+	ETerrainChunkCompression Compression)
+{
+	if (Density.IsEmpty())
+	{
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("❌ No density data to save."));
+		return false;
+	}
+
+	FTerrainChunkHeader Header;
+	Header.Size        = CurrentSize;
+	Header.Scale       = CurrentScale;
+	Header.IsoLevel    = CurrentIsoLevel;
+	Header.Encoding    = Encoding;
+	Header.Compression = Compression;
+
+	// Saving in the in-memory encoding reuses its step, so quantized chunks round-trip exactly.
+	Header.QuantizationStep = Encoding == Density.GetEncoding() ? Density.GetQuantizationStep() : 0.0f;
+
+	TArray<float> Dense;
+	Density.ToDense(Dense);
+
+	TArray<FTerrainMeshBlock> Mesh;
+	const TArray<FTerrainMeshBlock>* CachedMesh = bCacheMeshInSaves ? ExtractCachedMesh(Density, GetMeshSettings(), ReadHalo().Get(), Header, Mesh) : nullptr;
+
+	TArray<uint8> Bytes;
+	if (!TerrainChunkFormat::Write(Header, Dense, Bytes, CachedMesh))
+	{
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to encode terrain chunk (Size=%d, %d voxels)."), CurrentSize, Density.Num());
+		return false;
+	}
+
+	// An async save still queued would otherwise land after this one.
+	WaitForPendingSaves();
+
+	const FString SavePath = FPaths::ProjectSavedDir() / FileName;
+	if (!WriteChunkSave(SavePath, Bytes))
+	{
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to save terrain chunk: %s"), *SavePath);
+		return false;
+	}
+
+	bUnsavedEdits = false;
+	UE_LOG(LogDestructionTerrain, Log, TEXT("💾 Terrain saved: %s (%d bytes)"), *SavePath, Bytes.Num());
+	return true;
+}
+
+uint32 FTerrainBaselineSettings::GetHash() const
+{
+	uint32 Hash = GetTypeHash(Origin);
+	Hash = HashCombine(Hash, GetTypeHash(Size));
+	Hash = HashCombine(Hash, GetTypeHash(Scale));
+	Hash = HashCombine(Hash, GetTypeHash(NoiseScale));
+	Hash = HashCombine(Hash, GetTypeHash(HeightBias));
+	Hash = HashCombine(Hash, GetTypeHash(NoiseStrength));
+	Hash = HashCombine(Hash, GetTypeHash(Truncation));
+	// Both kernels evaluate the engine's noise: they share the hash the Engine kernel always had (saves of the former
+	// Vectorized lattice no longer match).
+	Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(ETerrainNoiseKernel::Engine)));
+	Hash = HashCombine(Hash, GetTypeHash(Noise.Octaves));
+	Hash = HashCombine(Hash, GetTypeHash(Noise.Lacunarity));
+	Hash = HashCombine(Hash, GetTypeHash(Noise.Gain));
+	return Hash;
+}
+
+uint32 FTerrainMeshSettings::GetHash() const
+{
+	uint32 Hash = GetTypeHash(Scale);
+	Hash = HashCombine(Hash, GetTypeHash(IsoLevel));
+	Hash = HashCombine(Hash, GetTypeHash(bSharedVertices));
+	Hash = HashCombine(Hash, GetTypeHash(BlockSize));
+	Hash = HashCombine(Hash, GetTypeHash(CollisionStride));
+	Hash = HashCombine(Hash, GetTypeHash(LODStride));
+	Hash = HashCombine(Hash, GetTypeHash(SkirtDepth));
+	return Hash;
+}
+
+void UProceduralTerrain::SetBaseline(int32 Size, float Scale, float NoiseScale, float HeightBias, float NoiseStrength)
+{
+	Baseline.Origin        = GetComponentLocation();
+	Baseline.Size          = Size;
+	Baseline.Scale         = Scale;
+	Baseline.NoiseScale    = NoiseScale;
+	Baseline.HeightBias    = HeightBias;
+	Baseline.NoiseStrength = NoiseStrength;
+	Baseline.Truncation    = DensityTruncation;
+	Baseline.Noise         = NoiseSettings;
+}
+
+bool UProceduralTerrain::DecodeChunkFile(const TArray<uint8>& Bytes, const FTerrainBaselineSettings& InBaseline, bool bParallel,
+	FTerrainChunkHeader& OutHeader, FTerrainDensityStorage& Storage)
+{
+	TERRAIN_TRACE_SCOPE(IO.Decode);
+
+	// A chunk with a baseline only takes files of its own size, checked before the payload is allocated.
+	const int32 ExpectedSize = InBaseline.IsValid() ? InBaseline.Size : 0;
+	if (!TerrainChunkFormat::ReadHeader(Bytes, OutHeader, ExpectedSize))
+		return false;
 
-		RebuildMeshFromCurrentDensity();
+	if (OutHeader.Content == ETerrainChunkContent::Density)
+	{
+		TArray<float> Dense;
+		if (!TerrainChunkFormat::Read(Bytes, OutHeader, Dense, ExpectedSize))
+			return false;
+
+		Storage.SetFromDense(OutHeader.Size, Dense);
+		return true;
+	}
+
+	FTerrainChunkDelta Delta;
+	if (!InBaseline.IsValid() || !TerrainChunkFormat::ReadDelta(Bytes, OutHeader, Delta, ExpectedSize))
+		return false;
+
+	// The procedural density is regenerated, then the saved bricks replace its own.
+	if (InBaseline.GetHash() != OutHeader.BaselineHash)
+		return false;
+
+	TArray<float> Dense;
+	GenerateDensity(InBaseline.Origin, InBaseline.Size, InBaseline.Scale, InBaseline.NoiseScale, InBaseline.HeightBias,
+		InBaseline.NoiseStrength, Dense, InBaseline.Truncation, InBaseline.Noise, bParallel);
+	Storage.SetFromDense(InBaseline.Size, Dense);
+
+	for (int32 i = 0; i < Delta.BrickIndices.Num(); i++)
+		Storage.SetBrickSamples(Delta.BrickIndices[i], &Delta.Samples[i * FTerrainChunkDelta::SamplesPerBrick]);
+	return true;
+}
+
+FTerrainChunkSave UProceduralTerrain::MakeChunkSave(const FString& Name, FTerrainChunkWriter Write, ETerrainDensityEncoding Encoding,
+	ETerrainChunkCompression Compression) const
+{
+	FTerrainChunkSave Save;
+	Save.Density   = Density;
+	Save.Baseline  = Baseline;
+	Save.Name      = Name;
+	Save.Write     = MoveTemp(Write);
+	Save.bParallel = bParallelBuild;
+
+	Save.Header.Size        = CurrentSize;
+	Save.Header.Scale       = CurrentScale;
+	Save.Header.IsoLevel    = CurrentIsoLevel;
+	Save.Header.Encoding    = Encoding;
+	Save.Header.Compression = Compression;
+	Save.Header.QuantizationStep = Encoding == Density.GetEncoding() ? Density.GetQuantizationStep() : 0.0f;
+
+	Save.bCacheMesh = bCacheMeshInSaves;
+	if (bCacheMeshInSaves)
+	{
+		Save.MeshSettings = GetMeshSettings();
+		Save.Halo = ReadHalo();
+	}
+	return Save;
+}
+
+bool UProceduralTerrain::SaveDeltaToFile(const FString& FileName, ETerrainDensityEncoding Encoding,
+	ETerrainChunkCompression Compression)
+{
+	const FString SavePath = FPaths::ProjectSavedDir() / FileName;
+	return SaveDeltaTo(SavePath, [SavePath](const TArray<uint8>& Bytes) { return WriteChunkSave(SavePath, Bytes); }, Encoding, Compression);
+}
+
+bool UProceduralTerrain::SaveDeltaTo(const FString& Name, FTerrainChunkWriter Write, ETerrainDensityEncoding Encoding,
+	ETerrainChunkCompression Compression)
+{
+	if (Density.IsEmpty())
+	{
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("❌ No density data to save."));
+		return false;
+	}
+
+	// An async save still queued would otherwise land after this one.
+	WaitForPendingSaves();
+
+	const FTerrainChunkSave Save = MakeChunkSave(Name, MoveTemp(Write), Encoding, Compression);
+
+	TArray<uint8> Bytes;
+	int32 NumBricks = 0;
+	if (!EncodeChunkSave(Save, Bytes, NumBricks))
+	{
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to encode terrain chunk (Size=%d, %d voxels)."), CurrentSize, Density.Num());
+		return false;
+	}
+
+	if (!Save.Write(Bytes))
+	{
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to save terrain chunk: %s"), *Save.Name);
+		return false;
+	}
+
+	bUnsavedEdits = false;
+	if (NumBricks > 0)
+	{
+		UE_LOG(LogDestructionTerrain, Log, TEXT("💾 Terrain delta saved: %s (%d/%d bricks, %d bytes)"),
+			*Save.Name, NumBricks, Density.GetNumBricks(), Bytes.Num());
+	}
+	else if (NumBricks == INDEX_NONE)
+	{
+		UE_LOG(LogDestructionTerrain, Log, TEXT("💾 Terrain saved: %s (%d bytes)"), *Save.Name, Bytes.Num());
+	}
+	return true;
+}
 
-		UE_LOG(LogTemp, Warning, TEXT("✅ Terrain loaded from JSON (%d voxels)"), Density.Num());
+UE::Tasks::FTask UProceduralTerrain::SaveDeltaToFileAsync(const FString& FileName, ETerrainDensityEncoding Encoding,
+	ETerrainChunkCompression Compression)
+{
+	const FString SavePath = FPaths::ProjectSavedDir() / FileName;
+	return SaveDeltaToAsync(SavePath, [SavePath](const TArray<uint8>& Bytes) { return WriteChunkSave(SavePath, Bytes); }, Encoding, Compression);
+}
+
+UE::Tasks::FTask UProceduralTerrain::SaveDeltaToAsync(const FString& Name, FTerrainChunkWriter Write, ETerrainDensityEncoding Encoding,
+	ETerrainChunkCompression Compression)
+{
+	if (Density.IsEmpty())
+	{
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("❌ No density data to save."));
+		return UE::Tasks::FTask();
 	}
+
+	TSharedRef<const FTerrainChunkSave, ESPMode::ThreadSafe> Save =
+		MakeShared<const FTerrainChunkSave, ESPMode::ThreadSafe>(MakeChunkSave(Name, MoveTemp(Write), Encoding, Compression));
+
+	return GetChunkSavePipe().Launch(TEXT("TerrainChunkSave"),
+		[Save, WeakThis = TWeakObjectPtr<UProceduralTerrain>(this), SavedEditSerial = EditSerial]()
+		{
+			TArray<uint8> Bytes;
+			int32 NumBricks = 0;
+			const bool bSaved = EncodeChunkSave(*Save, Bytes, NumBricks) && Save->Write(Bytes);
+			if (!bSaved)
+			{
+				UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to save terrain chunk: %s"), *Save->Name);
+				return;
+			}
+
+			UE_LOG(LogDestructionTerrain, Verbose, TEXT("💾 Terrain saved in background: %s (%d bricks, %d bytes)"),
+				*Save->Name, NumBricks, Bytes.Num());
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, SavedEditSerial]()
+			{
+				// Edits made after the snapshot still need a save.
+				UProceduralTerrain* Terrain = WeakThis.Get();
+				if (Terrain && Terrain->EditSerial == SavedEditSerial)
+					Terrain->bUnsavedEdits = false;
+			});
+		});
+}
+
+void UProceduralTerrain::WaitForPendingSaves()
+{
+	GetChunkSavePipe().WaitUntilEmpty();
+}
+
+UE::Tasks::FTask UProceduralTerrain::LaunchAfterPendingSaves(TUniqueFunction<void()> Work)
+{
+	return GetChunkSavePipe().Launch(TEXT("TerrainChunkSaveRead"), [Work = MoveTemp(Work)]() { Work(); });
+}
+
+bool UProceduralTerrain::LoadDensityFromFile(const FString& FileName)
+{
+	const FString LoadPath = FPaths::ProjectSavedDir() / FileName;
+
+	TArray<uint8> Bytes;
+	bool bRead = false;
+	{
+		TERRAIN_TRACE_SCOPE(IO.Read);
+		bRead = FFileHelper::LoadFileToArray(Bytes, *LoadPath, FILEREAD_Silent);
+	}
+	if (!bRead)
+	{
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("⚠️ No chunk file found: %s"), *LoadPath);
+		return false;
+	}
+
+	return LoadDensityFromBytes(Bytes, LoadPath);
+}
+
+bool UProceduralTerrain::LoadDensityFromBytes(const TArray<uint8>& Bytes, const FString& SourceName)
+{
+	FTerrainChunkHeader Header;
+	FTerrainDensityStorage Loaded;
+	ResetDensityStorage(Loaded);
+	if (!DecodeChunkFile(Bytes, Baseline, bParallelBuild, Header, Loaded))
+	{
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Invalid or unsupported terrain chunk file: %s"), *SourceName);
+		return false;
+	}
+
+	CurrentSize     = Header.Size;
+	CurrentScale    = Header.Scale;
+	CurrentIsoLevel = Header.IsoLevel;
+	Density         = MoveTemp(Loaded);
+	bUnsavedEdits   = false;
+
+	// A mesh cached by the save is uploaded right away if it was extracted from this very density.
+	const double LoadTime = FPlatformTime::Seconds();
+	if (ReadCachedMesh(Bytes, Header, Density, GetMeshSettings(), MeshScratch))
+	{
+		BeginRebuild();
+		DirtyRegion.Reset();
+		PendingBlocks.Reset();
+		bPendingFullRebuild = false;
+		bLODRemeshPending = false;
+		bDensityPending = false;
+
+		const double UploadTime = FPlatformTime::Seconds();
+		ApplyMeshBlocks(MeshScratch, true);
+		RecordRebuild(LoadTime, 0.0, UploadTime, true);
+		HaloFaceMask = Header.MeshHaloFaceMask;
+	}
+	else
+	{
+		RebuildMeshAsync();
+	}
+
+	UE_LOG(LogDestructionTerrain, Log, TEXT("✅ Terrain loaded from %s (%d voxels)"), *SourceName, Density.Num());
+	return true;
 }
 
 void UProceduralTerrain::RefreshTerrain()
@@ -270,222 +816,976 @@ void UProceduralTerrain::RefreshTerrain()
 	// MarkRenderStateDirty();
 	// Modify();
 	// MarkPackageDirty();
-	UE_LOG(LogTemp, Warning, TEXT("🔁 Terrain refreshed manually in editor"));
+	UE_LOG(LogDestructionTerrain, Warning, TEXT("🔁 Terrain refreshed manually in editor"));
 }
 
 
 void UProceduralTerrain::RebuildMeshFromCurrentDensity()
 {
- const int32 Size      = CurrentSize;
-	const float Scale     = CurrentScale;
-	const float IsoLevel  = CurrentIsoLevel;
-
-	if (Size <= 1 || Density.Num() != Size * Size * Size)
+	// A synchronous rebuild supersedes any pending asynchronous one.
+	BeginRebuild();
+	DirtyRegion.Reset();
+	PendingBlocks.Reset();
+	bPendingFullRebuild = false;
+	bDensityPending = false;
+
+	const double StartTime = FPlatformTime::Seconds();
+	if (CurrentSize <= 1 || Density.GetSize() != CurrentSize
+		|| !ExtractChunkMesh(Density, GetMeshSettings(), GetAllBlockIndices(), MeshScratch, [] { return false; }, MakeHalo().Get()))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("⚠️ Impossible de reconstruire le mesh : données incohérentes."));
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("⚠️ Impossible de reconstruire le mesh : données incohérentes."));
 		ClearAllMeshSections();
+		BlockMeshCounts.Reset();
+		RebuildStats = FTerrainRebuildStats();
 		return;
 	}
 
-	auto GetIndex = [&](int32 x, int32 y, int32 z)
+	const double UploadTime = FPlatformTime::Seconds();
+	ApplyMeshBlocks(MeshScratch, true);
+	RecordRebuild(StartTime, UploadTime - StartTime, UploadTime, true);
+}
+
+void UProceduralTerrain::RebuildMeshAsync(TFunction<void()> OnCompleted)
+{
+	const uint32 Serial = BeginRebuild();
+	DirtyRegion.Reset();
+	PendingBlocks.Reset();
+	bPendingFullRebuild = true;
+	bLODRemeshPending = false;
+	bDensityPending = false;
+
+	// Snapshot the density so that edits made while the worker runs cannot race with it.
+	TSharedRef<FTerrainDensityStorage, ESPMode::ThreadSafe> Snapshot = MakeShared<FTerrainDensityStorage, ESPMode::ThreadSafe>(Density);
+
+	LaunchMeshExtraction(Serial, true,
+		[Snapshot, Halo = MakeHalo(), Settings = GetMeshSettings(), BlockIndices = GetAllBlockIndices()]
+		(TArray<FTerrainMeshBlock>& OutBlocks, TFunctionRef<bool()> ShouldCancel)
+		{
+			ExtractChunkMesh(*Snapshot, Settings, BlockIndices, OutBlocks, ShouldCancel, Halo.Get());
+		},
+		nullptr,
+		MoveTemp(OnCompleted));
+}
+
+void UProceduralTerrain::MarkDirtyRegion(const FIntVector& VoxelMin, const FIntVector& VoxelMax)
+{
+	DirtyRegion.Add(VoxelMin, VoxelMax);
+}
+
+void UProceduralTerrain::RebuildDirtyRegionAsync(TFunction<void()> OnCompleted)
+{
+	if (DirtyRegion.IsEmpty())
+		return;
+
+	if (bDensityPending)
 	{
-		return x + y * Size + z * Size * Size;
-	};
+		DirtyRegion.Reset();
+		return;
+	}
 
-	auto SampleDensity = [&](int32 sx, int32 sy, int32 sz)
+	// Edited bricks that became uniform (e.g. fully dug out) are collapsed again before meshing.
+	Density.Compact(DirtyRegion.Min, DirtyRegion.Max);
+
+	// A GPU mesh is a single buffer: the GPU replays the digs over the whole chunk.
+	if (bGPUMeshed)
 	{
-		return Density[GetIndex(
-			FMath::Clamp(sx, 0, Size - 1),
-			FMath::Clamp(sy, 0, Size - 1),
-			FMath::Clamp(sz, 0, Size - 1))];
-	};
+		if (CanUseGPUGeneration())
+			LaunchGPUGeneration(false, MoveTemp(OnCompleted));
+		else
+			RebuildMeshAsync(MoveTemp(OnCompleted));
+		return;
+	}
 
-	TArray<FVector> Gradients;
-	Gradients.SetNum(Density.Num());
+	// Cancelling a pending full rebuild would march the whole chunk again: the region waits for it to land
+	// (see LaunchMeshExtraction()). The density is not snapshotted until then, so later edits join the region.
+	if (bPendingFullRebuild)
+	{
+		if (OnCompleted)
+			DeferredRemeshCallbacks.Add(MoveTemp(OnCompleted));
+		return;
+	}
 
-	for (int32 z = 0; z < Size; z++)
-	for (int32 y = 0; y < Size; y++)
-	for (int32 x = 0; x < Size; x++)
+	// Decimated chunks are a single block, always remeshed as a whole.
+	if (LODStride > 1)
 	{
-		float dx = SampleDensity(x + 1, y, z) - SampleDensity(x - 1, y, z);
-		float dy = SampleDensity(x, y + 1, z) - SampleDensity(x, y - 1, z);
-		float dz = SampleDensity(x, y, z + 1) - SampleDensity(x, y, z - 1);
+		RebuildMeshAsync(MoveTemp(OnCompleted));
+		return;
+	}
+
+	const uint32 Serial = BeginRebuild();
+	PendingBlocks.Append(GetBlocksAffectedBy(DirtyRegion));
+	DirtyRegion.Reset();
 
-		FVector Gradient(dx, dy, dz);
-		if (!FMath::IsNearlyZero(Scale))
+	TSharedRef<FTerrainDensityStorage, ESPMode::ThreadSafe> Snapshot = MakeShared<FTerrainDensityStorage, ESPMode::ThreadSafe>(Density);
+
+	LaunchMeshExtraction(Serial, false,
+		[Snapshot, Halo = MakeHalo(true), Settings = GetMeshSettings(), BlockIndices = PendingBlocks.Array()]
+		(TArray<FTerrainMeshBlock>& OutBlocks, TFunctionRef<bool()> ShouldCancel)
 		{
-			Gradient.X /= Scale;
-			Gradient.Y /= Scale;
-			Gradient.Z /= Scale;
-		}
+			ExtractChunkMesh(*Snapshot, Settings, BlockIndices, OutBlocks, ShouldCancel, Halo.Get());
+		},
+		nullptr,
+		MoveTemp(OnCompleted));
+}
+
+void UProceduralTerrain::GenerateTerrainAsync(int32 Size, float Scale, float NoiseScale, float HeightBias,
+	float NoiseStrength, TFunction<void()> OnCompleted, bool bKeepMesh)
+{
+	SetBaseline(Size, Scale, NoiseScale, HeightBias, NoiseStrength);
 
-		Gradients[GetIndex(x, y, z)] = Gradient;
+	GPUChunkDesc.Brushes.Reset();
+	bGPUBrushesIncomplete = false;
+	if (CanUseGPUGeneration() && Size > 1)
+	{
+		GPUChunkDesc.Origin        = GetComponentLocation();
+		GPUChunkDesc.Size          = Size;
+		GPUChunkDesc.Scale         = Scale;
+		GPUChunkDesc.NoiseScale    = NoiseScale;
+		GPUChunkDesc.HeightBias    = HeightBias;
+		GPUChunkDesc.NoiseStrength = NoiseStrength;
+		GPUChunkDesc.Truncation    = DensityTruncation;
+		GPUChunkDesc.IsoLevel      = CurrentIsoLevel;
+		GPUChunkDesc.Noise         = NoiseSettings;
+
+		bLODRemeshPending = false;
+		bDensityPending = true;
+		LaunchGPUGeneration(true, MoveTemp(OnCompleted));
+		return;
 	}
 
-	TArray<FVector> Vertices;
-	TArray<int32>   Triangles;
-	TArray<FVector> Normals;
+	const uint32 Serial = BeginRebuild();
+	DirtyRegion.Reset();
+	PendingBlocks.Reset();
+	bPendingFullRebuild = true;
+	bLODRemeshPending = false;
+
+	bDensityPending = true;
+
+	const FVector ChunkWorldOrigin = GetComponentLocation();
+	FTerrainMeshSettings Settings = GetMeshSettings();
+	Settings.Scale = Scale;
+
+	TArray<int32> BlockIndices;
+	const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(Size, Settings.BlockSize);
+	for (int32 i = 0; i < NumBlocks * NumBlocks * NumBlocks; i++)
+		BlockIndices.Add(i);
 
-	struct FVertexInterpResult
+	TSharedRef<FTerrainDensityStorage, ESPMode::ThreadSafe> Generated = MakeShared<FTerrainDensityStorage, ESPMode::ThreadSafe>();
+	ResetDensityStorage(*Generated);
+
+	LaunchMeshExtraction(Serial, true,
+		[Generated, ChunkWorldOrigin, Size, Scale, NoiseScale, HeightBias, NoiseStrength, Truncation = DensityTruncation,
+		 Noise = NoiseSettings, Settings, Halo = MakeHalo(), BlockIndices = MoveTemp(BlockIndices), bKeepMesh]
+		(TArray<FTerrainMeshBlock>& OutBlocks, TFunctionRef<bool()> ShouldCancel)
+		{
+			TArray<float> Dense;
+			GenerateDensity(ChunkWorldOrigin, Size, Scale, NoiseScale, HeightBias, NoiseStrength, Dense, Truncation, Noise, Settings.bParallel);
+			Generated->SetFromDense(Size, Dense);
+			if (!bKeepMesh)
+				ExtractChunkMesh(*Generated, Settings, BlockIndices, OutBlocks, ShouldCancel, Halo.Get());
+		},
+		[this, Generated, Size, Scale, bKeepMesh]()
+		{
+			bDensityPending = false;
+			bUnsavedEdits = false;
+			CurrentSize  = Size;
+			CurrentScale = Scale;
+			Density      = MoveTemp(*Generated);
+
+			// The kept mesh was built along with its neighbours: its seams need no remesh.
+			if (bKeepMesh)
+				HaloFaceMask = 0x3F;
+		},
+		MoveTemp(OnCompleted), !bKeepMesh);
+}
+
+void UProceduralTerrain::LoadTerrainAsync(const FString& FileName, TFunction<void()> OnCompleted)
+{
+	const FString LoadPath = FPaths::ProjectSavedDir() / FileName;
+	LoadTerrainFromAsync(LoadPath, [LoadPath](TArray<uint8>& OutBytes)
 	{
-		FVector Position;
-		FVector Normal;
-	};
+		TERRAIN_TRACE_SCOPE(IO.Read);
+		return FFileHelper::LoadFileToArray(OutBytes, *LoadPath, FILEREAD_Silent);
+	}, MoveTemp(OnCompleted));
+}
+
+void UProceduralTerrain::LoadTerrainFromAsync(const FString& SourceName, FTerrainChunkReader Read, TFunction<void()> OnCompleted,
+	bool bKeepMesh)
+{
+	const uint32 Serial = BeginRebuild();
+	DirtyRegion.Reset();
+	PendingBlocks.Reset();
+	bPendingFullRebuild = true;
+	bLODRemeshPending = false;
+
+	// Edits of the field being replaced are dropped (see bDensityPending).
+	bDensityPending = true;
 
-	auto VertexInterp = [&](const FVector& p1, const FVector& p2, float valp1, float valp2,
-	                        const FVector& n1, const FVector& n2)
+	struct FLoadedChunk
 	{
-		if (FMath::Abs(IsoLevel - valp1) < KINDA_SMALL_NUMBER)
-			return FVertexInterpResult{p1, n1.GetSafeNormal()};
-		if (FMath::Abs(IsoLevel - valp2) < KINDA_SMALL_NUMBER)
-			return FVertexInterpResult{p2, n2.GetSafeNormal()};
-		if (FMath::Abs(valp1 - valp2) < KINDA_SMALL_NUMBER)
-			return FVertexInterpResult{p1, n1.GetSafeNormal()};
+		FTerrainChunkHeader Header;
+		FTerrainDensityStorage Density;
+		bool bValid = false;
+
+		// The blocks come from the mesh cached in the file (see bCacheMeshInSaves).
+		bool bCachedMesh = false;
+	};
+	TSharedRef<FLoadedChunk, ESPMode::ThreadSafe> Loaded = MakeShared<FLoadedChunk, ESPMode::ThreadSafe>();
+	ResetDensityStorage(Loaded->Density);
+
+	LaunchMeshExtraction(Serial, true,
+		[Loaded, Read = MoveTemp(Read), ChunkBaseline = Baseline, Settings = GetMeshSettings(), Halo = MakeHalo(), bKeepMesh](TArray<FTerrainMeshBlock>& OutBlocks, TFunctionRef<bool()> ShouldCancel)
+		{
+			TArray<uint8> Bytes;
+			if (!Read(Bytes)
+				|| !DecodeChunkFile(Bytes, ChunkBaseline, Settings.bParallel, Loaded->Header, Loaded->Density))
+				return;
+
+			Loaded->bValid = true;
+			if (bKeepMesh)
+				return;
+
+			const FTerrainChunkHeader& Header = Loaded->Header;
+			const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(Header.Size, Settings.BlockSize);
+			TArray<int32> BlockIndices;
+			for (int32 i = 0; i < NumBlocks * NumBlocks * NumBlocks; i++)
+				BlockIndices.Add(i);
+
+			FTerrainMeshSettings FileSettings = Settings;
+			FileSettings.Scale    = Header.Scale;
+			FileSettings.IsoLevel = Header.IsoLevel;
+
+			// A mesh cached by the save is uploaded as is if it was extracted from this very density.
+			if (ReadCachedMesh(Bytes, Header, Loaded->Density, FileSettings, OutBlocks))
+			{
+				Loaded->bCachedMesh = true;
+				return;
+			}
+			ExtractChunkMesh(Loaded->Density, FileSettings, BlockIndices, OutBlocks, ShouldCancel, Halo.Get());
+		},
+		[this, Loaded, SourceName, bKeepMesh]()
+		{
+			bDensityPending = false;
+			if (!Loaded->bValid)
+			{
+				UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Invalid or unsupported terrain chunk file: %s"), *SourceName);
+				return;
+			}
+
+			CurrentSize     = Loaded->Header.Size;
+			CurrentScale    = Loaded->Header.Scale;
+			CurrentIsoLevel = Loaded->Header.IsoLevel;
+			Density         = MoveTemp(Loaded->Density);
+			bUnsavedEdits   = false;
+			if (bKeepMesh)
+				HaloFaceMask = 0x3F;
+			else if (Loaded->bCachedMesh)
+				HaloFaceMask = Loaded->Header.MeshHaloFaceMask;
+		},
+		MoveTemp(OnCompleted), !bKeepMesh);
+}
+
+bool UProceduralTerrain::HasPendingRebuild() const
+{
+	return PendingRebuilds > 0;
+}
+
+bool UProceduralTerrain::IsUploadQueued() const
+{
+	return PendingRebuilds > 0 && RebuildSerial.IsValid() && QueuedUploadSerial == RebuildSerial->load();
+}
+
+void UProceduralTerrain::RecordRebuild(double LaunchTime, double WorkerSeconds, double UploadStartTime, bool bFullRebuild)
+{
+	const double Now = FPlatformTime::Seconds();
+	RebuildStats.TotalMs       = (Now - LaunchTime) * 1000.0;
+	RebuildStats.WorkerMs      = WorkerSeconds * 1000.0;
+	RebuildStats.UploadMs      = (Now - UploadStartTime) * 1000.0;
+	RebuildStats.CompletedTime = Now;
+	RebuildStats.bFullRebuild  = bFullRebuild;
+}
 
-		float mu = (IsoLevel - valp1) / (valp2 - valp1);
+void UProceduralTerrain::ResetForReuse()
+{
+	BeginRebuild();
+	DirtyRegion.Reset();
+	PendingBlocks.Reset();
+	bPendingFullRebuild = false;
+	DeferredRemeshCallbacks.Reset();
+	bLODRemeshPending = false;
+	bDensityPending = false;
+	HaloFaceMask = 0;
+	bGPUMeshed = false;
+	GPUChunkDesc.Brushes.Reset();
+	bGPUBrushesIncomplete = false;
+	bGPUMeshOverflow = false;
+	bUnsavedEdits = false;
+	Baseline = FTerrainBaselineSettings();
+
+	CurrentSize = 0;
+	Density.Reset();
+	ClearAllMeshSections();
+	if (RenderComponent)
+		RenderComponent->ClearBlocks();
+	BlockMeshCounts.Reset();
+	RebuildStats = FTerrainRebuildStats();
+}
 
-		FVector Position = p1 + mu * (p2 - p1);
-		FVector Normal   = (n1 + mu * (n2 - n1));
-		if (!Normal.Normalize())
+void UProceduralTerrain::ResetDensityStorage(FTerrainDensityStorage& Storage) const
+{
+	// A range fitted to the generated density would silently clamp the digs and fills going past it.
+	ETerrainDensityEncoding Encoding = DensityEncoding;
+	if (Encoding != ETerrainDensityEncoding::Float32 && DensityTruncation <= 0.0f)
+	{
+		static std::atomic<bool> bWarned = false;
+		if (!bWarned.exchange(true))
 		{
-			Normal = FVector::UpVector;
+			UE_LOG(LogDestructionTerrain, Warning, TEXT("⚠️ %s: quantized DensityEncoding needs a DensityTruncation > 0, keeping float samples."),
+				*GetName());
 		}
+		Encoding = ETerrainDensityEncoding::Float32;
+	}
+
+	Storage.Reset();
+	Storage.SetEncoding(Encoding, DensityTruncation);
+}
+
+uint32 UProceduralTerrain::BeginRebuild()
+{
+	if (!RebuildSerial.IsValid())
+	{
+		RebuildSerial = MakeShared<std::atomic<uint32>, ESPMode::ThreadSafe>(0);
+	}
+	return ++(*RebuildSerial);
+}
 
-		return FVertexInterpResult{Position, Normal};
+TArray<int32> UProceduralTerrain::GetAllBlockIndices() const
+{
+	const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(CurrentSize, MeshBlockSize);
+
+	TArray<int32> Indices;
+	Indices.Reserve(NumBlocks * NumBlocks * NumBlocks);
+	for (int32 i = 0; i < NumBlocks * NumBlocks * NumBlocks; i++)
+		Indices.Add(i);
+	return Indices;
+}
+
+TArray<int32> UProceduralTerrain::GetBlocksAffectedBy(const FTerrainDirtyRegion& Region) const
+{
+	TArray<int32> Indices;
+	const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(CurrentSize, MeshBlockSize);
+	if (Region.IsEmpty() || NumBlocks == 0)
+		return Indices;
+
+	// A modified voxel changes the gradients of its direct neighbours, which are corners of the
+	// cells [v - 2, v + 1]; those cells' blocks must be remeshed.
+	const int32 CellsPerBlock = MeshBlockSize > 0 ? MeshBlockSize : CurrentSize - 1;
+	auto ToBlock = [&](int32 Cell)
+	{
+		return FMath::Clamp(FMath::Max(Cell, 0) / CellsPerBlock, 0, NumBlocks - 1);
 	};
 
-	for (int32 z = 0; z < Size - 1; z++)
-	for (int32 y = 0; y < Size - 1; y++)
-	for (int32 x = 0; x < Size - 1; x++)
-	{
-		FVector p[8];
-		float   val[8];
-		FVector grad[8];
-
-		static const int CornerOffsets[8][3] = {
-			{0, 0, 0},
-			{1, 0, 0},
-			{1, 1, 0},
-			{0, 1, 0},
-			{0, 0, 1},
-			{1, 0, 1},
-			{1, 1, 1},
-			{0, 1, 1}
-		};
-
-		for (int i = 0; i < 8; i++)
-		{
-			const int dx = CornerOffsets[i][0];
-			const int dy = CornerOffsets[i][1];
-			const int dz = CornerOffsets[i][2];
+	const FIntVector BlockMin(ToBlock(Region.Min.X - 2), ToBlock(Region.Min.Y - 2), ToBlock(Region.Min.Z - 2));
+	const FIntVector BlockMax(ToBlock(Region.Max.X + 1), ToBlock(Region.Max.Y + 1), ToBlock(Region.Max.Z + 1));
 
-			p[i]    = FVector((x + dx) * Scale, (y + dy) * Scale, (z + dz) * Scale);
-			val[i]  = Density[GetIndex(x + dx, y + dy, z + dz)];
-			grad[i] = Gradients[GetIndex(x + dx, y + dy, z + dz)].GetSafeNormal();
-		}
+	for (int32 bz = BlockMin.Z; bz <= BlockMax.Z; bz++)
+	for (int32 by = BlockMin.Y; by <= BlockMax.Y; by++)
+	for (int32 bx = BlockMin.X; bx <= BlockMax.X; bx++)
+		Indices.Add(bx + by * NumBlocks + bz * NumBlocks * NumBlocks);
 
-		int cubeIndex = 0;
-		if (val[0] < IsoLevel) cubeIndex |= 1;
-		if (val[1] < IsoLevel) cubeIndex |= 2;
-		if (val[2] < IsoLevel) cubeIndex |= 4;
-		if (val[3] < IsoLevel) cubeIndex |= 8;
-		if (val[4] < IsoLevel) cubeIndex |= 16;
-		if (val[5] < IsoLevel) cubeIndex |= 32;
-		if (val[6] < IsoLevel) cubeIndex |= 64;
-		if (val[7] < IsoLevel) cubeIndex |= 128;
-
-		if (edgeTable[cubeIndex] == 0)
-			continue;
+	return Indices;
+}
+
+void UProceduralTerrain::LaunchMeshExtraction(uint32 Serial, bool bFullRebuild, FMeshExtractionFunc Extract,
+	TFunction<void()> OnCommit, TFunction<void()> OnCompleted, bool bApplyMesh)
+{
+	TSharedRef<std::atomic<uint32>, ESPMode::ThreadSafe> SerialCounter = RebuildSerial.ToSharedRef();
+	TWeakObjectPtr<UProceduralTerrain> WeakThis(this);
+	++PendingRebuilds;
 
-		FVertexInterpResult vertList[12];
-
-		if (edgeTable[cubeIndex] & 1)    vertList[0]  = VertexInterp(p[0], p[1], val[0], val[1], grad[0], grad[1]);
-		if (edgeTable[cubeIndex] & 2)    vertList[1]  = VertexInterp(p[1], p[2], val[1], val[2], grad[1], grad[2]);
-		if (edgeTable[cubeIndex] & 4)    vertList[2]  = VertexInterp(p[2], p[3], val[2], val[3], grad[2], grad[3]);
-		if (edgeTable[cubeIndex] & 8)    vertList[3]  = VertexInterp(p[3], p[0], val[3], val[0], grad[3], grad[0]);
-		if (edgeTable[cubeIndex] & 16)   vertList[4]  = VertexInterp(p[4], p[5], val[4], val[5], grad[4], grad[5]);
-		if (edgeTable[cubeIndex] & 32)   vertList[5]  = VertexInterp(p[5], p[6], val[5], val[6], grad[5], grad[6]);
-		if (edgeTable[cubeIndex] & 64)   vertList[6]  = VertexInterp(p[6], p[7], val[6], val[7], grad[6], grad[7]);
-		if (edgeTable[cubeIndex] & 128)  vertList[7]  = VertexInterp(p[7], p[4], val[7], val[4], grad[7], grad[4]);
-		if (edgeTable[cubeIndex] & 256)  vertList[8]  = VertexInterp(p[0], p[4], val[0], val[4], grad[0], grad[4]);
-		if (edgeTable[cubeIndex] & 512)  vertList[9]  = VertexInterp(p[1], p[5], val[1], val[5], grad[1], grad[5]);
-		if (edgeTable[cubeIndex] & 1024) vertList[10] = VertexInterp(p[2], p[6], val[2], val[6], grad[2], grad[6]);
-		if (edgeTable[cubeIndex] & 2048) vertList[11] = VertexInterp(p[3], p[7], val[3], val[7], grad[3], grad[7]);
-
-		for (int i = 0; triTable[cubeIndex][i] != -1; i += 3)
+	// The worker refills the buffers of the previous upload (see MeshScratch); they come back once applied.
+	TSharedRef<TArray<FTerrainMeshBlock>, ESPMode::ThreadSafe> Blocks = MakeShared<TArray<FTerrainMeshBlock>, ESPMode::ThreadSafe>(MoveTemp(MeshScratch));
+	MeshScratch.Reset();
+
+	// Timed from the request for GetRebuildStats(); the name tags the trace events of this rebuild.
+	const double LaunchTime = FPlatformTime::Seconds();
+	const FName ChunkName = GetFName();
+
+	Async(EAsyncExecution::ThreadPool,
+		[WeakThis, SerialCounter, Serial, bFullRebuild, bApplyMesh, Blocks, LaunchTime, ChunkName, Extract = MoveTemp(Extract), OnCommit = MoveTemp(OnCommit), OnCompleted = MoveTemp(OnCompleted)]() mutable
 		{
-			const FVertexInterpResult& r0 = vertList[triTable[cubeIndex][i]];
-			const FVertexInterpResult& r1 = vertList[triTable[cubeIndex][i + 1]];
-			const FVertexInterpResult& r2 = vertList[triTable[cubeIndex][i + 2]];
+			auto IsStale = [&SerialCounter, Serial]() { return SerialCounter->load() != Serial; };
 
-			const FVector& v0 = r0.Position;
-			const FVector& v1 = r1.Position;
-			const FVector& v2 = r2.Position;
+			// Worker thread: pure extraction, no UObject access.
+			const double WorkerStartTime = FPlatformTime::Seconds();
+			if (!IsStale())
+			{
+				TERRAIN_TRACE_CHUNK_SCOPE(Extract, ChunkName);
+				Extract(*Blocks, IsStale);
+			}
+			const double WorkerSeconds = FPlatformTime::Seconds() - WorkerStartTime;
+
+			// Game thread: commit and upload, unless a newer rebuild superseded this one.
+			auto Finish = [WeakThis, SerialCounter, Serial, bFullRebuild, bApplyMesh, Blocks, LaunchTime, WorkerSeconds, ChunkName, OnCommit = MoveTemp(OnCommit), OnCompleted = MoveTemp(OnCompleted)]()
+			{
+				UProceduralTerrain* Terrain = WeakThis.Get();
+				if (!Terrain)
+					return;
+
+				--Terrain->PendingRebuilds;
+
+				if (SerialCounter->load() == Serial)
+				{
+					TERRAIN_TRACE_CHUNK_SCOPE(Commit, ChunkName);
+					const double UploadStartTime = FPlatformTime::Seconds();
+					if (OnCommit)
+						OnCommit();
+
+					Terrain->PendingBlocks.Reset();
+					Terrain->bPendingFullRebuild = false;
+					if (bApplyMesh)
+					{
+						Terrain->ApplyMeshBlocks(*Blocks, bFullRebuild);
+						Terrain->RecordRebuild(LaunchTime, WorkerSeconds, UploadStartTime, bFullRebuild);
+					}
+
+					// The extraction used the stride of its launch time.
+					if (Terrain->bLODRemeshPending)
+					{
+						Terrain->bLODRemeshPending = false;
+						Terrain->RebuildMeshAsync();
+					}
+					else if (bFullRebuild)
+					{
+						Terrain->RemeshDeferredRegion();
+					}
+				}
+
+				// Keep the largest set of buffers for the next extraction.
+				if (Terrain->MeshScratch.Num() < Blocks->Num())
+					Terrain->MeshScratch = MoveTemp(*Blocks);
+
+				if (OnCompleted)
+					OnCompleted();
+			};
+
+			DispatchFinish(WeakThis, SerialCounter, Serial, bFullRebuild, MoveTemp(Finish));
+		});
+}
+
+void UProceduralTerrain::RemeshDeferredRegion()
+{
+	TArray<TFunction<void()>> Deferred = MoveTemp(DeferredRemeshCallbacks);
+	DeferredRemeshCallbacks.Reset();
+	TFunction<void()> OnRemeshed = [Deferred = MoveTemp(Deferred)]()
+	{
+		for (const TFunction<void()>& Callback : Deferred)
+			Callback();
+	};
+
+	if (!DirtyRegion.IsEmpty())
+		RebuildDirtyRegionAsync(MoveTemp(OnRemeshed));
+	else
+		OnRemeshed();
+}
 
-			int32 BaseIndex = Vertices.Num();
-			Vertices.Add(v0);
-			Vertices.Add(v1);
-			Vertices.Add(v2);
+bool UProceduralTerrain::CanUseGPUGeneration() const
+{
+	return bGPUGeneration
+		&& RenderBackend == ETerrainRenderBackend::TerrainRenderer
+		&& NoiseSettings.Kernel == ETerrainNoiseKernel::Vectorized
+		&& LODStride == 1 && SkirtDepth <= 0.0f && CollisionStride <= 1
+		&& GPUChunkDesc.Brushes.Num() <= MaxGPUBrushes && !bGPUBrushesIncomplete && !bGPUMeshOverflow
+		&& TerrainGPU::IsSupported();
+}
+
+void UProceduralTerrain::LaunchGPUGeneration(bool bNewDensity, TFunction<void()> OnCompleted)
+{
+	const uint32 Serial = BeginRebuild();
+	DirtyRegion.Reset();
+	PendingBlocks.Reset();
+	bPendingFullRebuild = true;
 
-			Triangles.Add(BaseIndex);
-			Triangles.Add(BaseIndex + 1);
-			Triangles.Add(BaseIndex + 2);
+	FTerrainGPUChunkDesc Desc = GPUChunkDesc;
+	Desc.bReadbackDensity = bNewDensity;
+	Desc.bReadbackMesh = bTerrainCollisionEnabled;
 
-			FVector FaceNormal = FVector::CrossProduct(v1 - v0, v2 - v0).GetSafeNormal();
+	TSharedRef<FTerrainDensityStorage, ESPMode::ThreadSafe> Generated = MakeShared<FTerrainDensityStorage, ESPMode::ThreadSafe>();
+	ResetDensityStorage(*Generated);
 
-			auto AddNormal = [&](const FVector& Candidate)
+	TSharedRef<std::atomic<uint32>, ESPMode::ThreadSafe> SerialCounter = RebuildSerial.ToSharedRef();
+	TWeakObjectPtr<UProceduralTerrain> WeakThis(this);
+	++PendingRebuilds;
+
+	const double LaunchTime = FPlatformTime::Seconds();
+	const FName ChunkName = GetFName();
+
+	TerrainGPU::GenerateChunk(Desc,
+		[WeakThis, SerialCounter, Serial, Generated, LaunchTime, ChunkName, Size = Desc.Size, Scale = Desc.Scale, OnCompleted = MoveTemp(OnCompleted)]
+		(TSharedRef<FTerrainGPUReadback, ESPMode::ThreadSafe> Readback) mutable
+		{
+			// Worker thread: the density read back is stored like a CPU generation's.
+			if (Readback->Density.Num() > 0 && SerialCounter->load() == Serial)
 			{
-				FVector Result = Candidate;
-				if (!Result.Normalize())
+				TERRAIN_TRACE_CHUNK_SCOPE(Density, ChunkName);
+				Generated->SetFromDense(Size, Readback->Density);
+			}
+
+			auto Finish = [WeakThis, SerialCounter, Serial, Generated, Readback, Size, Scale, LaunchTime, ChunkName, OnCompleted = MoveTemp(OnCompleted)]()
+			{
+				UProceduralTerrain* Terrain = WeakThis.Get();
+				if (!Terrain)
+					return;
+
+				--Terrain->PendingRebuilds;
+
+				if (SerialCounter->load() == Serial)
 				{
-					Result = FaceNormal;
+					TERRAIN_TRACE_CHUNK_SCOPE(Commit, ChunkName);
+					const double UploadStartTime = FPlatformTime::Seconds();
+					if (Readback->Density.Num() > 0)
+					{
+						Terrain->bDensityPending = false;
+						Terrain->bUnsavedEdits = false;
+						Terrain->CurrentSize  = Size;
+						Terrain->CurrentScale = Scale;
+						Terrain->Density      = MoveTemp(*Generated);
+					}
+
+					Terrain->PendingBlocks.Reset();
+					Terrain->bPendingFullRebuild = false;
+
+					// Triangles past the capacity were dropped: the density is complete, the CPU meshes it instead.
+					if (Readback->NumVertices > static_cast<uint32>(Readback->GPUMesh->MaxVertices))
+					{
+						UE_LOG(LogDestructionTerrain, Log, TEXT("⚠️ %s: GPU mesh overflow (%u vertices for %d), meshing on the CPU."),
+							*ChunkName.ToString(), Readback->NumVertices, Readback->GPUMesh->MaxVertices);
+						Terrain->bGPUMeshOverflow = true;
+						Terrain->bLODRemeshPending = false;
+						Terrain->RebuildMeshAsync(MoveTemp(OnCompleted));
+						return;
+					}
+
+					Terrain->ApplyGPUMesh(*Readback);
+					Terrain->RecordRebuild(LaunchTime, 0.0, UploadStartTime, true);
+
+					if (Terrain->bLODRemeshPending)
+					{
+						Terrain->bLODRemeshPending = false;
+						Terrain->RebuildMeshAsync();
+					}
+					else
+					{
+						Terrain->RemeshDeferredRegion();
+					}
 				}
-				Normals.Add(Result);
+
+				if (OnCompleted)
+					OnCompleted();
 			};
 
-			AddNormal(r0.Normal);
-			AddNormal(r1.Normal);
-			AddNormal(r2.Normal);
+			DispatchFinish(WeakThis, SerialCounter, Serial, true, MoveTemp(Finish));
+		});
+}
+
+void UProceduralTerrain::ApplyGPUMesh(const FTerrainGPUReadback& Readback)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerrainUpload);
+	TERRAIN_TRACE_SCOPE(Upload);
+
+	UTerrainRenderComponent* Component = GetOrCreateRenderComponent();
+
+	// The vertices stay on the GPU: the bounds are the chunk's box.
+	const FBox ChunkBox(FVector::ZeroVector, FVector(static_cast<float>(CurrentSize - 1) * CurrentScale));
+	Component->SetGPUMesh(Readback.GPUMesh, ChunkBox, Readback.Mesh);
+
+	bGPUMeshed = true;
+
+	// The GPU field samples the noise (and the digs) one voxel beyond every face, as a neighbour would.
+	HaloFaceMask = 0x3F;
+
+	const int32 NumVertices = FMath::Min(static_cast<int32>(Readback.NumVertices), Readback.GPUMesh->MaxVertices);
+	BlockMeshCounts.Reset();
+	RebuildStats.Vertices  = NumVertices;
+	RebuildStats.Triangles = NumVertices / 3;
+
+	INC_DWORD_STAT_BY(STAT_TerrainVerticesUploaded, NumVertices);
+	INC_DWORD_STAT_BY(STAT_TerrainTrianglesUploaded, NumVertices / 3);
+}
+
+void UProceduralTerrain::QueueGPUBrush(const FTerrainVoxelBrush& Brush)
+{
+	if (!bGPUMeshed || bDensityPending)
+		return;
+
+	if (Brush.Shape != ETerrainBrushShape::Sphere || Brush.Operation != ETerrainBrushOperation::Add)
+	{
+		bGPUBrushesIncomplete = true;
+		return;
+	}
+
+	FTerrainGPUBrush& GPUBrush = GPUChunkDesc.Brushes.AddDefaulted_GetRef();
+	GPUBrush.Center   = FVector3f(Brush.Anchor) + Brush.Start;
+	GPUBrush.Radius   = Brush.Radius;
+	GPUBrush.Strength = Brush.Strength;
+}
+
+void UProceduralTerrain::ApplyMeshBlocks(const TArray<FTerrainMeshBlock>& Blocks, bool bReplaceAll)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerrainUpload);
+	TERRAIN_TRACE_SCOPE(Upload);
+
+	// A CPU mesh replaces the GPU one: later edits are remeshed from Density.
+	if (bReplaceAll)
+	{
+		bGPUMeshed = false;
+		GPUChunkDesc.Brushes.Reset();
+		bGPUBrushesIncomplete = false;
+		BlockMeshCounts.Reset();
+		RebuildStats.Vertices = RebuildStats.Triangles = 0;
+	}
+
+	// Chunk totals for GetRebuildStats(): each block replaces the counts of its section.
+	for (const FTerrainMeshBlock& Block : Blocks)
+	{
+		if (Block.bCollisionOnly)
+			continue;
+
+		const FIntPoint Counts(Block.Mesh.Vertices.Num(), Block.Mesh.Triangles.Num() / 3);
+		FIntPoint& Previous = BlockMeshCounts.FindOrAdd(Block.SectionIndex, FIntPoint::ZeroValue);
+		RebuildStats.Vertices  += Counts.X - Previous.X;
+		RebuildStats.Triangles += Counts.Y - Previous.Y;
+		Previous = Counts;
+	}
+
+	if (RenderBackend == ETerrainRenderBackend::TerrainRenderer)
+	{
+		int32 NumVertices = 0;
+		int32 NumTriangles = 0;
+		for (const FTerrainMeshBlock& Block : Blocks)
+		{
+			if (Block.bCollisionOnly)
+				continue;
+			NumVertices  += Block.Mesh.Vertices.Num();
+			NumTriangles += Block.Mesh.Triangles.Num() / 3;
 		}
+
+		GetOrCreateRenderComponent()->UpdateBlocks(Blocks, bReplaceAll);
+
+		INC_DWORD_STAT_BY(STAT_TerrainVerticesUploaded, NumVertices);
+		INC_DWORD_STAT_BY(STAT_TerrainTrianglesUploaded, NumTriangles);
+		return;
 	}
-	ClearAllMeshSections();
-	CreateMeshSection(0, Vertices, Triangles, Normals, {}, {}, {}, true);
 
-	UE_LOG(LogTemp, Warning, TEXT("✅ Mesh reconstruit (%d sommets / %d triangles)"),
-		Vertices.Num(), Triangles.Num() / 3);
+	if (RenderComponent && bReplaceAll)
+		RenderComponent->ClearBlocks();
+
+	// Clearing an already empty section would still rebuild the collision, so only used sections are cleared.
+	auto ClearUsedSection = [this](int32 SectionIndex)
+	{
+		const FProcMeshSection* Section = GetProcMeshSection(SectionIndex);
+		if (Section && Section->ProcIndexBuffer.Num() > 0)
+			ClearMeshSection(SectionIndex);
+	};
+
+	// Sections are rewritten in place, even for a full rebuild; it only clears the sections it did not produce.
+	TBitArray<> Written(false, bReplaceAll ? GetNumSections() : 0);
+
+	int32 NumVertices = 0;
+	int32 NumTriangles = 0;
+	for (const FTerrainMeshBlock& Block : Blocks)
+	{
+		if (Block.SectionIndex < Written.Num())
+			Written[Block.SectionIndex] = true;
+
+		if (Block.Mesh.IsEmpty())
+		{
+			ClearUsedSection(Block.SectionIndex);
+			continue;
+		}
+
+		WriteMeshSection(Block.SectionIndex, Block.Mesh, Block.bCollisionOnly);
+		if (Block.bCollisionOnly)
+			continue;
+
+		NumVertices  += Block.Mesh.Vertices.Num();
+		NumTriangles += Block.Mesh.Triangles.Num() / 3;
+	}
+
+	for (int32 SectionIndex = 0; SectionIndex < Written.Num(); SectionIndex++)
+	{
+		if (!Written[SectionIndex])
+			ClearUsedSection(SectionIndex);
+	}
+
+	INC_DWORD_STAT_BY(STAT_TerrainVerticesUploaded, NumVertices);
+	INC_DWORD_STAT_BY(STAT_TerrainTrianglesUploaded, NumTriangles);
+	UE_LOG(LogDestructionTerrain, Verbose, TEXT("✅ Mesh reconstruit (%d blocs, %d sommets / %d triangles)"),
+		Blocks.Num(), NumVertices, NumTriangles);
+}
+
+UTerrainRenderComponent* UProceduralTerrain::GetOrCreateRenderComponent()
+{
+	if (!RenderComponent)
+	{
+		RenderComponent = NewObject<UTerrainRenderComponent>(GetOwner(), NAME_None, RF_Transient);
+		RenderComponent->SetupAttachment(this);
+		RenderComponent->SetMaterial(0, GetMaterial(0));
+		RenderComponent->SetCollisionProfileName(GetCollisionProfileName());
+		RenderComponent->bUseAsyncCooking = bUseAsyncCooking;
+		RenderComponent->SetTerrainCollisionEnabled(bTerrainCollisionEnabled);
+		RenderComponent->RegisterComponent();
+
+		// Sections uploaded by the procedural mesh backend would be drawn twice.
+		ClearAllMeshSections();
+	}
+	return RenderComponent;
+}
+
+void UProceduralTerrain::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+	if (RenderComponent)
+	{
+		RenderComponent->DestroyComponent();
+		RenderComponent = nullptr;
+	}
+	Super::OnComponentDestroyed(bDestroyingHierarchy);
+}
+
+void UProceduralTerrain::WriteMeshSection(int32 SectionIndex, const FTerrainMeshData& Mesh, bool bCollisionOnly)
+{
+	FProcMeshSection* Existing = GetProcMeshSection(SectionIndex);
+
+	// With a decimated collision mesh, only its hidden section cooks physics.
+	const bool bVisible = !bCollisionOnly;
+	const bool bCollision = bTerrainCollisionEnabled && (bCollisionOnly || CollisionStride <= 1);
+
+	// Same topology as the uploaded section: only the vertex stream changes, the render proxy keeps its index buffer.
+	if (Existing
+		&& Existing->bSectionVisible == bVisible
+		&& Existing->bEnableCollision == bCollision
+		&& Existing->ProcVertexBuffer.Num() == Mesh.Vertices.Num()
+		&& Existing->ProcIndexBuffer.Num() == Mesh.Triangles.Num()
+		&& FMemory::Memcmp(Existing->ProcIndexBuffer.GetData(), Mesh.Triangles.GetData(), Mesh.Triangles.Num() * sizeof(int32)) == 0)
+	{
+		UploadPositions.Reset(Mesh.Vertices.Num());
+		UploadNormals.Reset(Mesh.Normals.Num());
+		for (int32 i = 0; i < Mesh.Vertices.Num(); i++)
+		{
+			UploadPositions.Add(FVector(Mesh.Vertices[i]));
+			UploadNormals.Add(FVector(Mesh.Normals[i]));
+		}
+		SubmitMeshSection(bCollisionOnly, [&] { UpdateMeshSection(SectionIndex, UploadPositions, UploadNormals, {}, {}, {}); });
+		return;
+	}
+
+	// Otherwise the section's own buffers are refilled (they keep their capacity); a new section is staged in UploadSection.
+	FProcMeshSection& Section = Existing ? *Existing : UploadSection;
+	Section.ProcVertexBuffer.Reset(Mesh.Vertices.Num());
+	Section.ProcIndexBuffer.Reset(Mesh.Triangles.Num());
+	Section.SectionLocalBox.Init();
+	Section.bEnableCollision = bCollision;
+	Section.bSectionVisible = bVisible;
+
+	for (int32 i = 0; i < Mesh.Vertices.Num(); i++)
+	{
+		FProcMeshVertex& Vertex = Section.ProcVertexBuffer.AddDefaulted_GetRef();
+		Vertex.Position = FVector(Mesh.Vertices[i]);
+		Vertex.Normal   = FVector(Mesh.Normals[i]);
+		Section.SectionLocalBox += Vertex.Position;
+	}
+	for (int32 Index : Mesh.Triangles)
+		Section.ProcIndexBuffer.Add(Index);
+
+	// Refreshes bounds, collision and render state (for an existing section, assigns it to itself).
+	SubmitMeshSection(bCollisionOnly, [&] { SetProcMeshSection(SectionIndex, Section); });
+}
+
+void UProceduralTerrain::SetTerrainCollisionEnabled(bool bEnabled)
+{
+	if (bTerrainCollisionEnabled == bEnabled)
+		return;
+	bTerrainCollisionEnabled = bEnabled;
+
+	if (RenderComponent)
+		RenderComponent->SetTerrainCollisionEnabled(bEnabled);
+
+	// GPU meshes only read their triangles back while collision is enabled.
+	if (bEnabled && bGPUMeshed && !bDensityPending && RenderComponent && !RenderComponent->ContainsPhysicsTriMeshData(true))
+	{
+		if (CanUseGPUGeneration())
+			LaunchGPUGeneration(false, nullptr);
+		else
+			RebuildMeshAsync();
+	}
+
+	// Re-flag the sections, then refresh one of them so that the collision is cooked (or dropped) once.
+	int32 LastUsedSection = INDEX_NONE;
+	for (int32 SectionIndex = 0; SectionIndex < GetNumSections(); SectionIndex++)
+	{
+		FProcMeshSection* Section = GetProcMeshSection(SectionIndex);
+		if (!Section || Section->ProcIndexBuffer.Num() == 0)
+			continue;
+
+		Section->bEnableCollision = bEnabled && (!Section->bSectionVisible || CollisionStride <= 1);
+		LastUsedSection = SectionIndex;
+	}
+
+	if (LastUsedSection != INDEX_NONE)
+	{
+		TERRAIN_TRACE_SCOPE(Cook);
+		SetProcMeshSection(LastUsedSection, *GetProcMeshSection(LastUsedSection));
+	}
+}
+
+TSharedPtr<const FTerrainDensityHalo, ESPMode::ThreadSafe> UProceduralTerrain::MakeHalo(bool bPartialRebuild)
+{
+	TSharedPtr<const FTerrainDensityHalo, ESPMode::ThreadSafe> Halo = ReadHalo();
+	const uint8 FaceMask = GetHaloFaceMask(Halo.Get());
+	HaloFaceMask = bPartialRebuild ? (HaloFaceMask & FaceMask) : FaceMask;
+	return Halo;
+}
+
+TSharedPtr<const FTerrainDensityHalo, ESPMode::ThreadSafe> UProceduralTerrain::ReadHalo() const
+{
+	if (!VoxelAccess.IsValid())
+		return nullptr;
+
+	TSharedRef<FTerrainDensityHalo, ESPMode::ThreadSafe> Halo = MakeShared<FTerrainDensityHalo, ESPMode::ThreadSafe>();
+	{
+		// Border gradients read these samples; the others are evaluated lazily by the march (see STAT_TerrainGradientsEvaluated).
+		TERRAIN_TRACE_SCOPE(Gradient);
+		VoxelAccess->BuildHalo(ChunkCoords, *Halo);
+	}
+	return Halo;
+}
+
+FTerrainMeshSettings UProceduralTerrain::GetMeshSettings() const
+{
+	FTerrainMeshSettings Settings;
+	Settings.Scale           = CurrentScale;
+	Settings.IsoLevel        = CurrentIsoLevel;
+	Settings.bSharedVertices = bSharedVertices;
+	Settings.BlockSize       = MeshBlockSize;
+	Settings.bParallel       = bParallelBuild;
+	Settings.CollisionStride = CollisionStride;
+	Settings.LODStride       = LODStride;
+	Settings.SkirtDepth      = SkirtDepth;
+	return Settings;
+}
+
+bool UProceduralTerrain::ExtractChunkMesh(const FTerrainDensityStorage& Storage, const FTerrainMeshSettings& Settings,
+	const TArray<int32>& BlockIndices, TArray<FTerrainMeshBlock>& OutBlocks, TFunctionRef<bool()> ShouldCancel,
+	const FTerrainDensityHalo* Halo)
+{
+	const int32 Size = Storage.GetSize();
+	const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(Size, Settings.BlockSize);
+
+	bool bExtracted;
+	if (Settings.LODStride > 1)
+	{
+		OutBlocks.SetNum(1);
+		OutBlocks[0].SectionIndex = 0;
+		OutBlocks[0].bCollisionOnly = false;
+		bExtracted = TerrainMesher::ExtractDecimated(Storage, Settings.Scale, Settings.IsoLevel, Settings.LODStride, OutBlocks[0].Mesh, ShouldCancel);
+	}
+	else
+	{
+		bExtracted = TerrainMesher::ExtractBlocks(Storage, Settings.Scale, Settings.IsoLevel, Settings.bSharedVertices,
+			Settings.BlockSize, BlockIndices, OutBlocks, ShouldCancel, Settings.bParallel, Halo);
+	}
+
+	if (!bExtracted || ShouldCancel())
+		return false;
+
+	if (Settings.SkirtDepth > 0.0f)
+	{
+		const FVector3f Extent(static_cast<float>(Size - 1) * Settings.Scale);
+		for (FTerrainMeshBlock& Block : OutBlocks)
+			TerrainMesher::AppendSkirts(Block.Mesh, Extent, Settings.SkirtDepth);
+	}
+
+	// The decimated collision is coarse enough to be extracted again as a whole, even after a local edit.
+	if (Settings.CollisionStride > 1)
+	{
+		FTerrainMeshBlock& Block = OutBlocks.AddDefaulted_GetRef();
+		Block.SectionIndex = NumBlocks * NumBlocks * NumBlocks;
+		Block.bCollisionOnly = true;
+		if (!TerrainMesher::ExtractDecimated(Storage, Settings.Scale, Settings.IsoLevel, Settings.CollisionStride, Block.Mesh, ShouldCancel))
+			return false;
+	}
+	return true;
+}
+
+void UProceduralTerrain::SetLODStride(int32 NewStride)
+{
+	NewStride = FMath::Clamp((int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(NewStride, 1)), 1, 8);
+	if (LODStride == NewStride)
+		return;
+
+	LODStride = NewStride;
+	if (!bDensityPending && CurrentSize > 1 && Density.GetSize() == CurrentSize)
+		RebuildMeshAsync();
+	else if (HasPendingRebuild())
+		bLODRemeshPending = true;
 }
 
 void UProceduralTerrain::BuildDensityField(int32 Size, float Scale, float NoiseScale, float HeightBias,
 	float NoiseStrength)
 {
+	check(Size > 0);
 	CurrentSize  = Size;
 	CurrentScale = Scale;
-	Density.SetNum(Size * Size * Size);
+	SetBaseline(Size, Scale, NoiseScale, HeightBias, NoiseStrength);
+	bUnsavedEdits = false;
 
-	FVector ChunkWorldOrigin = GetComponentLocation();
+	TArray<float> Dense;
+	GenerateDensity(GetComponentLocation(), Size, Scale, NoiseScale, HeightBias, NoiseStrength, Dense, DensityTruncation, NoiseSettings, bParallelBuild);
+	ResetDensityStorage(Density);
+	Density.SetFromDense(Size, Dense);
+}
 
-	auto GetIndex = [&](int32 x, int32 y, int32 z)
+void UProceduralTerrain::AddDensity(int32 X, int32 Y, int32 Z, float Delta)
+{
+	float Value = Density.Get(X, Y, Z) + Delta;
+	if (DensityTruncation > 0.0f)
+		Value = FMath::Clamp(Value, -DensityTruncation, DensityTruncation);
+	Density.Set(X, Y, Z, Value);
+	bUnsavedEdits = true;
+	++EditSerial;
+}
+
+void UProceduralTerrain::GenerateDensity(const FVector& ChunkWorldOrigin, int32 Size, float Scale, float NoiseScale,
+	float HeightBias, float NoiseStrength, TArray<float>& OutDensity, float Truncation, const FTerrainNoiseSettings& Noise, bool bParallel)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerrainDensity);
+	TERRAIN_TRACE_SCOPE(Density);
+	INC_DWORD_STAT_BY(STAT_TerrainVoxelsGenerated, Size * Size * Size);
+
+	OutDensity.SetNum(Size * Size * Size);
+
+	// Une rangée X à la fois : le noyau vectorisé évalue 4 voxels par appel ; les tranches Z sont indépendantes
+	ParallelFor(Size, [&](int32 z)
 	{
-		return x + y * Size + z * Size * Size;
-	};
-	check(Density.Num() == Size * Size * Size);
-	check(Size > 0);
-	for (int32 z = 0; z < Size; ++z)
 		for (int32 y = 0; y < Size; ++y)
+		{
+			float* Row = OutDensity.GetData() + y * Size + z * Size * Size;
+			const FVector RowStart = ChunkWorldOrigin + FVector(0.0, y * Scale, z * Scale);
+			TerrainNoise::FbmRow(RowStart * NoiseScale, static_cast<double>(Scale) * NoiseScale, Size, Noise, Row);
+
 			for (int32 x = 0; x < Size; ++x)
 			{
-				FVector WorldPos = ChunkWorldOrigin + FVector(x * Scale, y * Scale, z * Scale);
-				float Noise = FMath::PerlinNoise3D(WorldPos * NoiseScale);
-				float DensityValue = (z - HeightBias) + (Noise * NoiseStrength);
-				int32 Index = GetIndex(x, y, z);
-				check(Index >= 0 && Index < Density.Num());
-				Density[Index] = DensityValue;
-				Density[GetIndex(x, y, z)] = DensityValue;
+				float DensityValue = (z - HeightBias) + (Row[x] * NoiseStrength);
+				if (Truncation > 0.0f)
+					DensityValue = FMath::Clamp(DensityValue, -Truncation, Truncation);
+				Row[x] = DensityValue;
 			}
+		}
+	}, !bParallel);
 }
 
 bool UProceduralTerrain::ContainsWorldPoint(const FVector& WorldPos, float Radius) const
 {
-	const FBox ChunkBox = Bounds.GetBox();
+	const FBox ChunkBox = RenderComponent ? RenderComponent->Bounds.GetBox() : Bounds.GetBox();
 	return FMath::SphereAABBIntersection(FSphere(WorldPos, Radius), ChunkBox);
 }
\ No newline at end of file
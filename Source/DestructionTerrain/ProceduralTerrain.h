@@ -2,18 +2,127 @@
 
 #include "CoreMinimal.h"
 #include "ProceduralMeshComponent.h"
+#include "Tasks/Task.h"
+#include "TerrainBrush.h"
+#include "TerrainChunkFormat.h"
+#include "TerrainDensityStorage.h"
+#include "TerrainGPUGenerator.h"
+#include "TerrainNoise.h"
+#include "TerrainMesher.h"
+#include "TerrainRenderComponent.h"
+#include <atomic>
 #include "ProceduralTerrain.generated.h"
 
+class FTerrainUploadQueue;
+class FTerrainVoxelAccess;
+
+/** Inclusive box of voxels modified since the last remesh of a chunk. */
+struct FTerrainDirtyRegion
+{
+	FIntVector Min = FIntVector(MAX_int32);
+	FIntVector Max = FIntVector(MIN_int32);
+
+	bool IsEmpty() const { return Min.X > Max.X || Min.Y > Max.Y || Min.Z > Max.Z; }
+
+	void Add(const FIntVector& InMin, const FIntVector& InMax)
+	{
+		Min = FIntVector(FMath::Min(Min.X, InMin.X), FMath::Min(Min.Y, InMin.Y), FMath::Min(Min.Z, InMin.Z));
+		Max = FIntVector(FMath::Max(Max.X, InMax.X), FMath::Max(Max.Y, InMax.Y), FMath::Max(Max.Z, InMax.Z));
+	}
+
+	void Reset() { *this = FTerrainDirtyRegion(); }
+};
+
+/** Snapshot of the meshing parameters of a chunk, captured by value by worker-thread extractions. */
+struct FTerrainMeshSettings
+{
+	float Scale = 1.0f;
+	float IsoLevel = 0.0f;
+	bool  bSharedVertices = true;
+	int32 BlockSize = 8;
+	bool  bParallel = false;
+	int32 CollisionStride = 1;
+	int32 LODStride = 1;
+	float SkirtDepth = 0.0f;
+
+	/** Keys cached meshes along with the density (see bCacheMeshInSaves); bParallel does not change the surface. */
+	uint32 GetHash() const;
+};
+
+/** Procedural density of a chunk (see GenerateDensity()); edits are saved as a delta against it (see SaveDeltaToFile()). */
+struct FTerrainBaselineSettings
+{
+	/** World location of chunk voxel 0. */
+	FVector Origin = FVector::ZeroVector;
+
+	int32 Size = 0;
+	float Scale = 1.0f;
+	float NoiseScale = 0.0f;
+	float HeightBias = 0.0f;
+	float NoiseStrength = 0.0f;
+	float Truncation = 0.0f;
+	FTerrainNoiseSettings Noise;
+
+	bool IsValid() const { return Size > 1; }
+
+	/** Stored in delta files: a delta only applies to the baseline it was saved against. */
+	uint32 GetHash() const;
+};
+
+/** Snapshot of a chunk taken on the game thread by a save; encoded and written without touching the component. */
+struct FTerrainChunkSave
+{
+	/** Copy of the density (uniform bricks cost no samples). */
+	FTerrainDensityStorage Density;
+
+	FTerrainBaselineSettings Baseline;
+	FTerrainChunkHeader Header;
+
+	/** Where the save goes, for the logs. */
+	FString Name;
+
+	FTerrainChunkWriter Write;
+
+	bool bParallel = false;
+
+	/** Also store the mesh of the density (see bCacheMeshInSaves), extracted with these settings and neighbour samples. */
+	bool bCacheMesh = false;
+	FTerrainMeshSettings MeshSettings;
+	TSharedPtr<const FTerrainDensityHalo, ESPMode::ThreadSafe> Halo;
+};
+
+/** Cost and result of the last rebuild that reached the screen of a chunk (see UProceduralTerrain::GetRebuildStats()). */
+struct FTerrainRebuildStats
+{
+	/** From the request to the end of the upload, waits in the upload queue and density generation or decoding included. */
+	double TotalMs = 0.0;
+
+	/** Worker-thread part (generation or decoding, then extraction); zero for GPU rebuilds. */
+	double WorkerMs = 0.0;
+
+	/** Game-thread commit and upload, collision cooking included when it is not asynchronous. */
+	double UploadMs = 0.0;
+
+	/** Drawn by the whole chunk once uploaded. */
+	int32 Vertices = 0;
+	int32 Triangles = 0;
+
+	/** FPlatformTime::Seconds() at the end of the upload; 0 before the first one. */
+	double CompletedTime = 0.0;
+
+	bool bFullRebuild = false;
+};
+
 /**
  * UProceduralTerrain
  * 
  * This component extends ProceduralMeshComponent to support voxel-based terrain generation,
- * destruction (digging), and data persistence via JSON serialization.
+ * destruction (digging), and data persistence via a binary chunk format (legacy JSON saves can still be imported).
  * 
  * Typical usage:
  * - Create procedural terrain in editor or at runtime using CreateProceduralTerrain3D().
- * - Modify the terrain dynamically using DigSphere().
- * - Save and load terrain density data using SaveDensityToJSON() and LoadDensityFromJSON().
+ * - Modify the terrain dynamically using DigSphere() or ApplyBrush().
+ * - Save and load terrain density data using SaveDensityToFile() and LoadDensityFromFile().
  */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent), editinlinenew, Within = Actor, DefaultToInstanced)
 class DESTRUCTIONTERRAIN_API UProceduralTerrain : public UProceduralMeshComponent
@@ -28,16 +137,274 @@ protected:
 	float CurrentScale = 1.0f;
 	float CurrentIsoLevel = 0.0f;
 
+	// ──────────────── ASYNC REBUILD STATE ────────────────
+	// Incremented by every rebuild request; a worker result is only uploaded if its serial is still the latest.
+	TSharedPtr<std::atomic<uint32>, ESPMode::ThreadSafe> RebuildSerial;
+
+	// Number of extractions launched but not yet returned to the game thread.
+	int32 PendingRebuilds = 0;
+
+	// Last rebuild uploaded (see GetRebuildStats()), and the vertices (X) / triangles (Y) of each drawn block it totals.
+	FTerrainRebuildStats RebuildStats;
+	TMap<int32, FIntPoint> BlockMeshCounts;
+
+	/** Records an upload that started at UploadStartTime in RebuildStats, for a rebuild requested at LaunchTime. */
+	void RecordRebuild(double LaunchTime, double WorkerSeconds, double UploadStartTime, bool bFullRebuild);
+
+	// Voxels modified since the last remesh request (see MarkDirtyRegion()).
+	FTerrainDirtyRegion DirtyRegion;
+
+	// Mesh blocks requested but not uploaded yet. A newer request always re-extracts them,
+	// since it cancels the pending one.
+	TSet<int32> PendingBlocks;
+	bool bPendingFullRebuild = false;
+
+	// Callbacks of dirty-region remeshes left for the pending full rebuild (see RebuildDirtyRegionAsync()).
+	TArray<TFunction<void()>> DeferredRemeshCallbacks;
+
+	// Mesh blocks of the last extraction, handed to the next one so that remeshing refills buffers that
+	// already have the right capacity instead of allocating new ones (game thread only).
+	TArray<FTerrainMeshBlock> MeshScratch;
+
+	// Double-precision vertex streams for UpdateMeshSection(), and staging for newly created sections.
+	TArray<FVector> UploadPositions;
+	TArray<FVector> UploadNormals;
+	FProcMeshSection UploadSection;
+
+	// Runtime collision switch (see SetTerrainCollisionEnabled()); CollisionStride decides which sections cook it.
+	bool bTerrainCollisionEnabled = true;
+
+	// Voxels per marching cell (see SetLODStride()); 1 is full resolution.
+	int32 LODStride = 1;
+
+	// The LOD stride changed while the density was still being generated or loaded: remesh once it is uploaded.
+	bool bLODRemeshPending = false;
+
+	// A generation or load is in flight: its result replaces Density, so edits and remeshes of the current
+	// field are dropped instead of superseding it.
+	bool bDensityPending = false;
+
+	// The drawn mesh comes from the GPU (see bGPUGeneration); remeshes dispatch GPUChunkDesc again.
+	bool bGPUMeshed = false;
+
+	// Parameters of the last GPU generation, with the digs applied since in Brushes (replayed in order).
+	FTerrainGPUChunkDesc GPUChunkDesc;
+
+	// An edit the GPU cannot replay (see QueueGPUBrush()) was made since the last GPU generation: remeshes run on the CPU.
+	bool bGPUBrushesIncomplete = false;
+
+	// A GPU generation of this chunk emitted more vertices than its buffer holds (see TerrainGPU::GetMaxVertices()):
+	// its surface is meshed on the CPU from then on, until the component is reused.
+	bool bGPUMeshOverflow = false;
+
+	/** True if this chunk is generated and remeshed on the GPU (see bGPUGeneration). */
+	bool CanUseGPUGeneration() const;
+
+	/**
+	 * Dispatches GPUChunkDesc; the GPU mesh replaces the drawn one once its readbacks have landed, like a full rebuild.
+	 * @param bNewDensity - Also read the density back to replace Density (generation); edits keep the CPU field.
+	 */
+	void LaunchGPUGeneration(bool bNewDensity, TFunction<void()> OnCompleted);
+
+	/** Hands a GPU generation result to the render component (game thread). */
+	void ApplyGPUMesh(const FTerrainGPUReadback& Readback);
+
+	// Procedural density this chunk was generated from, or would be (see SetBaseline()).
+	FTerrainBaselineSettings Baseline;
+
+	// Density was edited since it was last generated, loaded or saved (see HasUnsavedEdits()).
+	bool bUnsavedEdits = false;
+
+	// Incremented by every edit; an async save only clears bUnsavedEdits if no edit followed its snapshot.
+	uint32 EditSerial = 0;
+
+	/** Captures what a save of the current density writes through Write. */
+	FTerrainChunkSave MakeChunkSave(const FString& Name, FTerrainChunkWriter Write, ETerrainDensityEncoding Encoding,
+		ETerrainChunkCompression Compression) const;
+
+	// Component drawing the blocks when RenderBackend is TerrainRenderer (created on first upload).
+	UPROPERTY(Transient)
+	UTerrainRenderComponent* RenderComponent = nullptr;
+
+	/** Returns RenderComponent, creating and attaching it if needed. */
+	UTerrainRenderComponent* GetOrCreateRenderComponent();
+
+	/**
+	 * Snapshot of the neighbours' border samples for the next extraction (null without VoxelAccess). Updates HaloFaceMask;
+	 * a partial rebuild only keeps the faces already known, since the blocks it does not remesh used the previous halo.
+	 */
+	TSharedPtr<const FTerrainDensityHalo, ESPMode::ThreadSafe> MakeHalo(bool bPartialRebuild = false);
+
+	/** Same snapshot as MakeHalo(), without recording it in HaloFaceMask (e.g. for the mesh cached by a save). */
+	TSharedPtr<const FTerrainDensityHalo, ESPMode::ThreadSafe> ReadHalo() const;
+
+	// Faces (bit i = FTerrainDensityHalo::Faces[i]) that had a neighbour when the last extraction was launched.
+	uint8 HaloFaceMask = 0;
+
+	/** Worker-side extraction step: fills the mesh blocks and polls the cancellation callback. */
+	using FMeshExtractionFunc = TFunction<void(TArray<FTerrainMeshBlock>&, TFunctionRef<bool()>)>;
+
+	/** Remeshes the edits and seams left for the full rebuild that just landed, then runs their deferred callbacks. */
+	void RemeshDeferredRegion();
+
+	/** Starts a new rebuild generation (cancelling pending ones) and returns its serial. */
+	uint32 BeginRebuild();
+
+	/** Empties a density storage and gives it this chunk's DensityEncoding (ranged by DensityTruncation, Float32 without one). */
+	void ResetDensityStorage(FTerrainDensityStorage& Storage) const;
+
+	/** Returns the indices of every mesh block of the current density field. */
+	TArray<int32> GetAllBlockIndices() const;
+
+	/** Returns the indices of the mesh blocks whose cells or gradients depend on the given voxels. */
+	TArray<int32> GetBlocksAffectedBy(const FTerrainDirtyRegion& Region) const;
+
+	/**
+	 * Runs Extract on the thread pool, then uploads the result on the game thread if it is still current.
+	 * @param bFullRebuild - The result replaces every mesh section (otherwise only the extracted blocks).
+	 * @param OnCommit - Game thread, right before the upload, only if the result is current.
+	 * @param OnCompleted - Game thread, once the task has finished, whether it was applied or superseded.
+	 * @param bApplyMesh - Upload the extracted blocks; false only commits (density restores keeping the drawn mesh).
+	 */
+	void LaunchMeshExtraction(uint32 Serial, bool bFullRebuild, FMeshExtractionFunc Extract,
+		TFunction<void()> OnCommit, TFunction<void()> OnCompleted, bool bApplyMesh = true);
+
 public:
 
-	// Density field storing scalar values for voxel sampling (Marching Cubes, etc.)
-	TArray<float> Density;
+	// Density field storing scalar values for voxel sampling (Marching Cubes, etc.).
+	// Uniform bricks and uniform chunks are collapsed to a single value (see FTerrainDensityStorage).
+	FTerrainDensityStorage Density;
+
+	// Optional owner-provided queue that throttles the upload of full rebuilds (see FTerrainUploadQueue).
+	// When unset, results are uploaded as soon as they reach the game thread.
+	TSharedPtr<FTerrainUploadQueue> UploadQueue;
+
+	// Serial of the last result left in UploadQueue (see IsUploadQueued()).
+	uint32 QueuedUploadSerial = 0;
+
+	// Optional owner-provided access to the neighbouring chunks, used to read a one-voxel halo around this
+	// chunk so that border normals match across seams. When unset, border gradients are clamped.
+	TSharedPtr<FTerrainVoxelAccess> VoxelAccess;
 
 	// ──────────────── CORE MESH GENERATION ────────────────
 
-	/** Rebuilds the procedural mesh from the current Density field. */
+	/** Rebuilds the procedural mesh from the current Density field (synchronously, on the calling thread). */
 	void RebuildMeshFromCurrentDensity();
 
+	/**
+	 * Rebuilds the mesh on a worker thread from a snapshot of the current Density field.
+	 * Only the section upload runs on the game thread; a newer rebuild supersedes pending ones.
+	 * @param OnCompleted - Called on the game thread when the task returns (applied or superseded).
+	 */
+	void RebuildMeshAsync(TFunction<void()> OnCompleted = nullptr);
+
+	/**
+	 * Generates a new density field and its mesh on a worker thread.
+	 * Density and the mesh are both replaced on the game thread once the work is done.
+	 * Parameters match BuildDensityField().
+	 * @param bKeepMesh - Only restore Density and keep the drawn mesh (see CanKeepMesh()); ignored on the GPU path.
+	 */
+	void GenerateTerrainAsync(int32 Size, float Scale, float NoiseScale, float HeightBias, float NoiseStrength,
+		TFunction<void()> OnCompleted = nullptr, bool bKeepMesh = false);
+
+	/**
+	 * True if the chunk draws a mesh that outlived its density (e.g. procedural mesh sections saved with the
+	 * level): restoring the density with bKeepMesh then skips Marching Cubes.
+	 */
+	bool CanKeepMesh() const { return RenderBackend == ETerrainRenderBackend::ProceduralMesh && GetNumSections() > 0; }
+
+	/**
+	 * Records that voxels in [VoxelMin, VoxelMax] (inclusive) were modified.
+	 * The next RebuildDirtyRegionAsync() only remeshes the blocks they affect.
+	 */
+	void MarkDirtyRegion(const FIntVector& VoxelMin, const FIntVector& VoxelMax);
+
+	/**
+	 * Remeshes, on a worker thread, only the mesh blocks touched by the dirty region (plus a one-voxel
+	 * gradient border) and updates just those mesh sections. Does nothing if nothing is dirty.
+	 * While a full rebuild is pending, the region is kept and remeshed once that rebuild has been uploaded,
+	 * instead of cancelling it and marching the whole chunk again.
+	 */
+	void RebuildDirtyRegionAsync(TFunction<void()> OnCompleted = nullptr);
+
+	/**
+	 * Reads and decodes a binary chunk file and builds its mesh on a worker thread (or reads the mesh cached in the
+	 * file, if it matches the density and meshing parameters: see bCacheMeshInSaves).
+	 * Density and the mesh are replaced on the game thread; on failure Density is left untouched.
+	 * @param FileName - Path of the file relative to Saved/.
+	 */
+	void LoadTerrainAsync(const FString& FileName, TFunction<void()> OnCompleted = nullptr);
+
+	/**
+	 * Same as LoadTerrainAsync(), for a chunk blob fetched by Read on the worker thread (e.g. from a region file).
+	 * @param SourceName - Where the blob comes from, for the logs.
+	 * @param bKeepMesh - Only restore Density and keep the drawn mesh (see CanKeepMesh()).
+	 */
+	void LoadTerrainFromAsync(const FString& SourceName, FTerrainChunkReader Read, TFunction<void()> OnCompleted = nullptr,
+		bool bKeepMesh = false);
+
+	/** Returns true while an asynchronous rebuild or generation has not returned yet. */
+	bool HasPendingRebuild() const;
+
+	/** True while the current rebuild has been extracted and waits in UploadQueue. */
+	bool IsUploadQueued() const;
+
+	/** Timings and triangle count of the last rebuild uploaded (e.g. for the debug overlay of AProceduralTerrainWorld). */
+	const FTerrainRebuildStats& GetRebuildStats() const { return RebuildStats; }
+
+	/**
+	 * Puts the component back in a blank state so that it can be reused for another chunk:
+	 * cancels pending rebuilds, clears the mesh and empties Density.
+	 */
+	void ResetForReuse();
+
+	/**
+	 * Uploads extracted mesh blocks, one mesh section per block (game thread only).
+	 * @param bReplaceAll - Full rebuild: sections without a block in Blocks are cleared.
+	 */
+	void ApplyMeshBlocks(const TArray<FTerrainMeshBlock>& Blocks, bool bReplaceAll);
+
+	/**
+	 * Writes one block into its mesh section, reusing the section's buffers. A block with the same
+	 * topology as the current section only updates its vertices (UpdateMeshSection()).
+	 * @param bCollisionOnly - Hidden section holding the decimated collision mesh (see CollisionStride).
+	 */
+	void WriteMeshSection(int32 SectionIndex, const FTerrainMeshData& Mesh, bool bCollisionOnly = false);
+
+	/**
+	 * Enables or disables the collision of this chunk (e.g. outside the world's physics radius).
+	 * Disabled chunks keep drawing but no longer cook collision when they are remeshed.
+	 */
+	void SetTerrainCollisionEnabled(bool bEnabled);
+
+	bool IsTerrainCollisionEnabled() const { return bTerrainCollisionEnabled; }
+
+	/** Current meshing parameters of this chunk (see FTerrainMeshSettings). */
+	FTerrainMeshSettings GetMeshSettings() const;
+
+	/**
+	 * Thread-safe: extracts the mesh blocks of a chunk. At LODStride 1 these are the requested BlockIndices;
+	 * above it, the whole chunk is a single decimated block (section 0). Skirts are added when SkirtDepth > 0,
+	 * and the decimated collision block is appended when CollisionStride > 1 (section NumBlocks³).
+	 */
+	static bool ExtractChunkMesh(const FTerrainDensityStorage& Storage, const FTerrainMeshSettings& Settings,
+		const TArray<int32>& BlockIndices, TArray<FTerrainMeshBlock>& OutBlocks, TFunctionRef<bool()> ShouldCancel,
+		const FTerrainDensityHalo* Halo = nullptr);
+
+	/**
+	 * Changes the marching stride of this chunk (1, 2, 4 or 8) and remeshes it from its current density.
+	 * Set by AProceduralTerrainWorld from the distance to the player.
+	 */
+	void SetLODStride(int32 NewStride);
+
+	/** True while a generation or load is about to replace Density. */
+	bool IsDensityPending() const { return bDensityPending; }
+
+	/** True if the last extraction read the neighbour behind the given halo face (see FTerrainDensityHalo::Faces). */
+	bool HasHaloFace(int32 Face) const { return (HaloFaceMask & (1 << Face)) != 0; }
+
+	int32 GetLODStride() const { return LODStride; }
+
 	/**
 	 * Builds a new density field using procedural noise.
 	 * @param Size - Number of voxels along each axis.
@@ -48,11 +415,137 @@ public:
 	 */
 	void BuildDensityField(int32 Size, float Scale, float NoiseScale, float HeightBias, float NoiseStrength);
 
+	/**
+	 * Thread-safe density generation for a chunk whose origin is at ChunkWorldOrigin (see BuildDensityField()).
+	 * @param Truncation - If > 0, samples are clamped to [-Truncation, Truncation] (see DensityTruncation).
+	 * @param Noise - Kernel and octaves of the noise (see NoiseSettings).
+	 * @param bParallel - Generate Z slices on worker threads (see bParallelBuild).
+	 */
+	static void GenerateDensity(const FVector& ChunkWorldOrigin, int32 Size, float Scale, float NoiseScale,
+		float HeightBias, float NoiseStrength, TArray<float>& OutDensity, float Truncation = 0.0f,
+		const FTerrainNoiseSettings& Noise = FTerrainNoiseSettings(), bool bParallel = false);
+
+	/**
+	 * Records the procedural density of this chunk (at its current location) without generating it. Saves then
+	 * only store the bricks that differ from it, and delta files are rebuilt from it when loaded.
+	 */
+	void SetBaseline(int32 Size, float Scale, float NoiseScale, float HeightBias, float NoiseStrength);
+
+	/** True if Density was edited since it was generated, loaded or saved: only such chunks need saving. */
+	bool HasUnsavedEdits() const { return bUnsavedEdits; }
+
+	/**
+	 * Thread-safe: decodes a binary chunk file into Storage (already reset with the chunk's encoding).
+	 * Delta files are applied over the density generated from InBaseline, and rejected if it changed since the save.
+	 * With a valid InBaseline, files of another chunk size are rejected from their header.
+	 */
+	static bool DecodeChunkFile(const TArray<uint8>& Bytes, const FTerrainBaselineSettings& InBaseline, bool bParallel,
+		FTerrainChunkHeader& OutHeader, FTerrainDensityStorage& Storage);
+
+	/** Adds Delta to one voxel of Density, applying DensityTruncation. The caller marks the region dirty. */
+	void AddDensity(int32 X, int32 Y, int32 Z, float Delta);
+
+	/**
+	 * Records a brush for the next GPU remesh of this chunk, in chunk voxels. The CPU field must be edited as well
+	 * (AddBrushDelta()); does nothing if the chunk is not GPU-meshed. The GPU only replays spheres adding density:
+	 * other brushes move the chunk back to CPU remeshing.
+	 */
+	void QueueGPUBrush(const FTerrainVoxelBrush& Brush);
+
+	/**
+	 * Adds the deltas of a brush evaluated in another voxel grid, whose voxel ChunkOrigin is voxel 0 of this chunk,
+	 * to the voxels this chunk stores (see AProceduralTerrainWorld::ApplyBrush()). The caller marks the region dirty.
+	 * @return Number of voxels modified.
+	 */
+	int32 AddBrushDelta(const FTerrainBrushDelta& Delta, const FIntVector& ChunkOrigin);
+
+	/** Transform from this chunk's voxel coordinates to world space (see FTerrainVoxelBrush::FromWorld()). */
+	FTransform GetVoxelToWorld() const;
+
+	/** True if the drawn mesh was generated on the GPU. */
+	bool IsGPUMeshed() const { return bGPUMeshed; }
+
+	virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+
 	/** Returns true if a given world position is inside this terrain chunk's bounds. */
 	bool ContainsWorldPoint(const FVector& WorldPos, float Radius) const;
 
 	// ──────────────── EDITOR / CHUNK PROPERTIES ────────────────
 
+	/** Emit an indexed mesh where each surface vertex is shared by all its triangles (3-5x fewer vertices). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Meshing")
+	bool bSharedVertices = true;
+
+	/** Cells per side of a mesh block. Each block is its own mesh section and is remeshed independently after edits. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Meshing", meta = (ClampMin = "2"))
+	int32 MeshBlockSize = 8;
+
+	/**
+	 * Split density generation, gradients and marching of this chunk across worker threads
+	 * (Z slabs, or mesh blocks in parallel), so a single large chunk scales with the core count.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Meshing")
+	bool bParallelBuild = true;
+
+	/**
+	 * Densities are clamped to [-DensityTruncation, DensityTruncation] (0, the default, disables it). Voxels far from
+	 * the surface then share the same value, so buried and airborne bricks collapse in memory. Must stay above |IsoLevel|.
+	 * This changes editing results: edits are clamped too, so a dig carves as deep at any depth, and a single refill
+	 * undoes any number of digs.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Density", meta = (ClampMin = "0.0"))
+	float DensityTruncation = 0.0f;
+
+	/**
+	 * In-memory sample format. Quantized samples store the truncated density on 16 / 8 bits with a per-chunk
+	 * step (DensityTruncation / max integer), for 2-4x less memory; edits, meshing and saves all use it.
+	 * Needs a DensityTruncation > 0: without one, the range would be fitted to the generated density and clamp the
+	 * edits going past it, so the chunk keeps floats (and logs a warning).
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Density")
+	ETerrainDensityEncoding DensityEncoding = ETerrainDensityEncoding::Float32;
+
+	/** Noise kernel and fBm octaves used when generating this chunk's density (defaults reproduce the original terrain). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Noise")
+	FTerrainNoiseSettings NoiseSettings;
+
+	/**
+	 * Component drawing this chunk's mesh. TerrainRenderer replaces only the GPU buffers of the edited
+	 * blocks instead of rebuilding the whole procedural mesh proxy; this component's sections stay empty.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Meshing")
+	ETerrainRenderBackend RenderBackend = ETerrainRenderBackend::ProceduralMesh;
+
+	/**
+	 * Generate the density and run Marching Cubes in compute shaders (see TerrainGPU); only the density, and the
+	 * triangles when collision is enabled, are read back. Requires the TerrainRenderer backend, the Vectorized
+	 * noise kernel and SM5; LOD strides, skirts and CollisionStride are CPU-only and fall back to the CPU mesher.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Meshing")
+	bool bGPUGeneration = false;
+
+	/**
+	 * Cells of the collision mesh, in voxels. Above 1, physics is cooked from a decimated copy of the
+	 * surface (Stride³ fewer cells) stored in a hidden section, and the drawn sections have no collision.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Collision", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 CollisionStride = 1;
+
+	/**
+	 * Depth of the skirts hanging from the chunk border edges (0 = none). Needed as soon as neighbouring
+	 * chunks use different LOD strides, on both sides of the seam; about LOD stride * voxel scale is enough.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Meshing", meta = (ClampMin = "0.0"))
+	float SkirtDepth = 0.0f;
+
+	/**
+	 * Store the extracted mesh blocks in this chunk's saves, keyed by a hash of the density and the meshing
+	 * parameters. Loading an unchanged save then uploads them instead of running Marching Cubes; saves get
+	 * about 24 bytes per vertex plus 12 per triangle larger, and are meshed once on their background task.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence")
+	bool bCacheMeshInSaves = false;
+
 	/** Coordinates of this terrain chunk (for streaming / world generation). */
 	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk")
 	FIntVector ChunkCoords = FIntVector::ZeroValue;
@@ -101,13 +594,79 @@ public:
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Terrain|Destruction")
 	void DigSphere(FVector WorldPosition, float Radius, float Strength = -20.0f);
 
+	/**
+	 * Applies a brush to this chunk only (see AProceduralTerrainWorld::ApplyBrush() for edits across chunks).
+	 * Only the voxels inside the brush are written, and only the blocks around the voxels it changed are remeshed.
+	 * @return Number of voxels modified.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain|Destruction")
+	int32 ApplyBrush(const FTerrainBrush& Brush);
+
 	// ──────────────── PERSISTENCE (SAVE / LOAD) ────────────────
 
-	/** Saves the current density field to a JSON file. */
+	/** Saves the current density field to a JSON file (legacy format, slow for large chunks). */
 	UFUNCTION(BlueprintCallable, Category = "Terrain|Persistence")
 	void SaveDensityToJSON(const FString& FileName);
 
 	/** Loads density data from a JSON file and rebuilds the terrain mesh. */
 	UFUNCTION(BlueprintCallable, Category = "Terrain|Persistence")
 	void LoadDensityFromJSON(const FString& FileName);
+
+	/**
+	 * Saves the current density field to a binary chunk file (relative to the project's Saved directory).
+	 * @param FileName - Path of the file relative to Saved/.
+	 * @param Encoding - Raw floats or 16 / 8-bit quantized samples.
+	 * @param Compression - Compression applied to the density payload.
+	 * @return True if the file was written.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain|Persistence")
+	bool SaveDensityToFile(const FString& FileName,
+		ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32,
+		ETerrainChunkCompression Compression = ETerrainChunkCompression::LZ4);
+
+	/**
+	 * Saves only the density bricks that differ from the procedural baseline (see SetBaseline()). A chunk without
+	 * edits writes nothing and deletes its previous save; a chunk without baseline is saved in full.
+	 * @return True if the chunk is saved (or has nothing to save).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain|Persistence")
+	bool SaveDeltaToFile(const FString& FileName,
+		ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32,
+		ETerrainChunkCompression Compression = ETerrainChunkCompression::LZ4);
+
+	/**
+	 * Same as SaveDeltaToFile(), off the game thread: only the density is copied here; the comparison with the
+	 * baseline, the encoding and the write run on a background task. Saves are written one after the other
+	 * (see WaitForPendingSaves()), each through a temporary file, so that a crash never leaves a truncated save.
+	 * @return The background task (completed right away if there is nothing to save).
+	 */
+	UE::Tasks::FTask SaveDeltaToFileAsync(const FString& FileName,
+		ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32,
+		ETerrainChunkCompression Compression = ETerrainChunkCompression::LZ4);
+
+	/** Same as SaveDeltaToFile(), with the encoded blob handed to Write instead of a file of its own (e.g. a region file). */
+	bool SaveDeltaTo(const FString& Name, FTerrainChunkWriter Write,
+		ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32,
+		ETerrainChunkCompression Compression = ETerrainChunkCompression::LZ4);
+
+	/** Same as SaveDeltaToFileAsync(), with the encoded blob handed to Write on the background task. */
+	UE::Tasks::FTask SaveDeltaToAsync(const FString& Name, FTerrainChunkWriter Write,
+		ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32,
+		ETerrainChunkCompression Compression = ETerrainChunkCompression::LZ4);
+
+	/** Blocks until every async chunk save has been written (e.g. before quitting). */
+	static void WaitForPendingSaves();
+
+	/** Runs Work on a background task once every save launched so far has been written (e.g. to read the saves back). */
+	static UE::Tasks::FTask LaunchAfterPendingSaves(TUniqueFunction<void()> Work);
+
+	/**
+	 * Loads density data from a binary chunk file and rebuilds the terrain mesh, unless the file caches an up-to-date
+	 * mesh (see bCacheMeshInSaves), which is uploaded right away. Returns false if the file is missing or invalid.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain|Persistence")
+	bool LoadDensityFromFile(const FString& FileName);
+
+	/** Same as LoadDensityFromFile(), for a chunk blob already in memory. SourceName is only used by the logs. */
+	bool LoadDensityFromBytes(const TArray<uint8>& Bytes, const FString& SourceName);
 };
\ No newline at end of file
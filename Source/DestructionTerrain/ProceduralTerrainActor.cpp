@@ -1,4 +1,5 @@
 #include "ProceduralTerrainActor.h"
+#include "DestructionTerrain.h"
 #include "EngineUtils.h"
 #include "ProceduralTerrain.h"
 #include "Misc/Paths.h"
@@ -36,13 +37,13 @@ void AProceduralTerrainActor::OnConstruction(const FTransform& Transform)
 	if (FPaths::FileExists(SavePath))
 	{
 		ProceduralTerrain->LoadDensityFromJSON(FileName);
-		UE_LOG(LogTemp, Log, TEXT("Loaded saved terrain data (Editor View)."));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Loaded saved terrain data (Editor View)."));
 	}
 	else
 	{
 		// Otherwise, create a new default terrain
 		ProceduralTerrain->CreateProceduralTerrain3D(TerrainSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength, IsoLevel);
-		UE_LOG(LogTemp, Log, TEXT("Created new procedural terrain (Editor View)."));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Created new procedural terrain (Editor View)."));
 	}
 }
 
@@ -54,7 +55,8 @@ void AProceduralTerrainActor::BeginPlay()
 {
 	Super::BeginPlay();
 
-	if (!ProceduralTerrain)
+	// Spawned actors ran OnConstruction in this world already: loading again would mesh the terrain twice.
+	if (!ProceduralTerrain || !ProceduralTerrain->Density.IsEmpty())
 		return;
 
 	const FString FileName = TEXT("TerrainDensity.json");
@@ -64,12 +66,12 @@ void AProceduralTerrainActor::BeginPlay()
 	if (FPaths::FileExists(SavePath))
 	{
 		ProceduralTerrain->LoadDensityFromJSON(FileName);
-		UE_LOG(LogTemp, Log, TEXT("Loaded terrain from JSON at BeginPlay."));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Loaded terrain from JSON at BeginPlay."));
 	}
 	else
 	{
 		ProceduralTerrain->CreateProceduralTerrain3D(TerrainSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength, IsoLevel);
-		UE_LOG(LogTemp, Log, TEXT("Generated new terrain at BeginPlay."));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Generated new terrain at BeginPlay."));
 	}
 }
 
@@ -82,7 +84,7 @@ void AProceduralTerrainActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	if (ProceduralTerrain)
 	{
 		ProceduralTerrain->SaveDensityToJSON(TEXT("TerrainDensity.json"));
-		UE_LOG(LogTemp, Log, TEXT("Saved terrain data on EndPlay."));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Saved terrain data on EndPlay."));
 	}
 
 	Super::EndPlay(EndPlayReason);
@@ -97,6 +99,6 @@ void AProceduralTerrainActor::RefreshInEditor()
 	if (ProceduralTerrain)
 	{
 		ProceduralTerrain->RefreshTerrain();
-		UE_LOG(LogTemp, Log, TEXT("Manual terrain refresh triggered in editor."));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Manual terrain refresh triggered in editor."));
 	}
 }
\ No newline at end of file
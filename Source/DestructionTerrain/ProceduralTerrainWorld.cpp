@@ -1,13 +1,21 @@
 #include "ProceduralTerrainWorld.h"
+#include "DestructionTerrain.h"
 #include "ProceduralTerrain.h"
+#include "TerrainEditReplication.h"
+#include "TerrainRegionFile.h"
+#include "TerrainUploadQueue.h"
+#include "TerrainVoxelAccess.h"
 #include "DrawDebugHelpers.h"
+#include "EngineUtils.h"
 #include "Async/Async.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
 #include "Engine/World.h"
 #include "TimerManager.h"
+#include "GameFramework/GameModeBase.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
 
 //────────────────────────────
 // Constructor
@@ -16,6 +24,10 @@
 AProceduralTerrainWorld::AProceduralTerrainWorld()
 {
 	PrimaryActorTick.bCanEverTick = true; // Enables Tick() for generation progress and debug display.
+
+	// Edits are multicast to every client, wherever its player is (see MulticastApplyEdit()).
+	bReplicates = true;
+	bAlwaysRelevant = true;
 }
 
 //────────────────────────────
@@ -28,21 +40,36 @@ void AProceduralTerrainWorld::OnConstruction(const FTransform& Transform)
 
 	if (bIsGenerating)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Generation already in progress, skipping OnConstruction."));
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("Generation already in progress, skipping OnConstruction."));
 		return;
 	}
 
+	// Region tables are read again: play sessions may have written the regions since.
+	RegionStore.Reset();
+
+	// Same grid as the last construction (another property was edited, or the level was loaded): the chunks
+	// and the meshes they draw are kept, and only the densities they lack are restored.
+	const uint32 GridHash = GetChunkGridHash();
+	if (GridHash == ChunkGridHash && Chunks.Num() == ChunksX * ChunksY * ChunksZ && !Chunks.Contains(nullptr))
+	{
+		RebuildChunkMap();
+		RestoreChunksAsync();
+		return;
+	}
+	ChunkGridHash = GridHash;
+
 	// Cleanup previous chunks
 	for (UProceduralTerrain* OldChunk : Chunks)
 		if (OldChunk)
 			OldChunk->DestroyComponent();
+	for (UProceduralTerrain* PooledChunk : ChunkPool)
+		if (PooledChunk)
+			PooledChunk->DestroyComponent();
 	Chunks.Empty();
-
-	bIsGenerating = true;
-	CompletedChunks = 0;
-
-	const FString SaveDir = TEXT("TerrainChunks");
-	IFileManager::Get().MakeDirectory(*SaveDir, true);
+	ChunkMap.Empty();
+	RestoreTokens.Empty();
+	ChunkPool.Empty();
+	RestoringChunks = 0;
 
 	//────────────────────────────
 	// Chunk Grid Creation
@@ -52,84 +79,455 @@ void AProceduralTerrainWorld::OnConstruction(const FTransform& Transform)
 	for (int32 y = 0; y < ChunksY; ++y)
 	for (int32 x = 0; x < ChunksX; ++x)
 	{
-		FString Name = FString::Printf(TEXT("Chunk_%d_%d_%d"), x, y, z);
-		UProceduralTerrain* Chunk = NewObject<UProceduralTerrain>(this, *Name);
-		Chunk->RegisterComponent();
-		Chunk->AttachToComponent(GetRootComponent() ? GetRootComponent() : nullptr,
-			FAttachmentTransformRules::KeepRelativeTransform);
-
-		const FVector Offset = FVector(x, y, z) * (ChunkSize - 1) * TerrainScale;
-		Chunk->SetRelativeLocation(Offset);
-		Chunk->ChunkCoords = FIntVector(x, y, z);
-
-		Chunks.Add(Chunk);
-		UE_LOG(LogTemp, Log, TEXT("Created chunk (%d,%d,%d) at %s"), x, y, z, *Offset.ToString());
+		UProceduralTerrain* Chunk = CreateChunk(FIntVector(x, y, z));
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Created chunk (%d,%d,%d) at %s"), x, y, z, *Chunk->GetRelativeLocation().ToString());
 	}
 
 	//────────────────────────────
 	// Load Existing or Generate New Terrain
 	//────────────────────────────
 
-	bool bLoadedExisting = false;
+	RestoreChunksAsync();
+}
+
+//────────────────────────────
+// Asynchronous Chunk Generation
+//────────────────────────────
+
+void AProceduralTerrainWorld::RestoreChunksAsync()
+{
+	// Chunks holding a density, or already loading / generating one, are left alone: a load and a generation never overlap.
+	TArray<UProceduralTerrain*> ToRestore;
 	for (UProceduralTerrain* Chunk : Chunks)
+		if (Chunk && Chunk->Density.IsEmpty() && !Chunk->IsDensityPending())
+			ToRestore.Add(Chunk);
+
+	// Nearest first: the workers and the upload queue serve the chunks in dispatch order.
+	const FVector Focus = GetStartupFocus();
+	const FVector HalfExtent = FVector((ChunkSize - 1) * TerrainScale * 0.5f);
+	ToRestore.Sort([&Focus, &HalfExtent](const UProceduralTerrain& A, const UProceduralTerrain& B)
 	{
-		const FString ChunkFile = FPaths::Combine(SaveDir, FString::Printf(TEXT("TerrainChunks_%s.json"), *Chunk->GetName()));
-		const FString FullPath = FPaths::ProjectSavedDir() / ChunkFile;
+		return FVector::DistSquared(A.GetComponentLocation() + HalfExtent, Focus) < FVector::DistSquared(B.GetComponentLocation() + HalfExtent, Focus);
+	});
+
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Restoring %d terrain chunks asynchronously around %s."), ToRestore.Num(), *Focus.ToString());
+	const double StartTime = FPlatformTime::Seconds();
+
+	RestoringChunks += ToRestore.Num();
+	CompletedChunks = Chunks.Num() - RestoringChunks;
+	bIsGenerating = RestoringChunks > 0;
 
-		if (FPaths::FileExists(FullPath))
+	// In the editor, meshes saved with the level are kept: only the density behind them is rebuilt.
+	const bool bEditorWorld = GetWorld() && !GetWorld()->IsGameWorld();
+
+	for (UProceduralTerrain* Chunk : ToRestore)
+	{
+		RestoreChunkAsync(Chunk, [this, Chunk, StartTime]()
 		{
-			Chunk->LoadDensityFromJSON(ChunkFile);
-			Chunk->RebuildMeshFromCurrentDensity();
-			bLoadedExisting = true;
-		}
+			--RestoringChunks;
+			CompletedChunks++;
+			InvalidateChunkSeams(Chunk);
+
+			UE_LOG(LogDestructionTerrain, Log, TEXT("%s completed (%.2fs elapsed)"),
+				*Chunk->GetName(), FPlatformTime::Seconds() - StartTime);
+
+			if (RestoringChunks <= 0)
+			{
+				bIsGenerating = false;
+				UE_LOG(LogDestructionTerrain, Log, TEXT("All chunks restored successfully."));
+			}
+		}, bEditorWorld && Chunk->CanKeepMesh());
 	}
+}
+
+void AProceduralTerrainWorld::RestoreChunkAsync(UProceduralTerrain* Chunk, TFunction<void()> OnFinished, bool bKeepMesh)
+{
+	// Chunks kept from an earlier construction (or duplicated for PIE) lose their runtime links, and may predate
+	// a persistence setting (it does not change the grid).
+	Chunk->SetBaseline(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength);
+	Chunk->bCacheMeshInSaves = bCacheChunkMeshes;
+	GetVoxelAccess();
+	Chunk->VoxelAccess = VoxelAccess;
+
+	const FIntVector Coords = Chunk->ChunkCoords;
+
+	// Superseded loads and generations still call back: a chunk released meanwhile may already be restoring again
+	// under the same coordinates, and a stale callback would regenerate it over its saved edits.
+	const uint32 RestoreToken = ++LastRestoreToken;
+	RestoreTokens.Add(Coords, RestoreToken);
+
+	// Clients never read saves of their own: edited chunks come from the server's snapshot, and the edits that
+	// followed it are replayed once the density is back.
+	OnFinished = [this, Chunk, Coords, RestoreToken, OnFinished = MoveTemp(OnFinished)]()
+	{
+		if (!IsCurrentRestore(Chunk, Coords, RestoreToken))
+			return;
+
+		RestoreTokens.Remove(Coords);
+		if (OnFinished)
+			OnFinished();
+		if (IsNetClient())
+			OnNetChunkRestored(Chunk);
+	};
 
-	if (bLoadedExisting)
+	auto OnLoaded = [this, Chunk, Coords, RestoreToken, OnFinished]()
+	{
+		if (!IsCurrentRestore(Chunk, Coords, RestoreToken))
+			return;
+
+		// Unreadable save: fall back to procedural generation.
+		if (Chunk->Density.IsEmpty())
+		{
+			Chunk->GenerateTerrainAsync(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength, OnFinished);
+			return;
+		}
+		OnFinished();
+	};
+
+	if (IsNetClient())
+	{
+		if (const TArray<uint8>* Snapshot = NetChunkSnapshots.Find(Coords))
+		{
+			Chunk->LoadTerrainFromAsync(GetChunkRegionName(Chunk), [Bytes = *Snapshot](TArray<uint8>& OutBytes)
+			{
+				OutBytes = Bytes;
+				return true;
+			}, OnLoaded, bKeepMesh);
+		}
+		else
+		{
+			Chunk->GenerateTerrainAsync(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength, OnFinished, bKeepMesh);
+		}
+	}
+	// The region table is in memory: a missing chunk costs no filesystem call, a saved one a mapping of its blob.
+	else if (GetRegionStore().Contains(Coords))
+	{
+		Chunk->LoadTerrainFromAsync(GetChunkRegionName(Chunk), [Store = RegionStore.ToSharedRef(), Coords](TArray<uint8>& OutBytes)
+		{
+			return Store->Read(Coords, OutBytes);
+		}, OnLoaded, bKeepMesh);
+	}
+	else if (HasLegacyChunkFile(Chunk, TerrainChunkFormat::FileExtension))
+	{
+		Chunk->LoadTerrainAsync(GetChunkFilePath(Chunk, TerrainChunkFormat::FileExtension), OnLoaded);
+	}
+	else if (HasLegacyChunkFile(Chunk, TEXT("json")) && LoadChunkFromDisk(Chunk))
 	{
-		UE_LOG(LogTemp, Log, TEXT("Loaded existing terrain chunks from disk."));
-		bIsGenerating = false;
+		// Legacy JSON import is synchronous; only its mesh rebuild is asynchronous.
+		OnFinished();
 	}
 	else
 	{
-		UE_LOG(LogTemp, Log, TEXT("No saved chunks found — generating new terrain grid."));
-		GenerateAllChunks();
+		// Density and Marching Cubes both run on a worker; only the mesh upload returns to the game thread.
+		Chunk->GenerateTerrainAsync(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength, OnFinished, bKeepMesh);
 	}
 }
 
+bool AProceduralTerrainWorld::IsCurrentRestore(const UProceduralTerrain* Chunk, const FIntVector& Coords, uint32 Token) const
+{
+	return FindChunk(Coords) == Chunk && RestoreTokens.FindRef(Coords) == Token;
+}
+
+uint32 AProceduralTerrainWorld::GetChunkGridHash() const
+{
+	uint32 Hash = GetTypeHash(GetActorLocation());
+	for (const uint32 Value : {GetTypeHash(ChunkSize), GetTypeHash(TerrainScale), GetTypeHash(NoiseScale), GetTypeHash(HeightBias),
+		GetTypeHash(NoiseStrength), GetTypeHash(static_cast<uint8>(NoiseSettings.Kernel)), GetTypeHash(NoiseSettings.Octaves),
+		GetTypeHash(NoiseSettings.Lacunarity), GetTypeHash(NoiseSettings.Gain), GetTypeHash(IsoLevel), GetTypeHash(bSharedVertices),
+		GetTypeHash(MeshBlockSize), GetTypeHash(static_cast<uint8>(RenderBackend)), GetTypeHash(bGPUChunkGeneration),
+		GetTypeHash(DensityTruncation), GetTypeHash(static_cast<uint8>(DensityEncoding)), GetTypeHash(CollisionCellStride),
+		GetTypeHash(bAsyncCollisionCooking), GetTypeHash(ChunksX), GetTypeHash(ChunksY), GetTypeHash(ChunksZ)})
+	{
+		Hash = HashCombine(Hash, Value);
+	}
+	return Hash;
+}
+
+FVector AProceduralTerrainWorld::GetStartupFocus() const
+{
+	UWorld* World = GetWorld();
+	if (World)
+	{
+		if (const APlayerController* PC = World->GetFirstPlayerController())
+			if (const APawn* Pawn = PC->GetPawn())
+				return Pawn->GetActorLocation();
+
+		// Player starts are placed in the level, so the editor and play sessions restore around the same spot.
+		for (TActorIterator<APlayerStart> It(World); It; ++It)
+			return It->GetActorLocation();
+	}
+
+	const FVector GridSize = FVector(ChunksX, ChunksY, ChunksZ) * (ChunkSize - 1) * TerrainScale;
+	return GetChunkGridOrigin() + GridSize * 0.5f;
+}
+
 //────────────────────────────
-// Asynchronous Chunk Generation
+// Chunk Registry
 //────────────────────────────
 
-void AProceduralTerrainWorld::GenerateAllChunks()
+UProceduralTerrain* AProceduralTerrainWorld::CreateChunk(const FIntVector& Coords)
 {
-	UE_LOG(LogTemp, Log, TEXT("Starting asynchronous terrain generation (%d chunks)."), Chunks.Num());
-	const double StartTime = FPlatformTime::Seconds();
+	FName Name(*FString::Printf(TEXT("Chunk_%d_%d_%d"), Coords.X, Coords.Y, Coords.Z));
+
+	// Prefer the pooled component that last held these coordinates: it already carries the right name.
+	UProceduralTerrain* Chunk = nullptr;
+	if (ChunkPool.Num() > 0)
+	{
+		int32 PoolIndex = ChunkPool.IndexOfByPredicate([&Coords](const UProceduralTerrain* Pooled)
+		{
+			return Pooled->ChunkCoords == Coords;
+		});
+		if (PoolIndex == INDEX_NONE)
+			PoolIndex = ChunkPool.Num() - 1;
+
+		Chunk = ChunkPool[PoolIndex];
+		ChunkPool.RemoveAtSwap(PoolIndex, 1, EAllowShrinking::No);
+	}
 
+	// Destroyed components keep their name until GC, so the plain name may still be taken.
+	UObject* NameOwner = StaticFindObjectFast(nullptr, this, Name);
+	if (NameOwner && NameOwner != Chunk)
+		Name = MakeUniqueObjectName(this, UProceduralTerrain::StaticClass(), Name);
+
+	if (Chunk)
+	{
+		if (Chunk->GetFName() != Name)
+			Chunk->Rename(*Name.ToString(), nullptr, REN_DontCreateRedirectors | REN_NonTransactional);
+	}
+	else
+	{
+		Chunk = NewObject<UProceduralTerrain>(this, Name);
+		Chunk->AttachToComponent(GetRootComponent() ? GetRootComponent() : nullptr,
+			FAttachmentTransformRules::KeepRelativeTransform);
+	}
+
+	const FVector Offset = FVector(Coords) * (ChunkSize - 1) * TerrainScale;
+	Chunk->SetRelativeLocation(Offset);
+	Chunk->ChunkCoords = Coords;
+	Chunk->bSharedVertices = bSharedVertices;
+	Chunk->MeshBlockSize = MeshBlockSize;
+	Chunk->bParallelBuild = bParallelChunkBuild;
+	Chunk->RenderBackend = RenderBackend;
+	Chunk->bGPUGeneration = bGPUChunkGeneration;
+	Chunk->DensityTruncation = DensityTruncation;
+	Chunk->DensityEncoding = DensityEncoding;
+	Chunk->NoiseSettings = NoiseSettings;
+	Chunk->bUseAsyncCooking = bAsyncCollisionCooking;
+	Chunk->CollisionStride = CollisionCellStride;
+	Chunk->bCacheMeshInSaves = bCacheChunkMeshes;
+	UpdateChunkDetail(Chunk, Coords);
+	Chunk->UploadQueue = UploadQueue;
+	GetVoxelAccess();
+	Chunk->VoxelAccess = VoxelAccess;
+	Chunk->RegisterComponent();
+
+	// Saves only store what the player changed relative to this procedural density.
+	Chunk->SetBaseline(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength);
+
+	Chunks.Add(Chunk);
+	ChunkMap.Add(Coords, Chunk);
+	return Chunk;
+}
+
+void AProceduralTerrainWorld::DestroyChunk(UProceduralTerrain* Chunk)
+{
+	if (!Chunk)
+		return;
+
+	UnlinkChunk(Chunk);
+	Chunk->DestroyComponent();
+}
+
+void AProceduralTerrainWorld::ReleaseChunk(UProceduralTerrain* Chunk)
+{
+	if (!Chunk)
+		return;
+
+	if (ChunkPool.Num() >= MaxPooledChunks)
+	{
+		DestroyChunk(Chunk);
+		return;
+	}
+
+	UnlinkChunk(Chunk);
+
+	// Drops the render proxy and physics body but keeps the UObject and its body setup.
+	Chunk->ResetForReuse();
+	Chunk->UnregisterComponent();
+	ChunkPool.Add(Chunk);
+}
+
+void AProceduralTerrainWorld::UnlinkChunk(UProceduralTerrain* Chunk)
+{
+	if (UProceduralTerrain** Registered = ChunkMap.Find(Chunk->ChunkCoords); Registered && *Registered == Chunk)
+	{
+		ChunkMap.Remove(Chunk->ChunkCoords);
+		StreamingInFlight.Remove(Chunk->ChunkCoords);
+		RestoreTokens.Remove(Chunk->ChunkCoords);
+	}
+
+	Chunks.RemoveSingleSwap(Chunk);
+}
+
+void AProceduralTerrainWorld::RebuildChunkMap()
+{
+	ChunkMap.Reset();
 	for (UProceduralTerrain* Chunk : Chunks)
+		if (Chunk)
+			ChunkMap.Add(Chunk->ChunkCoords, Chunk);
+}
+
+UProceduralTerrain* AProceduralTerrainWorld::FindChunk(const FIntVector& Coords) const
+{
+	UProceduralTerrain* const* Found = ChunkMap.Find(Coords);
+	return Found ? *Found : nullptr;
+}
+
+FVector AProceduralTerrainWorld::GetChunkGridOrigin() const
+{
+	return GetRootComponent() ? GetRootComponent()->GetComponentLocation() : FVector::ZeroVector;
+}
+
+//────────────────────────────
+// Chunk Persistence Helpers
+//────────────────────────────
+
+FString AProceduralTerrainWorld::GetChunkFilePath(const UProceduralTerrain* Chunk, const TCHAR* Extension) const
+{
+	const FIntVector& Coords = Chunk->ChunkCoords;
+	return FPaths::Combine(SaveDirectory, FString::Printf(TEXT("TerrainChunks_Chunk_%d_%d_%d.%s"),
+		Coords.X, Coords.Y, Coords.Z, Extension));
+}
+
+FString AProceduralTerrainWorld::GetChunkRegionName(const UProceduralTerrain* Chunk)
+{
+	const FIntVector& Coords = Chunk->ChunkCoords;
+	return FString::Printf(TEXT("region chunk (%d, %d, %d)"), Coords.X, Coords.Y, Coords.Z);
+}
+
+FTerrainRegionStore& AProceduralTerrainWorld::GetRegionStore()
+{
+	if (!RegionStore.IsValid())
 	{
-		if (!Chunk) continue;
+		const FString SaveDir = FPaths::ProjectSavedDir() / SaveDirectory;
+		RegionStore = MakeShared<FTerrainRegionStore, ESPMode::ThreadSafe>(SaveDir);
+
+		// A single listing finds the saves from before region files, instead of a stat per chunk.
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(SaveDir / TEXT("TerrainChunks_Chunk_*")), true, false);
+		LegacyChunkFiles = TSet<FString>(Files);
+	}
+	return *RegionStore;
+}
 
-		Async(EAsyncExecution::ThreadPool, [this, Chunk, StartTime]()
+bool AProceduralTerrainWorld::HasLegacyChunkFile(const UProceduralTerrain* Chunk, const TCHAR* Extension) const
+{
+	return LegacyChunkFiles.Contains(FPaths::GetCleanFilename(GetChunkFilePath(Chunk, Extension)));
+}
+
+FTerrainChunkWriter AProceduralTerrainWorld::MakeChunkWriter(UProceduralTerrain* Chunk)
+{
+	GetRegionStore();
+
+	// Once in its region, the chunk's former file would shadow a delta removed from the region: it goes with the first save.
+	TArray<FString> LegacyPaths;
+	for (const TCHAR* Extension : {TerrainChunkFormat::FileExtension, TEXT("json")})
+	{
+		const FString File = GetChunkFilePath(Chunk, Extension);
+		if (LegacyChunkFiles.Remove(FPaths::GetCleanFilename(File)) > 0)
+			LegacyPaths.Add(FPaths::ProjectSavedDir() / File);
+	}
+
+	return [Store = RegionStore.ToSharedRef(), Coords = Chunk->ChunkCoords, LegacyPaths](const TArray<uint8>& Bytes)
+	{
+		if (!Store->Write(Coords, Bytes))
+			return false;
+
+		for (const FString& Path : LegacyPaths)
+			IFileManager::Get().Delete(*Path);
+		return true;
+	};
+}
+
+bool AProceduralTerrainWorld::LoadChunkFromDisk(UProceduralTerrain* Chunk)
+{
+	TArray<uint8> Bytes;
+	if (GetRegionStore().Read(Chunk->ChunkCoords, Bytes) && Chunk->LoadDensityFromBytes(Bytes, GetChunkRegionName(Chunk)))
+		return true;
+
+	// Saves from before region files (one file per chunk) are imported, and moved to their region by the next save.
+	const FString BinaryFile = GetChunkFilePath(Chunk, TerrainChunkFormat::FileExtension);
+	if (HasLegacyChunkFile(Chunk, TerrainChunkFormat::FileExtension) && Chunk->LoadDensityFromFile(BinaryFile))
+		return true;
+
+	// Legacy import: JSON saves are read once and rewritten in the binary format on the next save.
+	const FString JsonFile = GetChunkFilePath(Chunk, TEXT("json"));
+	if (HasLegacyChunkFile(Chunk, TEXT("json")))
+	{
+		Chunk->Density.Reset();
+		Chunk->LoadDensityFromJSON(JsonFile);
+		if (!Chunk->Density.IsEmpty())
 		{
-			// Worker thread: compute density field
-			Chunk->BuildDensityField(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength);
+			UE_LOG(LogDestructionTerrain, Log, TEXT("Imported legacy JSON save for %s."), *Chunk->GetName());
+			return true;
+		}
+	}
 
-			// Return to game thread to build the mesh
-			AsyncTask(ENamedThreads::GameThread, [this, Chunk, StartTime]()
-			{
-				Chunk->RebuildMeshFromCurrentDensity();
-				CompletedChunks++;
+	return false;
+}
 
-				UE_LOG(LogTemp, Log, TEXT("%s completed (%.2fs elapsed)"),
-					*Chunk->GetName(), FPlatformTime::Seconds() - StartTime);
+void AProceduralTerrainWorld::SaveChunkToDisk(UProceduralTerrain* Chunk)
+{
+	Chunk->SaveDeltaTo(GetChunkRegionName(Chunk), MakeChunkWriter(Chunk), SaveEncoding, SaveCompression);
+}
 
-				if (CompletedChunks >= Chunks.Num())
-				{
-					bIsGenerating = false;
-					UE_LOG(LogTemp, Log, TEXT("All chunks generated successfully."));
-				}
-			});
-		});
+void AProceduralTerrainWorld::SaveChunkToDiskAsync(UProceduralTerrain* Chunk)
+{
+	PendingChunkSaves.Add(Chunk->ChunkCoords,
+		Chunk->SaveDeltaToAsync(GetChunkRegionName(Chunk), MakeChunkWriter(Chunk), SaveEncoding, SaveCompression));
+}
+
+bool AProceduralTerrainWorld::IsChunkSavePending(const FIntVector& Coords)
+{
+	const UE::Tasks::FTask* Task = PendingChunkSaves.Find(Coords);
+	if (!Task)
+		return false;
+
+	if (!Task->IsCompleted())
+		return true;
+
+	PendingChunkSaves.Remove(Coords);
+	return false;
+}
+
+void AProceduralTerrainWorld::TickAutosave()
+{
+	if (IsNetClient())
+		return;
+
+	const double Now = FPlatformTime::Seconds();
+	if (AutosaveInterval > 0.0f && AutosaveQueue.IsEmpty() && Now - LastAutosaveTime >= AutosaveInterval)
+	{
+		LastAutosaveTime = Now;
+		for (UProceduralTerrain* Chunk : Chunks)
+		{
+			if (Chunk && Chunk->HasUnsavedEdits())
+				AutosaveQueue.Add(Chunk->ChunkCoords);
+		}
+
+		if (AutosaveQueue.Num() > 0)
+			UE_LOG(LogDestructionTerrain, Log, TEXT("Autosaving %d edited chunks."), AutosaveQueue.Num());
+	}
+
+	// Snapshots are spread over frames: each costs a copy of the chunk's density on the game thread.
+	for (int32 Started = 0; Started < MaxAutosavesPerFrame && AutosaveQueue.Num() > 0; )
+	{
+		UProceduralTerrain* Chunk = FindChunk(AutosaveQueue.Pop(EAllowShrinking::No));
+		if (Chunk && Chunk->HasUnsavedEdits() && !Chunk->Density.IsEmpty())
+		{
+			SaveChunkToDiskAsync(Chunk);
+			++Started;
+		}
 	}
 }
 
@@ -137,10 +535,27 @@ void AProceduralTerrainWorld::GenerateAllChunks()
 // Tick (Progress Display + Debug Bounds)
 //────────────────────────────
 
+FColor AProceduralTerrainWorld::GetChunkStateColor(const UProceduralTerrain* Chunk) const
+{
+	if (StreamingInFlight.Contains(Chunk->ChunkCoords) || Chunk->IsDensityPending())
+		return FColor::Blue;
+	if (Chunk->IsUploadQueued())
+		return FColor::Orange;
+	if (Chunk->HasPendingRebuild())
+		return FColor::Yellow;
+	if (EditedChunkCoords.Contains(Chunk->ChunkCoords))
+		return FColor::Purple;
+	return FColor::Green;
+}
+
 void AProceduralTerrainWorld::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
+	TickStreaming();
+	TickEdits();
+	TickAutosave();
+
 	// Show async generation progress
 	if (bIsGenerating && Chunks.Num() > 0)
 	{
@@ -163,6 +578,7 @@ void AProceduralTerrainWorld::Tick(float DeltaSeconds)
 
 	const float ChunkWorldSize = (ChunkSize - 1) * TerrainScale;
 	const FVector HalfExtent(ChunkWorldSize * 0.5f);
+	const double Now = FPlatformTime::Seconds();
 
 	for (UProceduralTerrain* Chunk : Chunks)
 	{
@@ -170,17 +586,49 @@ void AProceduralTerrainWorld::Tick(float DeltaSeconds)
 
 		const FVector Origin = Chunk->GetComponentLocation();
 		const FVector Center = Origin + HalfExtent;
+		const FTerrainRebuildStats& Stats = Chunk->GetRebuildStats();
+
+		FColor Color = ChunkBoundsColor;
+		float Thickness = ChunkBoundsThickness;
+		if (ChunkBoundsMode == ETerrainChunkBoundsMode::RebuildCost && Stats.CompletedTime > 0.0)
+		{
+			const float Cost = FMath::Clamp(static_cast<float>(Stats.TotalMs) / ChunkBoundsCostMs, 0.0f, 1.0f);
+			Color = FLinearColor::LerpUsingHSV(FLinearColor::Green, FLinearColor::Red, Cost).ToFColor(true);
+			if (Now - Stats.CompletedTime < 1.0)
+				Thickness *= 2.0f;
+		}
+		else if (ChunkBoundsMode == ETerrainChunkBoundsMode::QueueState)
+		{
+			Color = GetChunkStateColor(Chunk);
+		}
 
 		DrawDebugBox(
 			World,
 			Center,
 			HalfExtent,
-			ChunkBoundsColor,
+			Color,
 			false, // bPersistentLines
 			0.0f,  // Duration
 			0,
-			ChunkBoundsThickness
+			Thickness
 		);
+
+		if (bShowChunkStats && Stats.CompletedTime > 0.0)
+		{
+			const FString Text = FString::Printf(TEXT("%.1f ms (%.1f / %.1f)\n%d tris"),
+				Stats.TotalMs, Stats.WorkerMs, Stats.UploadMs, Stats.Triangles);
+			DrawDebugString(World, Center, Text, nullptr, Color, 0.0f, true);
+		}
+	}
+
+	// Chunks still waiting for a streaming slot have no component yet.
+	if (ChunkBoundsMode == ETerrainChunkBoundsMode::QueueState)
+	{
+		for (const FStreamingRequest& Request : StreamingQueue)
+		{
+			const FVector Center = GetActorLocation() + FVector(Request.Coords) * ChunkWorldSize + HalfExtent;
+			DrawDebugBox(World, Center, HalfExtent, FColor::Silver, false, 0.0f, 0, ChunkBoundsThickness);
+		}
 	}
 }
 
@@ -193,6 +641,16 @@ void AProceduralTerrainWorld::BeginPlay()
 	Super::BeginPlay();
 
 	PersistentChunks.Reset();
+	PersistentChunkCoords.Reset();
+	RebuildChunkMap();
+
+	LastAutosaveTime = FPlatformTime::Seconds();
+
+	// At runtime, finished chunk meshes are uploaded through a per-frame budget.
+	UploadQueue = MakeShared<FTerrainUploadQueue>();
+	for (UProceduralTerrain* Chunk : Chunks)
+		if (Chunk)
+			Chunk->UploadQueue = UploadQueue;
 
 	GetWorldTimerManager().SetTimer(
 		StreamingTimer,
@@ -202,29 +660,26 @@ void AProceduralTerrainWorld::BeginPlay()
 		true
 	);
 
-	UE_LOG(LogTemp, Log, TEXT("Chunk streaming system initialized."));
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Chunk streaming system initialized."));
 
-	const FString SaveDir = TEXT("TerrainChunks");
-	IFileManager::Get().MakeDirectory(*SaveDir, true);
-
-	for (UProceduralTerrain* Chunk : Chunks)
+	// Players that log in get the component carrying their edits and snapshot; a listen server's own player is already in.
+	if (HasAuthority() && GetNetMode() != NM_Standalone)
 	{
-		const FString ChunkFile = FPaths::Combine(SaveDir, FString::Printf(TEXT("TerrainChunks_%s.json"), *Chunk->GetName()));
-		const FString FullPath = FPaths::ProjectSavedDir() / ChunkFile;
-
-		if (FPaths::FileExists(FullPath))
-		{
-			Chunk->LoadDensityFromJSON(ChunkFile);
-		}
-		else
-		{
-			GenerateAllChunks();
-			break; // Avoid regenerating multiple times
-		}
+		PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &AProceduralTerrainWorld::OnPlayerLogin);
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+			UTerrainEditComponent::FindOrAdd(It->Get());
 	}
+	RequestNetSnapshot();
+
+	// Edited chunks are restored from their save and the untouched ones generated, nearest to the player first.
+	// Chunks whose restore started in OnConstruction keep it; seams are fixed as each chunk lands.
+	RestoreChunksAsync();
 
 	for (UProceduralTerrain* Chunk : Chunks)
+	{
 		PersistentChunks.Add(Chunk);
+		PersistentChunkCoords.Add(Chunk->ChunkCoords);
+	}
 }
 
 //────────────────────────────
@@ -233,16 +688,33 @@ void AProceduralTerrainWorld::BeginPlay()
 
 void AProceduralTerrainWorld::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	const FString SaveDir = TEXT("TerrainChunks");
-	IFileManager::Get().MakeDirectory(*SaveDir, true);
+	// Background saves first, so that they cannot land over the final ones.
+	UProceduralTerrain::WaitForPendingSaves();
+	PendingChunkSaves.Reset();
+	AutosaveQueue.Reset();
 
-	for (UProceduralTerrain* Chunk : PersistentChunks)
+	FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+
+	// Untouched chunks already match their save (or the noise): only edited chunks are written, streamed ones included.
+	int32 Saved = 0;
+	for (UProceduralTerrain* Chunk : Chunks)
 	{
-		const FString ChunkFile = FPaths::Combine(SaveDir, FString::Printf(TEXT("TerrainChunks_%s.json"), *Chunk->GetName()));
-		Chunk->SaveDensityToJSON(ChunkFile);
+		if (Chunk && Chunk->HasUnsavedEdits() && !IsNetClient())
+		{
+			SaveChunkToDisk(Chunk);
+			++Saved;
+		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("All persistent chunks saved on EndPlay."));
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Saved %d edited chunks on EndPlay (%d loaded)."), Saved, Chunks.Num());
+
+	if (RegionStore.IsValid())
+		RegionStore->ReleaseHandles();
+
+	StreamingQueue.Reset();
+	if (UploadQueue.IsValid())
+		UploadQueue->Reset();
+
 	Super::EndPlay(EndPlayReason);
 }
 
@@ -252,64 +724,175 @@ void AProceduralTerrainWorld::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 void AProceduralTerrainWorld::DigAt(FVector WorldPosition, float Radius, float Strength)
 {
-	UE_LOG(LogTemp, Log, TEXT("Dig operation at %s (Radius=%.1f, Strength=%.1f)"),
+	UE_LOG(LogDestructionTerrain, Verbose, TEXT("Dig operation at %s (Radius=%.1f, Strength=%.1f)"),
 		*WorldPosition.ToString(), Radius, Strength);
 
-	const FSphere DigSphere(WorldPosition, Radius);
-	bool bAnyAffected = false;
+	ApplyBrush(FTerrainBrush::MakeSphere(WorldPosition, Radius, Strength));
+}
 
-	for (UProceduralTerrain* Chunk : Chunks)
+int32 AProceduralTerrainWorld::ApplyBrush(const FTerrainBrush& Brush)
+{
+	if (!IsNetClient())
+		return CommitEdit(Brush);
+
+	// Clients edit through the server, so that every machine applies the edits in the same order.
+	if (UTerrainEditComponent* Link = UTerrainEditComponent::FindLocal(GetWorld()))
+		Link->SendBrush(this, Brush);
+	else
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("No UTerrainEditComponent on the local player controller: terrain edit dropped."));
+	return 0;
+}
+
+int32 AProceduralTerrainWorld::ApplyBrushLocally(const FTerrainBrush& Brush, UProceduralTerrain* OnlyChunk)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TerrainDig);
+	if (FMath::IsNearlyZero(TerrainScale))
+		return 0;
+
+	// The brush is evaluated once in global voxel coordinates (unclipped, so that it does not depend on the
+	// chunks loaded); each voxel is written to all of its copies (border voxels are shared by neighbouring
+	// chunks) with the same delta.
+	const FTerrainVoxelAccess& Access = GetVoxelAccess();
+	const FTerrainVoxelBrush VoxelBrush = FTerrainVoxelBrush::FromWorld(Brush,
+		FTransform(FQuat::Identity, GetChunkGridOrigin(), FVector(TerrainScale)));
+
+	// A replay only evaluates the voxels of its chunk: the deltas of a voxel do not depend on the clipping.
+	FIntVector ClipMin(MIN_int32);
+	FIntVector ClipMax(MAX_int32);
+	if (OnlyChunk)
 	{
-		if (!Chunk || Chunk->Density.Num() == 0)
-			continue;
+		ClipMin = Access.GetChunkOrigin(OnlyChunk->ChunkCoords);
+		ClipMax = ClipMin + FIntVector(ChunkSize - 1);
+	}
+
+	FTerrainBrushDelta Delta;
+	const bool bChanged = TerrainBrush::Evaluate(VoxelBrush, ClipMin, ClipMax,
+		[&Access](const FIntVector& Voxel, float& OutValue) { return Access.GetVoxel(Voxel, OutValue); },
+		Delta);
+
+	// Exactly the chunks whose samples or border gradients changed are remeshed, neighbours reading
+	// the edited voxels through their halo included.
+	int32 Modified = 0;
+	if (bChanged)
+	{
+		Access.ForEachAffectedChunk(Delta.DirtyMin, Delta.DirtyMax,
+			[this, &Access, &Delta, &VoxelBrush, &Modified, OnlyChunk](UProceduralTerrain* Chunk, const FIntVector& LocalMin, const FIntVector& LocalMax)
+			{
+				if (OnlyChunk && Chunk != OnlyChunk)
+					return;
+
+				const FIntVector ChunkOrigin = Access.GetChunkOrigin(Chunk->ChunkCoords);
+				Modified += Chunk->AddBrushDelta(Delta, ChunkOrigin);
+
+				// GPU-meshed chunks replay the brush themselves, halo included.
+				Chunk->QueueGPUBrush(VoxelBrush.Translated(ChunkOrigin));
+				Chunk->MarkDirtyRegion(LocalMin, LocalMax);
+				EditedChunkCoords.Add(Chunk->ChunkCoords);
+			});
+	}
+	INC_DWORD_STAT_BY(STAT_TerrainVoxelsModified, Modified);
+
+	if (Modified == 0)
+	{
+		UE_LOG(LogDestructionTerrain, Verbose, TEXT("No chunks were affected by the dig operation."));
+		return 0;
+	}
+	UE_LOG(LogDestructionTerrain, Verbose, TEXT("Modified %d voxels."), Modified);
+
+	FlushEditsIfNotTicking();
+	return Modified;
+}
 
-		const FVector ChunkMin = Chunk->GetComponentLocation();
-		const FVector ChunkMax = ChunkMin + FVector(ChunkSize - 1) * TerrainScale;
-		const FBox ChunkBox(ChunkMin, ChunkMax);
+void AProceduralTerrainWorld::FlushEditsIfNotTicking()
+{
+	// Outside of play the actor does not tick, so edits are remeshed right away.
+	UWorld* World = GetWorld();
+	if (!World || !World->IsGameWorld())
+		FlushTerrainEdits();
+}
+
+FTerrainVoxelAccess& AProceduralTerrainWorld::GetVoxelAccess()
+{
+	if (!VoxelAccess.IsValid() || VoxelAccess->GetChunkSize() != ChunkSize)
+	{
+		VoxelAccess = MakeShared<FTerrainVoxelAccess>(this, ChunkSize);
+		for (UProceduralTerrain* Chunk : Chunks)
+			if (Chunk)
+				Chunk->VoxelAccess = VoxelAccess;
+	}
+	return *VoxelAccess;
+}
+
+void AProceduralTerrainWorld::InvalidateChunkSeams(UProceduralTerrain* Chunk, bool bAllFaces)
+{
+	const FTerrainVoxelAccess& Access = GetVoxelAccess();
+	if (!Chunk || Access.FindLoadedChunk(Chunk->ChunkCoords) != Chunk)
+		return;
 
-		if (!FMath::SphereAABBIntersection(DigSphere, ChunkBox))
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	for (int32 Side = 0; Side < 2; Side++)
+	{
+		FIntVector Offset = FIntVector::ZeroValue;
+		Offset[Axis] = Side == 0 ? -1 : 1;
+
+		UProceduralTerrain* Neighbour = Access.FindLoadedChunk(Chunk->ChunkCoords + Offset);
+		if (!Neighbour)
 			continue;
 
-		// Convert world position to local voxel coordinates
-		const FVector LocalPosUnits = WorldPosition - Chunk->GetComponentLocation();
-		const FVector LocalVoxelPos = LocalPosUnits / TerrainScale;
+		// Each side of the seam is remeshed only if its last extraction did not see the other one.
+		const int32 Face = Axis * 2 + Side;
+		const int32 OppositeFace = Axis * 2 + (1 - Side);
+		if (bAllFaces || !Chunk->HasHaloFace(Face))
+			MarkChunkFaceDirty(Chunk, Face);
+		if (bAllFaces || !Neighbour->HasHaloFace(OppositeFace))
+			MarkChunkFaceDirty(Neighbour, OppositeFace);
+	}
 
-		const int32 XCenter = FMath::RoundToInt(LocalVoxelPos.X);
-		const int32 YCenter = FMath::RoundToInt(LocalVoxelPos.Y);
-		const int32 ZCenter = FMath::RoundToInt(LocalVoxelPos.Z);
-		const int32 RadiusVoxels = FMath::CeilToInt(Radius / TerrainScale);
+	FlushEditsIfNotTicking();
+}
 
-		auto GetIndex = [&](int32 X, int32 Y, int32 Z)
-		{
-			return X + Y * ChunkSize + Z * ChunkSize * ChunkSize;
-		};
+void AProceduralTerrainWorld::MarkChunkFaceDirty(UProceduralTerrain* Chunk, int32 Face)
+{
+	const int32 Axis = Face / 2;
+	FIntVector Min(0);
+	FIntVector Max(ChunkSize - 1);
+	Min[Axis] = Max[Axis] = (Face % 2 == 0) ? 0 : ChunkSize - 1;
 
-		int32 Modified = 0;
-		for (int32 z = ZCenter - RadiusVoxels; z <= ZCenter + RadiusVoxels; z++)
-		for (int32 y = YCenter - RadiusVoxels; y <= YCenter + RadiusVoxels; y++)
-		for (int32 x = XCenter - RadiusVoxels; x <= XCenter + RadiusVoxels; x++)
-		{
-			if (x < 0 || y < 0 || z < 0 || x >= ChunkSize || y >= ChunkSize || z >= ChunkSize)
-				continue;
+	Chunk->MarkDirtyRegion(Min, Max);
+	EditedChunkCoords.Add(Chunk->ChunkCoords);
+}
 
-			const FVector VoxelPos(x, y, z);
-			const float Dist = FVector::Dist(VoxelPos, FVector(XCenter, YCenter, ZCenter));
+void AProceduralTerrainWorld::FlushTerrainEdits()
+{
+	LastEditFlushTime = FPlatformTime::Seconds();
+	if (EditedChunkCoords.IsEmpty())
+		return;
 
-			if (Dist <= RadiusVoxels)
-			{
-				const int32 Idx = GetIndex(x, y, z);
-				Chunk->Density[Idx] += Strength * (1.0f - (Dist / RadiusVoxels));
-				++Modified;
-			}
+	// Each chunk launches a single extraction covering all of its edits; they run concurrently on the thread pool.
+	int32 Remeshed = 0;
+	for (const FIntVector& Coords : EditedChunkCoords)
+	{
+		// Chunks still waiting for their density have nothing to remesh yet.
+		UProceduralTerrain* Chunk = FindChunk(Coords);
+		if (Chunk && !Chunk->Density.IsEmpty())
+		{
+			Chunk->RebuildDirtyRegionAsync();
+			++Remeshed;
 		}
-
-		Chunk->RebuildMeshFromCurrentDensity();
-		UE_LOG(LogTemp, Log, TEXT("Modified %d voxels in %s"), Modified, *Chunk->GetName());
-		bAnyAffected = true;
 	}
+	EditedChunkCoords.Reset();
+
+	INC_DWORD_STAT_BY(STAT_TerrainChunksRemeshed, Remeshed);
+	UE_LOG(LogDestructionTerrain, Verbose, TEXT("Flushed terrain edits: %d chunks remeshed."), Remeshed);
+}
 
-	if (!bAnyAffected)
-		UE_LOG(LogTemp, Warning, TEXT("No chunks were affected by the dig operation."));
+void AProceduralTerrainWorld::TickEdits()
+{
+	if (EditedChunkCoords.IsEmpty())
+		return;
+
+	if ((FPlatformTime::Seconds() - LastEditFlushTime) * 1000.0 >= EditFlushIntervalMs)
+		FlushTerrainEdits();
 }
 
 //────────────────────────────
@@ -318,21 +901,21 @@ void AProceduralTerrainWorld::DigAt(FVector WorldPosition, float Radius, float S
 
 void AProceduralTerrainWorld::RefreshTerrain()
 {
-	const FString SaveDir = TEXT("TerrainChunks");
+	RegionStore.Reset();
 
 	for (UProceduralTerrain* Chunk : Chunks)
 	{
-		const FString ChunkFile = FPaths::Combine(SaveDir, FString::Printf(TEXT("TerrainChunks_%s.json"), *Chunk->GetName()));
-		const FString FullPath = FPaths::ProjectSavedDir() / ChunkFile;
-
-		if (FPaths::FileExists(FullPath))
+		if (LoadChunkFromDisk(Chunk))
 		{
-			Chunk->LoadDensityFromJSON(ChunkFile);
-			UE_LOG(LogTemp, Log, TEXT("Reloaded chunk from JSON: %s"), *Chunk->GetName());
+			UE_LOG(LogDestructionTerrain, Log, TEXT("Reloaded chunk from disk: %s"), *Chunk->GetName());
 		}
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("All chunks manually refreshed in editor."));
+	// Chunks reloaded first read the halo of their neighbours' previous densities.
+	for (UProceduralTerrain* Chunk : Chunks)
+		InvalidateChunkSeams(Chunk, true);
+
+	UE_LOG(LogDestructionTerrain, Log, TEXT("All chunks manually refreshed in editor."));
 }
 
 //────────────────────────────
@@ -347,86 +930,472 @@ void AProceduralTerrainWorld::UpdateStreamedChunks()
 	APawn* Pawn = PC->GetPawn();
 	if (!Pawn) return;
 
-	const FVector PlayerPos = Pawn->GetActorLocation();
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	UpdateStreamedChunksAround(Pawn->GetActorLocation(), ViewLocation, ViewRotation.Vector());
+}
+
+void AProceduralTerrainWorld::UpdateStreamedChunksAround(const FVector& PlayerPos, const FVector& ViewLocation,
+	const FVector& ViewDirection)
+{
 	const FVector ChunkWorldSize = FVector(ChunkSize - 1) * TerrainScale;
-	const FIntVector PlayerChunkCoords(
+	const FIntVector PlayerChunk(
 		FMath::FloorToInt(PlayerPos.X / ChunkWorldSize.X),
 		FMath::FloorToInt(PlayerPos.Y / ChunkWorldSize.Y),
 		0
 	);
 
 	// Skip if player is still within the same central chunk
-	const FVector PlayerChunkCenter = FVector(PlayerChunkCoords) * ChunkWorldSize;
+	const FVector PlayerChunkCenter = FVector(PlayerChunk) * ChunkWorldSize;
 	if (FVector::Dist(PlayerChunkCenter, LastPlayerChunkCenter) < ChunkWorldSize.X * 0.5f)
 		return;
 
 	LastPlayerChunkCenter = PlayerChunkCenter;
-	UE_LOG(LogTemp, Log, TEXT("Player moved to chunk (%d, %d)."), PlayerChunkCoords.X, PlayerChunkCoords.Y);
+	PlayerChunkCoords = PlayerChunk;
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Player moved to chunk (%d, %d)."), PlayerChunk.X, PlayerChunk.Y);
 
 	// Determine which chunks should be loaded
 	TSet<FIntVector> DesiredChunks;
 	for (int32 dx = -StreamRadius; dx <= StreamRadius; ++dx)
 	for (int32 dy = -StreamRadius; dy <= StreamRadius; ++dy)
-		DesiredChunks.Add(FIntVector(PlayerChunkCoords.X + dx, PlayerChunkCoords.Y + dy, 0));
+		DesiredChunks.Add(FIntVector(PlayerChunk.X + dx, PlayerChunk.Y + dy, 0));
 
-	// Remove distant chunks
-	for (int32 i = Chunks.Num() - 1; i >= 0; --i)
+	// Remove distant chunks (persistent ones are never unloaded)
+	TArray<UProceduralTerrain*> ToRemove;
+	for (const TPair<FIntVector, UProceduralTerrain*>& Entry : ChunkMap)
 	{
-		UProceduralTerrain* Chunk = Chunks[i];
-		if (!Chunk) continue;
+		if (!DesiredChunks.Contains(Entry.Key) && !PersistentChunkCoords.Contains(Entry.Key))
+			ToRemove.Add(Entry.Value);
+	}
 
-		if (!DesiredChunks.Contains(Chunk->ChunkCoords))
-		{
-			// Skip persistent (initial) chunks
-			if (PersistentChunks.Contains(Chunk))
-				continue;
+	for (UProceduralTerrain* Chunk : ToRemove)
+	{
+		UE_LOG(LogDestructionTerrain, Log, TEXT("Removing distant chunk: %s"), *Chunk->GetName());
 
-			UE_LOG(LogTemp, Log, TEXT("Removing distant chunk: %s"), *Chunk->GetName());
-			Chunk->DestroyComponent();
-			Chunks.RemoveAt(i);
+		// Edits of a streamed chunk would be lost with its density; untouched chunks cost nothing. Clients keep
+		// them in memory instead (see NetChunkSnapshots).
+		if (Chunk->HasUnsavedEdits())
+		{
+			if (IsNetClient())
+				FoldNetChunkEdits(Chunk);
+			else
+				SaveChunkToDiskAsync(Chunk);
 		}
+		ReleaseChunk(Chunk);
 	}
 
-	// Create missing chunks
+	// Detail follows the player: LOD strides and collision of the loaded chunks are updated for the new chunk.
+	for (const TPair<FIntVector, UProceduralTerrain*>& Entry : ChunkMap)
+	{
+		if (Entry.Value)
+			UpdateChunkDetail(Entry.Value, Entry.Key);
+	}
+
+	// Queue missing chunks, ordered by distance and view direction. The queue is rebuilt from scratch
+	// so that requests which are no longer wanted are dropped and the others are re-prioritised.
+	StreamingQueue.Reset();
 	for (const FIntVector& Coords : DesiredChunks)
 	{
-		bool bExists = false;
-		for (UProceduralTerrain* Existing : Chunks)
+		if (ChunkMap.Contains(Coords) || StreamingInFlight.Contains(Coords))
+			continue;
+
+		StreamingQueue.Add({Coords, GetStreamingPriority(Coords, ViewLocation, ViewDirection)});
+	}
+	StreamingQueue.Heapify();
+}
+
+bool AProceduralTerrainWorld::IsWithinPhysicsRadius(const FIntVector& Coords) const
+{
+	if (PhysicsRadius <= 0 || !PlayerChunkCoords.IsSet())
+		return true;
+
+	const FIntVector Delta = Coords - PlayerChunkCoords.GetValue();
+	return FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y)) <= PhysicsRadius;
+}
+
+int32 AProceduralTerrainWorld::GetChunkLODStride(const FIntVector& Coords) const
+{
+	if (LODChunkDistance <= 0 || !PlayerChunkCoords.IsSet())
+		return 1;
+
+	const FIntVector Delta = Coords - PlayerChunkCoords.GetValue();
+	const int32 Level = FMath::Min(FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y)) / LODChunkDistance, 3);
+	return 1 << Level;
+}
+
+void AProceduralTerrainWorld::UpdateChunkDetail(UProceduralTerrain* Chunk, const FIntVector& Coords)
+{
+	Chunk->SetTerrainCollisionEnabled(IsWithinPhysicsRadius(Coords));
+
+	// Neighbours differ by at most one level; a skirt as deep as the next coarser cell covers the seam.
+	const int32 Stride = GetChunkLODStride(Coords);
+	Chunk->SkirtDepth = LODChunkDistance > 0 ? 2.0f * Stride * TerrainScale : 0.0f;
+	Chunk->SetLODStride(Stride);
+}
+
+float AProceduralTerrainWorld::GetStreamingPriority(const FIntVector& Coords, const FVector& ViewLocation,
+	const FVector& ViewDirection) const
+{
+	const float ChunkWorldSize = (ChunkSize - 1) * TerrainScale;
+	const FVector ChunkCenter = GetChunkGridOrigin() + (FVector(Coords) + FVector(0.5f)) * ChunkWorldSize;
+
+	const FVector ToChunk = ChunkCenter - ViewLocation;
+	const float DistanceInChunks = ToChunk.Size2D() / FMath::Max(ChunkWorldSize, KINDA_SMALL_NUMBER);
+	const float Facing = FVector::DotProduct(ToChunk.GetSafeNormal2D(), ViewDirection.GetSafeNormal2D());
+
+	return DistanceInChunks - StreamingViewWeight * Facing;
+}
+
+void AProceduralTerrainWorld::StartChunkStreaming(const FIntVector& Coords)
+{
+	UProceduralTerrain* Chunk = CreateChunk(Coords);
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Creating streamed chunk: %s"), *Chunk->GetName());
+
+	StreamingInFlight.Add(Coords);
+	auto OnFinished = [this, Chunk, Coords]()
+	{
+		// Ignore completions of a component that was released (and possibly reused) meanwhile.
+		if (FindChunk(Coords) == Chunk)
 		{
-			if (Existing && Existing->ChunkCoords == Coords)
-			{
-				bExists = true;
-				break;
-			}
+			StreamingInFlight.Remove(Coords);
+			InvalidateChunkSeams(Chunk);
 		}
+	};
+
+	RestoreChunkAsync(Chunk, OnFinished, false);
+}
 
-		if (!bExists)
+void AProceduralTerrainWorld::TickStreaming()
+{
+	// Dispatch the best queued chunks to the workers, up to the concurrency limit.
+	TArray<FStreamingRequest, TInlineAllocator<8>> DeferredRequests;
+	while (StreamingInFlight.Num() < MaxConcurrentStreamingTasks && StreamingQueue.Num() > 0)
+	{
+		FStreamingRequest Request;
+		StreamingQueue.HeapPop(Request, EAllowShrinking::No);
+
+		// A chunk unloaded moments ago would read its previous save: wait for the new one to land.
+		if (IsChunkSavePending(Request.Coords))
 		{
-			FString Name = FString::Printf(TEXT("Chunk_%d_%d_%d"), Coords.X, Coords.Y, Coords.Z);
-			UE_LOG(LogTemp, Log, TEXT("Creating streamed chunk: %s"), *Name);
+			DeferredRequests.Add(Request);
+			continue;
+		}
 
-			UProceduralTerrain* NewChunk = NewObject<UProceduralTerrain>(this, *Name);
-			NewChunk->RegisterComponent();
-			NewChunk->AttachToComponent(GetRootComponent() ? GetRootComponent() : nullptr,
-				FAttachmentTransformRules::KeepRelativeTransform);
+		if (!ChunkMap.Contains(Request.Coords))
+			StartChunkStreaming(Request.Coords);
+	}
 
-			const FVector Offset = FVector(Coords) * (ChunkSize - 1) * TerrainScale;
-			NewChunk->SetRelativeLocation(Offset);
-			NewChunk->ChunkCoords = Coords;
+	for (const FStreamingRequest& Request : DeferredRequests)
+		StreamingQueue.HeapPush(Request);
 
-			const FString ChunkFile = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("TerrainChunks"), FString::Printf(TEXT("TerrainChunks_%s.json"), *NewChunk->GetName()));
-			if (FPaths::FileExists(ChunkFile))
+	// Upload finished meshes within the frame budget.
+	if (UploadQueue.IsValid())
+	{
+		TERRAIN_TRACE_SCOPE(Upload.Queue);
+		UploadQueue->Drain(StreamingUploadBudgetMs / 1000.0);
+	}
+}
+
+//────────────────────────────
+// Replication (Edit Commands & Snapshots)
+//────────────────────────────
+
+int32 AProceduralTerrainWorld::CommitEdit(const FTerrainBrush& Brush)
+{
+	// A single player edit is applied as is.
+	if (GetNetMode() == NM_Standalone)
+		return ApplyBrushLocally(Brush);
+
+	// The server applies the quantized command, exactly as the clients will.
+	const FTerrainEditCommand Command = FTerrainEditCommand::Make(Brush, ++LastEditSequence);
+	const int32 Modified = ApplyBrushLocally(Command.Brush);
+	MulticastApplyEdit(Command);
+	return Modified;
+}
+
+void AProceduralTerrainWorld::CommitClientEdit(const FTerrainEditCommand& Command)
+{
+	if (!Command.IsValid(MaxClientBrushSize, MaxClientBrushStrength))
+	{
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("Rejected a terrain edit from a client (invalid, or beyond MaxClientBrushSize / MaxClientBrushStrength)."));
+		return;
+	}
+	CommitEdit(Command.Brush);
+}
+
+void AProceduralTerrainWorld::MulticastApplyEdit_Implementation(const FTerrainEditCommand& Command)
+{
+	// The server applied the edit when it committed it.
+	if (IsNetClient())
+		ReceiveNetEdit(Command);
+}
+
+void AProceduralTerrainWorld::ReceiveNetEdit(const FTerrainEditCommand& Command)
+{
+	// Already in the snapshot.
+	if (NetSnapshotSequence.IsSet() && Command.Sequence <= LastEditSequence)
+		return;
+
+	// Edits multicast before this world's channel was open never arrive: the first snapshot covers them, a later one
+	// is requested for those missed since.
+	if (Command.Sequence != LastEditSequence + 1)
+	{
+		HighestMissedEdit = Command.Sequence - 1;
+		if (NetSnapshotSequence.IsSet())
+		{
+			UE_LOG(LogDestructionTerrain, Warning, TEXT("Missed terrain edits %u to %u: requesting a new snapshot."),
+				LastEditSequence + 1, Command.Sequence - 1);
+			RequestNetSnapshot(nullptr, true);
+		}
+	}
+	LastEditSequence = Command.Sequence;
+
+	LogNetEdit(Command);
+	ApplyBrushLocally(Command.Brush);
+}
+
+void AProceduralTerrainWorld::LogNetEdit(const FTerrainEditCommand& Command)
+{
+	const FTerrainVoxelBrush VoxelBrush = FTerrainVoxelBrush::FromWorld(Command.Brush,
+		FTransform(FQuat::Identity, GetChunkGridOrigin(), FVector(TerrainScale)));
+	FIntVector Min, Max;
+	VoxelBrush.GetBounds(Min, Max);
+	if (Min.X > Max.X || Min.Y > Max.Y || Min.Z > Max.Z)
+		return;
+
+	const FTerrainVoxelAccess& Access = GetVoxelAccess();
+	FIntVector ChunkMin, ChunkMax;
+	Access.GetStoringChunks(Min, Max, ChunkMin, ChunkMax);
+
+	// Streamed chunks are all in the first layer of the grid.
+	const bool bSnapshotPending = IsNetSnapshotPending();
+	for (int32 cz = FMath::Max(ChunkMin.Z, 0); cz <= FMath::Min(ChunkMax.Z, ChunksZ - 1); cz++)
+	for (int32 cy = ChunkMin.Y; cy <= ChunkMax.Y; cy++)
+	for (int32 cx = ChunkMin.X; cx <= ChunkMax.X; cx++)
+	{
+		// A chunk holding its density applies the edit right away; its density (folded if it unloads) holds it from then on.
+		const FIntVector Coords(cx, cy, cz);
+		if (bSnapshotPending || !Access.FindLoadedChunk(Coords))
+			NetChunkEdits.FindOrAdd(Coords).Add(Command);
+	}
+}
+
+bool AProceduralTerrainWorld::IsNetSnapshotPending() const
+{
+	return !NetSnapshotSequence.IsSet() || NetSnapshotsAwaited > 0;
+}
+
+void AProceduralTerrainWorld::FoldNetChunkEdits(UProceduralTerrain* Chunk)
+{
+	if (IsNetSnapshotPending() || Chunk->IsDensityPending() || Chunk->Density.IsEmpty())
+		return;
+
+	// The client's own delta against the procedural density, as the server would have saved it.
+	TArray<uint8> Bytes;
+	const bool bSaved = Chunk->SaveDeltaTo(GetChunkRegionName(Chunk), [&Bytes](const TArray<uint8>& Blob)
+	{
+		Bytes = Blob;
+		return true;
+	}, SaveEncoding, SaveCompression);
+
+	if (bSaved)
+	{
+		NetChunkSnapshots.Add(Chunk->ChunkCoords, MoveTemp(Bytes));
+		NetChunkEdits.Remove(Chunk->ChunkCoords);
+	}
+}
+
+void AProceduralTerrainWorld::OnPlayerLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+	// The event is shared by every world (e.g. PIE instances).
+	if (GameMode && GameMode->GetWorld() == GetWorld())
+		UTerrainEditComponent::FindOrAdd(NewPlayer);
+}
+
+void AProceduralTerrainWorld::SendNetSnapshot(UTerrainEditComponent* Receiver)
+{
+	if (!Receiver || IsNetClient())
+		return;
+
+	using FChunkSaves = TArray<TPair<FIntVector, TArray<uint8>>>;
+	TSharedRef<FChunkSaves, ESPMode::ThreadSafe> ChunkSaves = MakeShared<FChunkSaves, ESPMode::ThreadSafe>();
+	const uint32 Sequence = LastEditSequence;
+
+	// The snapshot of a loaded chunk with unsaved edits is its next save: the density is copied here, at edit
+	// Sequence, and the blob goes to both the region and the client. Saves run one after the other, so ChunkSaves
+	// is only touched by one task at a time.
+	GetRegionStore();
+	TSet<FIntVector> SavedCoords;
+	for (UProceduralTerrain* Chunk : Chunks)
+	{
+		if (!Chunk || !Chunk->HasUnsavedEdits() || Chunk->Density.IsEmpty())
+			continue;
+
+		const FIntVector Coords = Chunk->ChunkCoords;
+		SavedCoords.Add(Coords);
+		PendingChunkSaves.Add(Coords, Chunk->SaveDeltaToAsync(GetChunkRegionName(Chunk),
+			[Write = MakeChunkWriter(Chunk), ChunkSaves, Coords](const TArray<uint8>& Bytes)
 			{
-				NewChunk->LoadDensityFromJSON(ChunkFile);
-				NewChunk->RebuildMeshFromCurrentDensity();
-			}
-			else
+				if (!Write(Bytes))
+					return false;
+				ChunkSaves->Emplace(Coords, Bytes);
+				return true;
+			}, SaveEncoding, SaveCompression));
+	}
+
+	// Every other edited chunk has a save: it is read back once the saves launched so far (those of chunks
+	// unloaded moments ago included) have landed.
+	UProceduralTerrain::LaunchAfterPendingSaves(
+		[Store = RegionStore.ToSharedRef(), ChunkSaves, SavedCoords = MoveTemp(SavedCoords), Sequence,
+		 WeakThis = TWeakObjectPtr<AProceduralTerrainWorld>(this), WeakReceiver = TWeakObjectPtr<UTerrainEditComponent>(Receiver)]()
+		{
+			TArray<FIntVector> StoredCoords;
+			Store->GetStoredChunks(StoredCoords);
+			for (const FIntVector& Coords : StoredCoords)
 			{
-				NewChunk->BuildDensityField(ChunkSize, TerrainScale, NoiseScale, HeightBias, NoiseStrength);
-				NewChunk->RebuildMeshFromCurrentDensity();
+				TArray<uint8> Bytes;
+				if (!SavedCoords.Contains(Coords) && Store->Read(Coords, Bytes))
+					ChunkSaves->Emplace(Coords, MoveTemp(Bytes));
 			}
 
-			Chunks.Add(NewChunk);
-		}
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, WeakReceiver, ChunkSaves, Sequence]()
+			{
+				AProceduralTerrainWorld* Terrain = WeakThis.Get();
+				UTerrainEditComponent* Receiver = WeakReceiver.Get();
+				if (!Terrain || !Receiver)
+					return;
+
+				UE_LOG(LogDestructionTerrain, Log, TEXT("Sending terrain snapshot to %s: %d chunks, up to edit %u."),
+					*GetNameSafe(Receiver->GetOwner()), ChunkSaves->Num(), Sequence);
+				Receiver->QueueSnapshot(Terrain, Sequence, MoveTemp(*ChunkSaves));
+			});
+		});
+}
+
+void AProceduralTerrainWorld::RequestNetSnapshot(UTerrainEditComponent* Link, bool bResync)
+{
+	if (!IsNetClient() || (bNetSnapshotRequested && !bResync))
+		return;
+
+	// The server ignores a request while this client's previous snapshot is in flight: FinishNetSnapshot() asks again
+	// for the edits it still misses.
+	if (NetSnapshotsAwaited > 0)
+		return;
+
+	// Before the local controller is replicated, its component asks on its BeginPlay instead.
+	if (!Link)
+		Link = UTerrainEditComponent::FindLocal(GetWorld());
+	if (!Link)
+		return;
+
+	bNetSnapshotRequested = true;
+	NetSnapshotsAwaited++;
+	Link->RequestSnapshot(this);
+}
+
+void AProceduralTerrainWorld::BeginNetSnapshot(uint32 Sequence, int32 NumChunks)
+{
+	NetSnapshotSequence = Sequence;
+	for (auto It = NetChunkEdits.CreateIterator(); It; ++It)
+	{
+		It.Value().RemoveAll([Sequence](const FTerrainEditCommand& Command) { return Command.Sequence <= Sequence; });
+		if (It.Value().IsEmpty())
+			It.RemoveCurrent();
+	}
+
+	LastEditSequence = FMath::Max(LastEditSequence, Sequence);
+
+	TArray<FIntVector> PreviousCoords;
+	NetChunkSnapshots.GetKeys(PreviousCoords);
+	StaleNetSnapshots = TSet<FIntVector>(PreviousCoords);
+	PendingNetSnapshotChunks = NumChunks;
+
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Receiving terrain snapshot: %d chunks, up to edit %u."), NumChunks, Sequence);
+
+	if (NumChunks == 0)
+		FinishNetSnapshot();
+}
+
+void AProceduralTerrainWorld::ReceiveNetSnapshotChunk(const FIntVector& Coords, TArray<uint8>&& Bytes)
+{
+	StaleNetSnapshots.Remove(Coords);
+	if (Bytes.IsEmpty())
+		NetChunkSnapshots.Remove(Coords);
+	else
+		NetChunkSnapshots.Add(Coords, MoveTemp(Bytes));
+
+	// Edits applied to the chunk before its snapshot arrived are replaced along with its density.
+	ReloadNetChunk(Coords);
+
+	if (--PendingNetSnapshotChunks == 0)
+		FinishNetSnapshot();
+}
+
+void AProceduralTerrainWorld::FinishNetSnapshot()
+{
+	for (const FIntVector& Coords : StaleNetSnapshots)
+	{
+		NetChunkSnapshots.Remove(Coords);
+		ReloadNetChunk(Coords);
 	}
-}
\ No newline at end of file
+	StaleNetSnapshots.Reset();
+	NetSnapshotsAwaited = FMath::Max(NetSnapshotsAwaited - 1, 0);
+
+	// Chunks holding their density (not reloading from the snapshot) no longer need their edits logged.
+	if (!IsNetSnapshotPending())
+	{
+		const FTerrainVoxelAccess& Access = GetVoxelAccess();
+		for (auto It = NetChunkEdits.CreateIterator(); It; ++It)
+			if (Access.FindLoadedChunk(It.Key()) && !NetSnapshotReloads.Contains(It.Key()))
+				It.RemoveCurrent();
+	}
+
+	UE_LOG(LogDestructionTerrain, Log, TEXT("Terrain snapshot received: %d edited chunks, edits pending for %d chunks."),
+		NetChunkSnapshots.Num(), NetChunkEdits.Num());
+
+	// The edits received meanwhile must follow the snapshot without a hole (edits arrive in order).
+	if (HighestMissedEdit > NetSnapshotSequence.Get(0))
+		RequestNetSnapshot(nullptr, true);
+}
+
+void AProceduralTerrainWorld::ReloadNetChunk(const FIntVector& Coords)
+{
+	// Chunks not loaded read their snapshot when they are streamed in.
+	UProceduralTerrain* Chunk = FindChunk(Coords);
+	if (!Chunk)
+		return;
+
+	// A load and a generation never overlap: the restore in flight finishes first.
+	if (Chunk->IsDensityPending() || Chunk->Density.IsEmpty())
+	{
+		NetSnapshotReloads.Add(Coords);
+		return;
+	}
+
+	RestoreChunkAsync(Chunk, [this, Chunk]() { InvalidateChunkSeams(Chunk, true); }, false);
+}
+
+void AProceduralTerrainWorld::OnNetChunkRestored(UProceduralTerrain* Chunk)
+{
+	if (FindChunk(Chunk->ChunkCoords) != Chunk || Chunk->Density.IsEmpty())
+		return;
+
+	if (NetSnapshotReloads.Remove(Chunk->ChunkCoords) > 0)
+	{
+		RestoreChunkAsync(Chunk, [this, Chunk]() { InvalidateChunkSeams(Chunk, true); }, false);
+		return;
+	}
+
+	// Its snapshot (or procedural density) predates the logged edits; neighbours loaded meanwhile already have them.
+	if (const TArray<FTerrainEditCommand>* Edits = NetChunkEdits.Find(Chunk->ChunkCoords))
+	{
+		for (const FTerrainEditCommand& Command : *Edits)
+			ApplyBrushLocally(Command.Brush, Chunk);
+
+		// A snapshot on its way may still replace the density: the edits that follow it are replayed again then.
+		if (!IsNetSnapshotPending())
+			NetChunkEdits.Remove(Chunk->ChunkCoords);
+	}
+}
@@ -2,9 +2,37 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Tasks/Task.h"
+#include "TerrainBrush.h"
+#include "TerrainChunkFormat.h"
+#include "TerrainEditReplication.h"
+#include "TerrainNoise.h"
+#include "TerrainRenderComponent.h"
 #include "ProceduralTerrainWorld.generated.h"
 
 class UProceduralTerrain;
+class FTerrainRegionStore;
+class FTerrainUploadQueue;
+class FTerrainVoxelAccess;
+class AGameModeBase;
+class APlayerController;
+
+/** How the debug chunk boxes are colored (see bShowChunkBounds). */
+UENUM(BlueprintType)
+enum class ETerrainChunkBoundsMode : uint8
+{
+	/** ChunkBoundsColor for every chunk. */
+	Uniform,
+
+	/** Green to red with the duration of the last rebuild, up to ChunkBoundsCostMs; chunks rebuilt within a second are drawn thicker. */
+	RebuildCost,
+
+	/**
+	 * Where the chunk is in the pipeline: gray queued for streaming, blue restoring, yellow remeshing,
+	 * orange extracted and waiting in the upload queue, purple edited until the next flush, green idle.
+	 */
+	QueueState
+};
 
 /**
  * AProceduralTerrainWorld
@@ -12,12 +40,22 @@ class UProceduralTerrain;
  * High-level actor that coordinates multiple procedural terrain chunks.
  * Handles asynchronous terrain generation, dynamic streaming around the player,
  * and automatic saving/loading of persistent chunks.
+ *
+ * In multiplayer, the server owns the terrain: edits are applied there, numbered, and multicast as brush commands
+ * (FTerrainEditCommand) that every client applies to its own chunks. Clients do not save; when they join, they
+ * receive the saves of the chunks edited so far (see UTerrainEditComponent) and replay the later commands over them.
  */
 UCLASS()
 class DESTRUCTIONTERRAIN_API AProceduralTerrainWorld : public AActor
 {
 	GENERATED_BODY()
 
+	/** Automation tests and benchmarks configure the grid and read the streaming state (see Tests/). */
+	friend struct FTerrainWorldTestAccess;
+
+	/** Forwards the edits and snapshots of its player to this world's server / client side. */
+	friend class UTerrainEditComponent;
+
 public:
 	/** Default constructor */
 	AProceduralTerrainWorld();
@@ -37,8 +75,8 @@ protected:
 	// Terrain Configuration
 	//────────────────────────────
 
-	/** Number of voxels along one side of a chunk (resolution per chunk). */
-	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
+	/** Number of voxels along one side of a chunk (resolution per chunk), at most FTerrainChunkHeader::MaxSize to be saved. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings", meta = (ClampMax = "256"))
 	int32 ChunkSize = 32;
 
 	/** World-space scale factor for each voxel. */
@@ -57,10 +95,64 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Terrain|Noise Settings")
 	float NoiseStrength = 3.0f;
 
+	/** Noise kernel and fBm octaves applied to every chunk (see UProceduralTerrain::NoiseSettings). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Noise Settings")
+	FTerrainNoiseSettings NoiseSettings;
+
 	/** Iso-surface threshold used for Marching Cubes extraction. */
 	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
 	float IsoLevel = 0.0f;
 
+	/** Build indexed chunk meshes with shared vertices (disable to get one vertex per triangle corner). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
+	bool bSharedVertices = true;
+
+	/** Cells per side of a chunk mesh block; edits only remesh the blocks they touch (one mesh section per block). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings", meta = (ClampMin = "2"))
+	int32 MeshBlockSize = 8;
+
+	/** Component used to draw the chunks (see UProceduralTerrain::RenderBackend). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
+	ETerrainRenderBackend RenderBackend = ETerrainRenderBackend::ProceduralMesh;
+
+	/** Generate and remesh chunks in compute shaders (see UProceduralTerrain::bGPUGeneration); needs the TerrainRenderer backend. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
+	bool bGPUChunkGeneration = false;
+
+	/** Build each chunk with ParallelFor over slabs / blocks (see UProceduralTerrain::bParallelBuild). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
+	bool bParallelChunkBuild = true;
+
+	/**
+	 * Density clamp applied to every chunk (see UProceduralTerrain::DensityTruncation); lets air and buried chunks collapse
+	 * in memory, but also clamps edits, so digs and fills behave differently. 0 (the default) disables it.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings", meta = (ClampMin = "0.0"))
+	float DensityTruncation = 0.0f;
+
+	/** In-memory sample format of every chunk (see UProceduralTerrain::DensityEncoding); quantized ones need a DensityTruncation. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Chunk Settings")
+	ETerrainDensityEncoding DensityEncoding = ETerrainDensityEncoding::Float32;
+
+	/** Cook chunk collision on background threads; collision then follows the visual mesh with a frame or two of delay. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Collision")
+	bool bAsyncCollisionCooking = true;
+
+	/** Voxels per collision cell (see UProceduralTerrain::CollisionStride); 1 cooks the visual mesh itself. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Collision", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 CollisionCellStride = 1;
+
+	/** Only chunks within this many chunks of the player (in X / Y) cook collision; 0 = every chunk. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Collision", meta = (ClampMin = "0"))
+	int32 PhysicsRadius = 0;
+
+	/**
+	 * Minimum time (milliseconds) between two remesh passes over edited chunks. Edits made in between only
+	 * write density; each edited chunk is then remeshed once. 0 flushes the edits once per frame.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Destruction", meta = (ClampMin = "0.0"))
+	float EditFlushIntervalMs = 0.0f;
+
 	//────────────────────────────
 	// Chunk Grid
 	//────────────────────────────
@@ -81,6 +173,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Chunks|Runtime")
 	TArray<UProceduralTerrain*> Chunks;
 
+	/** Chunk registry by grid coordinates, kept in sync with Chunks by CreateChunk() / DestroyChunk(). */
+	UPROPERTY(Transient)
+	TMap<FIntVector, UProceduralTerrain*> ChunkMap;
+
 	//────────────────────────────
 	// Debug Visualization
 	//────────────────────────────
@@ -97,6 +193,18 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Debug")
 	float ChunkBoundsThickness = 5.0f;
 
+	/** Colors the debug boxes by rebuild cost or pipeline state instead of ChunkBoundsColor. */
+	UPROPERTY(EditAnywhere, Category = "Debug", meta = (EditCondition = "bShowChunkBounds"))
+	ETerrainChunkBoundsMode ChunkBoundsMode = ETerrainChunkBoundsMode::Uniform;
+
+	/** Rebuild time (request to upload, in milliseconds) drawn fully red in RebuildCost mode. */
+	UPROPERTY(EditAnywhere, Category = "Debug", meta = (ClampMin = "0.1", EditCondition = "bShowChunkBounds"))
+	float ChunkBoundsCostMs = 16.0f;
+
+	/** Prints the last rebuild time (worker / upload) and triangle count at the center of each debug box. */
+	UPROPERTY(EditAnywhere, Category = "Debug", meta = (EditCondition = "bShowChunkBounds"))
+	bool bShowChunkStats = false;
+
 	//────────────────────────────
 	// Terrain Streaming & Persistence
 	//────────────────────────────
@@ -105,20 +213,177 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming")
 	int32 StreamRadius = 2;
 
+	/**
+	 * Chunks per level of detail: chunks at least this many chunks away from the player (in X / Y) are
+	 * marched at stride 2, twice as far at stride 4, then 8. Chunks get skirts to hide the seams. 0 disables LOD.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming", meta = (ClampMin = "0"))
+	int32 LODChunkDistance = 0;
+
 	/** Time interval (seconds) between streaming updates. */
 	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming")
 	float UpdateInterval = 0.1f;
 
+	/** Maximum number of chunks being generated or loaded on worker threads at the same time. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming", meta = (ClampMin = "1"))
+	int32 MaxConcurrentStreamingTasks = 4;
+
+	/** Game-thread time (milliseconds per frame) allowed for uploading finished chunk meshes. At least one upload runs per frame. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming", meta = (ClampMin = "0.0"))
+	float StreamingUploadBudgetMs = 2.0f;
+
+	/** Priority bonus (in chunks of distance) given to chunks in front of the camera over chunks behind it. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming", meta = (ClampMin = "0.0"))
+	float StreamingViewWeight = 1.0f;
+
+	/** Maximum number of unloaded chunk components kept for reuse (0 disables pooling). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Streaming", meta = (ClampMin = "0"))
+	int32 MaxPooledChunks = 16;
+
+	/** Sample encoding used when saving chunks (quantized saves are 2-4x smaller; lossless for chunks already quantized in memory with the same encoding). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence")
+	ETerrainDensityEncoding SaveEncoding = ETerrainDensityEncoding::Float32;
+
+	/** Compression applied to saved chunk files. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence")
+	ETerrainChunkCompression SaveCompression = ETerrainChunkCompression::LZ4;
+
+	/** Store each saved chunk's mesh in its save, so that loading it skips Marching Cubes (see UProceduralTerrain::bCacheMeshInSaves). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence")
+	bool bCacheChunkMeshes = false;
+
+	/** Directory of the chunk saves, relative to Saved/ (region files and legacy per-chunk files). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence")
+	FString SaveDirectory = TEXT("TerrainChunks");
+
+	/** Time interval (seconds) between two background saves of the edited chunks during play; 0 only saves on unload and EndPlay. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence", meta = (ClampMin = "0.0"))
+	float AutosaveInterval = 60.0f;
+
+	/** Edited chunks snapshotted per frame by an autosave (copying the density is its only game-thread work). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Persistence", meta = (ClampMin = "1"))
+	int32 MaxAutosavesPerFrame = 2;
+
+	//────────────────────────────
+	// Replication
+	//────────────────────────────
+
+	/** Largest radius, box extent or capsule stroke (world units) the server accepts in an edit sent by a client. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Replication", meta = (ClampMin = "0.0"))
+	float MaxClientBrushSize = 2000.0f;
+
+	/** Largest density an Add edit sent by a client may add or remove at its center. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Replication", meta = (ClampMin = "0.0"))
+	float MaxClientBrushStrength = 100.0f;
+
+	/** Server: sequence number of the last edit. Client: last edit received, in order. */
+	uint32 LastEditSequence = 0;
+
+	/** Client: highest edit known to be missing (multicast before this world's channel was open, or lost in a gap). */
+	uint32 HighestMissedEdit = 0;
+
+	/**
+	 * Client: edits each chunk's snapshot (or procedural density) predates, in order; the chunk replays them when its
+	 * density is restored. Chunks holding their density only log edits while a snapshot may still replace it, and
+	 * fold their edits into NetChunkSnapshots when they unload (see FoldNetChunkEdits()).
+	 */
+	TMap<FIntVector, TArray<FTerrainEditCommand>> NetChunkEdits;
+
+	/** Client: last edit included in the snapshot, once its start has been received. */
+	TOptional<uint32> NetSnapshotSequence;
+
+	/** Client: save blob of every chunk of the snapshot that differs from its procedural density. */
+	TMap<FIntVector, TArray<uint8>> NetChunkSnapshots;
+
+	/** Client: chunks of the previous snapshot not in the current one yet; they go back to procedural once it is complete. */
+	TSet<FIntVector> StaleNetSnapshots;
+
+	/** Client: chunks of the current snapshot still to receive. */
+	int32 PendingNetSnapshotChunks = 0;
+
+	/** Client: chunks whose snapshot arrived while they were restoring; they are restored again once done. */
+	TSet<FIntVector> NetSnapshotReloads;
+
+	/** Client: a snapshot was requested from the server. */
+	bool bNetSnapshotRequested = false;
+
+	/** Client: snapshots requested and not completely received yet. */
+	int32 NetSnapshotsAwaited = 0;
+
+	/** Server: registration to player logins, which get a UTerrainEditComponent. */
+	FDelegateHandle PostLoginHandle;
+
 	/** Persistent chunks that are never unloaded (initial grid). */
 	UPROPERTY()
 	TArray<UProceduralTerrain*> PersistentChunks;
 
+	/** Grid coordinates of the persistent chunks (constant-time lookup during streaming). */
+	TSet<FIntVector> PersistentChunkCoords;
+
 	/** Center of the last player chunk (to detect movement between chunks). */
 	FVector LastPlayerChunkCenter;
 
+	/** Grid coordinates of the player's chunk, once known (center of the physics radius). */
+	TOptional<FIntVector> PlayerChunkCoords;
+
 	/** Timer used to periodically update streamed chunks. */
 	FTimerHandle StreamingTimer;
 
+	/** A chunk waiting to be streamed in; lower Priority goes first. */
+	struct FStreamingRequest
+	{
+		FIntVector Coords;
+		float Priority = 0.0f;
+
+		bool operator<(const FStreamingRequest& Other) const { return Priority < Other.Priority; }
+	};
+
+	/** Missing chunks around the player, kept as a min-heap on priority (distance and view direction). */
+	TArray<FStreamingRequest> StreamingQueue;
+
+	/** Chunks currently generating or loading on a worker thread. */
+	TSet<FIntVector> StreamingInFlight;
+
+	/**
+	 * Restore in flight for each chunk coordinates (see RestoreChunkAsync()). A component released and streamed straight
+	 * back in reuses the same coordinates, so only the token tells the completions of its earlier restore apart.
+	 */
+	TMap<FIntVector, uint32> RestoreTokens;
+
+	/** Last token handed out by RestoreChunkAsync(). */
+	uint32 LastRestoreToken = 0;
+
+	/** Unregistered chunk components waiting to be reused by CreateChunk(). */
+	UPROPERTY(Transient)
+	TArray<UProceduralTerrain*> ChunkPool;
+
+	/** Finished full-chunk meshes waiting for their game-thread upload (drained in Tick within the budget). */
+	TSharedPtr<FTerrainUploadQueue> UploadQueue;
+
+	/** Global voxel view of the loaded chunks, shared with them for their halo reads (see GetVoxelAccess()). */
+	TSharedPtr<FTerrainVoxelAccess> VoxelAccess;
+
+	/** Chunks whose density was edited since the last remesh pass (see FlushTerrainEdits()). */
+	TSet<FIntVector> EditedChunkCoords;
+
+	/** Time of the last remesh pass over edited chunks (FPlatformTime::Seconds()). */
+	double LastEditFlushTime = 0.0;
+
+	/** Time the last autosave was started (FPlatformTime::Seconds()). */
+	double LastAutosaveTime = 0.0;
+
+	/** Edited chunks the current autosave has not snapshotted yet (see MaxAutosavesPerFrame). */
+	TArray<FIntVector> AutosaveQueue;
+
+	/** Background saves not yet written, by chunk; a chunk is not streamed back in before its save has landed. */
+	TMap<FIntVector, UE::Tasks::FTask> PendingChunkSaves;
+
+	/** Region files holding the chunk saves (see GetRegionStore()). */
+	TSharedPtr<FTerrainRegionStore, ESPMode::ThreadSafe> RegionStore;
+
+	/** Names of the per-chunk save files written before region files, found when RegionStore was created. */
+	TSet<FString> LegacyChunkFiles;
+
 	//────────────────────────────
 	// Internal State
 	//────────────────────────────
@@ -129,14 +394,197 @@ protected:
 	/** Number of chunks that have completed asynchronous generation. */
 	int32 CompletedChunks = 0;
 
+	/** Chunks dispatched by RestoreChunksAsync() that have not landed yet. */
+	int32 RestoringChunks = 0;
+
+	/** GetChunkGridHash() of the grid built by the last construction; an unchanged grid is kept as is. */
+	UPROPERTY()
+	uint32 ChunkGridHash = 0;
+
 	//────────────────────────────
 	// Core Internal Functions
 	//────────────────────────────
 
 private:
 
-	/** Asynchronously generates all chunks (called at first construction). */
-	void GenerateAllChunks();
+	/**
+	 * Restores every chunk without a density asynchronously, nearest to GetStartupFocus() first: edited chunks
+	 * from their save, the others from the noise. Chunks already loading or generating are skipped.
+	 */
+	void RestoreChunksAsync();
+
+	/**
+	 * Loads a chunk from its region slot (or legacy save) on a worker thread, or generates it if it has no save.
+	 * @param bKeepMesh - Only restore the density and keep the mesh the chunk already draws (see UProceduralTerrain::CanKeepMesh()).
+	 */
+	void RestoreChunkAsync(UProceduralTerrain* Chunk, TFunction<void()> OnFinished, bool bKeepMesh);
+
+	/** True if Chunk still holds its coordinates and Token is their latest restore (superseded rebuilds still call back). */
+	bool IsCurrentRestore(const UProceduralTerrain* Chunk, const FIntVector& Coords, uint32 Token) const;
+
+	/** Hash of every setting that shapes the chunk grid, its densities or its meshes (see ChunkGridHash). */
+	uint32 GetChunkGridHash() const;
+
+	/** Where startup restores begin: the player's pawn, else the first player start, else the grid center. */
+	FVector GetStartupFocus() const;
+
+	/**
+	 * Places a chunk at the given grid coordinates and adds it to Chunks / ChunkMap.
+	 * Reuses a pooled component when one is available, otherwise creates and registers a new one.
+	 */
+	UProceduralTerrain* CreateChunk(const FIntVector& Coords);
+
+	/** Removes a chunk from Chunks / ChunkMap and destroys its component. */
+	void DestroyChunk(UProceduralTerrain* Chunk);
+
+	/** Removes a chunk from Chunks / ChunkMap and moves its component to the pool (destroys it if the pool is full). */
+	void ReleaseChunk(UProceduralTerrain* Chunk);
+
+	/** Removes a chunk from Chunks, ChunkMap and the streaming bookkeeping. */
+	void UnlinkChunk(UProceduralTerrain* Chunk);
+
+	/** Rebuilds ChunkMap from Chunks (e.g. after the actor was duplicated for PIE). */
+	void RebuildChunkMap();
+
+	/** World-space position of the corner of chunk (0, 0, 0). */
+	FVector GetChunkGridOrigin() const;
+
+	/** Returns true if the chunk at Coords should have collision (see PhysicsRadius). */
+	bool IsWithinPhysicsRadius(const FIntVector& Coords) const;
+
+	/** Marching stride of the chunk at Coords for the current player chunk (see LODChunkDistance). */
+	int32 GetChunkLODStride(const FIntVector& Coords) const;
+
+	/** Applies the LOD stride, skirts and collision state matching the player's position to a chunk. */
+	void UpdateChunkDetail(UProceduralTerrain* Chunk, const FIntVector& Coords);
+
+	/** Streaming priority of a chunk for the given view (lower is sooner). */
+	float GetStreamingPriority(const FIntVector& Coords, const FVector& ViewLocation, const FVector& ViewDirection) const;
+
+	/** Creates a queued chunk and starts loading or generating it on a worker thread. */
+	void StartChunkStreaming(const FIntVector& Coords);
+
+	/** Per-frame streaming work: dispatches queued chunks and uploads finished meshes within the budget. */
+	void TickStreaming();
+
+	/** Flushes the pending edits once EditFlushIntervalMs has elapsed since the last pass. */
+	void TickEdits();
+
+	/** Starts an autosave every AutosaveInterval, then snapshots its chunks a few per frame. */
+	void TickAutosave();
+
+	/** Debug box color of a loaded chunk in ETerrainChunkBoundsMode::QueueState. */
+	FColor GetChunkStateColor(const UProceduralTerrain* Chunk) const;
+
+	/** True while a background save of the chunk at Coords is still being written. */
+	bool IsChunkSavePending(const FIntVector& Coords);
+
+	/** Remeshes the pending edits right away when the actor does not tick (outside of play). */
+	void FlushEditsIfNotTicking();
+
+	/** Returns VoxelAccess, (re)creating it for the current ChunkSize and handing it to the chunks. */
+	FTerrainVoxelAccess& GetVoxelAccess();
+
+	/**
+	 * Called once a chunk has its density: queues the remesh of the borders meshed without the matching
+	 * neighbour, on this chunk and on its loaded neighbours, so that seam normals use both sides.
+	 * @param bAllFaces - Remesh every seam of the chunk and its neighbours (their densities were replaced).
+	 */
+	void InvalidateChunkSeams(UProceduralTerrain* Chunk, bool bAllFaces = false);
+
+	/** Marks the voxel layer of a chunk face as edited (Face as in FTerrainDensityHalo::Faces). */
+	void MarkChunkFaceDirty(UProceduralTerrain* Chunk, int32 Face);
+
+	/** Returns the path (relative to Saved/) of a legacy per-chunk save with the given extension, named after the chunk's grid coordinates. */
+	FString GetChunkFilePath(const UProceduralTerrain* Chunk, const TCHAR* Extension) const;
+
+	/** Name of a chunk's slot in the region files, for the logs. */
+	static FString GetChunkRegionName(const UProceduralTerrain* Chunk);
+
+	/** Returns RegionStore (Saved/SaveDirectory), creating it and listing the legacy saves if needed. */
+	FTerrainRegionStore& GetRegionStore();
+
+	/** True if the chunk has a legacy per-chunk save with the given extension (see LegacyChunkFiles). */
+	bool HasLegacyChunkFile(const UProceduralTerrain* Chunk, const TCHAR* Extension) const;
+
+	/** Writer storing a chunk save in its region slot; the chunk's legacy files are deleted once it is there. */
+	FTerrainChunkWriter MakeChunkWriter(UProceduralTerrain* Chunk);
+
+	/**
+	 * Restores a chunk from disk: its region slot first, then a legacy binary or JSON save as a fallback import.
+	 * @return True if the chunk was loaded from any of them.
+	 */
+	bool LoadChunkFromDisk(UProceduralTerrain* Chunk);
+
+	/** Writes the edits of a chunk (a brick delta against its procedural density) to its region slot, using the configured encoding and compression. */
+	void SaveChunkToDisk(UProceduralTerrain* Chunk);
+
+	/** Same as SaveChunkToDisk(), on a background task (see UProceduralTerrain::SaveDeltaToFileAsync()). */
+	void SaveChunkToDiskAsync(UProceduralTerrain* Chunk);
+
+	/** True on a network client: the server owns the terrain, edits go through it and nothing is saved here. */
+	bool IsNetClient() const { return GetNetMode() == NM_Client; }
+
+	/**
+	 * Evaluates a brush in global voxel coordinates and writes it to the loaded chunks (see ApplyBrush()).
+	 * @param OnlyChunk - Only write this chunk (replay of the edits it missed).
+	 */
+	int32 ApplyBrushLocally(const FTerrainBrush& Brush, UProceduralTerrain* OnlyChunk = nullptr);
+
+	/** Server: numbers an edit, applies it, and multicasts it to the clients. */
+	int32 CommitEdit(const FTerrainBrush& Brush);
+
+	/** Server: commits an edit sent by a client, unless it is invalid (see MaxClientBrushSize, MaxClientBrushStrength). */
+	void CommitClientEdit(const FTerrainEditCommand& Command);
+
+	/** Sends an edit to every client, which applies it on arrival (see ReceiveNetEdit()). */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastApplyEdit(const FTerrainEditCommand& Command);
+
+	/** Client: applies an edit of the server; a hole in the sequence asks for a new snapshot. */
+	void ReceiveNetEdit(const FTerrainEditCommand& Command);
+
+	/** Client: adds an edit to NetChunkEdits for every chunk of the grid storing its voxels that may need to replay it. */
+	void LogNetEdit(const FTerrainEditCommand& Command);
+
+	/** Client: true until the first snapshot and while a requested one is being received (it may replace any chunk). */
+	bool IsNetSnapshotPending() const;
+
+	/**
+	 * Client: stores the density of an edited chunk about to unload in NetChunkSnapshots, which then covers its logged
+	 * edits. Skipped while a snapshot is pending: its own save of the chunk would predate some of them.
+	 */
+	void FoldNetChunkEdits(UProceduralTerrain* Chunk);
+
+	/** Server: gives the edit component of every player logging in. */
+	void OnPlayerLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+
+	/**
+	 * Server: gathers the save of every edited chunk (written to the region store on the way for the loaded ones,
+	 * read back from it for the others) and queues it on Receiver, along with the current edit sequence.
+	 */
+	void SendNetSnapshot(UTerrainEditComponent* Receiver);
+
+	/**
+	 * Client: asks for the snapshot of this world once, through Link (the local player's edit component if null).
+	 * bResync asks for a new one, unless a snapshot is still awaited (the server serves one at a time).
+	 */
+	void RequestNetSnapshot(UTerrainEditComponent* Link = nullptr, bool bResync = false);
+
+	/** Client: a snapshot up to edit Sequence starts; edits it includes are dropped from NetChunkEdits. */
+	void BeginNetSnapshot(uint32 Sequence, int32 NumChunks);
+
+	/** Client: stores the save of a chunk (empty: procedural density) and restores the chunk from it if it is loaded. */
+	void ReceiveNetSnapshotChunk(const FIntVector& Coords, TArray<uint8>&& Bytes);
+
+	/** Client: once every chunk of the snapshot has arrived, sends the chunks of the previous one left out back to procedural. */
+	void FinishNetSnapshot();
+
+	/** Client: restores a loaded chunk from its snapshot (or the noise), then replays its NetChunkEdits over it. */
+	void ReloadNetChunk(const FIntVector& Coords);
+
+	/** Client: called once a chunk has restored its density; replays the edits it missed. */
+	void OnNetChunkRestored(UProceduralTerrain* Chunk);
 
 public:
 
@@ -145,7 +593,7 @@ public:
 	//────────────────────────────
 
 	/**
-	 * Performs a spherical modification of the terrain at the specified world position.
+	 * Performs a spherical modification of the terrain at the specified world position (see ApplyBrush()).
 	 * @param WorldPosition - Center of the dig sphere in world space.
 	 * @param Radius - Radius of the operation in world units.
 	 * @param Strength - Signed intensity of the modification (negative = dig).
@@ -153,10 +601,37 @@ public:
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Terrain|Destruction")
 	void DigAt(FVector WorldPosition, float Radius, float Strength);
 
-	/** Reloads all saved chunks from JSON files (manual editor refresh). */
+	/**
+	 * Applies a brush (sphere, box or capsule stroke; add, smooth or flatten) across the loaded chunks.
+	 * Only the voxels inside the brush are written, and each chunk only remeshes the blocks around the voxels
+	 * it changed, on the next edit flush: a tunnel stroke is one bounded update instead of a string of spheres.
+	 * On a client, the brush is sent to the server, and applied here when the server multicasts it back.
+	 * @return Number of voxel copies modified (0 on a client).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain|Destruction")
+	int32 ApplyBrush(const FTerrainBrush& Brush);
+
+	/**
+	 * Remeshes every chunk edited since the last pass, once per chunk. The chunks are extracted in
+	 * parallel on the thread pool. Called from Tick (see EditFlushIntervalMs); call it to remesh right away.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Terrain|Destruction")
+	void FlushTerrainEdits();
+
+	/** Returns the loaded chunk at the given grid coordinates, or nullptr. */
+	UProceduralTerrain* FindChunk(const FIntVector& Coords) const;
+
+	/** Reloads all saved chunks from disk (manual editor refresh). */
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Terrain|Persistence")
 	void RefreshTerrain();
 
 	/** Updates which chunks are loaded or unloaded based on player position. */
 	void UpdateStreamedChunks();
+
+	/**
+	 * Same as UpdateStreamedChunks(), for an explicit player position and view (e.g. a scripted camera path).
+	 * @param ViewLocation - Where the view is from, for the streaming priorities.
+	 * @param ViewDirection - Facing of the view; chunks in front of it are streamed first (see StreamingViewWeight).
+	 */
+	void UpdateStreamedChunksAround(const FVector& PlayerPos, const FVector& ViewLocation, const FVector& ViewDirection);
 };
\ No newline at end of file
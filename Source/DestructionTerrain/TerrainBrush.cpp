@@ -0,0 +1,364 @@
+#include "TerrainBrush.h"
+#include "Math/VectorRegister.h"
+#include <limits>
+
+namespace
+{
+	// Row spans are widened by this much before rounding: a voxel on the surface gets a zero weight anyway.
+	constexpr float SpanTolerance = 1e-3f;
+
+	/** Grows [InOutMin, InOutMax] by the part of row (Y, Z) inside a ball. */
+	void AddBallSpan(const FVector3f& Center, float Radius, float Y, float Z, float& InOutMin, float& InOutMax)
+	{
+		const float Remaining = FMath::Square(Radius) - FMath::Square(Y - Center.Y) - FMath::Square(Z - Center.Z);
+		if (Remaining < 0.0f)
+			return;
+
+		const float HalfSpan = FMath::Sqrt(Remaining);
+		InOutMin = FMath::Min(InOutMin, Center.X - HalfSpan);
+		InOutMax = FMath::Max(InOutMax, Center.X + HalfSpan);
+	}
+
+	/** Grows [InOutMin, InOutMax] by the part of row (Y, Z) inside the cylinder of radius Radius around segment [A, B]. */
+	void AddCylinderSpan(const FVector3f& A, const FVector3f& B, float Radius, float Y, float Z, float& InOutMin, float& InOutMax)
+	{
+		const FVector3f Axis = B - A;
+		const float Length = Axis.Size();
+		if (Length <= UE_KINDA_SMALL_NUMBER)
+			return;
+		const FVector3f Direction = Axis / Length;
+
+		// Row point P(x) = (x, Y, Z): its distance to the axis is a quadratic of x, its position along the axis is linear.
+		const FVector3f ToRow(-A.X, Y - A.Y, Z - A.Z);
+		const float Along = FVector3f::DotProduct(ToRow, Direction);
+
+		float Min = -UE_BIG_NUMBER;
+		float Max = UE_BIG_NUMBER;
+
+		// Between the end caps: 0 <= Along + x * Direction.X <= Length.
+		if (FMath::Abs(Direction.X) > UE_KINDA_SMALL_NUMBER)
+		{
+			const float T0 = -Along / Direction.X;
+			const float T1 = (Length - Along) / Direction.X;
+			Min = FMath::Min(T0, T1);
+			Max = FMath::Max(T0, T1);
+		}
+		else if (Along < 0.0f || Along > Length)
+		{
+			return;
+		}
+
+		// Within Radius of the axis: a x² + b x + c <= 0.
+		const float QuadA = 1.0f - FMath::Square(Direction.X);
+		const float QuadB = 2.0f * (ToRow.X - Along * Direction.X);
+		const float QuadC = ToRow.SizeSquared() - FMath::Square(Along) - FMath::Square(Radius);
+		if (QuadA > UE_KINDA_SMALL_NUMBER)
+		{
+			const float Discriminant = FMath::Square(QuadB) - 4.0f * QuadA * QuadC;
+			if (Discriminant < 0.0f)
+				return;
+
+			const float Root = FMath::Sqrt(Discriminant);
+			Min = FMath::Max(Min, (-QuadB - Root) / (2.0f * QuadA));
+			Max = FMath::Min(Max, (-QuadB + Root) / (2.0f * QuadA));
+		}
+		else if (QuadC > 0.0f)
+		{
+			return;
+		}
+
+		if (Min <= Max)
+		{
+			InOutMin = FMath::Min(InOutMin, Min);
+			InOutMax = FMath::Max(InOutMax, Max);
+		}
+	}
+
+	/**
+	 * Falloff weights of Count voxels of a row (a multiple of 4), from (X, Y, Z) relative to the brush's anchor.
+	 * Sphere and capsule evaluate the squared distance to their segment; only the weight needs its root.
+	 */
+	void EvaluateRowWeights(const FTerrainVoxelBrush& Brush, int32 X, float Y, float Z, int32 Count, float* OutWeights)
+	{
+		const VectorRegister4Float Lanes = MakeVectorRegisterFloat(0.0f, 1.0f, 2.0f, 3.0f);
+		const FVector3f& Start = Brush.Start;
+
+		if (Brush.Shape == ETerrainBrushShape::Box)
+		{
+			const FVector3f InvExtent(1.0f / Brush.Extent.X, 1.0f / Brush.Extent.Y, 1.0f / Brush.Extent.Z);
+			const float RowDistance = FMath::Max(FMath::Abs(Y - Start.Y) * InvExtent.Y, FMath::Abs(Z - Start.Z) * InvExtent.Z);
+			for (int32 i = 0; i < Count; i += 4)
+			{
+				const VectorRegister4Float DX = VectorSubtract(VectorAdd(VectorSetFloat1(static_cast<float>(X + i)), Lanes), VectorSetFloat1(Start.X));
+				const VectorRegister4Float Distance = VectorMax(VectorMultiply(VectorAbs(DX), VectorSetFloat1(InvExtent.X)), VectorSetFloat1(RowDistance));
+				VectorStore(VectorMax(VectorSubtract(VectorOne(), Distance), VectorZeroFloat()), OutWeights + i);
+			}
+			return;
+		}
+
+		// Closest point of the segment: t = clamp(AP.AB / |AB|², 0, 1); a sphere is a segment of length 0.
+		const FVector3f AB = Brush.Shape == ETerrainBrushShape::Capsule ? Brush.End - Start : FVector3f::ZeroVector;
+		const float LengthSquared = AB.SizeSquared();
+		const VectorRegister4Float InvLengthSquared = VectorSetFloat1(LengthSquared > UE_SMALL_NUMBER ? 1.0f / LengthSquared : 0.0f);
+		const VectorRegister4Float ABX = VectorSetFloat1(AB.X);
+		const VectorRegister4Float ABY = VectorSetFloat1(AB.Y);
+		const VectorRegister4Float ABZ = VectorSetFloat1(AB.Z);
+		const VectorRegister4Float APY = VectorSetFloat1(Y - Start.Y);
+		const VectorRegister4Float APZ = VectorSetFloat1(Z - Start.Z);
+		const VectorRegister4Float InvRadius = VectorSetFloat1(1.0f / Brush.Radius);
+
+		for (int32 i = 0; i < Count; i += 4)
+		{
+			const VectorRegister4Float APX = VectorSubtract(VectorAdd(VectorSetFloat1(static_cast<float>(X + i)), Lanes), VectorSetFloat1(Start.X));
+
+			VectorRegister4Float T = VectorMultiply(VectorMultiplyAdd(APX, ABX, VectorMultiplyAdd(APY, ABY, VectorMultiply(APZ, ABZ))), InvLengthSquared);
+			T = VectorMin(VectorMax(T, VectorZeroFloat()), VectorOne());
+
+			const VectorRegister4Float DX = VectorNegateMultiplyAdd(ABX, T, APX);
+			const VectorRegister4Float DY = VectorNegateMultiplyAdd(ABY, T, APY);
+			const VectorRegister4Float DZ = VectorNegateMultiplyAdd(ABZ, T, APZ);
+			const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DX, DX, VectorMultiplyAdd(DY, DY, VectorMultiply(DZ, DZ)));
+
+			const VectorRegister4Float Weight = VectorSubtract(VectorOne(), VectorMultiply(VectorSqrt(DistanceSquared), InvRadius));
+			VectorStore(VectorMax(Weight, VectorZeroFloat()), OutWeights + i);
+		}
+	}
+}
+
+//────────────────────────────
+// Brushes
+//────────────────────────────
+
+FTerrainBrush FTerrainBrush::MakeSphere(const FVector& Center, float Radius, float Strength, ETerrainBrushOperation Operation)
+{
+	FTerrainBrush Brush;
+	Brush.Shape     = ETerrainBrushShape::Sphere;
+	Brush.Operation = Operation;
+	Brush.Start     = Center;
+	Brush.End       = Center;
+	Brush.Radius    = Radius;
+	Brush.Strength  = Strength;
+	return Brush;
+}
+
+FTerrainBrush FTerrainBrush::MakeBox(const FVector& Center, const FVector& Extent, float Strength, ETerrainBrushOperation Operation)
+{
+	FTerrainBrush Brush;
+	Brush.Shape     = ETerrainBrushShape::Box;
+	Brush.Operation = Operation;
+	Brush.Start     = Center;
+	Brush.End       = Center;
+	Brush.Extent    = Extent;
+	Brush.Strength  = Strength;
+	return Brush;
+}
+
+FTerrainBrush FTerrainBrush::MakeCapsule(const FVector& Start, const FVector& End, float Radius, float Strength, ETerrainBrushOperation Operation)
+{
+	FTerrainBrush Brush;
+	Brush.Shape     = ETerrainBrushShape::Capsule;
+	Brush.Operation = Operation;
+	Brush.Start     = Start;
+	Brush.End       = End;
+	Brush.Radius    = Radius;
+	Brush.Strength  = Strength;
+	return Brush;
+}
+
+FTerrainVoxelBrush FTerrainVoxelBrush::FromWorld(const FTerrainBrush& Brush, const FTransform& VoxelToWorld)
+{
+	const FVector Start = VoxelToWorld.InverseTransformPosition(Brush.Start);
+	const FVector End   = VoxelToWorld.InverseTransformPosition(Brush.End);
+	const double VoxelSize = FMath::Max(VoxelToWorld.GetScale3D().GetAbsMax(), UE_KINDA_SMALL_NUMBER);
+
+	FTerrainVoxelBrush VoxelBrush;
+	VoxelBrush.Shape     = Brush.Shape;
+	VoxelBrush.Operation = Brush.Operation;
+	VoxelBrush.Anchor    = FIntVector(FMath::FloorToInt(Start.X), FMath::FloorToInt(Start.Y), FMath::FloorToInt(Start.Z));
+	VoxelBrush.Start     = FVector3f(Start - FVector(VoxelBrush.Anchor));
+	VoxelBrush.End       = FVector3f(End - FVector(VoxelBrush.Anchor));
+	VoxelBrush.Extent    = FVector3f(Brush.Extent.GetAbs() / VoxelSize);
+	VoxelBrush.Radius    = static_cast<float>(Brush.Radius / VoxelSize);
+	VoxelBrush.Strength  = Brush.Strength;
+	return VoxelBrush;
+}
+
+FTerrainVoxelBrush FTerrainVoxelBrush::Translated(const FIntVector& Origin) const
+{
+	FTerrainVoxelBrush Brush = *this;
+	Brush.Anchor -= Origin;
+	return Brush;
+}
+
+bool FTerrainVoxelBrush::IsValid() const
+{
+	const bool bHasVolume = Shape == ETerrainBrushShape::Box
+		? Extent.X > 0.0f && Extent.Y > 0.0f && Extent.Z > 0.0f
+		: Radius > 0.0f;
+	const bool bHasEffect = Operation == ETerrainBrushOperation::Add ? Strength != 0.0f : Strength > 0.0f;
+	return bHasVolume && bHasEffect;
+}
+
+void FTerrainVoxelBrush::GetBounds(FIntVector& OutMin, FIntVector& OutMax) const
+{
+	OutMin = FIntVector(MAX_int32);
+	OutMax = FIntVector(MIN_int32);
+	if (!IsValid())
+		return;
+
+	FVector3f Min, Max;
+	if (Shape == ETerrainBrushShape::Box)
+	{
+		Min = Start - Extent;
+		Max = Start + Extent;
+	}
+	else
+	{
+		const FVector3f& Other = Shape == ETerrainBrushShape::Capsule ? End : Start;
+		Min = Start.ComponentMin(Other) - FVector3f(Radius);
+		Max = Start.ComponentMax(Other) + FVector3f(Radius);
+	}
+
+	OutMin = Anchor + FIntVector(FMath::CeilToInt(Min.X), FMath::CeilToInt(Min.Y), FMath::CeilToInt(Min.Z));
+	OutMax = Anchor + FIntVector(FMath::FloorToInt(Max.X), FMath::FloorToInt(Max.Y), FMath::FloorToInt(Max.Z));
+}
+
+bool FTerrainVoxelBrush::ClipRow(int32 Y, int32 Z, int32& InOutMinX, int32& InOutMaxX) const
+{
+	// The bounds of a box are already its rows' spans.
+	if (Shape == ETerrainBrushShape::Box)
+		return InOutMinX <= InOutMaxX;
+
+	const float RowY = static_cast<float>(Y - Anchor.Y);
+	const float RowZ = static_cast<float>(Z - Anchor.Z);
+
+	// A capsule is its two end balls and the cylinder between them; a row crosses it along a single span.
+	float Min = UE_BIG_NUMBER;
+	float Max = -UE_BIG_NUMBER;
+	AddBallSpan(Start, Radius, RowY, RowZ, Min, Max);
+	if (Shape == ETerrainBrushShape::Capsule)
+	{
+		AddBallSpan(End, Radius, RowY, RowZ, Min, Max);
+		AddCylinderSpan(Start, End, Radius, RowY, RowZ, Min, Max);
+	}
+	if (Min > Max)
+		return false;
+
+	InOutMinX = FMath::Max(InOutMinX, Anchor.X + FMath::CeilToInt(Min - SpanTolerance));
+	InOutMaxX = FMath::Min(InOutMaxX, Anchor.X + FMath::FloorToInt(Max + SpanTolerance));
+	return InOutMinX <= InOutMaxX;
+}
+
+//────────────────────────────
+// Evaluation
+//────────────────────────────
+
+bool TerrainBrush::Evaluate(const FTerrainVoxelBrush& Brush, const FIntVector& ClipMin, const FIntVector& ClipMax,
+	TFunctionRef<bool(const FIntVector&, float&)> GetVoxel, FTerrainBrushDelta& OutDelta)
+{
+	OutDelta.Reset();
+
+	FIntVector Min, Max;
+	Brush.GetBounds(Min, Max);
+	Min = FIntVector(FMath::Max(Min.X, ClipMin.X), FMath::Max(Min.Y, ClipMin.Y), FMath::Max(Min.Z, ClipMin.Z));
+	Max = FIntVector(FMath::Min(Max.X, ClipMax.X), FMath::Min(Max.Y, ClipMax.Y), FMath::Min(Max.Z, ClipMax.Z));
+	if (Min.X > Max.X || Min.Y > Max.Y || Min.Z > Max.Z)
+		return false;
+
+	OutDelta.Min  = Min;
+	OutDelta.Size = Max - Min + FIntVector(1);
+	OutDelta.Deltas.SetNumZeroed(OutDelta.Size.X * OutDelta.Size.Y * OutDelta.Size.Z);
+
+	// Smooth and Flatten blend towards values of the current field, read once (one voxel beyond the box for Smooth).
+	// Voxels that are not stored are NaN.
+	const bool bSmooth = Brush.Operation == ETerrainBrushOperation::Smooth;
+	const int32 Border = bSmooth ? 1 : 0;
+	const FIntVector SampleMin = Min - FIntVector(Border);
+	const FIntVector SampleSize = OutDelta.Size + FIntVector(2 * Border);
+	TArray<float> Samples;
+	if (Brush.Operation != ETerrainBrushOperation::Add)
+	{
+		Samples.SetNumUninitialized(SampleSize.X * SampleSize.Y * SampleSize.Z);
+		int32 Index = 0;
+		for (int32 z = 0; z < SampleSize.Z; z++)
+		for (int32 y = 0; y < SampleSize.Y; y++)
+		for (int32 x = 0; x < SampleSize.X; x++, Index++)
+		{
+			float Value;
+			Samples[Index] = GetVoxel(SampleMin + FIntVector(x, y, z), Value) ? Value : std::numeric_limits<float>::quiet_NaN();
+		}
+	}
+	auto GetSample = [&Samples, &SampleMin, &SampleSize](int32 X, int32 Y, int32 Z)
+	{
+		return Samples[(X - SampleMin.X) + (Y - SampleMin.Y) * SampleSize.X + (Z - SampleMin.Z) * SampleSize.X * SampleSize.Y];
+	};
+
+	const float Blend = FMath::Clamp(Brush.Strength, 0.0f, 1.0f);
+
+	TArray<float, TInlineAllocator<128>> Weights;
+	Weights.SetNumUninitialized(Align(OutDelta.Size.X, 4));
+
+	for (int32 z = Min.Z; z <= Max.Z; z++)
+	for (int32 y = Min.Y; y <= Max.Y; y++)
+	{
+		int32 RowMin = Min.X;
+		int32 RowMax = Max.X;
+		if (!Brush.ClipRow(y, z, RowMin, RowMax))
+			continue;
+
+		const int32 Count = RowMax - RowMin + 1;
+		EvaluateRowWeights(Brush, RowMin - Brush.Anchor.X, static_cast<float>(y - Brush.Anchor.Y), static_cast<float>(z - Brush.Anchor.Z),
+			Align(Count, 4), Weights.GetData());
+
+		float* Row = &OutDelta.Deltas[(RowMin - Min.X) + (y - Min.Y) * OutDelta.Size.X + (z - Min.Z) * OutDelta.Size.X * OutDelta.Size.Y];
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float Weight = Weights[i];
+			if (Weight <= 0.0f)
+				continue;
+
+			const int32 x = RowMin + i;
+			float Delta = 0.0f;
+			if (Brush.Operation == ETerrainBrushOperation::Add)
+			{
+				Delta = Brush.Strength * Weight;
+			}
+			else
+			{
+				const float Value = GetSample(x, y, z);
+				if (FMath::IsNaN(Value))
+					continue;
+
+				float Target;
+				if (bSmooth)
+				{
+					const float Neighbours[6] = {
+						GetSample(x - 1, y, z), GetSample(x + 1, y, z),
+						GetSample(x, y - 1, z), GetSample(x, y + 1, z),
+						GetSample(x, y, z - 1), GetSample(x, y, z + 1)
+					};
+					float Sum = 0.0f;
+					for (const float Neighbour : Neighbours)
+						Sum += FMath::IsNaN(Neighbour) ? Value : Neighbour;
+					Target = Sum / 6.0f;
+				}
+				else
+				{
+					// Generated density grows by one per voxel upwards (see UProceduralTerrain::GenerateDensity()).
+					Target = static_cast<float>(z - Brush.Anchor.Z) - Brush.Start.Z;
+				}
+				Delta = (Target - Value) * Weight * Blend;
+			}
+
+			if (Delta == 0.0f)
+				continue;
+
+			Row[i] = Delta;
+			OutDelta.DirtyMin = FIntVector(FMath::Min(OutDelta.DirtyMin.X, x), FMath::Min(OutDelta.DirtyMin.Y, y), FMath::Min(OutDelta.DirtyMin.Z, z));
+			OutDelta.DirtyMax = FIntVector(FMath::Max(OutDelta.DirtyMax.X, x), FMath::Max(OutDelta.DirtyMax.Y, y), FMath::Max(OutDelta.DirtyMax.Z, z));
+			++OutDelta.NumModified;
+		}
+	}
+
+	return OutDelta.NumModified > 0;
+}
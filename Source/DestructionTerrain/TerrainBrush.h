@@ -0,0 +1,159 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainBrush.generated.h"
+
+/** Volume covered by a terrain brush (see FTerrainBrush). */
+UENUM(BlueprintType)
+enum class ETerrainBrushShape : uint8
+{
+	/** Ball of Radius around Start. */
+	Sphere,
+
+	/** Box of half size Extent around Start, aligned with the voxel grid. */
+	Box,
+
+	/** Every point within Radius of the segment [Start, End]: one stroke of a line or tunnel tool. */
+	Capsule
+};
+
+/** What a terrain brush does to the voxels it covers, weighted by its falloff. */
+UENUM(BlueprintType)
+enum class ETerrainBrushOperation : uint8
+{
+	/** Adds Strength to the density (negative = dig, positive = add material), like DigSphere(). */
+	Add,
+
+	/** Blends each voxel towards the average of its 6 neighbours, by Strength in [0, 1]. */
+	Smooth,
+
+	/** Blends the density towards a horizontal surface at the height of Start, by Strength in [0, 1]. */
+	Flatten
+};
+
+/**
+ * FTerrainBrush
+ *
+ * One terrain edit in world space. Its weight falls off linearly from 1 at the center (the segment of a
+ * capsule) to 0 at its surface, and it only writes the voxels with a non-zero weight.
+ */
+USTRUCT(BlueprintType)
+struct DESTRUCTIONTERRAIN_API FTerrainBrush
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush")
+	ETerrainBrushShape Shape = ETerrainBrushShape::Sphere;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush")
+	ETerrainBrushOperation Operation = ETerrainBrushOperation::Add;
+
+	/** Center of a sphere or box, first end of a capsule. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush")
+	FVector Start = FVector::ZeroVector;
+
+	/** Second end of a capsule. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush", meta = (EditCondition = "Shape == ETerrainBrushShape::Capsule"))
+	FVector End = FVector::ZeroVector;
+
+	/** Radius of a sphere or capsule, in world units. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush", meta = (ClampMin = "0.0", EditCondition = "Shape != ETerrainBrushShape::Box"))
+	float Radius = 100.0f;
+
+	/** Half size of a box, in world units. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush", meta = (EditCondition = "Shape == ETerrainBrushShape::Box"))
+	FVector Extent = FVector(100.0f);
+
+	/** Signed density added at the center (Add), or blend factor in [0, 1] (Smooth, Flatten). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Terrain|Brush")
+	float Strength = -20.0f;
+
+	static FTerrainBrush MakeSphere(const FVector& Center, float Radius, float Strength, ETerrainBrushOperation Operation = ETerrainBrushOperation::Add);
+	static FTerrainBrush MakeBox(const FVector& Center, const FVector& Extent, float Strength, ETerrainBrushOperation Operation = ETerrainBrushOperation::Add);
+	static FTerrainBrush MakeCapsule(const FVector& Start, const FVector& End, float Radius, float Strength, ETerrainBrushOperation Operation = ETerrainBrushOperation::Add);
+};
+
+/**
+ * A brush in the voxel space of a grid (a chunk, or the global voxels of AProceduralTerrainWorld).
+ * Positions are relative to the integer voxel Anchor, so that they stay small, and exact in floats, far from the origin.
+ */
+struct DESTRUCTIONTERRAIN_API FTerrainVoxelBrush
+{
+	ETerrainBrushShape Shape = ETerrainBrushShape::Sphere;
+	ETerrainBrushOperation Operation = ETerrainBrushOperation::Add;
+
+	FIntVector Anchor = FIntVector::ZeroValue;
+	FVector3f Start = FVector3f::ZeroVector;
+	FVector3f End = FVector3f::ZeroVector;
+
+	/** In voxels. */
+	FVector3f Extent = FVector3f::ZeroVector;
+	float Radius = 0.0f;
+
+	float Strength = 0.0f;
+
+	/**
+	 * Converts a world brush with the voxel-to-world transform of a grid (its scale includes the voxel size).
+	 * Lengths are divided by the largest scale axis; boxes stay aligned with the grid.
+	 */
+	static FTerrainVoxelBrush FromWorld(const FTerrainBrush& Brush, const FTransform& VoxelToWorld);
+
+	/** The same brush in a grid whose voxel 0 is voxel Origin of this one (e.g. a chunk of the global grid). */
+	FTerrainVoxelBrush Translated(const FIntVector& Origin) const;
+
+	/** False if the brush cannot change any voxel (no volume, or nothing to add). */
+	bool IsValid() const;
+
+	/** Inclusive box of the voxels with a non-zero weight; Min > Max if there are none. */
+	void GetBounds(FIntVector& OutMin, FIntVector& OutMax) const;
+
+	/**
+	 * Narrows [InOutMinX, InOutMaxX] to the voxels of row (Y, Z) inside the brush (exact for every shape).
+	 * @return False if the row misses the brush.
+	 */
+	bool ClipRow(int32 Y, int32 Z, int32& InOutMinX, int32& InOutMaxX) const;
+};
+
+/** Density changes of one brush application, dense over the part of its bounds that was evaluated. */
+struct DESTRUCTIONTERRAIN_API FTerrainBrushDelta
+{
+	/** First voxel and size of Deltas (X fastest); zero where the brush does not reach. */
+	FIntVector Min = FIntVector::ZeroValue;
+	FIntVector Size = FIntVector::ZeroValue;
+	TArray<float> Deltas;
+
+	/** Exact inclusive box of the voxels with a non-zero delta: the region to remesh. */
+	FIntVector DirtyMin = FIntVector(MAX_int32);
+	FIntVector DirtyMax = FIntVector(MIN_int32);
+
+	int32 NumModified = 0;
+
+	bool IsEmpty() const { return NumModified == 0; }
+
+	/** Delta of a voxel of the evaluated box. */
+	float Get(int32 X, int32 Y, int32 Z) const
+	{
+		return Deltas[(X - Min.X) + (Y - Min.Y) * Size.X + (Z - Min.Z) * Size.X * Size.Y];
+	}
+
+	void Reset() { *this = FTerrainBrushDelta(); }
+};
+
+/**
+ * TerrainBrush
+ *
+ * Thread-safe evaluation of brushes. The weights of a row are computed 4 voxels at a time with squared
+ * distances, over the row's exact span only; the result only depends on the brush and the voxels it reads,
+ * so every machine applying the same brush to the same field gets the same density.
+ */
+namespace TerrainBrush
+{
+	/**
+	 * Computes the deltas of Brush over its bounds clipped to [ClipMin, ClipMax].
+	 * @param GetVoxel - Current density of a voxel, false if it is not stored. Only Smooth and Flatten read the field;
+	 *                   Smooth uses the voxel itself for missing neighbours.
+	 * @return False if no voxel changes.
+	 */
+	DESTRUCTIONTERRAIN_API bool Evaluate(const FTerrainVoxelBrush& Brush, const FIntVector& ClipMin, const FIntVector& ClipMax,
+		TFunctionRef<bool(const FIntVector&, float&)> GetVoxel, FTerrainBrushDelta& OutDelta);
+}
@@ -0,0 +1,494 @@
+#include "TerrainChunkFormat.h"
+#include "TerrainMesher.h"
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+const TCHAR* const TerrainChunkFormat::FileExtension = TEXT("tchunk");
+
+namespace
+{
+	FName GetCompressionFormatName(ETerrainChunkCompression Compression)
+	{
+		switch (Compression)
+		{
+		case ETerrainChunkCompression::LZ4:   return NAME_LZ4;
+		case ETerrainChunkCompression::Oodle: return NAME_Oodle;
+		default:                              return NAME_None;
+		}
+	}
+
+	void SerializeHeader(FArchive& Ar, FTerrainChunkHeader& Header)
+	{
+		uint8 Encoding    = static_cast<uint8>(Header.Encoding);
+		uint8 Compression = static_cast<uint8>(Header.Compression);
+
+		Ar << Header.Version;
+		Ar << Header.Size;
+		Ar << Header.Scale;
+		Ar << Header.IsoLevel;
+		Ar << Encoding;
+		Ar << Compression;
+		Ar << Header.QuantizationStep;
+		Ar << Header.UncompressedBytes;
+		Ar << Header.PayloadBytes;
+
+		// Older files only hold full densities.
+		uint8 Content = static_cast<uint8>(Header.Content);
+		if (Header.Version >= 3)
+		{
+			Ar << Content;
+			Ar << Header.BaselineHash;
+		}
+		else
+		{
+			Content = static_cast<uint8>(ETerrainChunkContent::Density);
+			Header.BaselineHash = 0;
+		}
+
+		if (Header.Version >= 4)
+		{
+			Ar << Header.MeshUncompressedBytes;
+			Ar << Header.MeshBytes;
+			Ar << Header.MeshHash;
+			Ar << Header.MeshHaloFaceMask;
+		}
+		else
+		{
+			Header.MeshUncompressedBytes = 0;
+			Header.MeshBytes = 0;
+			Header.MeshHash = 0;
+			Header.MeshHaloFaceMask = 0;
+		}
+
+		Header.Content     = static_cast<ETerrainChunkContent>(Content);
+		Header.Encoding    = static_cast<ETerrainDensityEncoding>(Encoding);
+		Header.Compression = static_cast<ETerrainChunkCompression>(Compression);
+	}
+
+	/** Size³ of a header, in 64 bits (a hostile Size would wrap in 32). */
+	int64 GetVoxelCount(const FTerrainChunkHeader& Header)
+	{
+		return static_cast<int64>(Header.Size) * Header.Size * Header.Size;
+	}
+
+	/** Largest encoded payload a header may declare: every sample of its content, at 32 bits each. */
+	int64 GetMaxPayloadBytes(const FTerrainChunkHeader& Header)
+	{
+		if (Header.Content == ETerrainChunkContent::Delta)
+		{
+			const int64 BricksPerAxis = FMath::DivideAndRoundUp(Header.Size, FTerrainChunkDelta::BrickSize);
+			const int64 MaxBricks = BricksPerAxis * BricksPerAxis * BricksPerAxis;
+			return sizeof(int32) + MaxBricks * (sizeof(int32) + FTerrainChunkDelta::SamplesPerBrick * sizeof(float));
+		}
+		return GetVoxelCount(Header) * sizeof(float);
+	}
+
+	/**
+	 * Largest cached mesh a header may declare: five unshared triangles per voxel for the render sections and as
+	 * many for the collision ones (well above what Marching Cubes and the skirts emit), plus one block record per voxel.
+	 */
+	int64 GetMaxMeshBytes(const FTerrainChunkHeader& Header)
+	{
+		constexpr int64 BytesPerTriangle = 3 * (sizeof(FVector3f) * 2 + sizeof(int32));
+		constexpr int64 BlockRecordBytes = sizeof(int32) * 3 + sizeof(uint8);
+		return sizeof(int32) + GetVoxelCount(Header) * (2 * 5 * BytesPerTriangle + BlockRecordBytes);
+	}
+
+	template <typename QuantizedType>
+	void QuantizeDensity(const TArray<float>& Density, FTerrainChunkHeader& Header, TArray<uint8>& OutPayload)
+	{
+		constexpr int32 MaxQuantized = TNumericLimits<QuantizedType>::Max();
+
+		// A preset step (samples already quantized in memory) keeps them exact; otherwise fit the data.
+		if (Header.QuantizationStep <= 0.0f)
+		{
+			float MaxAbs = 0.0f;
+			for (float V : Density)
+				MaxAbs = FMath::Max(MaxAbs, FMath::Abs(V));
+
+			Header.QuantizationStep = FMath::Max(MaxAbs / MaxQuantized, KINDA_SMALL_NUMBER);
+		}
+		const float InvStep = 1.0f / Header.QuantizationStep;
+
+		OutPayload.SetNumUninitialized(Density.Num() * sizeof(QuantizedType));
+		QuantizedType* Dest = reinterpret_cast<QuantizedType*>(OutPayload.GetData());
+		for (int32 i = 0; i < Density.Num(); i++)
+		{
+			Dest[i] = static_cast<QuantizedType>(FMath::Clamp(FMath::RoundToInt(Density[i] * InvStep), -MaxQuantized, MaxQuantized));
+		}
+	}
+
+	template <typename QuantizedType>
+	bool DequantizeDensity(const uint8* Payload, int32 PayloadSize, const FTerrainChunkHeader& Header, int32 VoxelCount, TArray<float>& OutDensity)
+	{
+		if (PayloadSize != static_cast<int64>(VoxelCount) * sizeof(QuantizedType))
+			return false;
+
+		const QuantizedType* Src = reinterpret_cast<const QuantizedType*>(Payload);
+		OutDensity.SetNumUninitialized(VoxelCount);
+		for (int32 i = 0; i < VoxelCount; i++)
+		{
+			OutDensity[i] = Src[i] * Header.QuantizationStep;
+		}
+		return true;
+	}
+
+	void EncodeDensity(const TArray<float>& Density, FTerrainChunkHeader& Header, TArray<uint8>& OutPayload)
+	{
+		if (Header.Encoding == ETerrainDensityEncoding::Quantized16)
+		{
+			QuantizeDensity<int16>(Density, Header, OutPayload);
+		}
+		else if (Header.Encoding == ETerrainDensityEncoding::Quantized8)
+		{
+			QuantizeDensity<int8>(Density, Header, OutPayload);
+		}
+		else
+		{
+			Header.Encoding = ETerrainDensityEncoding::Float32;
+			Header.QuantizationStep = 1.0f;
+
+			OutPayload.SetNumUninitialized(Density.Num() * sizeof(float));
+			FMemory::Memcpy(OutPayload.GetData(), Density.GetData(), OutPayload.Num());
+		}
+	}
+
+	/** Decodes VoxelCount samples in Header.Encoding (a full field, or the bricks of a delta). */
+	bool DecodeDensity(const uint8* Payload, int32 PayloadSize, const FTerrainChunkHeader& Header, int32 VoxelCount, TArray<float>& OutDensity)
+	{
+		if (Header.Encoding == ETerrainDensityEncoding::Quantized16)
+			return DequantizeDensity<int16>(Payload, PayloadSize, Header, VoxelCount, OutDensity);
+
+		if (Header.Encoding == ETerrainDensityEncoding::Quantized8)
+			return DequantizeDensity<int8>(Payload, PayloadSize, Header, VoxelCount, OutDensity);
+
+		if (Header.Encoding == ETerrainDensityEncoding::Float32)
+		{
+			if (PayloadSize != static_cast<int64>(VoxelCount) * sizeof(float))
+				return false;
+
+			OutDensity.SetNumUninitialized(VoxelCount);
+			FMemory::Memcpy(OutDensity.GetData(), Payload, PayloadSize);
+			return true;
+		}
+
+		return false;
+	}
+
+	/** Compresses Payload into OutCompressed; false (OutCompressed empty) if the codec is unavailable or the result is not smaller. */
+	bool CompressPayload(FName FormatName, const TArray<uint8>& Payload, TArray<uint8>& OutCompressed)
+	{
+		OutCompressed.Reset();
+		if (FormatName.IsNone() || Payload.Num() == 0)
+			return false;
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, Payload.Num());
+		OutCompressed.SetNumUninitialized(CompressedSize);
+
+		if (FCompression::CompressMemory(FormatName, OutCompressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num())
+			&& CompressedSize < Payload.Num())
+		{
+			OutCompressed.SetNum(CompressedSize, EAllowShrinking::No);
+			return true;
+		}
+
+		OutCompressed.Reset();
+		return false;
+	}
+
+	/**
+	 * Mesh payload: block count, then per block its section index, collision flag, vertex and index counts,
+	 * followed by the vertices, normals and indices.
+	 */
+	bool EncodeMesh(const TArray<FTerrainMeshBlock>& Blocks, TArray<uint8>& OutPayload)
+	{
+		int64 NumBytes = sizeof(int32);
+		for (const FTerrainMeshBlock& Block : Blocks)
+			NumBytes += sizeof(int32) * 3 + sizeof(uint8) + Block.Mesh.Vertices.Num() * sizeof(FVector3f) * 2 + Block.Mesh.Triangles.Num() * sizeof(int32);
+		if (NumBytes > MAX_int32)
+			return false;
+
+		OutPayload.Reset(static_cast<int32>(NumBytes));
+		FMemoryWriter Writer(OutPayload);
+
+		int32 NumBlocks = Blocks.Num();
+		Writer << NumBlocks;
+		for (const FTerrainMeshBlock& Block : Blocks)
+		{
+			const FTerrainMeshData& Mesh = Block.Mesh;
+			if (Mesh.Normals.Num() != Mesh.Vertices.Num())
+				return false;
+
+			int32 SectionIndex = Block.SectionIndex;
+			uint8 bCollisionOnly = Block.bCollisionOnly ? 1 : 0;
+			int32 NumVertices = Mesh.Vertices.Num();
+			int32 NumIndices = Mesh.Triangles.Num();
+			Writer << SectionIndex << bCollisionOnly << NumVertices << NumIndices;
+			Writer.Serialize(const_cast<FVector3f*>(Mesh.Vertices.GetData()), NumVertices * sizeof(FVector3f));
+			Writer.Serialize(const_cast<FVector3f*>(Mesh.Normals.GetData()), NumVertices * sizeof(FVector3f));
+			Writer.Serialize(const_cast<int32*>(Mesh.Triangles.GetData()), NumIndices * sizeof(int32));
+		}
+		return !Writer.IsError();
+	}
+
+	bool DecodeMesh(const uint8* Payload, int32 PayloadSize, TArray<FTerrainMeshBlock>& OutBlocks)
+	{
+		int32 Offset = 0;
+		auto ReadBytes = [&](void* Dest, int64 NumBytes)
+		{
+			if (NumBytes < 0 || Offset + NumBytes > PayloadSize)
+				return false;
+			FMemory::Memcpy(Dest, Payload + Offset, NumBytes);
+			Offset += static_cast<int32>(NumBytes);
+			return true;
+		};
+
+		int32 NumBlocks = 0;
+		if (!ReadBytes(&NumBlocks, sizeof(int32)) || NumBlocks < 0 || NumBlocks > PayloadSize)
+			return false;
+
+		OutBlocks.SetNum(NumBlocks);
+		for (FTerrainMeshBlock& Block : OutBlocks)
+		{
+			uint8 bCollisionOnly = 0;
+			int32 NumVertices = 0;
+			int32 NumIndices = 0;
+			if (!ReadBytes(&Block.SectionIndex, sizeof(int32)) || !ReadBytes(&bCollisionOnly, sizeof(uint8))
+				|| !ReadBytes(&NumVertices, sizeof(int32)) || !ReadBytes(&NumIndices, sizeof(int32))
+				|| NumVertices < 0 || NumIndices < 0 || NumIndices % 3 != 0
+				|| static_cast<int64>(NumVertices) * sizeof(FVector3f) * 2 + static_cast<int64>(NumIndices) * sizeof(int32) > PayloadSize - Offset)
+				return false;
+
+			FTerrainMeshData& Mesh = Block.Mesh;
+			Block.bCollisionOnly = bCollisionOnly != 0;
+			Mesh.Vertices.SetNumUninitialized(NumVertices);
+			Mesh.Normals.SetNumUninitialized(NumVertices);
+			Mesh.Triangles.SetNumUninitialized(NumIndices);
+			ReadBytes(Mesh.Vertices.GetData(), NumVertices * sizeof(FVector3f));
+			ReadBytes(Mesh.Normals.GetData(), NumVertices * sizeof(FVector3f));
+			ReadBytes(Mesh.Triangles.GetData(), NumIndices * sizeof(int32));
+
+			for (int32 Index : Mesh.Triangles)
+			{
+				if (Index < 0 || Index >= NumVertices)
+					return false;
+			}
+		}
+		return Offset == PayloadSize;
+	}
+
+	/**
+	 * Compresses an encoded payload (as requested by Header, if it helps) and writes the file blob,
+	 * followed by the optional mesh payload (compressed the same way).
+	 */
+	bool WriteChunk(FTerrainChunkHeader& Header, const TArray<uint8>& Payload, TArray<uint8>& OutBytes, const TArray<FTerrainMeshBlock>* Mesh)
+	{
+		Header.Version = FTerrainChunkHeader::CurrentVersion;
+		Header.UncompressedBytes = Payload.Num();
+
+		TArray<uint8> MeshPayload;
+		if (Mesh && !EncodeMesh(*Mesh, MeshPayload))
+			return false;
+		if (!Mesh)
+		{
+			Header.MeshHash = 0;
+			Header.MeshHaloFaceMask = 0;
+		}
+		Header.MeshUncompressedBytes = MeshPayload.Num();
+
+		// Try to compress; keep the raw payloads if the codec is unavailable or the result is not smaller.
+		const FName FormatName = GetCompressionFormatName(Header.Compression);
+		TArray<uint8> Compressed;
+		TArray<uint8> CompressedMesh;
+		const bool bCompressed = CompressPayload(FormatName, Payload, Compressed);
+		const bool bCompressedMesh = CompressPayload(FormatName, MeshPayload, CompressedMesh);
+
+		if (!bCompressed && !bCompressedMesh)
+			Header.Compression = ETerrainChunkCompression::None;
+
+		const TArray<uint8>& Stored = bCompressed ? Compressed : Payload;
+		const TArray<uint8>& StoredMesh = bCompressedMesh ? CompressedMesh : MeshPayload;
+		Header.PayloadBytes = Stored.Num();
+		Header.MeshBytes = StoredMesh.Num();
+
+		OutBytes.Reset(sizeof(FTerrainChunkHeader) + sizeof(uint32) + Stored.Num() + StoredMesh.Num());
+		FMemoryWriter Writer(OutBytes);
+
+		uint32 Magic = FTerrainChunkHeader::FileMagic;
+		Writer << Magic;
+		SerializeHeader(Writer, Header);
+		Writer.Serialize(const_cast<uint8*>(Stored.GetData()), Stored.Num());
+		Writer.Serialize(const_cast<uint8*>(StoredMesh.GetData()), StoredMesh.Num());
+
+		return !Writer.IsError();
+	}
+
+	/** Validates the header of a file blob (of ExpectedSize if > 0); returns the offset of its payload, or INDEX_NONE. */
+	int32 ReadChunkHeader(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, int32 ExpectedSize)
+	{
+		FMemoryReader Reader(Bytes);
+
+		uint32 Magic = 0;
+		Reader << Magic;
+		if (Magic != FTerrainChunkHeader::FileMagic)
+			return INDEX_NONE;
+
+		SerializeHeader(Reader, OutHeader);
+		if (Reader.IsError() || OutHeader.Version == 0 || OutHeader.Version > FTerrainChunkHeader::CurrentVersion)
+			return INDEX_NONE;
+
+		if (OutHeader.Size <= 0 || OutHeader.Size > FTerrainChunkHeader::MaxSize || (ExpectedSize > 0 && OutHeader.Size != ExpectedSize)
+			|| OutHeader.PayloadBytes < 0
+			|| OutHeader.MeshBytes < 0 || Reader.Tell() + OutHeader.PayloadBytes + OutHeader.MeshBytes > Reader.TotalSize())
+			return INDEX_NONE;
+
+		// Uncompressed sizes are allocated before the codec runs: they must fit what the header's chunk can hold.
+		if (OutHeader.UncompressedBytes < 0 || OutHeader.UncompressedBytes > GetMaxPayloadBytes(OutHeader)
+			|| OutHeader.MeshUncompressedBytes < 0 || OutHeader.MeshUncompressedBytes > GetMaxMeshBytes(OutHeader))
+			return INDEX_NONE;
+
+		return static_cast<int32>(Reader.Tell());
+	}
+
+	/** Uncompresses one stored payload (pointing into Stored or Scratch); payloads not smaller than their raw size are raw. */
+	bool UncompressPayload(ETerrainChunkCompression Compression, const uint8* Stored, int32 StoredSize, int32 UncompressedSize,
+		TArray<uint8>& Scratch, const uint8*& OutPayload, int32& OutPayloadSize)
+	{
+		if (Compression == ETerrainChunkCompression::None || StoredSize >= UncompressedSize)
+		{
+			OutPayload = Stored;
+			OutPayloadSize = StoredSize;
+			return true;
+		}
+
+		const FName FormatName = GetCompressionFormatName(Compression);
+		if (FormatName.IsNone())
+			return false;
+
+		Scratch.SetNumUninitialized(UncompressedSize);
+		if (!FCompression::UncompressMemory(FormatName, Scratch.GetData(), Scratch.Num(), Stored, StoredSize))
+			return false;
+
+		OutPayload = Scratch.GetData();
+		OutPayloadSize = Scratch.Num();
+		return true;
+	}
+
+	/** Reads the header, then the uncompressed payload of a file blob (pointing into Bytes or Scratch). */
+	bool ReadChunk(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, int32 ExpectedSize, TArray<uint8>& Scratch,
+		const uint8*& OutPayload, int32& OutPayloadSize)
+	{
+		const int32 Offset = ReadChunkHeader(Bytes, OutHeader, ExpectedSize);
+		if (Offset == INDEX_NONE)
+			return false;
+
+		return UncompressPayload(OutHeader.Compression, Bytes.GetData() + Offset, OutHeader.PayloadBytes, OutHeader.UncompressedBytes,
+			Scratch, OutPayload, OutPayloadSize);
+	}
+}
+
+bool TerrainChunkFormat::Write(FTerrainChunkHeader Header, const TArray<float>& Density, TArray<uint8>& OutBytes,
+	const TArray<FTerrainMeshBlock>* Mesh)
+{
+	if (Header.Size <= 0 || Header.Size > FTerrainChunkHeader::MaxSize || Density.Num() != GetVoxelCount(Header))
+		return false;
+
+	Header.Content = ETerrainChunkContent::Density;
+	Header.BaselineHash = 0;
+
+	TArray<uint8> Payload;
+	EncodeDensity(Density, Header, Payload);
+	return WriteChunk(Header, Payload, OutBytes, Mesh);
+}
+
+bool TerrainChunkFormat::Read(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, TArray<float>& OutDensity,
+	int32 ExpectedSize)
+{
+	TArray<uint8> Uncompressed;
+	const uint8* Payload = nullptr;
+	int32 PayloadSize = 0;
+	if (!ReadChunk(Bytes, OutHeader, ExpectedSize, Uncompressed, Payload, PayloadSize) || OutHeader.Content != ETerrainChunkContent::Density)
+		return false;
+
+	// ReadChunkHeader() capped Size: the count fits in 32 bits.
+	return DecodeDensity(Payload, PayloadSize, OutHeader, static_cast<int32>(GetVoxelCount(OutHeader)), OutDensity);
+}
+
+bool TerrainChunkFormat::ReadHeader(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, int32 ExpectedSize)
+{
+	return ReadChunkHeader(Bytes, OutHeader, ExpectedSize) != INDEX_NONE;
+}
+
+bool TerrainChunkFormat::WriteDelta(FTerrainChunkHeader Header, const FTerrainChunkDelta& Delta, TArray<uint8>& OutBytes,
+	const TArray<FTerrainMeshBlock>* Mesh)
+{
+	const int32 NumBricks = Delta.BrickIndices.Num();
+	if (Header.Size <= 0 || Header.Size > FTerrainChunkHeader::MaxSize
+		|| Delta.Samples.Num() != static_cast<int64>(NumBricks) * FTerrainChunkDelta::SamplesPerBrick)
+		return false;
+
+	Header.Content = ETerrainChunkContent::Delta;
+
+	// Payload: brick count, brick indices, then the samples of every brick in the chunk's encoding.
+	TArray<uint8> Samples;
+	EncodeDensity(Delta.Samples, Header, Samples);
+
+	TArray<uint8> Payload;
+	Payload.Reserve(sizeof(int32) * (NumBricks + 1) + Samples.Num());
+	FMemoryWriter Writer(Payload);
+	int32 Count = NumBricks;
+	Writer << Count;
+	Writer.Serialize(const_cast<int32*>(Delta.BrickIndices.GetData()), NumBricks * sizeof(int32));
+	Writer.Serialize(Samples.GetData(), Samples.Num());
+	if (Writer.IsError())
+		return false;
+
+	return WriteChunk(Header, Payload, OutBytes, Mesh);
+}
+
+bool TerrainChunkFormat::ReadDelta(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, FTerrainChunkDelta& OutDelta,
+	int32 ExpectedSize)
+{
+	TArray<uint8> Uncompressed;
+	const uint8* Payload = nullptr;
+	int32 PayloadSize = 0;
+	if (!ReadChunk(Bytes, OutHeader, ExpectedSize, Uncompressed, Payload, PayloadSize) || OutHeader.Content != ETerrainChunkContent::Delta)
+		return false;
+
+	if (PayloadSize < static_cast<int32>(sizeof(int32)))
+		return false;
+
+	int32 NumBricks = 0;
+	FMemory::Memcpy(&NumBricks, Payload, sizeof(int32));
+	const int32 BricksPerAxis = FMath::DivideAndRoundUp(OutHeader.Size, FTerrainChunkDelta::BrickSize);
+	const int64 IndexBytes = static_cast<int64>(NumBricks + 1) * sizeof(int32);
+	if (NumBricks < 0 || NumBricks > BricksPerAxis * BricksPerAxis * BricksPerAxis || IndexBytes > PayloadSize)
+		return false;
+
+	OutDelta.BrickIndices.SetNumUninitialized(NumBricks);
+	FMemory::Memcpy(OutDelta.BrickIndices.GetData(), Payload + sizeof(int32), NumBricks * sizeof(int32));
+	for (int32 BrickIndex : OutDelta.BrickIndices)
+	{
+		if (BrickIndex < 0 || BrickIndex >= BricksPerAxis * BricksPerAxis * BricksPerAxis)
+			return false;
+	}
+
+	return DecodeDensity(Payload + IndexBytes, PayloadSize - static_cast<int32>(IndexBytes), OutHeader,
+		NumBricks * FTerrainChunkDelta::SamplesPerBrick, OutDelta.Samples);
+}
+
+bool TerrainChunkFormat::ReadMesh(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, TArray<FTerrainMeshBlock>& OutBlocks,
+	int32 ExpectedSize)
+{
+	const int32 Offset = ExpectedSize > 0 ? ReadChunkHeader(Bytes, OutHeader, ExpectedSize) : INDEX_NONE;
+	if (Offset == INDEX_NONE || OutHeader.MeshBytes == 0)
+		return false;
+
+	TArray<uint8> Uncompressed;
+	const uint8* Payload = nullptr;
+	int32 PayloadSize = 0;
+	return UncompressPayload(OutHeader.Compression, Bytes.GetData() + Offset + OutHeader.PayloadBytes, OutHeader.MeshBytes,
+			OutHeader.MeshUncompressedBytes, Uncompressed, Payload, PayloadSize)
+		&& DecodeMesh(Payload, PayloadSize, OutBlocks);
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainChunkFormat.generated.h"
+
+struct FTerrainMeshBlock;
+
+/** How density samples are stored, in memory (see FTerrainDensityStorage) and inside a binary chunk file. */
+UENUM(BlueprintType)
+enum class ETerrainDensityEncoding : uint8
+{
+	/** Raw 32-bit floats (lossless). */
+	Float32,
+
+	/** 16-bit signed integers scaled by a per-chunk quantization step. */
+	Quantized16,
+
+	/** 8-bit signed integers scaled by a per-chunk quantization step (enough for a truncated signed distance). */
+	Quantized8
+};
+
+/** Compression applied to the density payload of a binary chunk file. */
+UENUM(BlueprintType)
+enum class ETerrainChunkCompression : uint8
+{
+	None,
+	LZ4,
+	Oodle
+};
+
+/** What the payload of a binary chunk file holds. */
+enum class ETerrainChunkContent : uint8
+{
+	/** The whole Size³ density field. */
+	Density,
+
+	/** Only the bricks that differ from the chunk's procedural density (see FTerrainChunkDelta). */
+	Delta
+};
+
+/**
+ * FTerrainChunkHeader
+ *
+ * Fixed-size header written at the start of every binary chunk file.
+ * It is followed by PayloadBytes of density data (Size³ samples in the given
+ * encoding, or an edit delta), compressed with the given method if Compression != None,
+ * then by MeshBytes of cached mesh blocks (see TerrainChunkFormat::ReadMesh()).
+ * A payload is stored raw when compressing it did not make it smaller.
+ */
+struct FTerrainChunkHeader
+{
+	/** 'TCHK' tag identifying a binary terrain chunk. */
+	static constexpr uint32 FileMagic = 0x4B484354;
+
+	/**
+	 * Bump whenever the on-disk layout changes (older versions must stay readable).
+	 * Version 2 adds Quantized8, 3 edit deltas, 4 cached meshes.
+	 */
+	static constexpr uint32 CurrentVersion = 4;
+
+	/**
+	 * Largest Size a file may declare; readers reject larger ones before sizing anything from them. A reader that
+	 * knows the chunk size also rejects any other (see TerrainChunkFormat::Read()), which bounds its allocations
+	 * to what that chunk can hold.
+	 */
+	static constexpr int32 MaxSize = 256;
+
+	uint32 Version = CurrentVersion;
+	int32 Size = 0;
+	float Scale = 1.0f;
+	float IsoLevel = 0.0f;
+	ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32;
+	ETerrainChunkCompression Compression = ETerrainChunkCompression::None;
+
+	/** Value of one quantization unit (only meaningful for the quantized encodings). */
+	float QuantizationStep = 1.0f;
+
+	/** Size of the encoded payload before compression. */
+	int32 UncompressedBytes = 0;
+
+	/** Size of the payload actually stored in the file. */
+	int32 PayloadBytes = 0;
+
+	ETerrainChunkContent Content = ETerrainChunkContent::Density;
+
+	/** Delta files: hash of the generation parameters the delta applies to (a mismatch means the baseline changed). */
+	uint32 BaselineHash = 0;
+
+	/** Size of the cached mesh before compression, and as stored after the payload (0: no cached mesh). */
+	int32 MeshUncompressedBytes = 0;
+	int32 MeshBytes = 0;
+
+	/** Hash of the density and meshing parameters the cached mesh was extracted from; a mismatch means it is stale. */
+	uint32 MeshHash = 0;
+
+	/** Halo faces (bit i = FTerrainDensityHalo::Faces[i]) the cached mesh's extraction read. */
+	uint8 MeshHaloFaceMask = 0;
+};
+
+/**
+ * FTerrainChunkDelta
+ *
+ * Edits of a chunk as the density bricks (FTerrainDensityStorage::BrickSize³ voxels) that differ from its
+ * procedural density. A chunk without edits has no brick, and no file.
+ */
+struct FTerrainChunkDelta
+{
+	/** Voxels per side of a delta brick (FTerrainDensityStorage::BrickSize). */
+	static constexpr int32 BrickSize = 8;
+	static constexpr int32 SamplesPerBrick = BrickSize * BrickSize * BrickSize;
+
+	/** Storage brick indices (see FTerrainDensityStorage::GetNumBricks()). */
+	TArray<int32> BrickIndices;
+
+	/** BrickSize³ samples per brick, in the order of BrickIndices (layout of FTerrainDensityStorage::GetBrickSamples()). */
+	TArray<float> Samples;
+};
+
+/** Stores the encoded blob of a chunk save (empty bytes: nothing to keep); may run on any thread. */
+using FTerrainChunkWriter = TFunction<bool(const TArray<uint8>& Bytes)>;
+
+/** Fetches the encoded blob of a chunk save; may run on any thread. */
+using FTerrainChunkReader = TFunction<bool(TArray<uint8>& OutBytes)>;
+
+/**
+ * TerrainChunkFormat
+ *
+ * Encoding / decoding of the versioned binary chunk format used for terrain persistence.
+ * Both functions work on memory buffers so that a save or load is a single file operation.
+ */
+namespace TerrainChunkFormat
+{
+	/** File extension (without dot) used for binary chunk saves. */
+	DESTRUCTIONTERRAIN_API extern const TCHAR* const FileExtension;
+
+	/**
+	 * Encodes a density field into a binary chunk blob.
+	 * Size, Scale, IsoLevel, Encoding and Compression are taken from Header; the remaining fields are filled in.
+	 * For quantized encodings, a QuantizationStep > 0 is used as is, and 0 derives the step from the data.
+	 * Falls back to an uncompressed payload if compression fails or does not reduce the size.
+	 * @param Mesh - Optional mesh blocks cached after the density, keyed by Header.MeshHash and Header.MeshHaloFaceMask.
+	 */
+	DESTRUCTIONTERRAIN_API bool Write(FTerrainChunkHeader Header, const TArray<float>& Density, TArray<uint8>& OutBytes,
+		const TArray<FTerrainMeshBlock>* Mesh = nullptr);
+
+	/**
+	 * Decodes a binary chunk blob. Returns false if the data is not a valid chunk file, or holds a delta.
+	 * @param ExpectedSize - If > 0, files of another Size are rejected before anything is allocated.
+	 */
+	DESTRUCTIONTERRAIN_API bool Read(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, TArray<float>& OutDensity,
+		int32 ExpectedSize = 0);
+
+	/** Decodes only the header of a binary chunk blob (e.g. to tell a delta from a full density). */
+	DESTRUCTIONTERRAIN_API bool ReadHeader(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, int32 ExpectedSize = 0);
+
+	/**
+	 * Encodes an edit delta (Header.Content is set to Delta; BaselineHash is taken from Header).
+	 * Samples are encoded and compressed, and Mesh cached, as in Write().
+	 */
+	DESTRUCTIONTERRAIN_API bool WriteDelta(FTerrainChunkHeader Header, const FTerrainChunkDelta& Delta, TArray<uint8>& OutBytes,
+		const TArray<FTerrainMeshBlock>* Mesh = nullptr);
+
+	/** Decodes an edit delta blob. Returns false if the data is not a valid delta file (ExpectedSize as in Read()). */
+	DESTRUCTIONTERRAIN_API bool ReadDelta(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, FTerrainChunkDelta& OutDelta,
+		int32 ExpectedSize = 0);
+
+	/**
+	 * Decodes the mesh blocks cached in a chunk blob (full density or delta). Blocks already in OutBlocks are
+	 * refilled in place. Returns false if the blob has no cached mesh or it is invalid; the caller checks MeshHash.
+	 * @param ExpectedSize - Size of the chunk the mesh is for; files of another Size are rejected from their header
+	 *                       (a mesh may take far more bytes than the density, so its bound needs the real size).
+	 */
+	DESTRUCTIONTERRAIN_API bool ReadMesh(const TArray<uint8>& Bytes, FTerrainChunkHeader& OutHeader, TArray<FTerrainMeshBlock>& OutBlocks,
+		int32 ExpectedSize);
+}
@@ -0,0 +1,501 @@
+#include "TerrainDensityStorage.h"
+
+static_assert(FTerrainChunkDelta::BrickSize == FTerrainDensityStorage::BrickSize, "Edit deltas are saved per storage brick.");
+
+namespace
+{
+	int32 GetMaxQuantized(ETerrainDensityEncoding Encoding)
+	{
+		switch (Encoding)
+		{
+		case ETerrainDensityEncoding::Quantized16: return MAX_int16;
+		case ETerrainDensityEncoding::Quantized8:  return MAX_int8;
+		default:                                   return 0;
+		}
+	}
+
+	int32 GetEncodingBytes(ETerrainDensityEncoding Encoding)
+	{
+		switch (Encoding)
+		{
+		case ETerrainDensityEncoding::Quantized16: return sizeof(int16);
+		case ETerrainDensityEncoding::Quantized8:  return sizeof(int8);
+		default:                                   return sizeof(float);
+		}
+	}
+}
+
+void FTerrainDensityStorage::Reset()
+{
+	Size = 0;
+	BricksPerAxis = 0;
+	UniformValue = 0.0f;
+	Bricks.Empty();
+	UpdateQuantizationStep(0.0f);
+}
+
+void FTerrainDensityStorage::SetEncoding(ETerrainDensityEncoding InEncoding, float Range)
+{
+	if (InEncoding == Encoding && Range == RequestedRange)
+		return;
+
+	TArray<float> Dense;
+	const int32 OldSize = Size;
+	if (OldSize > 0)
+		ToDense(Dense);
+
+	Encoding = InEncoding;
+	BytesPerSample = GetEncodingBytes(InEncoding);
+	RequestedRange = FMath::Max(Range, 0.0f);
+
+	if (OldSize > 0)
+		SetFromDense(OldSize, Dense);
+	else
+		UpdateQuantizationStep(0.0f);
+}
+
+void FTerrainDensityStorage::InitUniform(int32 InSize, float Value)
+{
+	check(InSize >= 0);
+	Size = InSize;
+	BricksPerAxis = FMath::DivideAndRoundUp(InSize, BrickSize);
+	Bricks.Empty();
+
+	UpdateQuantizationStep(FMath::Abs(Value));
+	UniformValue = Quantize(Value);
+}
+
+void FTerrainDensityStorage::SetFromDense(int32 InSize, const TArray<float>& Dense)
+{
+	check(Dense.Num() == InSize * InSize * InSize);
+
+	float MaxAbs = 0.0f;
+	if (Encoding != ETerrainDensityEncoding::Float32 && RequestedRange <= 0.0f)
+	{
+		for (float V : Dense)
+			MaxAbs = FMath::Max(MaxAbs, FMath::Abs(V));
+	}
+
+	Size = InSize;
+	BricksPerAxis = FMath::DivideAndRoundUp(InSize, BrickSize);
+	Bricks.Empty();
+
+	UpdateQuantizationStep(MaxAbs);
+	UniformValue = Dense.Num() > 0 ? Quantize(Dense[0]) : 0.0f;
+	if (Dense.Num() == 0)
+		return;
+
+	Bricks.SetNum(BricksPerAxis * BricksPerAxis * BricksPerAxis);
+
+	for (int32 Bz = 0; Bz < BricksPerAxis; Bz++)
+	for (int32 By = 0; By < BricksPerAxis; By++)
+	for (int32 Bx = 0; Bx < BricksPerAxis; Bx++)
+	{
+		FBrick& Brick = Bricks[Bx + By * BricksPerAxis + Bz * BricksPerAxis * BricksPerAxis];
+		const int32 X0 = Bx * BrickSize, Y0 = By * BrickSize, Z0 = Bz * BrickSize;
+		const int32 X1 = FMath::Min(X0 + BrickSize, Size), Y1 = FMath::Min(Y0 + BrickSize, Size), Z1 = FMath::Min(Z0 + BrickSize, Size);
+
+		// Uniformity is tested on the encoded values, so quantization can only help bricks collapse.
+		const float First = Quantize(Dense[X0 + Y0 * Size + Z0 * Size * Size]);
+		bool bUniform = true;
+		for (int32 z = Z0; z < Z1 && bUniform; z++)
+		for (int32 y = Y0; y < Y1 && bUniform; y++)
+		for (int32 x = X0; x < X1; x++)
+		{
+			if (Quantize(Dense[x + y * Size + z * Size * Size]) != First)
+			{
+				bUniform = false;
+				break;
+			}
+		}
+
+		Brick.Value = First;
+		Brick.Min = First;
+		Brick.Max = First;
+		if (bUniform)
+			continue;
+
+		Brick.Samples.SetNumZeroed(BrickSize * BrickSize * BrickSize * BytesPerSample);
+		for (int32 z = Z0; z < Z1; z++)
+		for (int32 y = Y0; y < Y1; y++)
+		for (int32 x = X0; x < X1; x++)
+		{
+			const float Value = Dense[x + y * Size + z * Size * Size];
+			StoreSample(&Brick.Samples[GetSampleIndex(x, y, z) * BytesPerSample], Value);
+
+			const float Stored = Quantize(Value);
+			Brick.Min = FMath::Min(Brick.Min, Stored);
+			Brick.Max = FMath::Max(Brick.Max, Stored);
+		}
+	}
+
+	CompactField();
+}
+
+void FTerrainDensityStorage::ToDense(TArray<float>& OutDense) const
+{
+	if (IsUniform())
+	{
+		OutDense.Init(UniformValue, Num());
+		return;
+	}
+
+	OutDense.SetNumUninitialized(Num());
+
+	for (int32 Bz = 0; Bz < BricksPerAxis; Bz++)
+	for (int32 By = 0; By < BricksPerAxis; By++)
+	for (int32 Bx = 0; Bx < BricksPerAxis; Bx++)
+	{
+		const FBrick& Brick = Bricks[Bx + By * BricksPerAxis + Bz * BricksPerAxis * BricksPerAxis];
+		const int32 X0 = Bx * BrickSize, Y0 = By * BrickSize, Z0 = Bz * BrickSize;
+		const int32 X1 = FMath::Min(X0 + BrickSize, Size), Y1 = FMath::Min(Y0 + BrickSize, Size), Z1 = FMath::Min(Z0 + BrickSize, Size);
+
+		for (int32 z = Z0; z < Z1; z++)
+		for (int32 y = Y0; y < Y1; y++)
+		{
+			float* Row = OutDense.GetData() + X0 + y * Size + z * Size * Size;
+			for (int32 x = X0; x < X1; x++)
+			{
+				*Row++ = Brick.Samples.Num() > 0
+					? LoadSample(&Brick.Samples[GetSampleIndex(x, y, z) * BytesPerSample])
+					: Brick.Value;
+			}
+		}
+	}
+}
+
+void FTerrainDensityStorage::ToDenseSamples(TArray<uint8>& OutSamples) const
+{
+	OutSamples.SetNumUninitialized(Num() * BytesPerSample);
+
+	auto FillSamples = [this](uint8* Dest, int32 Count, float Value)
+	{
+		uint8 Encoded[sizeof(float)];
+		StoreSample(Encoded, Value);
+		for (int32 i = 0; i < Count; i++, Dest += BytesPerSample)
+			FMemory::Memcpy(Dest, Encoded, BytesPerSample);
+	};
+
+	if (IsUniform())
+	{
+		FillSamples(OutSamples.GetData(), Num(), UniformValue);
+		return;
+	}
+
+	for (int32 Bz = 0; Bz < BricksPerAxis; Bz++)
+	for (int32 By = 0; By < BricksPerAxis; By++)
+	for (int32 Bx = 0; Bx < BricksPerAxis; Bx++)
+	{
+		const FBrick& Brick = Bricks[Bx + By * BricksPerAxis + Bz * BricksPerAxis * BricksPerAxis];
+		const int32 X0 = Bx * BrickSize, Y0 = By * BrickSize, Z0 = Bz * BrickSize;
+		const int32 X1 = FMath::Min(X0 + BrickSize, Size), Y1 = FMath::Min(Y0 + BrickSize, Size), Z1 = FMath::Min(Z0 + BrickSize, Size);
+
+		for (int32 z = Z0; z < Z1; z++)
+		for (int32 y = Y0; y < Y1; y++)
+		{
+			uint8* Row = OutSamples.GetData() + (X0 + y * Size + z * Size * Size) * BytesPerSample;
+			if (Brick.Samples.Num() == 0)
+				FillSamples(Row, X1 - X0, Brick.Value);
+			else
+				FMemory::Memcpy(Row, &Brick.Samples[GetSampleIndex(X0, y, z) * BytesPerSample], (X1 - X0) * BytesPerSample);
+		}
+	}
+}
+
+bool FTerrainDensityStorage::CanContainSurface(float IsoLevel) const
+{
+	if (Size == 0 || IsUniform())
+		return false;
+
+	const bool bFirstBelow = Bricks[0].Value < IsoLevel;
+	for (const FBrick& Brick : Bricks)
+	{
+		if (Brick.Samples.Num() > 0 || (Brick.Value < IsoLevel) != bFirstBelow)
+			return true;
+	}
+	return false;
+}
+
+float FTerrainDensityStorage::Get(int32 X, int32 Y, int32 Z) const
+{
+	checkSlow(X >= 0 && Y >= 0 && Z >= 0 && X < Size && Y < Size && Z < Size);
+	if (Bricks.Num() == 0)
+		return UniformValue;
+
+	const FBrick& Brick = Bricks[GetBrickIndex(X, Y, Z)];
+	return Brick.Samples.Num() > 0 ? LoadSample(&Brick.Samples[GetSampleIndex(X, Y, Z) * BytesPerSample]) : Brick.Value;
+}
+
+void FTerrainDensityStorage::Set(int32 X, int32 Y, int32 Z, float Value)
+{
+	checkSlow(X >= 0 && Y >= 0 && Z >= 0 && X < Size && Y < Size && Z < Size);
+	Value = Quantize(Value);
+
+	if (Bricks.Num() == 0)
+	{
+		if (Value == UniformValue)
+			return;
+
+		Bricks.SetNum(BricksPerAxis * BricksPerAxis * BricksPerAxis);
+		for (FBrick& Brick : Bricks)
+		{
+			Brick.Value = UniformValue;
+			Brick.Min = UniformValue;
+			Brick.Max = UniformValue;
+		}
+	}
+
+	FBrick& Brick = Bricks[GetBrickIndex(X, Y, Z)];
+	if (Brick.Samples.Num() == 0)
+	{
+		if (Value == Brick.Value)
+			return;
+
+		constexpr int32 SamplesPerBrick = BrickSize * BrickSize * BrickSize;
+		Brick.Samples.SetNumUninitialized(SamplesPerBrick * BytesPerSample);
+		for (int32 i = 0; i < SamplesPerBrick; i++)
+			StoreSample(&Brick.Samples[i * BytesPerSample], Brick.Value);
+	}
+	StoreSample(&Brick.Samples[GetSampleIndex(X, Y, Z) * BytesPerSample], Value);
+
+	// The overwritten sample may have been the extremum: the range only grows until the brick is compacted.
+	Brick.Min = FMath::Min(Brick.Min, Value);
+	Brick.Max = FMath::Max(Brick.Max, Value);
+}
+
+void FTerrainDensityStorage::Compact(const FIntVector& VoxelMin, const FIntVector& VoxelMax)
+{
+	if (Bricks.Num() == 0)
+		return;
+
+	const int32 BxMin = FMath::Clamp(VoxelMin.X, 0, Size - 1) / BrickSize, BxMax = FMath::Clamp(VoxelMax.X, 0, Size - 1) / BrickSize;
+	const int32 ByMin = FMath::Clamp(VoxelMin.Y, 0, Size - 1) / BrickSize, ByMax = FMath::Clamp(VoxelMax.Y, 0, Size - 1) / BrickSize;
+	const int32 BzMin = FMath::Clamp(VoxelMin.Z, 0, Size - 1) / BrickSize, BzMax = FMath::Clamp(VoxelMax.Z, 0, Size - 1) / BrickSize;
+
+	for (int32 Bz = BzMin; Bz <= BzMax; Bz++)
+	for (int32 By = ByMin; By <= ByMax; By++)
+	for (int32 Bx = BxMin; Bx <= BxMax; Bx++)
+		CompactBrick(Bx, By, Bz);
+
+	CompactField();
+}
+
+int32 FTerrainDensityStorage::GetActiveCellBricks(float IsoLevel, TArray<uint8>& OutActive) const
+{
+	const int32 NumCellBricks = GetNumCellBricksPerAxis();
+	OutActive.Init(0, NumCellBricks * NumCellBricks * NumCellBricks);
+	if (Bricks.Num() == 0)
+		return 0;
+
+	// The cells of brick B read the voxels B * BrickSize .. (B + 1) * BrickSize, the last layer lying in brick B + 1.
+	int32 NumActive = 0;
+	for (int32 Bz = 0; Bz < NumCellBricks; Bz++)
+	for (int32 By = 0; By < NumCellBricks; By++)
+	for (int32 Bx = 0; Bx < NumCellBricks; Bx++)
+	{
+		float Min = MAX_flt, Max = -MAX_flt;
+		for (int32 Nz = Bz; Nz <= FMath::Min(Bz + 1, BricksPerAxis - 1); Nz++)
+		for (int32 Ny = By; Ny <= FMath::Min(By + 1, BricksPerAxis - 1); Ny++)
+		for (int32 Nx = Bx; Nx <= FMath::Min(Bx + 1, BricksPerAxis - 1); Nx++)
+		{
+			const FBrick& Brick = Bricks[Nx + Ny * BricksPerAxis + Nz * BricksPerAxis * BricksPerAxis];
+			Min = FMath::Min(Min, Brick.Min);
+			Max = FMath::Max(Max, Brick.Max);
+		}
+
+		// Same test as the cube index: a cell crosses the surface when some corner is below IsoLevel and some is not.
+		if (Min < IsoLevel && Max >= IsoLevel)
+		{
+			OutActive[Bx + By * NumCellBricks + Bz * NumCellBricks * NumCellBricks] = 1;
+			NumActive++;
+		}
+	}
+	return NumActive;
+}
+
+void FTerrainDensityStorage::GetBrickSamples(int32 BrickIndex, float* OutSamples) const
+{
+	check(BrickIndex >= 0 && BrickIndex < GetNumBricks());
+	const int32 Bx = BrickIndex % BricksPerAxis, By = (BrickIndex / BricksPerAxis) % BricksPerAxis, Bz = BrickIndex / (BricksPerAxis * BricksPerAxis);
+
+	for (int32 z = 0; z < BrickSize; z++)
+	for (int32 y = 0; y < BrickSize; y++)
+	for (int32 x = 0; x < BrickSize; x++)
+	{
+		const int32 X = Bx * BrickSize + x, Y = By * BrickSize + y, Z = Bz * BrickSize + z;
+		OutSamples[x + y * BrickSize + z * BrickSize * BrickSize] = X < Size && Y < Size && Z < Size ? Get(X, Y, Z) : 0.0f;
+	}
+}
+
+void FTerrainDensityStorage::SetBrickSamples(int32 BrickIndex, const float* Samples)
+{
+	check(BrickIndex >= 0 && BrickIndex < GetNumBricks());
+	const int32 Bx = BrickIndex % BricksPerAxis, By = (BrickIndex / BricksPerAxis) % BricksPerAxis, Bz = BrickIndex / (BricksPerAxis * BricksPerAxis);
+
+	const int32 X0 = Bx * BrickSize, Y0 = By * BrickSize, Z0 = Bz * BrickSize;
+	const int32 X1 = FMath::Min(X0 + BrickSize, Size), Y1 = FMath::Min(Y0 + BrickSize, Size), Z1 = FMath::Min(Z0 + BrickSize, Size);
+	for (int32 z = Z0; z < Z1; z++)
+	for (int32 y = Y0; y < Y1; y++)
+	for (int32 x = X0; x < X1; x++)
+		Set(x, y, z, Samples[(x - X0) + (y - Y0) * BrickSize + (z - Z0) * BrickSize * BrickSize]);
+
+	if (Bricks.Num() > 0)
+	{
+		CompactBrick(Bx, By, Bz);
+		CompactField();
+	}
+}
+
+bool FTerrainDensityStorage::IsBrickEqual(int32 BrickIndex, const FTerrainDensityStorage& Other, float Tolerance) const
+{
+	check(Other.Size == Size && BrickIndex >= 0 && BrickIndex < GetNumBricks());
+
+	// Two uniform bricks compare by value without expanding them.
+	const FBrick* Brick = Bricks.Num() > 0 ? &Bricks[BrickIndex] : nullptr;
+	const FBrick* OtherBrick = Other.Bricks.Num() > 0 ? &Other.Bricks[BrickIndex] : nullptr;
+	if ((!Brick || Brick->Samples.Num() == 0) && (!OtherBrick || OtherBrick->Samples.Num() == 0))
+	{
+		const float Value = Brick ? Brick->Value : UniformValue;
+		const float OtherValue = OtherBrick ? OtherBrick->Value : Other.UniformValue;
+		return FMath::Abs(Value - OtherValue) <= Tolerance;
+	}
+
+	const int32 Bx = BrickIndex % BricksPerAxis, By = (BrickIndex / BricksPerAxis) % BricksPerAxis, Bz = BrickIndex / (BricksPerAxis * BricksPerAxis);
+	const int32 X0 = Bx * BrickSize, Y0 = By * BrickSize, Z0 = Bz * BrickSize;
+	const int32 X1 = FMath::Min(X0 + BrickSize, Size), Y1 = FMath::Min(Y0 + BrickSize, Size), Z1 = FMath::Min(Z0 + BrickSize, Size);
+	for (int32 z = Z0; z < Z1; z++)
+	for (int32 y = Y0; y < Y1; y++)
+	for (int32 x = X0; x < X1; x++)
+	{
+		if (FMath::Abs(Get(x, y, z) - Other.Get(x, y, z)) > Tolerance)
+			return false;
+	}
+	return true;
+}
+
+uint32 FTerrainDensityStorage::GetContentHash() const
+{
+	uint32 Hash = FCrc::MemCrc32(&Size, sizeof(Size));
+
+	// Bricks whose in-field samples share one value hash that value, whether or not they were collapsed.
+	float Samples[BrickSize * BrickSize * BrickSize];
+	for (int32 BrickIndex = 0; BrickIndex < GetNumBricks(); BrickIndex++)
+	{
+		const FBrick* Brick = Bricks.Num() > 0 ? &Bricks[BrickIndex] : nullptr;
+		if (!Brick || Brick->Samples.Num() == 0 || Brick->Min == Brick->Max)
+		{
+			const float Value = !Brick ? UniformValue : Brick->Samples.Num() == 0 ? Brick->Value : Brick->Min;
+			Hash = FCrc::MemCrc32(&Value, sizeof(Value), Hash);
+			continue;
+		}
+
+		GetBrickSamples(BrickIndex, Samples);
+		Hash = FCrc::MemCrc32(Samples, sizeof(Samples), Hash);
+	}
+	return Hash;
+}
+
+SIZE_T FTerrainDensityStorage::GetAllocatedSize() const
+{
+	SIZE_T Bytes = Bricks.GetAllocatedSize();
+	for (const FBrick& Brick : Bricks)
+		Bytes += Brick.Samples.GetAllocatedSize();
+	return Bytes;
+}
+
+void FTerrainDensityStorage::UpdateQuantizationStep(float MaxAbs)
+{
+	const int32 MaxQuantized = GetMaxQuantized(Encoding);
+	if (MaxQuantized == 0)
+	{
+		QuantizationStep = 1.0f;
+		return;
+	}
+
+	const float Range = RequestedRange > 0.0f ? RequestedRange : MaxAbs;
+	QuantizationStep = FMath::Max(Range / MaxQuantized, KINDA_SMALL_NUMBER);
+}
+
+float FTerrainDensityStorage::Quantize(float Value) const
+{
+	const int32 MaxQuantized = GetMaxQuantized(Encoding);
+	if (MaxQuantized == 0)
+		return Value;
+
+	return FMath::Clamp(FMath::RoundToInt(Value / QuantizationStep), -MaxQuantized, MaxQuantized) * QuantizationStep;
+}
+
+float FTerrainDensityStorage::LoadSample(const uint8* Sample) const
+{
+	switch (Encoding)
+	{
+	case ETerrainDensityEncoding::Quantized16: return *reinterpret_cast<const int16*>(Sample) * QuantizationStep;
+	case ETerrainDensityEncoding::Quantized8:  return *reinterpret_cast<const int8*>(Sample) * QuantizationStep;
+	default:                                   return *reinterpret_cast<const float*>(Sample);
+	}
+}
+
+void FTerrainDensityStorage::StoreSample(uint8* Sample, float Value) const
+{
+	const int32 MaxQuantized = GetMaxQuantized(Encoding);
+	const int32 Quantized = MaxQuantized > 0
+		? FMath::Clamp(FMath::RoundToInt(Value / QuantizationStep), -MaxQuantized, MaxQuantized)
+		: 0;
+
+	switch (Encoding)
+	{
+	case ETerrainDensityEncoding::Quantized16: *reinterpret_cast<int16*>(Sample) = static_cast<int16>(Quantized); break;
+	case ETerrainDensityEncoding::Quantized8:  *reinterpret_cast<int8*>(Sample)  = static_cast<int8>(Quantized);  break;
+	default:                                   FMemory::Memcpy(Sample, &Value, sizeof(float));                 break;
+	}
+}
+
+void FTerrainDensityStorage::CompactBrick(int32 Bx, int32 By, int32 Bz)
+{
+	FBrick& Brick = Bricks[Bx + By * BricksPerAxis + Bz * BricksPerAxis * BricksPerAxis];
+	if (Brick.Samples.Num() == 0)
+		return;
+
+	const int32 X0 = Bx * BrickSize, Y0 = By * BrickSize, Z0 = Bz * BrickSize;
+	const int32 X1 = FMath::Min(X0 + BrickSize, Size), Y1 = FMath::Min(Y0 + BrickSize, Size), Z1 = FMath::Min(Z0 + BrickSize, Size);
+
+	// Only the voxels inside the field count; the padding of border bricks is never read.
+	const uint8* First = &Brick.Samples[GetSampleIndex(X0, Y0, Z0) * BytesPerSample];
+	bool bUniform = true;
+	float Min = MAX_flt, Max = -MAX_flt;
+	for (int32 z = Z0; z < Z1; z++)
+	for (int32 y = Y0; y < Y1; y++)
+	for (int32 x = X0; x < X1; x++)
+	{
+		const uint8* Sample = &Brick.Samples[GetSampleIndex(x, y, z) * BytesPerSample];
+		bUniform = bUniform && FMemory::Memcmp(Sample, First, BytesPerSample) == 0;
+
+		const float Value = LoadSample(Sample);
+		Min = FMath::Min(Min, Value);
+		Max = FMath::Max(Max, Value);
+	}
+
+	Brick.Min = Min;
+	Brick.Max = Max;
+	if (!bUniform)
+		return;
+
+	Brick.Value = LoadSample(First);
+	Brick.Samples.Empty();
+}
+
+void FTerrainDensityStorage::CompactField()
+{
+	if (Bricks.Num() == 0)
+		return;
+
+	const float First = Bricks[0].Value;
+	for (const FBrick& Brick : Bricks)
+	{
+		if (Brick.Samples.Num() > 0 || Brick.Value != First)
+			return;
+	}
+
+	UniformValue = First;
+	Bricks.Empty();
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainChunkFormat.h"
+
+/**
+ * FTerrainDensityStorage
+ *
+ * Size³ density field stored as BrickSize³ bricks allocated on demand. A brick whose samples all
+ * share the same value only keeps that value, and a field made of a single value keeps no brick
+ * at all, so chunks that are entirely in the air or entirely buried cost a few bytes.
+ *
+ * Samples are kept as floats or, with a quantized encoding, as 16 / 8-bit integers times a per-chunk
+ * step; values written to a quantized field are rounded to that step and clamped to its range.
+ *
+ * Coordinates follow the dense layout used everywhere else (x + y * Size + z * Size * Size);
+ * ToDense() / ToDenseSamples() expand the field into flat buffers for persistence and meshing.
+ */
+class DESTRUCTIONTERRAIN_API FTerrainDensityStorage
+{
+public:
+	/** Voxels per side of a brick. */
+	static constexpr int32 BrickSize = 8;
+
+	/** Releases every sample (IsEmpty() becomes true). The encoding is kept. */
+	void Reset();
+
+	/**
+	 * Sets how samples are stored; existing samples are re-encoded.
+	 * @param InEncoding - Floats, or 16 / 8-bit quantized samples.
+	 * @param Range - Largest magnitude a quantized sample can hold (the per-chunk step is Range / max integer).
+	 *                When <= 0, the range is taken from the largest magnitude of the field, and later values past
+	 *                it are clamped: callers that edit the field give a range.
+	 */
+	void SetEncoding(ETerrainDensityEncoding InEncoding, float Range = 0.0f);
+
+	/** Fills a Size³ field with a single value. */
+	void InitUniform(int32 InSize, float Value);
+
+	/** Copies a dense Size³ field, collapsing uniform bricks (and the whole field if it is uniform). */
+	void SetFromDense(int32 InSize, const TArray<float>& Dense);
+
+	/** Expands the field into a dense Size³ buffer of floats. */
+	void ToDense(TArray<float>& OutDense) const;
+
+	/** Expands the field into a dense Size³ buffer of encoded samples (GetEncoding(), GetBytesPerSample() each). */
+	void ToDenseSamples(TArray<uint8>& OutSamples) const;
+
+	int32 GetSize() const { return Size; }
+	int32 Num() const { return Size * Size * Size; }
+	bool IsEmpty() const { return Size == 0; }
+
+	ETerrainDensityEncoding GetEncoding() const { return Encoding; }
+	int32 GetBytesPerSample() const { return BytesPerSample; }
+
+	/** Value of one quantization unit (1 for Float32). */
+	float GetQuantizationStep() const { return QuantizationStep; }
+
+	/** True if the whole field holds a single value (see GetUniformValue()). */
+	bool IsUniform() const { return Size > 0 && Bricks.Num() == 0; }
+	float GetUniformValue() const { return UniformValue; }
+
+	/**
+	 * Returns false when the field cannot produce any surface at IsoLevel: every brick is uniform and
+	 * all of them lie on the same side of the iso-level. Such chunks can skip meshing entirely.
+	 */
+	bool CanContainSurface(float IsoLevel) const;
+
+	float Get(int32 X, int32 Y, int32 Z) const;
+
+	/** Writes a sample, allocating its brick if it was uniform. */
+	void Set(int32 X, int32 Y, int32 Z, float Value);
+
+	/** Collapses the bricks overlapping [VoxelMin, VoxelMax] that became uniform, then the whole field if possible. */
+	void Compact(const FIntVector& VoxelMin, const FIntVector& VoxelMax);
+
+	/** Number of cell bricks along each axis: cell brick B covers the cells [B * BrickSize, (B + 1) * BrickSize). */
+	int32 GetNumCellBricksPerAxis() const { return Size > 1 ? FMath::DivideAndRoundUp(Size - 1, BrickSize) : 0; }
+
+	/**
+	 * Flags the cell bricks whose cells may cross IsoLevel, from the value ranges of the bricks they read
+	 * (their own and the next one on each axis). Indexed bx + by * N + bz * N * N, N = GetNumCellBricksPerAxis().
+	 * Conservative: a flagged brick may still be empty, an unflagged one never produces a triangle.
+	 * @return Number of flagged cell bricks.
+	 */
+	int32 GetActiveCellBricks(float IsoLevel, TArray<uint8>& OutActive) const;
+
+	/** Number of bricks: brick Bx + By * N + Bz * N * N covers the voxels [B * BrickSize, (B + 1) * BrickSize). */
+	int32 GetNumBricks() const { return BricksPerAxis * BricksPerAxis * BricksPerAxis; }
+
+	/** Copies one brick into BrickSize³ floats (x + y * BrickSize + z * BrickSize²); voxels outside the field read 0. */
+	void GetBrickSamples(int32 BrickIndex, float* OutSamples) const;
+
+	/** Writes the in-field voxels of one brick from BrickSize³ floats (layout of GetBrickSamples()), then compacts it. */
+	void SetBrickSamples(int32 BrickIndex, const float* Samples);
+
+	/** True if no in-field voxel of the brick differs from the same voxel of Other (same size) by more than Tolerance. */
+	bool IsBrickEqual(int32 BrickIndex, const FTerrainDensityStorage& Other, float Tolerance) const;
+
+	/**
+	 * Hash of the sample values (not of how they are stored: a uniform brick hashes like its expanded samples).
+	 * Keys the meshes cached in chunk saves.
+	 */
+	uint32 GetContentHash() const;
+
+	/** Heap memory used by the samples, in bytes. */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FBrick
+	{
+		/** BrickSize³ encoded samples, or empty when every voxel of the brick equals Value. */
+		TArray<uint8> Samples;
+		float Value = 0.0f;
+
+		/** Range of the in-field samples: exact after SetFromDense() / Compact(), widened by Set(). */
+		float Min = 0.0f;
+		float Max = 0.0f;
+	};
+
+	int32 GetBrickIndex(int32 X, int32 Y, int32 Z) const
+	{
+		return X / BrickSize + (Y / BrickSize) * BricksPerAxis + (Z / BrickSize) * BricksPerAxis * BricksPerAxis;
+	}
+
+	static int32 GetSampleIndex(int32 X, int32 Y, int32 Z)
+	{
+		return X % BrickSize + (Y % BrickSize) * BrickSize + (Z % BrickSize) * BrickSize * BrickSize;
+	}
+
+	/** Recomputes QuantizationStep from RequestedRange, or from MaxAbs when no range was requested. */
+	void UpdateQuantizationStep(float MaxAbs);
+
+	/** Rounds a value to what the current encoding can represent. */
+	float Quantize(float Value) const;
+
+	float LoadSample(const uint8* Sample) const;
+	void StoreSample(uint8* Sample, float Value) const;
+
+	/** Collapses one brick if all of its in-range voxels are equal, and recomputes its range otherwise. */
+	void CompactBrick(int32 Bx, int32 By, int32 Bz);
+
+	/** Collapses the field to UniformValue if all bricks are uniform with the same value. */
+	void CompactField();
+
+	int32 Size = 0;
+	int32 BricksPerAxis = 0;
+
+	ETerrainDensityEncoding Encoding = ETerrainDensityEncoding::Float32;
+	int32 BytesPerSample = sizeof(float);
+	float QuantizationStep = 1.0f;
+
+	/** Fixed quantization range requested by SetEncoding() (0 = derived from the data). */
+	float RequestedRange = 0.0f;
+
+	/** Value of every voxel while the field is uniform (Bricks is empty). */
+	float UniformValue = 0.0f;
+
+	TArray<FBrick> Bricks;
+};
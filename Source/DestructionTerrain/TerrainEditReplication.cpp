@@ -0,0 +1,329 @@
+#include "TerrainEditReplication.h"
+#include "DestructionTerrain.h"
+#include "ProceduralTerrainWorld.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	/** Writes a length as a packed integer of PositionStep steps (zigzag: small magnitudes take fewer bytes); reads it back quantized. */
+	void SerializeLength(FArchive& Ar, double& Value)
+	{
+		uint32 Packed = 0;
+		if (Ar.IsSaving())
+		{
+			const double Steps = FMath::RoundToDouble(Value / FTerrainEditCommand::PositionStep);
+			const int32 Quantized = static_cast<int32>(FMath::Clamp(Steps, static_cast<double>(MIN_int32), static_cast<double>(MAX_int32)));
+			Packed = (static_cast<uint32>(Quantized) << 1) ^ static_cast<uint32>(Quantized >> 31);
+		}
+
+		Ar.SerializeIntPacked(Packed);
+
+		if (Ar.IsLoading())
+		{
+			const int32 Quantized = static_cast<int32>(Packed >> 1) ^ -static_cast<int32>(Packed & 1);
+			Value = Quantized * FTerrainEditCommand::PositionStep;
+		}
+	}
+
+	void SerializeLength(FArchive& Ar, float& Value)
+	{
+		double Length = Value;
+		SerializeLength(Ar, Length);
+		Value = static_cast<float>(Length);
+	}
+
+	void SerializeVector(FArchive& Ar, FVector& Value)
+	{
+		SerializeLength(Ar, Value.X);
+		SerializeLength(Ar, Value.Y);
+		SerializeLength(Ar, Value.Z);
+	}
+}
+
+//────────────────────────────
+// Edit Command
+//────────────────────────────
+
+FTerrainEditCommand FTerrainEditCommand::Make(const FTerrainBrush& Brush, uint32 Sequence)
+{
+	FTerrainEditCommand Command;
+	Command.Brush = Brush;
+	Command.Sequence = Sequence;
+
+	// Round trip through the wire format: the sender applies exactly what the receivers decode.
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	bool bSuccess = true;
+	Command.NetSerialize(Writer, nullptr, bSuccess);
+
+	FTerrainEditCommand Quantized;
+	FMemoryReader Reader(Bytes);
+	Quantized.NetSerialize(Reader, nullptr, bSuccess);
+	return Quantized;
+}
+
+bool FTerrainEditCommand::IsValid(float MaxSize, float MaxStrength) const
+{
+	if (Brush.Start.ContainsNaN() || Brush.End.ContainsNaN() || Brush.Extent.ContainsNaN()
+		|| !FMath::IsFinite(Brush.Radius) || !FMath::IsFinite(Brush.Strength))
+	{
+		return false;
+	}
+
+	// Smooth and Flatten clamp their blend factor to [0, 1] themselves.
+	if (Brush.Operation == ETerrainBrushOperation::Add && FMath::Abs(Brush.Strength) > MaxStrength)
+		return false;
+
+	switch (Brush.Shape)
+	{
+	case ETerrainBrushShape::Box:
+		return Brush.Extent.GetAbsMax() <= MaxSize;
+	case ETerrainBrushShape::Capsule:
+		return Brush.Radius <= MaxSize && FVector::Dist(Brush.Start, Brush.End) <= MaxSize;
+	default:
+		return Brush.Radius <= MaxSize;
+	}
+}
+
+bool FTerrainEditCommand::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 ShapeAndOperation = static_cast<uint8>(Brush.Shape) | static_cast<uint8>(Brush.Operation) << 4;
+	Ar << ShapeAndOperation;
+	Ar.SerializeIntPacked(Sequence);
+
+	if (Ar.IsLoading())
+	{
+		const uint8 Shape = ShapeAndOperation & 0x0F;
+		const uint8 Operation = ShapeAndOperation >> 4;
+		if (Shape > static_cast<uint8>(ETerrainBrushShape::Capsule) || Operation > static_cast<uint8>(ETerrainBrushOperation::Flatten))
+		{
+			bOutSuccess = false;
+			return false;
+		}
+
+		// Fields the shape does not use keep their defaults, on the sender (see Make()) as on the receivers.
+		Brush = FTerrainBrush();
+		Brush.Shape = static_cast<ETerrainBrushShape>(Shape);
+		Brush.Operation = static_cast<ETerrainBrushOperation>(Operation);
+	}
+
+	SerializeVector(Ar, Brush.Start);
+	if (Brush.Shape == ETerrainBrushShape::Capsule)
+		SerializeVector(Ar, Brush.End);
+	if (Brush.Shape == ETerrainBrushShape::Box)
+		SerializeVector(Ar, Brush.Extent);
+	else
+		SerializeLength(Ar, Brush.Radius);
+	Ar << Brush.Strength;
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+//────────────────────────────
+// Edit Component
+//────────────────────────────
+
+UTerrainEditComponent::UTerrainEditComponent()
+{
+	// Only ticks while a snapshot is deferred or being sent.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	SetIsReplicatedByDefault(true);
+}
+
+UTerrainEditComponent* UTerrainEditComponent::FindOrAdd(APlayerController* PlayerController)
+{
+	if (!PlayerController)
+		return nullptr;
+
+	if (UTerrainEditComponent* Existing = PlayerController->FindComponentByClass<UTerrainEditComponent>())
+		return Existing;
+
+	UTerrainEditComponent* Component = NewObject<UTerrainEditComponent>(PlayerController);
+	PlayerController->AddInstanceComponent(Component);
+	Component->RegisterComponent();
+	return Component;
+}
+
+UTerrainEditComponent* UTerrainEditComponent::FindLocal(const UWorld* World)
+{
+	const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+	return PlayerController ? PlayerController->FindComponentByClass<UTerrainEditComponent>() : nullptr;
+}
+
+void UTerrainEditComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// The controller of a client is replicated after the level's terrain worlds began play: they ask for their snapshot now.
+	const APlayerController* PlayerController = Cast<APlayerController>(GetOwner());
+	if (PlayerController && PlayerController->IsLocalController() && GetNetMode() == NM_Client)
+	{
+		for (TActorIterator<AProceduralTerrainWorld> It(GetWorld()); It; ++It)
+			It->RequestNetSnapshot(this);
+	}
+}
+
+void UTerrainEditComponent::SendBrush(AProceduralTerrainWorld* Terrain, const FTerrainBrush& Brush)
+{
+	ServerApplyBrush(Terrain, FTerrainEditCommand::Make(Brush, 0));
+}
+
+void UTerrainEditComponent::RequestSnapshot(AProceduralTerrainWorld* Terrain)
+{
+	ServerRequestSnapshot(Terrain);
+}
+
+void UTerrainEditComponent::ServerApplyBrush_Implementation(AProceduralTerrainWorld* Terrain, const FTerrainEditCommand& Command)
+{
+	if (Terrain)
+		Terrain->CommitClientEdit(Command);
+}
+
+void UTerrainEditComponent::ServerRequestSnapshot_Implementation(AProceduralTerrainWorld* Terrain)
+{
+	if (Terrain)
+		StartSnapshot(Terrain);
+}
+
+//────────────────────────────
+// Snapshot Transfer
+//────────────────────────────
+
+void UTerrainEditComponent::StartSnapshot(AProceduralTerrainWorld* Terrain)
+{
+	// A client asks again only once its snapshot has completely arrived.
+	if (IsSnapshotPending(Terrain))
+	{
+		UE_LOG(LogDestructionTerrain, Verbose, TEXT("Ignoring terrain snapshot request of %s: one is already on its way."),
+			*GetNameSafe(GetOwner()));
+		return;
+	}
+
+	PreparingSnapshots.RemoveAll([](const TWeakObjectPtr<AProceduralTerrainWorld>& Preparing) { return !Preparing.IsValid(); });
+	if (PreparingSnapshots.Num() + DeferredSnapshots.Num() + OutgoingSnapshots.Num() >= MaxQueuedSnapshots)
+	{
+		UE_LOG(LogDestructionTerrain, Warning, TEXT("Ignoring terrain snapshot request of %s: %d snapshots already queued."),
+			*GetNameSafe(GetOwner()), MaxQueuedSnapshots);
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (Now < NextSnapshotTime)
+	{
+		DeferredSnapshots.Add(Terrain);
+		SetComponentTickEnabled(true);
+		return;
+	}
+
+	NextSnapshotTime = Now + MinSnapshotInterval;
+	PreparingSnapshots.Add(Terrain);
+	Terrain->SendNetSnapshot(this);
+}
+
+bool UTerrainEditComponent::IsSnapshotPending(const AProceduralTerrainWorld* Terrain) const
+{
+	return PreparingSnapshots.Contains(Terrain) || DeferredSnapshots.Contains(Terrain)
+		|| OutgoingSnapshots.ContainsByPredicate([Terrain](const FOutgoingSnapshot& Snapshot) { return Snapshot.Terrain.Get() == Terrain; });
+}
+
+void UTerrainEditComponent::QueueSnapshot(AProceduralTerrainWorld* Terrain, uint32 Sequence, TArray<TPair<FIntVector, TArray<uint8>>>&& ChunkSaves)
+{
+	PreparingSnapshots.Remove(Terrain);
+
+	FOutgoingSnapshot& Snapshot = OutgoingSnapshots.AddDefaulted_GetRef();
+	Snapshot.Terrain = Terrain;
+	Snapshot.Sequence = Sequence;
+	Snapshot.ChunkSaves = MoveTemp(ChunkSaves);
+
+	SetComponentTickEnabled(true);
+}
+
+void UTerrainEditComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Deferred requests are served one per MinSnapshotInterval.
+	while (DeferredSnapshots.Num() > 0 && GetWorld()->GetTimeSeconds() >= NextSnapshotTime)
+	{
+		TWeakObjectPtr<AProceduralTerrainWorld> Deferred = DeferredSnapshots[0];
+		DeferredSnapshots.RemoveAt(0);
+		if (AProceduralTerrainWorld* Terrain = Deferred.Get())
+			StartSnapshot(Terrain);
+	}
+
+	SendAllowance = FMath::Min(SendAllowance + DeltaTime * SnapshotBytesPerSecond, static_cast<double>(SnapshotBytesPerSecond));
+
+	while (SendAllowance > 0.0 && OutgoingSnapshots.Num() > 0)
+	{
+		FOutgoingSnapshot& Snapshot = OutgoingSnapshots[0];
+		AProceduralTerrainWorld* Terrain = Snapshot.Terrain.Get();
+		if (!Terrain || (Snapshot.bStarted && Snapshot.NextChunk >= Snapshot.ChunkSaves.Num()))
+		{
+			OutgoingSnapshots.RemoveAt(0);
+			continue;
+		}
+
+		if (!Snapshot.bStarted)
+		{
+			ClientBeginSnapshot(Terrain, Snapshot.Sequence, Snapshot.ChunkSaves.Num());
+			Snapshot.bStarted = true;
+			if (Snapshot.ChunkSaves.IsEmpty())
+				OutgoingSnapshots.RemoveAt(0);
+			continue;
+		}
+
+		// A chunk back to its procedural density is sent as a single empty part.
+		const TPair<FIntVector, TArray<uint8>>& ChunkSave = Snapshot.ChunkSaves[Snapshot.NextChunk];
+		const int32 PartBytes = FMath::Min(SnapshotPartBytes, ChunkSave.Value.Num() - Snapshot.NextByte);
+		const TArray<uint8> Part(ChunkSave.Value.GetData() + Snapshot.NextByte, PartBytes);
+		ClientReceiveSnapshotPart(Terrain, ChunkSave.Key, ChunkSave.Value.Num(), Part);
+
+		SendAllowance -= PartBytes + sizeof(FIntVector);
+		Snapshot.NextByte += PartBytes;
+		if (Snapshot.NextByte >= ChunkSave.Value.Num())
+		{
+			Snapshot.NextChunk++;
+			Snapshot.NextByte = 0;
+		}
+
+		// Sent: the client may ask for the next one as soon as this one has arrived.
+		if (Snapshot.NextChunk >= Snapshot.ChunkSaves.Num())
+			OutgoingSnapshots.RemoveAt(0);
+	}
+
+	if (OutgoingSnapshots.IsEmpty() && DeferredSnapshots.IsEmpty())
+		SetComponentTickEnabled(false);
+}
+
+void UTerrainEditComponent::ClientBeginSnapshot_Implementation(AProceduralTerrainWorld* Terrain, uint32 Sequence, int32 NumChunks)
+{
+	if (Terrain)
+		Terrain->BeginNetSnapshot(Sequence, NumChunks);
+}
+
+void UTerrainEditComponent::ClientReceiveSnapshotPart_Implementation(AProceduralTerrainWorld* Terrain, FIntVector Coords, int32 TotalBytes,
+	const TArray<uint8>& Part)
+{
+	if (IncomingTerrain.Get() != Terrain || IncomingCoords != Coords)
+	{
+		IncomingTerrain = Terrain;
+		IncomingCoords = Coords;
+		IncomingBytes.Reset(TotalBytes);
+	}
+
+	IncomingBytes.Append(Part);
+	if (IncomingBytes.Num() < TotalBytes)
+		return;
+
+	IncomingTerrain.Reset();
+	if (Terrain)
+		Terrain->ReceiveNetSnapshotChunk(Coords, MoveTemp(IncomingBytes));
+	IncomingBytes.Reset();
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TerrainBrush.h"
+#include "TerrainEditReplication.generated.h"
+
+class AProceduralTerrainWorld;
+class APlayerController;
+
+/**
+ * FTerrainEditCommand
+ *
+ * One terrain edit as it travels between machines: a brush and its place in the server's edit order. Positions and
+ * lengths are quantized to PositionStep before the server applies the edit, and strengths sent as is, so that every
+ * machine evaluates the exact same brush (see TerrainBrush). A sphere dig takes about 20 bytes on the wire.
+ */
+USTRUCT()
+struct DESTRUCTIONTERRAIN_API FTerrainEditCommand
+{
+	GENERATED_BODY()
+
+	/** World units per step of the quantized positions and lengths. */
+	static constexpr double PositionStep = 0.1;
+
+	UPROPERTY()
+	FTerrainBrush Brush;
+
+	/** Order of the edit on the server, from 1; 0 in the requests sent by clients. */
+	UPROPERTY()
+	uint32 Sequence = 0;
+
+	/** The command for Brush, quantized as it will be received; fields its shape does not use are cleared. */
+	static FTerrainEditCommand Make(const FTerrainBrush& Brush, uint32 Sequence);
+
+	/**
+	 * False if Brush holds non-finite values, if a radius, extent or stroke is longer than MaxSize (world units), or if
+	 * an Add brush adds or removes more than MaxStrength.
+	 */
+	bool IsValid(float MaxSize, float MaxStrength) const;
+
+	/** Shape and operation in one byte, then only the fields of the shape, quantized to packed integers. */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FTerrainEditCommand> : public TStructOpsTypeTraitsBase2<FTerrainEditCommand>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ * UTerrainEditComponent
+ *
+ * Network link between a player controller and the terrain worlds. Only the owner of an actor may call its server
+ * RPCs, so clients send their edits through this component, and receive through it the snapshot of the chunks
+ * edited before they joined. Live edits are multicast by the terrain world itself (see AProceduralTerrainWorld::ApplyBrush()).
+ *
+ * Added on the server to every player controller that logs in, unless it already has one (e.g. from its blueprint).
+ */
+UCLASS(ClassGroup = (Terrain), meta = (BlueprintSpawnableComponent))
+class DESTRUCTIONTERRAIN_API UTerrainEditComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTerrainEditComponent();
+
+	/** Server: returns the edit component of a player controller, adding it if needed. */
+	static UTerrainEditComponent* FindOrAdd(APlayerController* PlayerController);
+
+	/** The edit component of the first local player controller of World, or nullptr. */
+	static UTerrainEditComponent* FindLocal(const UWorld* World);
+
+	/** Client: asks the server to apply Brush to Terrain. */
+	void SendBrush(AProceduralTerrainWorld* Terrain, const FTerrainBrush& Brush);
+
+	/** Client: asks the server for the snapshot of the chunks Terrain has edited (one at a time, see MinSnapshotInterval). */
+	void RequestSnapshot(AProceduralTerrainWorld* Terrain);
+
+	/**
+	 * Server: queues a snapshot for this client, sent over the next ticks within SnapshotBytesPerSecond.
+	 * @param Sequence - Last edit included in the chunks.
+	 * @param ChunkSaves - Save blob of each chunk (see UProceduralTerrain::SaveDeltaTo()); empty for a chunk back to its procedural density.
+	 */
+	void QueueSnapshot(AProceduralTerrainWorld* Terrain, uint32 Sequence, TArray<TPair<FIntVector, TArray<uint8>>>&& ChunkSaves);
+
+	/** Snapshot bytes sent per second to this client; reliable RPCs beyond what the connection can carry would pile up. */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Replication", meta = (ClampMin = "1024"))
+	int32 SnapshotBytesPerSecond = 64 * 1024;
+
+	/** Largest part of a chunk save sent in one RPC (a whole save may exceed the size of a bunch). */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Replication", meta = (ClampMin = "256", ClampMax = "32768"))
+	int32 SnapshotPartBytes = 8 * 1024;
+
+	/**
+	 * Seconds between two snapshots prepared for this client (each one saves and reads every edited chunk); a request
+	 * arriving sooner is served once they have elapsed.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Terrain|Replication", meta = (ClampMin = "0.0"))
+	float MinSnapshotInterval = 2.0f;
+
+	/** Snapshots prepared, queued or deferred for this client at once; further requests are ignored. */
+	static constexpr int32 MaxQueuedSnapshots = 8;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	UFUNCTION(Server, Reliable)
+	void ServerApplyBrush(AProceduralTerrainWorld* Terrain, const FTerrainEditCommand& Command);
+
+	UFUNCTION(Server, Reliable)
+	void ServerRequestSnapshot(AProceduralTerrainWorld* Terrain);
+
+	UFUNCTION(Client, Reliable)
+	void ClientBeginSnapshot(AProceduralTerrainWorld* Terrain, uint32 Sequence, int32 NumChunks);
+
+	/** One part of a chunk save; parts arrive in order, and the chunk is complete once TotalBytes have arrived. */
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveSnapshotPart(AProceduralTerrainWorld* Terrain, FIntVector Coords, int32 TotalBytes, const TArray<uint8>& Part);
+
+private:
+	/** A snapshot waiting to be sent (server). */
+	struct FOutgoingSnapshot
+	{
+		TWeakObjectPtr<AProceduralTerrainWorld> Terrain;
+		uint32 Sequence = 0;
+		TArray<TPair<FIntVector, TArray<uint8>>> ChunkSaves;
+
+		bool bStarted = false;
+		int32 NextChunk = 0;
+		int32 NextByte = 0;
+	};
+
+	/**
+	 * Server: prepares a snapshot of Terrain for this client, or defers it until MinSnapshotInterval has elapsed.
+	 * Ignored while one of Terrain is already on its way, or once MaxQueuedSnapshots are.
+	 */
+	void StartSnapshot(AProceduralTerrainWorld* Terrain);
+
+	/** True if a snapshot of Terrain is being prepared, deferred or sent to this client. */
+	bool IsSnapshotPending(const AProceduralTerrainWorld* Terrain) const;
+
+	/** Terrain worlds gathering the chunks of a snapshot for this client (see AProceduralTerrainWorld::SendNetSnapshot()). */
+	TArray<TWeakObjectPtr<AProceduralTerrainWorld>> PreparingSnapshots;
+
+	/** Terrain worlds whose snapshot was requested before MinSnapshotInterval had elapsed, oldest first. */
+	TArray<TWeakObjectPtr<AProceduralTerrainWorld>> DeferredSnapshots;
+
+	/** World time from which the next snapshot may be prepared. */
+	double NextSnapshotTime = 0.0;
+
+	/** Snapshots to send, oldest first; one is sent completely before the next starts. */
+	TArray<FOutgoingSnapshot> OutgoingSnapshots;
+
+	/** Bytes that may be sent right away, refilled at SnapshotBytesPerSecond up to a second's worth. */
+	double SendAllowance = 0.0;
+
+	/** Chunk save being received (client). */
+	TWeakObjectPtr<AProceduralTerrainWorld> IncomingTerrain;
+	FIntVector IncomingCoords = FIntVector::ZeroValue;
+	TArray<uint8> IncomingBytes;
+};
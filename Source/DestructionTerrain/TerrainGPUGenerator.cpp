@@ -0,0 +1,298 @@
+#include "TerrainGPUGenerator.h"
+#include "DestructionTerrain.h"
+#include "MarchingCubesTables.h"
+#include "TerrainComputeShaders.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "GlobalShader.h"
+#include "Misc/App.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHIGPUReadback.h"
+#include <atomic>
+
+namespace
+{
+	/**
+	 * Triangles reserved per column of cells: a height field crosses each column a few times at most. Caves and
+	 * overhangs can exceed it; the chunk is then meshed on the CPU (see UProceduralTerrain::bGPUMeshOverflow).
+	 */
+	constexpr int32 MaxTrianglesPerColumn = 8;
+
+	/** GPU copies of one generation, polled from the game thread until the GPU has written them. */
+	struct FTerrainGPURequest
+	{
+		FTerrainGPUChunkDesc Desc;
+		TSharedRef<FTerrainGPUMesh, ESPMode::ThreadSafe> Mesh = MakeShared<FTerrainGPUMesh, ESPMode::ThreadSafe>();
+		TFunction<void(TSharedRef<FTerrainGPUReadback, ESPMode::ThreadSafe>)> OnReadback;
+
+		TUniquePtr<FRHIGPUBufferReadback> CounterReadback;
+		TUniquePtr<FRHIGPUBufferReadback> DensityReadback;
+		TUniquePtr<FRHIGPUBufferReadback> PositionReadback;
+
+		// A poll is queued on the render thread / the copies have been handed over.
+		std::atomic<bool> bPolling = false;
+		std::atomic<bool> bDone = false;
+	};
+
+	FIntVector GetGroupCount(int32 Count)
+	{
+		return FComputeShaderUtils::GetGroupCount(FIntVector(Count), TerrainComputeShaders::GroupSize);
+	}
+
+	/** Records the density, brush, march and draw-argument passes of a chunk, plus their readbacks. */
+	void AddChunkPasses(FRDGBuilder& GraphBuilder, FTerrainGPURequest& Request)
+	{
+		const FTerrainGPUChunkDesc& Desc = Request.Desc;
+		FTerrainGPUMesh& Mesh = *Request.Mesh;
+		FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+
+		RDG_EVENT_SCOPE(GraphBuilder, "TerrainChunkGPU");
+
+		const int32 FieldSize = Desc.Size + 2;
+		const int32 FieldCount = FieldSize * FieldSize * FieldSize;
+
+		// The tables are static data: the graph uploads them without copying.
+		const TConstArrayView<int32> Permutation = TerrainNoise::GetPermutationTable();
+		FRDGBufferRef PermutationBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("TerrainGPU.Permutation"),
+			sizeof(int32), Permutation.Num(), Permutation.GetData(), Permutation.Num() * sizeof(int32), ERDGInitialDataFlags::NoCopy);
+		FRDGBufferRef EdgeTableBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("TerrainGPU.EdgeTable"),
+			sizeof(int32), UE_ARRAY_COUNT(edgeTable), edgeTable, sizeof(edgeTable), ERDGInitialDataFlags::NoCopy);
+		FRDGBufferRef TriTableBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("TerrainGPU.TriTable"),
+			sizeof(int32), sizeof(triTable) / sizeof(int32), &triTable[0][0], sizeof(triTable), ERDGInitialDataFlags::NoCopy);
+
+		FRDGBufferRef DensityBuffer = GraphBuilder.CreateBuffer(
+			FRDGBufferDesc::CreateStructuredDesc(sizeof(float), FieldCount), TEXT("TerrainGPU.Density"));
+
+		// ─── Noise density, halo included ───
+		{
+			FTerrainDensityCS::FParameters* Parameters = GraphBuilder.AllocParameters<FTerrainDensityCS::FParameters>();
+			Parameters->NoiseOrigin   = FVector3f(Desc.Origin * Desc.NoiseScale);
+			Parameters->NoiseStep     = Desc.Scale * Desc.NoiseScale;
+			Parameters->FieldSize     = FieldSize;
+			Parameters->HeightBias    = Desc.HeightBias;
+			Parameters->NoiseStrength = Desc.NoiseStrength;
+			Parameters->Truncation    = Desc.Truncation;
+			Parameters->Octaves       = FMath::Max(Desc.Noise.Octaves, 1);
+			Parameters->Lacunarity    = Desc.Noise.Lacunarity;
+			Parameters->Gain          = Desc.Noise.Gain;
+			Parameters->Permutation   = GraphBuilder.CreateSRV(PermutationBuffer);
+			Parameters->OutDensity    = GraphBuilder.CreateUAV(DensityBuffer);
+
+			FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("TerrainDensity"),
+				TShaderMapRef<FTerrainDensityCS>(ShaderMap), Parameters, GetGroupCount(FieldSize));
+		}
+
+		// ─── Dig brushes, in order, each over its own box ───
+		for (const FTerrainGPUBrush& Brush : Desc.Brushes)
+		{
+			const FVector3f Center = Brush.Center + FVector3f(1.0f);
+			const FIntVector BoxMin(
+				FMath::Max(FMath::FloorToInt(Center.X - Brush.Radius), 0),
+				FMath::Max(FMath::FloorToInt(Center.Y - Brush.Radius), 0),
+				FMath::Max(FMath::FloorToInt(Center.Z - Brush.Radius), 0));
+			const FIntVector BoxMax(
+				FMath::Min(FMath::CeilToInt(Center.X + Brush.Radius), FieldSize - 1),
+				FMath::Min(FMath::CeilToInt(Center.Y + Brush.Radius), FieldSize - 1),
+				FMath::Min(FMath::CeilToInt(Center.Z + Brush.Radius), FieldSize - 1));
+			if (Brush.Radius <= 0.0f || BoxMin.X > BoxMax.X || BoxMin.Y > BoxMax.Y || BoxMin.Z > BoxMax.Z)
+				continue;
+
+			const FIntVector BoxSize = BoxMax - BoxMin + FIntVector(1);
+
+			FTerrainBrushCS::FParameters* Parameters = GraphBuilder.AllocParameters<FTerrainBrushCS::FParameters>();
+			Parameters->BoxMin        = BoxMin;
+			Parameters->BoxSize       = BoxSize;
+			Parameters->BrushCenter   = Center;
+			Parameters->BrushRadius   = Brush.Radius;
+			Parameters->BrushStrength = Brush.Strength;
+			Parameters->Truncation    = Desc.Truncation;
+			Parameters->FieldSize     = FieldSize;
+			Parameters->OutDensity    = GraphBuilder.CreateUAV(DensityBuffer);
+
+			FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("TerrainBrush"),
+				TShaderMapRef<FTerrainBrushCS>(ShaderMap), Parameters,
+				FComputeShaderUtils::GetGroupCount(BoxSize, TerrainComputeShaders::GroupSize));
+		}
+
+		// ─── Marching Cubes into the vertex buffers ───
+		const int32 MaxVertices = TerrainGPU::GetMaxVertices(Desc.Size);
+		Mesh.MaxVertices = MaxVertices;
+
+		FRDGBufferDesc PositionsDesc = FRDGBufferDesc::CreateBufferDesc(sizeof(float), MaxVertices * 3);
+		FRDGBufferDesc TangentsDesc  = FRDGBufferDesc::CreateBufferDesc(sizeof(uint32), MaxVertices * 2);
+		FRDGBufferDesc TexCoordsDesc = FRDGBufferDesc::CreateBufferDesc(sizeof(float), MaxVertices * 2);
+		PositionsDesc.Usage |= EBufferUsageFlags::VertexBuffer;
+		TangentsDesc.Usage  |= EBufferUsageFlags::VertexBuffer;
+		TexCoordsDesc.Usage |= EBufferUsageFlags::VertexBuffer;
+
+		FRDGBufferRef Positions = GraphBuilder.CreateBuffer(PositionsDesc, TEXT("TerrainGPU.Positions"));
+		FRDGBufferRef Tangents  = GraphBuilder.CreateBuffer(TangentsDesc, TEXT("TerrainGPU.Tangents"));
+		FRDGBufferRef TexCoords = GraphBuilder.CreateBuffer(TexCoordsDesc, TEXT("TerrainGPU.TexCoords"));
+		FRDGBufferRef Counter   = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(uint32), 1), TEXT("TerrainGPU.VertexCounter"));
+		FRDGBufferRef DrawArgs  = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateIndirectDesc<FRHIDrawIndirectParameters>(1), TEXT("TerrainGPU.DrawArgs"));
+
+		// Cells dropped on overflow leave whole triangles unwritten: cleared, they stay degenerate.
+		FRDGBufferUAVRef PositionsUAV = GraphBuilder.CreateUAV(Positions, PF_R32_FLOAT);
+		AddClearUAVPass(GraphBuilder, PositionsUAV, 0u);
+		AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(TexCoords, PF_R32_FLOAT), 0u);
+		AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(Counter), 0u);
+
+		{
+			FTerrainMarchCS::FParameters* Parameters = GraphBuilder.AllocParameters<FTerrainMarchCS::FParameters>();
+			Parameters->FieldSize     = FieldSize;
+			Parameters->Scale         = Desc.Scale;
+			Parameters->IsoLevel      = Desc.IsoLevel;
+			Parameters->MaxVertices   = MaxVertices;
+			Parameters->Density       = GraphBuilder.CreateSRV(DensityBuffer);
+			Parameters->EdgeTable     = GraphBuilder.CreateSRV(EdgeTableBuffer);
+			Parameters->TriTable      = GraphBuilder.CreateSRV(TriTableBuffer);
+			Parameters->VertexCounter = GraphBuilder.CreateUAV(Counter);
+			Parameters->OutPositions  = PositionsUAV;
+			Parameters->OutTangents   = GraphBuilder.CreateUAV(Tangents, PF_R32_UINT);
+
+			FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("TerrainMarch"),
+				TShaderMapRef<FTerrainMarchCS>(ShaderMap), Parameters, GetGroupCount(Desc.Size - 1));
+		}
+
+		{
+			FTerrainDrawArgsCS::FParameters* Parameters = GraphBuilder.AllocParameters<FTerrainDrawArgsCS::FParameters>();
+			Parameters->MaxVertices = MaxVertices;
+			Parameters->VertexCount = GraphBuilder.CreateSRV(Counter);
+			Parameters->OutDrawArgs = GraphBuilder.CreateUAV(DrawArgs, PF_R32_UINT);
+
+			FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("TerrainDrawArgs"),
+				TShaderMapRef<FTerrainDrawArgsCS>(ShaderMap), Parameters, FIntVector(1));
+		}
+
+		// ─── Readbacks: only what the CPU needs ───
+		Request.CounterReadback = MakeUnique<FRHIGPUBufferReadback>(TEXT("TerrainGPU.CounterReadback"));
+		AddEnqueueCopyPass(GraphBuilder, Request.CounterReadback.Get(), Counter, sizeof(uint32));
+
+		if (Desc.bReadbackDensity)
+		{
+			Request.DensityReadback = MakeUnique<FRHIGPUBufferReadback>(TEXT("TerrainGPU.DensityReadback"));
+			AddEnqueueCopyPass(GraphBuilder, Request.DensityReadback.Get(), DensityBuffer, FieldCount * sizeof(float));
+		}
+		if (Desc.bReadbackMesh)
+		{
+			Request.PositionReadback = MakeUnique<FRHIGPUBufferReadback>(TEXT("TerrainGPU.PositionReadback"));
+			AddEnqueueCopyPass(GraphBuilder, Request.PositionReadback.Get(), Positions, MaxVertices * 3 * sizeof(float));
+		}
+
+		// The renderer reads the extracted buffers as vertex streams and indirect arguments.
+		const ERHIAccess VertexAccess = ERHIAccess::VertexOrIndexBuffer | ERHIAccess::SRVMask;
+		GraphBuilder.QueueBufferExtraction(Positions, &Mesh.Positions, VertexAccess);
+		GraphBuilder.QueueBufferExtraction(Tangents, &Mesh.Tangents, VertexAccess);
+		GraphBuilder.QueueBufferExtraction(TexCoords, &Mesh.TexCoords, VertexAccess);
+		GraphBuilder.QueueBufferExtraction(DrawArgs, &Mesh.DrawArgs, ERHIAccess::IndirectArgs);
+	}
+
+	/** Render thread: if every copy has landed, moves them out and finishes the request on a worker. */
+	void PollRequest_RenderThread(const TSharedRef<FTerrainGPURequest, ESPMode::ThreadSafe>& Request)
+	{
+		const bool bReady = Request->CounterReadback->IsReady()
+			&& (!Request->DensityReadback || Request->DensityReadback->IsReady())
+			&& (!Request->PositionReadback || Request->PositionReadback->IsReady());
+		if (!bReady)
+			return;
+
+		const int32 Size = Request->Desc.Size;
+		const int32 FieldSize = Size + 2;
+		const int32 MaxVertices = Request->Mesh->MaxVertices;
+
+		TSharedRef<FTerrainGPUReadback, ESPMode::ThreadSafe> Readback = MakeShared<FTerrainGPUReadback, ESPMode::ThreadSafe>();
+		Readback->GPUMesh = Request->Mesh;
+
+		Readback->NumVertices = *static_cast<const uint32*>(Request->CounterReadback->Lock(sizeof(uint32)));
+		Request->CounterReadback->Unlock();
+
+		// Raw copies only on the render thread; cropping and index generation happen on the worker.
+		TArray<float> Field;
+		if (Request->DensityReadback)
+		{
+			Field.SetNumUninitialized(FieldSize * FieldSize * FieldSize);
+			FMemory::Memcpy(Field.GetData(), Request->DensityReadback->Lock(Field.Num() * sizeof(float)), Field.Num() * sizeof(float));
+			Request->DensityReadback->Unlock();
+		}
+
+		const int32 NumVertices = FMath::Min(static_cast<int32>(Readback->NumVertices), MaxVertices);
+		if (Request->PositionReadback && NumVertices > 0)
+		{
+			Readback->Mesh.Vertices.SetNumUninitialized(NumVertices);
+			FMemory::Memcpy(Readback->Mesh.Vertices.GetData(), Request->PositionReadback->Lock(NumVertices * sizeof(FVector3f)), NumVertices * sizeof(FVector3f));
+			Request->PositionReadback->Unlock();
+		}
+
+		Async(EAsyncExecution::ThreadPool, [Readback, Field = MoveTemp(Field), Size, MaxVertices, OnReadback = MoveTemp(Request->OnReadback)]()
+		{
+			const int32 FieldSize = Size + 2;
+			if (Field.Num() > 0)
+			{
+				Readback->Density.SetNumUninitialized(Size * Size * Size);
+				for (int32 z = 0; z < Size; z++)
+				for (int32 y = 0; y < Size; y++)
+				{
+					FMemory::Memcpy(&Readback->Density[y * Size + z * Size * Size],
+						&Field[1 + (y + 1) * FieldSize + (z + 1) * FieldSize * FieldSize], Size * sizeof(float));
+				}
+			}
+
+			// Non-indexed triangle list: triangle i uses vertices 3i .. 3i + 2.
+			FTerrainMeshData& Mesh = Readback->Mesh;
+			Mesh.Triangles.SetNumUninitialized(Mesh.Vertices.Num());
+			for (int32 i = 0; i < Mesh.Triangles.Num(); i++)
+				Mesh.Triangles[i] = i;
+
+			OnReadback(Readback);
+		});
+
+		Request->bDone = true;
+	}
+}
+
+bool TerrainGPU::IsSupported()
+{
+	return FApp::CanEverRender() && GMaxRHIFeatureLevel >= ERHIFeatureLevel::SM5;
+}
+
+int32 TerrainGPU::GetMaxVertices(int32 Size)
+{
+	const int32 Cells = FMath::Max(Size - 1, 1);
+	return 3 * MaxTrianglesPerColumn * Cells * Cells;
+}
+
+void TerrainGPU::GenerateChunk(const FTerrainGPUChunkDesc& Desc, TFunction<void(TSharedRef<FTerrainGPUReadback, ESPMode::ThreadSafe>)> OnReadback)
+{
+	check(IsInGameThread());
+	check(Desc.Size > 1);
+
+	TSharedRef<FTerrainGPURequest, ESPMode::ThreadSafe> Request = MakeShared<FTerrainGPURequest, ESPMode::ThreadSafe>();
+	Request->Desc = Desc;
+	Request->OnReadback = MoveTemp(OnReadback);
+
+	ENQUEUE_RENDER_COMMAND(GenerateTerrainChunkGPU)([Request](FRHICommandListImmediate& RHICmdList)
+	{
+		FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("TerrainChunkGPU"));
+		AddChunkPasses(GraphBuilder, *Request);
+		GraphBuilder.Execute();
+	});
+
+	// One poll in flight at a time, once per game frame: the copies are usually ready after a frame or two.
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Request](float)
+	{
+		if (Request->bDone)
+			return false;
+
+		if (!Request->bPolling.exchange(true))
+		{
+			ENQUEUE_RENDER_COMMAND(PollTerrainChunkGPU)([Request](FRHICommandListImmediate&)
+			{
+				PollRequest_RenderThread(Request);
+				Request->bPolling = false;
+			});
+		}
+		return true;
+	}));
+}
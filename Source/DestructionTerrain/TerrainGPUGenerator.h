@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphResources.h"
+#include "TerrainMesher.h"
+#include "TerrainNoise.h"
+
+/** One dig brush replayed by the GPU generation, in chunk voxel coordinates (same falloff as a CPU dig). */
+struct FTerrainGPUBrush
+{
+	FVector3f Center = FVector3f::ZeroVector;
+	float Radius = 0.0f;
+	float Strength = 0.0f;
+};
+
+/** Everything the GPU needs to build one chunk; captured by value on the game thread. */
+struct FTerrainGPUChunkDesc
+{
+	/** World location of chunk voxel 0. */
+	FVector Origin = FVector::ZeroVector;
+
+	int32 Size = 0;
+	float Scale = 1.0f;
+	float NoiseScale = 0.0f;
+	float HeightBias = 0.0f;
+	float NoiseStrength = 0.0f;
+	float Truncation = 0.0f;
+	float IsoLevel = 0.0f;
+	FTerrainNoiseSettings Noise;
+
+	/** Applied in order after the noise (the chunk's edit history). */
+	TArray<FTerrainGPUBrush> Brushes;
+
+	/** Copy the density back (first generation; remeshes after edits keep the CPU field the edits wrote). */
+	bool bReadbackDensity = true;
+
+	/** Also read the triangles back, to cook the chunk's collision. */
+	bool bReadbackMesh = false;
+};
+
+/**
+ * FTerrainGPUMesh
+ *
+ * Non-indexed triangle list of a chunk, written by the GPU straight into vertex buffers and drawn with
+ * DrawPrimitiveIndirect. The buffers are extracted from the generation graph on the render thread and
+ * are only read by render commands enqueued after it.
+ */
+class FTerrainGPUMesh
+{
+public:
+	/** Capacity of the vertex buffers (triangles beyond it are dropped, see FTerrainGPUReadback::NumVertices). */
+	int32 MaxVertices = 0;
+
+	/** float3 per vertex. */
+	TRefCountPtr<FRDGPooledBuffer> Positions;
+
+	/** TangentX, TangentZ (FPackedNormal) per vertex. */
+	TRefCountPtr<FRDGPooledBuffer> Tangents;
+
+	/** float2 per vertex, zero (the CPU meshes have no UVs either). */
+	TRefCountPtr<FRDGPooledBuffer> TexCoords;
+
+	/** FRHIDrawIndirectParameters. */
+	TRefCountPtr<FRDGPooledBuffer> DrawArgs;
+};
+
+/** Result of a GPU generation, once its copies have reached the CPU. */
+struct FTerrainGPUReadback
+{
+	TSharedPtr<FTerrainGPUMesh, ESPMode::ThreadSafe> GPUMesh;
+
+	/** Size³ samples without the halo (x + y * Size + z * Size * Size), only with FTerrainGPUChunkDesc::bReadbackDensity. */
+	TArray<float> Density;
+
+	/** Generated triangles (indices 0..N-1), only with FTerrainGPUChunkDesc::bReadbackMesh. */
+	FTerrainMeshData Mesh;
+
+	/** Vertices the march produced, including the ones dropped for lack of capacity. */
+	uint32 NumVertices = 0;
+};
+
+/**
+ * TerrainGPU
+ *
+ * Optional RDG pipeline generating chunks on the GPU: noise density (with a one-voxel halo), dig brushes,
+ * then Marching Cubes with the tables of MarchingCubesTables.h uploaded as buffers.
+ */
+namespace TerrainGPU
+{
+	/** True if the current RHI can run the pipeline (SM5 compute). */
+	DESTRUCTIONTERRAIN_API bool IsSupported();
+
+	/** Vertex capacity reserved for a chunk of Size voxels. */
+	DESTRUCTIONTERRAIN_API int32 GetMaxVertices(int32 Size);
+
+	/**
+	 * Enqueues the generation of a chunk (game thread). The vertex count, the density and the triangles (as requested)
+	 * are copied back without stalling the GPU; the chunk is handed over once they have landed, a few frames later,
+	 * so that what is drawn always matches the density the CPU edits.
+	 * @param OnReadback - Called on a worker thread with the GPU mesh and the copies.
+	 */
+	DESTRUCTIONTERRAIN_API void GenerateChunk(const FTerrainGPUChunkDesc& Desc,
+		TFunction<void(TSharedRef<FTerrainGPUReadback, ESPMode::ThreadSafe>)> OnReadback);
+}
@@ -0,0 +1,642 @@
+#include "TerrainMesher.h"
+#include "DestructionTerrain.h"
+#include "MarchingCubesTables.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
+
+namespace
+{
+	/** Smallest number of cell layers worth marching as a separate slab. */
+	constexpr int32 MinLayersPerSlab = 8;
+
+	/** Appends slab meshes in order into OutMesh, offsetting their triangle indices. */
+	void AppendSlabs(const TArray<FTerrainMeshData>& Slabs, FTerrainMeshData& OutMesh)
+	{
+		int32 NumVertices = 0;
+		int32 NumIndices = 0;
+		for (const FTerrainMeshData& Slab : Slabs)
+		{
+			NumVertices += Slab.Vertices.Num();
+			NumIndices += Slab.Triangles.Num();
+		}
+
+		OutMesh.Reset();
+		OutMesh.Vertices.Reserve(NumVertices);
+		OutMesh.Normals.Reserve(NumVertices);
+		OutMesh.Triangles.Reserve(NumIndices);
+
+		for (const FTerrainMeshData& Slab : Slabs)
+		{
+			const int32 BaseIndex = OutMesh.Vertices.Num();
+			OutMesh.Vertices.Append(Slab.Vertices);
+			OutMesh.Normals.Append(Slab.Normals);
+			for (int32 Index : Slab.Triangles)
+				OutMesh.Triangles.Add(BaseIndex + Index);
+		}
+	}
+	/** Dense quantized samples read back as floats (Density[Index] == Samples[Index] * Step). */
+	template <typename QuantizedType>
+	struct TQuantizedDensity
+	{
+		const QuantizedType* Samples;
+		float Step;
+
+		float operator[](int32 Index) const { return Samples[Index] * Step; }
+	};
+
+	/**
+	 * Marching Cubes over the cells [CellMin, InCellMax) of a dense Size³ field. DensityType is either a
+	 * TArray<float> or a TQuantizedDensity; the caller has checked that it holds Size³ samples.
+	 * Normals come from gradients evaluated lazily at the corners of surface cells. With bParallel, slabs of
+	 * cell layers are marched on worker threads.
+	 * With Stride > 1, cells span Stride voxels (cell coordinates are coarse, the last cell of an axis is
+	 * clamped to the border) and only the voxels at their corners are sampled.
+	 * Gradients read Halo outside of the field when it is given, and clamp to the border otherwise.
+	 * ActiveBricks (FTerrainDensityStorage::GetActiveCellBricks()) lets the walk jump over the cell bricks that
+	 * cannot cross the surface; it is ignored when Stride does not divide the brick size.
+	 */
+	template <typename DensityType>
+	bool ExtractRegionImpl(const DensityType& Density, int32 Size, float Scale, float IsoLevel,
+		bool bSharedVertices, const FIntVector& CellMin, const FIntVector& InCellMax, FTerrainMeshData& OutMesh,
+		TFunctionRef<bool()> ShouldCancel, bool bParallel, const FTerrainDensityHalo* Halo = nullptr, int32 Stride = 1,
+		const TArray<uint8>* ActiveBricks = nullptr)
+	{
+		OutMesh.Reset();
+
+		if (Size <= 1 || Stride < 1)
+			return false;
+
+		const int32 NumCells = FMath::DivideAndRoundUp(Size - 1, Stride);
+		const FIntVector CellMax(
+			FMath::Min(InCellMax.X, NumCells),
+			FMath::Min(InCellMax.Y, NumCells),
+			FMath::Min(InCellMax.Z, NumCells));
+
+		if (CellMin.X < 0 || CellMin.Y < 0 || CellMin.Z < 0
+			|| CellMin.X >= CellMax.X || CellMin.Y >= CellMax.Y || CellMin.Z >= CellMax.Z)
+			return true;
+
+		// A coarse cell lies in the brick of its lower corner as long as Stride divides the brick size.
+		constexpr int32 BrickSize = FTerrainDensityStorage::BrickSize;
+		const int32 NumCellBricks = FMath::DivideAndRoundUp(Size - 1, BrickSize);
+		const int32 CellsPerBrick = BrickSize / Stride;
+		const bool bSkipBricks = ActiveBricks && BrickSize % Stride == 0
+			&& ActiveBricks->Num() == NumCellBricks * NumCellBricks * NumCellBricks;
+
+		auto IsBrickActive = [&](int32 Bx, int32 By, int32 Bz)
+		{
+			return (*ActiveBricks)[Bx + By * NumCellBricks + Bz * NumCellBricks * NumCellBricks] != 0;
+		};
+
+		// Regions without any active brick are left empty before allocating their caches.
+		if (bSkipBricks)
+		{
+			const FIntVector BrickMin = CellMin / CellsPerBrick;
+			const FIntVector BrickMax = (CellMax - FIntVector(1)) / CellsPerBrick;
+			bool bAnyActive = false;
+			for (int32 Bz = BrickMin.Z; Bz <= BrickMax.Z && !bAnyActive; Bz++)
+			for (int32 By = BrickMin.Y; By <= BrickMax.Y && !bAnyActive; By++)
+			for (int32 Bx = BrickMin.X; Bx <= BrickMax.X && !bAnyActive; Bx++)
+				bAnyActive = IsBrickActive(Bx, By, Bz);
+
+			if (!bAnyActive)
+				return true;
+		}
+
+		auto GetIndex = [&](int32 x, int32 y, int32 z)
+		{
+			return x + y * Size + z * Size * Size;
+		};
+
+		auto SampleDensity = [&](int32 sx, int32 sy, int32 sz) -> float
+		{
+			float HaloValue;
+			if (Halo && (sx < 0 || sy < 0 || sz < 0 || sx >= Size || sy >= Size || sz >= Size)
+				&& Halo->Sample(sx, sy, sz, HaloValue))
+				return HaloValue;
+
+			return Density[GetIndex(
+				FMath::Clamp(sx, 0, Size - 1),
+				FMath::Clamp(sy, 0, Size - 1),
+				FMath::Clamp(sz, 0, Size - 1))];
+		};
+
+		const FIntVector VoxelDim = CellMax - CellMin + FIntVector(1);
+
+		// Voxel coordinate of a cell corner.
+		auto ToVoxel = [&](int32 c)
+		{
+			return FMath::Min(c * Stride, Size - 1);
+		};
+
+		// Central-difference gradient of a voxel (unnormalized, per world unit).
+		auto ComputeGradient = [&](int32 x, int32 y, int32 z)
+		{
+			float dx = SampleDensity(x + 1, y, z) - SampleDensity(x - 1, y, z);
+			float dy = SampleDensity(x, y + 1, z) - SampleDensity(x, y - 1, z);
+			float dz = SampleDensity(x, y, z + 1) - SampleDensity(x, y, z - 1);
+
+			FVector3f Gradient(dx, dy, dz);
+			if (!FMath::IsNearlyZero(Scale))
+			{
+				Gradient.X /= Scale;
+				Gradient.Y /= Scale;
+				Gradient.Z /= Scale;
+			}
+			return Gradient;
+		};
+
+		std::atomic<bool> bCancelled = false;
+
+		struct FVertexInterpResult
+		{
+			FVector3f Position;
+			FVector3f Normal;
+		};
+
+		auto VertexInterp = [&](const FVector3f& p1, const FVector3f& p2, float valp1, float valp2,
+		                        const FVector3f& n1, const FVector3f& n2)
+		{
+			if (FMath::Abs(IsoLevel - valp1) < KINDA_SMALL_NUMBER)
+				return FVertexInterpResult{p1, n1.GetSafeNormal()};
+			if (FMath::Abs(IsoLevel - valp2) < KINDA_SMALL_NUMBER)
+				return FVertexInterpResult{p2, n2.GetSafeNormal()};
+			if (FMath::Abs(valp1 - valp2) < KINDA_SMALL_NUMBER)
+				return FVertexInterpResult{p1, n1.GetSafeNormal()};
+
+			float mu = (IsoLevel - valp1) / (valp2 - valp1);
+
+			FVector3f Position = p1 + mu * (p2 - p1);
+			FVector3f Normal   = (n1 + mu * (n2 - n1));
+			if (!Normal.Normalize())
+			{
+				Normal = FVector3f::UpVector;
+			}
+
+			return FVertexInterpResult{Position, Normal};
+		};
+
+		static const int CornerOffsets[8][3] = {
+			{0, 0, 0},
+			{1, 0, 0},
+			{1, 1, 0},
+			{0, 1, 0},
+			{0, 0, 1},
+			{1, 0, 1},
+			{1, 1, 1},
+			{0, 1, 1}
+		};
+
+		// Corner pairs of each cube edge, ordered from the lower to the higher grid point so that
+		// the two cells sharing an edge interpolate it identically.
+		static const int EdgeCorners[12][2] = {
+			{0, 1}, {1, 2}, {3, 2}, {0, 3},
+			{4, 5}, {5, 6}, {7, 6}, {4, 7},
+			{0, 4}, {1, 5}, {2, 6}, {3, 7}
+		};
+
+		// Location of each cube edge in the edge caches: axis (0 = X, 1 = Y, 2 = Z),
+		// Z plane (0 = lower, 1 = upper; unused for Z edges) and X/Y offset of its lower grid point.
+		static const int EdgeSlots[12][4] = {
+			{0, 0, 0, 0}, {1, 0, 1, 0}, {0, 0, 0, 1}, {1, 0, 0, 0},
+			{0, 1, 0, 0}, {1, 1, 1, 0}, {0, 1, 0, 1}, {1, 1, 0, 0},
+			{2, 0, 0, 0}, {2, 0, 1, 0}, {2, 0, 1, 1}, {2, 0, 0, 1}
+		};
+
+		// Marches the cell layers [ZBegin, ZEnd) into Mesh, with its own edge and gradient caches.
+		auto MarchSlab = [&](int32 ZBegin, int32 ZEnd, FTerrainMeshData& Mesh)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_TerrainMarch);
+			TERRAIN_TRACE_SCOPE(March);
+
+			TArray<FVector3f>& Vertices  = Mesh.Vertices;
+			TArray<int32>&   Triangles = Mesh.Triangles;
+			TArray<FVector3f>& Normals   = Mesh.Normals;
+
+			// Edge-vertex caches for the indexed output: X / Y edges of the two Z planes bounding the
+			// current cell layer, and the Z edges crossing it. Entries are vertex indices or INDEX_NONE.
+			const int32 SliceCount = VoxelDim.X * VoxelDim.Y;
+			TArray<int32> XEdges[2];
+			TArray<int32> YEdges[2];
+			TArray<int32> ZEdges;
+			if (bSharedVertices)
+			{
+				for (int32 Plane = 0; Plane < 2; Plane++)
+				{
+					XEdges[Plane].Init(INDEX_NONE, SliceCount);
+					YEdges[Plane].Init(INDEX_NONE, SliceCount);
+				}
+				ZEdges.Init(INDEX_NONE, SliceCount);
+			}
+
+			// Normalized gradients of the two Z planes bounding the current cell layer, computed on first use:
+			// only the corners of cells crossing the iso-surface are ever evaluated.
+			TArray<FVector3f> PlaneGradients[2];
+			TArray<uint8>   PlaneGradientReady[2];
+			for (int32 Plane = 0; Plane < 2; Plane++)
+			{
+				PlaneGradients[Plane].SetNumUninitialized(SliceCount);
+				PlaneGradientReady[Plane].SetNumZeroed(SliceCount);
+			}
+			int32 NumGradients = 0;
+
+			for (int32 z = ZBegin; z < ZEnd; z++)
+			{
+				if (ShouldCancel())
+					return false;
+
+				// Plane z lives in cache ((z - ZBegin) & 1); the other cache still holds plane z - 1 and becomes plane z + 1.
+				const int32 LowerPlane = (z - ZBegin) & 1;
+				const int32 UpperPlane = LowerPlane ^ 1;
+				if (bSharedVertices && z > ZBegin)
+				{
+					FMemory::Memset(XEdges[UpperPlane].GetData(), 0xFF, SliceCount * sizeof(int32));
+					FMemory::Memset(YEdges[UpperPlane].GetData(), 0xFF, SliceCount * sizeof(int32));
+					FMemory::Memset(ZEdges.GetData(), 0xFF, SliceCount * sizeof(int32));
+				}
+				if (z > ZBegin)
+				{
+					FMemory::Memzero(PlaneGradientReady[UpperPlane].GetData(), SliceCount);
+				}
+
+				for (int32 y = CellMin.Y; y < CellMax.Y; y++)
+				for (int32 x = CellMin.X; x < CellMax.X; x++)
+				{
+					// Cells of an inactive brick have all their corners on the same side: jump to the next brick.
+					if (bSkipBricks && !IsBrickActive(x / CellsPerBrick, y / CellsPerBrick, z / CellsPerBrick))
+					{
+						x = (x / CellsPerBrick + 1) * CellsPerBrick - 1;
+						continue;
+					}
+
+					float val[8];
+					for (int i = 0; i < 8; i++)
+					{
+						val[i] = Density[GetIndex(ToVoxel(x + CornerOffsets[i][0]), ToVoxel(y + CornerOffsets[i][1]), ToVoxel(z + CornerOffsets[i][2]))];
+					}
+
+					int cubeIndex = 0;
+					if (val[0] < IsoLevel) cubeIndex |= 1;
+					if (val[1] < IsoLevel) cubeIndex |= 2;
+					if (val[2] < IsoLevel) cubeIndex |= 4;
+					if (val[3] < IsoLevel) cubeIndex |= 8;
+					if (val[4] < IsoLevel) cubeIndex |= 16;
+					if (val[5] < IsoLevel) cubeIndex |= 32;
+					if (val[6] < IsoLevel) cubeIndex |= 64;
+					if (val[7] < IsoLevel) cubeIndex |= 128;
+
+					if (edgeTable[cubeIndex] == 0)
+						continue;
+
+					FVector3f p[8];
+					FVector3f grad[8];
+					for (int i = 0; i < 8; i++)
+					{
+						const int dx = CornerOffsets[i][0];
+						const int dy = CornerOffsets[i][1];
+						const int dz = CornerOffsets[i][2];
+
+						const int32 vx = ToVoxel(x + dx);
+						const int32 vy = ToVoxel(y + dy);
+						const int32 vz = ToVoxel(z + dz);
+						p[i] = FVector3f(vx * Scale, vy * Scale, vz * Scale);
+
+						const int32 Plane = dz ? UpperPlane : LowerPlane;
+						const int32 PlaneIndex = (x + dx - CellMin.X) + (y + dy - CellMin.Y) * VoxelDim.X;
+						if (!PlaneGradientReady[Plane][PlaneIndex])
+						{
+							PlaneGradients[Plane][PlaneIndex] = ComputeGradient(vx, vy, vz).GetSafeNormal();
+							PlaneGradientReady[Plane][PlaneIndex] = 1;
+							NumGradients++;
+						}
+						grad[i] = PlaneGradients[Plane][PlaneIndex];
+					}
+
+					if (bSharedVertices)
+					{
+						// Indexed output: each surface vertex is created once, by the first cell touching its edge.
+						int32 EdgeVertex[12];
+						for (int e = 0; e < 12; e++)
+						{
+							if (!(edgeTable[cubeIndex] & (1 << e)))
+								continue;
+
+							const int* Slot = EdgeSlots[e];
+							const int32 SlotIndex = (x - CellMin.X + Slot[2]) + (y - CellMin.Y + Slot[3]) * VoxelDim.X;
+							int32& Cached = Slot[0] == 0 ? XEdges[Slot[1] ? UpperPlane : LowerPlane][SlotIndex]
+							              : Slot[0] == 1 ? YEdges[Slot[1] ? UpperPlane : LowerPlane][SlotIndex]
+							              : ZEdges[SlotIndex];
+
+							if (Cached == INDEX_NONE)
+							{
+								const int c0 = EdgeCorners[e][0];
+								const int c1 = EdgeCorners[e][1];
+								const FVertexInterpResult r = VertexInterp(p[c0], p[c1], val[c0], val[c1], grad[c0], grad[c1]);
+
+								Cached = Vertices.Add(r.Position);
+								Normals.Add(r.Normal.IsNearlyZero() ? FVector3f::UpVector : r.Normal);
+							}
+							EdgeVertex[e] = Cached;
+						}
+
+						for (int i = 0; triTable[cubeIndex][i] != -1; i += 3)
+						{
+							Triangles.Add(EdgeVertex[triTable[cubeIndex][i]]);
+							Triangles.Add(EdgeVertex[triTable[cubeIndex][i + 1]]);
+							Triangles.Add(EdgeVertex[triTable[cubeIndex][i + 2]]);
+						}
+						continue;
+					}
+
+					FVertexInterpResult vertList[12];
+
+					if (edgeTable[cubeIndex] & 1)    vertList[0]  = VertexInterp(p[0], p[1], val[0], val[1], grad[0], grad[1]);
+					if (edgeTable[cubeIndex] & 2)    vertList[1]  = VertexInterp(p[1], p[2], val[1], val[2], grad[1], grad[2]);
+					if (edgeTable[cubeIndex] & 4)    vertList[2]  = VertexInterp(p[2], p[3], val[2], val[3], grad[2], grad[3]);
+					if (edgeTable[cubeIndex] & 8)    vertList[3]  = VertexInterp(p[3], p[0], val[3], val[0], grad[3], grad[0]);
+					if (edgeTable[cubeIndex] & 16)   vertList[4]  = VertexInterp(p[4], p[5], val[4], val[5], grad[4], grad[5]);
+					if (edgeTable[cubeIndex] & 32)   vertList[5]  = VertexInterp(p[5], p[6], val[5], val[6], grad[5], grad[6]);
+					if (edgeTable[cubeIndex] & 64)   vertList[6]  = VertexInterp(p[6], p[7], val[6], val[7], grad[6], grad[7]);
+					if (edgeTable[cubeIndex] & 128)  vertList[7]  = VertexInterp(p[7], p[4], val[7], val[4], grad[7], grad[4]);
+					if (edgeTable[cubeIndex] & 256)  vertList[8]  = VertexInterp(p[0], p[4], val[0], val[4], grad[0], grad[4]);
+					if (edgeTable[cubeIndex] & 512)  vertList[9]  = VertexInterp(p[1], p[5], val[1], val[5], grad[1], grad[5]);
+					if (edgeTable[cubeIndex] & 1024) vertList[10] = VertexInterp(p[2], p[6], val[2], val[6], grad[2], grad[6]);
+					if (edgeTable[cubeIndex] & 2048) vertList[11] = VertexInterp(p[3], p[7], val[3], val[7], grad[3], grad[7]);
+
+					for (int i = 0; triTable[cubeIndex][i] != -1; i += 3)
+					{
+						const FVertexInterpResult& r0 = vertList[triTable[cubeIndex][i]];
+						const FVertexInterpResult& r1 = vertList[triTable[cubeIndex][i + 1]];
+						const FVertexInterpResult& r2 = vertList[triTable[cubeIndex][i + 2]];
+
+						const FVector3f& v0 = r0.Position;
+						const FVector3f& v1 = r1.Position;
+						const FVector3f& v2 = r2.Position;
+
+						int32 BaseIndex = Vertices.Num();
+						Vertices.Add(v0);
+						Vertices.Add(v1);
+						Vertices.Add(v2);
+
+						Triangles.Add(BaseIndex);
+						Triangles.Add(BaseIndex + 1);
+						Triangles.Add(BaseIndex + 2);
+
+						FVector3f FaceNormal = FVector3f::CrossProduct(v1 - v0, v2 - v0).GetSafeNormal();
+
+						auto AddNormal = [&](const FVector3f& Candidate)
+						{
+							FVector3f Result = Candidate;
+							if (!Result.Normalize())
+							{
+								Result = FaceNormal;
+							}
+							Normals.Add(Result);
+						};
+
+						AddNormal(r0.Normal);
+						AddNormal(r1.Normal);
+						AddNormal(r2.Normal);
+					}
+				}
+			}
+
+			INC_DWORD_STAT_BY(STAT_TerrainGradientsEvaluated, NumGradients);
+			return true;
+		};
+
+		// Sequential: one slab. Parallel: slabs of layers marched on worker threads, then appended in
+		// Z order. Vertices on a slab boundary are emitted once per slab (same position and normal).
+		const int32 NumLayers = CellMax.Z - CellMin.Z;
+		const int32 NumSlabs = bParallel ? FMath::Clamp(NumLayers / MinLayersPerSlab, 1, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1) : 1;
+		if (NumSlabs == 1)
+			return MarchSlab(CellMin.Z, CellMax.Z, OutMesh);
+
+		TArray<FTerrainMeshData> Slabs;
+		Slabs.SetNum(NumSlabs);
+		ParallelFor(NumSlabs, [&](int32 Slab)
+		{
+			const int32 ZBegin = CellMin.Z + NumLayers * Slab / NumSlabs;
+			const int32 ZEnd   = CellMin.Z + NumLayers * (Slab + 1) / NumSlabs;
+			if (!MarchSlab(ZBegin, ZEnd, Slabs[Slab]))
+				bCancelled = true;
+		});
+		if (bCancelled)
+			return false;
+
+		AppendSlabs(Slabs, OutMesh);
+		return true;
+	}
+
+	/**
+	 * Extracts the listed blocks. With bParallel, several blocks are extracted at once (each into its own
+	 * buffers); a single block is split into slabs instead.
+	 */
+	template <typename DensityType>
+	bool ExtractBlocksImpl(const DensityType& Density, int32 Size, float Scale, float IsoLevel,
+		bool bSharedVertices, int32 BlockSize, const TArray<int32>& BlockIndices, TArray<FTerrainMeshBlock>& OutBlocks,
+		TFunctionRef<bool()> ShouldCancel, bool bParallel, const FTerrainDensityHalo* Halo = nullptr,
+		const TArray<uint8>* ActiveBricks = nullptr)
+	{
+		const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(Size, BlockSize);
+		const int32 CellsPerBlock = BlockSize > 0 ? BlockSize : Size - 1;
+
+		// Blocks already in OutBlocks are reused: their buffers keep the capacity of their previous extraction.
+		OutBlocks.SetNum(BlockIndices.Num());
+
+		const bool bParallelBlocks = bParallel && BlockIndices.Num() > 1;
+		std::atomic<bool> bCancelled = false;
+
+		ParallelFor(BlockIndices.Num(), [&](int32 i)
+		{
+			if (bCancelled)
+				return;
+
+			const int32 BlockIndex = BlockIndices[i];
+			const FIntVector Block(
+				BlockIndex % NumBlocks,
+				(BlockIndex / NumBlocks) % NumBlocks,
+				BlockIndex / (NumBlocks * NumBlocks));
+			const FIntVector CellMin = Block * CellsPerBlock;
+
+			FTerrainMeshBlock& Out = OutBlocks[i];
+			Out.SectionIndex = BlockIndex;
+			Out.bCollisionOnly = false;
+			if (!ExtractRegionImpl(Density, Size, Scale, IsoLevel, bSharedVertices,
+				CellMin, CellMin + FIntVector(CellsPerBlock), Out.Mesh, ShouldCancel, bParallel && !bParallelBlocks, Halo, 1, ActiveBricks))
+			{
+				bCancelled = true;
+			}
+		}, !bParallelBlocks);
+
+		return !bCancelled;
+	}
+
+	/**
+	 * Expands a density storage once and calls Func with a dense view of it in its own encoding:
+	 * a TArray<float> for Float32, a TQuantizedDensity of 16 / 8-bit samples otherwise.
+	 */
+	template <typename FuncType>
+	bool WithDenseField(const FTerrainDensityStorage& Density, FuncType&& Func)
+	{
+		if (Density.GetEncoding() == ETerrainDensityEncoding::Float32)
+		{
+			TArray<float> Dense;
+			Density.ToDense(Dense);
+			return Func(Dense);
+		}
+
+		// March the samples in their stored encoding: quantized chunks are walked as 8 / 16-bit data.
+		TArray<uint8> Samples;
+		Density.ToDenseSamples(Samples);
+
+		const float Step = Density.GetQuantizationStep();
+		if (Density.GetEncoding() == ETerrainDensityEncoding::Quantized16)
+			return Func(TQuantizedDensity<int16>{reinterpret_cast<const int16*>(Samples.GetData()), Step});
+		return Func(TQuantizedDensity<int8>{reinterpret_cast<const int8*>(Samples.GetData()), Step});
+	}
+}
+
+bool TerrainMesher::ExtractSurface(const TArray<float>& Density, int32 Size, float Scale, float IsoLevel,
+	bool bSharedVertices, FTerrainMeshData& OutMesh, TFunctionRef<bool()> ShouldCancel, bool bParallel)
+{
+	return ExtractRegion(Density, Size, Scale, IsoLevel, bSharedVertices,
+		FIntVector::ZeroValue, FIntVector(Size - 1), OutMesh, ShouldCancel, bParallel);
+}
+
+bool TerrainMesher::ExtractRegion(const TArray<float>& Density, int32 Size, float Scale, float IsoLevel,
+	bool bSharedVertices, const FIntVector& CellMin, const FIntVector& CellMax, FTerrainMeshData& OutMesh,
+	TFunctionRef<bool()> ShouldCancel, bool bParallel)
+{
+	if (Density.Num() != Size * Size * Size)
+	{
+		OutMesh.Reset();
+		return false;
+	}
+	return ExtractRegionImpl(Density, Size, Scale, IsoLevel, bSharedVertices, CellMin, CellMax, OutMesh, ShouldCancel, bParallel);
+}
+
+int32 TerrainMesher::GetNumBlocksPerAxis(int32 Size, int32 BlockSize)
+{
+	if (Size <= 1)
+		return 0;
+	return BlockSize > 0 ? FMath::DivideAndRoundUp(Size - 1, BlockSize) : 1;
+}
+
+bool TerrainMesher::ExtractBlocks(const TArray<float>& Density, int32 Size, float Scale, float IsoLevel,
+	bool bSharedVertices, int32 BlockSize, const TArray<int32>& BlockIndices, TArray<FTerrainMeshBlock>& OutBlocks,
+	TFunctionRef<bool()> ShouldCancel, bool bParallel)
+{
+	if (Size <= 1 || Density.Num() != Size * Size * Size)
+		return false;
+	return ExtractBlocksImpl(Density, Size, Scale, IsoLevel, bSharedVertices, BlockSize, BlockIndices, OutBlocks, ShouldCancel, bParallel);
+}
+
+bool TerrainMesher::ExtractBlocks(const FTerrainDensityStorage& Density, float Scale, float IsoLevel,
+	bool bSharedVertices, int32 BlockSize, const TArray<int32>& BlockIndices, TArray<FTerrainMeshBlock>& OutBlocks,
+	TFunctionRef<bool()> ShouldCancel, bool bParallel, const FTerrainDensityHalo* Halo)
+{
+	const int32 Size = Density.GetSize();
+	if (Size <= 1)
+		return false;
+
+	// Chunks entirely in the air or underground have nothing to march; empty blocks still clear their sections.
+	if (!Density.CanContainSurface(IsoLevel))
+	{
+		OutBlocks.SetNum(BlockIndices.Num());
+		for (int32 i = 0; i < BlockIndices.Num(); i++)
+		{
+			OutBlocks[i].SectionIndex = BlockIndices[i];
+			OutBlocks[i].Mesh.Reset();
+			OutBlocks[i].bCollisionOnly = false;
+		}
+		return true;
+	}
+
+	TArray<uint8> ActiveBricks;
+	const int32 NumActive = Density.GetActiveCellBricks(IsoLevel, ActiveBricks);
+	INC_DWORD_STAT_BY(STAT_TerrainBricksSkipped, ActiveBricks.Num() - NumActive);
+
+	return WithDenseField(Density, [&](const auto& Dense)
+	{
+		// A halo is only meaningful around a field of the same size.
+		const FTerrainDensityHalo* FieldHalo = Halo && Halo->Size == Size ? Halo : nullptr;
+		return ExtractBlocksImpl(Dense, Size, Scale, IsoLevel, bSharedVertices, BlockSize, BlockIndices, OutBlocks,
+			ShouldCancel, bParallel, FieldHalo, &ActiveBricks);
+	});
+}
+
+bool TerrainMesher::ExtractDecimated(const FTerrainDensityStorage& Density, float Scale, float IsoLevel, int32 Stride,
+	FTerrainMeshData& OutMesh, TFunctionRef<bool()> ShouldCancel)
+{
+	OutMesh.Reset();
+
+	const int32 Size = Density.GetSize();
+	if (Size <= 1 || Stride < 1)
+		return false;
+
+	if (!Density.CanContainSurface(IsoLevel))
+		return true;
+
+	TArray<uint8> ActiveBricks;
+	Density.GetActiveCellBricks(IsoLevel, ActiveBricks);
+
+	return WithDenseField(Density, [&](const auto& Dense)
+	{
+		return ExtractRegionImpl(Dense, Size, Scale, IsoLevel, true, FIntVector::ZeroValue, FIntVector(MAX_int32),
+			OutMesh, ShouldCancel, false, nullptr, Stride, &ActiveBricks);
+	});
+}
+
+void TerrainMesher::AppendSkirts(FTerrainMeshData& Mesh, const FVector3f& Extent, float Depth)
+{
+	if (Depth <= 0.0f || Mesh.IsEmpty())
+		return;
+
+	// Border vertices are interpolated between two border voxels, so they lie exactly on the plane.
+	constexpr float PlaneTolerance = 0.01f;
+	auto GetBorderAxis = [&](const FVector3f& A, const FVector3f& B)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if ((FMath::Abs(A[Axis]) < PlaneTolerance && FMath::Abs(B[Axis]) < PlaneTolerance)
+				|| (FMath::Abs(A[Axis] - Extent[Axis]) < PlaneTolerance && FMath::Abs(B[Axis] - Extent[Axis]) < PlaneTolerance))
+				return Axis;
+		}
+		return (int32)INDEX_NONE;
+	};
+
+	// Normals point towards the air: the skirt follows -Normal, flattened into the border plane.
+	auto GetSkirtDirection = [](const FVector3f& Normal, int32 Axis)
+	{
+		FVector3f Direction = -Normal;
+		Direction[Axis] = 0.0f;
+		return Direction.GetSafeNormal();
+	};
+
+	const int32 NumIndices = Mesh.Triangles.Num();
+	for (int32 t = 0; t + 2 < NumIndices; t += 3)
+	{
+		for (int32 e = 0; e < 3; e++)
+		{
+			const int32 i0 = Mesh.Triangles[t + e];
+			const int32 i1 = Mesh.Triangles[t + (e + 1) % 3];
+			const int32 Axis = GetBorderAxis(Mesh.Vertices[i0], Mesh.Vertices[i1]);
+			if (Axis == INDEX_NONE)
+				continue;
+
+			const FVector3f Dir0 = GetSkirtDirection(Mesh.Normals[i0], Axis);
+			const FVector3f Dir1 = GetSkirtDirection(Mesh.Normals[i1], Axis);
+			if (Dir0.IsZero() || Dir1.IsZero())
+				continue;
+
+			const int32 s0 = Mesh.Vertices.Add(Mesh.Vertices[i0] + Dir0 * Depth);
+			const int32 s1 = Mesh.Vertices.Add(Mesh.Vertices[i1] + Dir1 * Depth);
+			Mesh.Normals.Add(Mesh.Normals[i0]);
+			Mesh.Normals.Add(Mesh.Normals[i1]);
+
+			// The quad continues the surface across the edge, so it walks the edge backwards (i1 -> i0).
+			Mesh.Triangles.Append({i1, i0, s0, i1, s0, s1});
+		}
+	}
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainDensityStorage.h"
+
+/**
+ * FTerrainMeshData
+ *
+ * Output buffers of a Marching Cubes extraction, in component space (single precision,
+ * converted once when written into the mesh sections). Reset() keeps the allocations,
+ * so a recycled FTerrainMeshData can be refilled without touching the allocator.
+ */
+struct FTerrainMeshData
+{
+	TArray<FVector3f> Vertices;
+	TArray<int32>     Triangles;
+	TArray<FVector3f> Normals;
+
+	void Reset()
+	{
+		Vertices.Reset();
+		Triangles.Reset();
+		Normals.Reset();
+	}
+
+	bool IsEmpty() const { return Triangles.Num() == 0; }
+};
+
+/** Mesh of one sub-block of a chunk, uploaded as its own mesh section. */
+struct FTerrainMeshBlock
+{
+	int32 SectionIndex = INDEX_NONE;
+	FTerrainMeshData Mesh;
+
+	/** Decimated collision mesh of the chunk: cooked for physics but never drawn. */
+	bool bCollisionOnly = false;
+};
+
+/**
+ * FTerrainDensityHalo
+ *
+ * One layer of samples just outside each face of a chunk, copied from its neighbours. The mesher reads it
+ * where a border gradient would otherwise be clamped, so that normals match across chunk seams.
+ */
+struct FTerrainDensityHalo
+{
+	/** Size of the chunk the halo surrounds. */
+	int32 Size = 0;
+
+	/** Faces -X, +X, -Y, +Y, -Z, +Z; Size² samples each (the two other axes, lowest first), or empty without a neighbour. */
+	TArray<float> Faces[6];
+
+	/** Reads the halo sample at (X, Y, Z), exactly one coordinate being -1 or Size. False if that face is missing. */
+	bool Sample(int32 X, int32 Y, int32 Z, float& OutValue) const
+	{
+		int32 Face, U, V;
+		if      (X < 0)     { Face = 0; U = Y; V = Z; }
+		else if (X >= Size) { Face = 1; U = Y; V = Z; }
+		else if (Y < 0)     { Face = 2; U = X; V = Z; }
+		else if (Y >= Size) { Face = 3; U = X; V = Z; }
+		else if (Z < 0)     { Face = 4; U = X; V = Y; }
+		else if (Z >= Size) { Face = 5; U = X; V = Y; }
+		else return false;
+
+		if (Faces[Face].IsEmpty() || U < 0 || V < 0 || U >= Size || V >= Size)
+			return false;
+		OutValue = Faces[Face][U + V * Size];
+		return true;
+	}
+};
+
+/**
+ * TerrainMesher
+ *
+ * Pure mesh extraction functions. They only read the density buffer they are given
+ * and never touch UObjects, so they can run on any worker thread.
+ */
+namespace TerrainMesher
+{
+	/**
+	 * Extracts the iso-surface of a Size³ density field with Marching Cubes.
+	 * @param Density - Size³ samples, X-major (x + y * Size + z * Size * Size).
+	 * @param Size - Number of voxels along each axis.
+	 * @param Scale - Distance between two voxels in component space.
+	 * @param IsoLevel - Iso-surface threshold.
+	 * @param bSharedVertices - Indexed output: vertices are cached per cube edge and shared between triangles.
+	 *                          When false, every triangle gets three unique vertices (flat per-triangle buffers).
+	 * @param OutMesh - Receives the extracted vertices, triangles and normals.
+	 * @param ShouldCancel - Polled between Z slices; extraction stops early (with partial output) when it returns true.
+	 *                       With bParallel it is called from several worker threads and must be thread-safe.
+	 * @param bParallel - Spread marching over worker threads (ParallelFor over Z slabs / blocks).
+	 *                    Slabs are merged in order; their boundary vertices are not shared in indexed output.
+	 * @return False if the input is inconsistent or the extraction was cancelled.
+	 */
+	DESTRUCTIONTERRAIN_API bool ExtractSurface(
+		const TArray<float>& Density,
+		int32 Size,
+		float Scale,
+		float IsoLevel,
+		bool bSharedVertices,
+		FTerrainMeshData& OutMesh,
+		TFunctionRef<bool()> ShouldCancel = [] { return false; },
+		bool bParallel = false);
+
+	/**
+	 * Same as ExtractSurface(), restricted to the cells in [CellMin, CellMax) (cell c spans voxels c..c+1).
+	 * Gradients are only evaluated at the corners of cells crossing the surface, so the cost is proportional to it.
+	 */
+	DESTRUCTIONTERRAIN_API bool ExtractRegion(
+		const TArray<float>& Density,
+		int32 Size,
+		float Scale,
+		float IsoLevel,
+		bool bSharedVertices,
+		const FIntVector& CellMin,
+		const FIntVector& CellMax,
+		FTerrainMeshData& OutMesh,
+		TFunctionRef<bool()> ShouldCancel = [] { return false; },
+		bool bParallel = false);
+
+	/** Number of mesh blocks along each axis of a chunk of Size voxels (BlockSize <= 0 means a single block). */
+	DESTRUCTIONTERRAIN_API int32 GetNumBlocksPerAxis(int32 Size, int32 BlockSize);
+
+	/**
+	 * Extracts a list of mesh blocks of BlockSize³ cells. Block indices are bx + by * N + bz * N * N
+	 * with N = GetNumBlocksPerAxis(); each block's index is also its mesh section index.
+	 * Blocks already present in OutBlocks are refilled in place (their buffers are reused).
+	 */
+	DESTRUCTIONTERRAIN_API bool ExtractBlocks(
+		const TArray<float>& Density,
+		int32 Size,
+		float Scale,
+		float IsoLevel,
+		bool bSharedVertices,
+		int32 BlockSize,
+		const TArray<int32>& BlockIndices,
+		TArray<FTerrainMeshBlock>& OutBlocks,
+		TFunctionRef<bool()> ShouldCancel = [] { return false; },
+		bool bParallel = false);
+
+	/**
+	 * Same as above for a density storage. Fields that cannot contain a surface are not marched (every block
+	 * comes back empty); otherwise the field is expanded once and marched in its own encoding, so quantized
+	 * chunks are read as 8 / 16-bit samples. Cell bricks whose value range does not cross IsoLevel are not
+	 * walked, so the cost follows the surface rather than the volume.
+	 * @param Halo - Optional samples around the chunk, used by the gradients of border voxels.
+	 */
+	DESTRUCTIONTERRAIN_API bool ExtractBlocks(
+		const FTerrainDensityStorage& Density,
+		float Scale,
+		float IsoLevel,
+		bool bSharedVertices,
+		int32 BlockSize,
+		const TArray<int32>& BlockIndices,
+		TArray<FTerrainMeshBlock>& OutBlocks,
+		TFunctionRef<bool()> ShouldCancel = [] { return false; },
+		bool bParallel = false,
+		const FTerrainDensityHalo* Halo = nullptr);
+
+	/**
+	 * Extracts the whole field at a coarser resolution, with cells of Stride voxels (the last cell of each
+	 * axis is clamped to the chunk border). Indexed output; used to cook decimated collision.
+	 */
+	DESTRUCTIONTERRAIN_API bool ExtractDecimated(
+		const FTerrainDensityStorage& Density,
+		float Scale,
+		float IsoLevel,
+		int32 Stride,
+		FTerrainMeshData& OutMesh,
+		TFunctionRef<bool()> ShouldCancel = [] { return false; });
+
+	/**
+	 * Appends skirts under the surface edges lying on the border planes of a chunk (0 or Extent on an axis):
+	 * a strip of Depth hanging from each such edge into the solid, inside the border plane. They hide the
+	 * cracks between neighbouring chunks meshed at different strides. Skirts reuse the normals of the edge.
+	 * @param Extent - Component-space size of the chunk ((Size - 1) * Scale on each axis).
+	 */
+	DESTRUCTIONTERRAIN_API void AppendSkirts(FTerrainMeshData& Mesh, const FVector3f& Extent, float Depth);
+}
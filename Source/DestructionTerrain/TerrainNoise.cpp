@@ -0,0 +1,239 @@
+#include "TerrainNoise.h"
+
+namespace
+{
+	// Permutation of FMath::PerlinNoise3D (UnrealMath.cpp), so that both kernels evaluate the same noise.
+	constexpr uint8 BasePermutation[256] = {
+		 63,   9, 212, 205,  31, 128,  72,  59, 137, 203, 195, 170, 181, 115, 165,  40,
+		116, 139, 175, 225, 132,  99, 222,   2,  41,  15, 197,  93, 169,  90, 228,  43,
+		221,  38, 206, 204,  73,  17,  97,  10,  96,  47,  32, 138, 136,  30, 219,  78,
+		224,  13, 193,  88, 134, 211,   7, 112, 176,  19, 106,  83,  75, 217,  85,   0,
+		 98, 140, 229,  80, 118, 151, 117, 251, 103, 242,  81, 238, 172,  82, 110,   4,
+		227,  77, 243,  46,  12, 189,  34, 188, 200, 161,  68,  76, 171, 194,  57,  48,
+		247, 233,  51, 105,   5,  23,  42,  50, 216,  45, 239, 148, 249,  84,  70, 125,
+		108, 241,  62,  66,  64, 240, 173, 185, 250,  49,   6,  37,  26,  21, 244,  60,
+		223, 255,  16, 145,  27, 109,  58, 102, 142, 253, 120, 149, 160, 124, 156,  79,
+		186, 135, 127,  14, 121,  22,  65,  54, 153,  91, 213, 174,  24, 252, 131, 192,
+		190, 202, 208,  35,  94, 231,  56,  95, 183, 163, 111, 147,  25,  67,  36,  92,
+		236,  71, 166,   1, 187, 100, 130, 143, 237, 178, 158, 104, 184, 159, 177,  52,
+		214, 230, 119,  87, 114, 201, 179, 198,   3, 248, 182,  39,  11, 152, 196, 113,
+		 20, 232,  69, 141, 207, 234,  53,  86, 180, 226,  74, 150, 218,  29, 133,   8,
+		 44, 123,  28, 146,  89, 101, 154, 220, 126, 155, 122, 210, 168, 254, 162, 129,
+		 33,  18, 209,  61, 191, 199, 157, 245,  55, 164, 167, 215, 246, 144, 107, 235,
+	};
+
+	// Permutation repeated twice, so that the nested lookups of a cell never wrap.
+	struct FPermutationTable
+	{
+		int32 P[512];
+
+		FPermutationTable()
+		{
+			for (int32 i = 0; i < 512; i++)
+				P[i] = BasePermutation[i & 255];
+		}
+	};
+	const FPermutationTable Permutation;
+
+	// Gradient of each hash & 15: the 12 cube edge midpoints, then 4 of them again (FMath::PerlinNoise3D's Grad3()).
+	constexpr float GradX[16] = { 1,  1,  0, -1, -1, -1,  0,  1,  1,  0, -1,  0,  1, -1,  0,  0 };
+	constexpr float GradY[16] = { 0,  1,  1,  1,  0, -1, -1, -1,  0,  1,  0, -1,  1,  1, -1, -1 };
+	constexpr float GradZ[16] = { 1,  0,  1,  0,  1,  0,  1,  0, -1, -1, -1, -1,  0,  0,  1, -1 };
+
+	// Keeps the output inside [-1, 1] with a small margin, then clamped to it, like the engine noise.
+	constexpr float OutputScale = 0.97f;
+
+	// Hashes of the 8 corners of a lattice cell, in the order 000, 100, 010, 110, 001, 101, 011, 111.
+	void HashCell(int32 Xi, int32 Yi, int32 Zi, int32 OutHashes[8])
+	{
+		const int32* P = Permutation.P;
+		const int32 A  = P[Xi] + Yi;
+		const int32 B  = P[Xi + 1] + Yi;
+		const int32 AA = P[A] + Zi;
+		const int32 AB = P[A + 1] + Zi;
+		const int32 BA = P[B] + Zi;
+		const int32 BB = P[B + 1] + Zi;
+
+		OutHashes[0] = P[AA]     & 15;
+		OutHashes[1] = P[BA]     & 15;
+		OutHashes[2] = P[AB]     & 15;
+		OutHashes[3] = P[BB]     & 15;
+		OutHashes[4] = P[AA + 1] & 15;
+		OutHashes[5] = P[BA + 1] & 15;
+		OutHashes[6] = P[AB + 1] & 15;
+		OutHashes[7] = P[BB + 1] & 15;
+	}
+
+	float Fade(float T)
+	{
+		return T * T * T * (T * (T * 6.0f - 15.0f) + 10.0f);
+	}
+
+	VectorRegister4Float VectorFade(const VectorRegister4Float& T)
+	{
+		const VectorRegister4Float Inner = VectorMultiplyAdd(T, VectorMultiplyAdd(T, VectorSetFloat1(6.0f), VectorSetFloat1(-15.0f)), VectorSetFloat1(10.0f));
+		return VectorMultiply(VectorMultiply(VectorMultiply(T, T), T), Inner);
+	}
+
+	VectorRegister4Float VectorLerp(const VectorRegister4Float& A, const VectorRegister4Float& B, const VectorRegister4Float& Alpha)
+	{
+		return VectorMultiplyAdd(VectorSubtract(B, A), Alpha, A);
+	}
+}
+
+TConstArrayView<int32> TerrainNoise::GetPermutationTable()
+{
+	return TConstArrayView<int32>(Permutation.P, UE_ARRAY_COUNT(Permutation.P));
+}
+
+float TerrainNoise::Perlin3D(float X, float Y, float Z)
+{
+	const float Xf = FMath::FloorToFloat(X);
+	const float Yf = FMath::FloorToFloat(Y);
+	const float Zf = FMath::FloorToFloat(Z);
+
+	int32 Hashes[8];
+	HashCell(static_cast<int32>(Xf) & 255, static_cast<int32>(Yf) & 255, static_cast<int32>(Zf) & 255, Hashes);
+
+	const float Fx = X - Xf;
+	const float Fy = Y - Yf;
+	const float Fz = Z - Zf;
+
+	auto Grad = [](int32 Hash, float Dx, float Dy, float Dz)
+	{
+		return GradX[Hash] * Dx + GradY[Hash] * Dy + GradZ[Hash] * Dz;
+	};
+
+	const float U = Fade(Fx);
+	const float V = Fade(Fy);
+	const float W = Fade(Fz);
+
+	const float X00 = FMath::Lerp(Grad(Hashes[0], Fx, Fy, Fz),        Grad(Hashes[1], Fx - 1, Fy, Fz),        U);
+	const float X10 = FMath::Lerp(Grad(Hashes[2], Fx, Fy - 1, Fz),    Grad(Hashes[3], Fx - 1, Fy - 1, Fz),    U);
+	const float X01 = FMath::Lerp(Grad(Hashes[4], Fx, Fy, Fz - 1),    Grad(Hashes[5], Fx - 1, Fy, Fz - 1),    U);
+	const float X11 = FMath::Lerp(Grad(Hashes[6], Fx, Fy - 1, Fz - 1), Grad(Hashes[7], Fx - 1, Fy - 1, Fz - 1), U);
+
+	return FMath::Clamp(OutputScale * FMath::Lerp(FMath::Lerp(X00, X10, V), FMath::Lerp(X01, X11, V), W), -1.0f, 1.0f);
+}
+
+VectorRegister4Float TerrainNoise::Perlin3D(const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Float& Z)
+{
+	const VectorRegister4Float Xf = VectorFloor(X);
+	const VectorRegister4Float Yf = VectorFloor(Y);
+	const VectorRegister4Float Zf = VectorFloor(Z);
+
+	// Hashing stays scalar (table lookups); everything else runs on 4 lanes.
+	alignas(16) float CellX[4], CellY[4], CellZ[4];
+	VectorStoreAligned(Xf, CellX);
+	VectorStoreAligned(Yf, CellY);
+	VectorStoreAligned(Zf, CellZ);
+
+	alignas(16) float Gx[8][4], Gy[8][4], Gz[8][4];
+	for (int32 Lane = 0; Lane < 4; Lane++)
+	{
+		int32 Hashes[8];
+		HashCell(static_cast<int32>(CellX[Lane]) & 255, static_cast<int32>(CellY[Lane]) & 255, static_cast<int32>(CellZ[Lane]) & 255, Hashes);
+
+		for (int32 Corner = 0; Corner < 8; Corner++)
+		{
+			Gx[Corner][Lane] = GradX[Hashes[Corner]];
+			Gy[Corner][Lane] = GradY[Hashes[Corner]];
+			Gz[Corner][Lane] = GradZ[Hashes[Corner]];
+		}
+	}
+
+	const VectorRegister4Float One = VectorOne();
+	const VectorRegister4Float Fx[2] = { VectorSubtract(X, Xf), VectorSubtract(VectorSubtract(X, Xf), One) };
+	const VectorRegister4Float Fy[2] = { VectorSubtract(Y, Yf), VectorSubtract(VectorSubtract(Y, Yf), One) };
+	const VectorRegister4Float Fz[2] = { VectorSubtract(Z, Zf), VectorSubtract(VectorSubtract(Z, Zf), One) };
+
+	VectorRegister4Float Dots[8];
+	for (int32 Corner = 0; Corner < 8; Corner++)
+	{
+		const VectorRegister4Float& Dx = Fx[Corner & 1];
+		const VectorRegister4Float& Dy = Fy[(Corner >> 1) & 1];
+		const VectorRegister4Float& Dz = Fz[(Corner >> 2) & 1];
+
+		Dots[Corner] = VectorMultiplyAdd(VectorLoadAligned(Gx[Corner]), Dx,
+			VectorMultiplyAdd(VectorLoadAligned(Gy[Corner]), Dy, VectorMultiply(VectorLoadAligned(Gz[Corner]), Dz)));
+	}
+
+	const VectorRegister4Float U = VectorFade(Fx[0]);
+	const VectorRegister4Float V = VectorFade(Fy[0]);
+	const VectorRegister4Float W = VectorFade(Fz[0]);
+
+	const VectorRegister4Float X00 = VectorLerp(Dots[0], Dots[1], U);
+	const VectorRegister4Float X10 = VectorLerp(Dots[2], Dots[3], U);
+	const VectorRegister4Float X01 = VectorLerp(Dots[4], Dots[5], U);
+	const VectorRegister4Float X11 = VectorLerp(Dots[6], Dots[7], U);
+
+	const VectorRegister4Float Noise = VectorMultiply(VectorSetFloat1(OutputScale), VectorLerp(VectorLerp(X00, X10, V), VectorLerp(X01, X11, V), W));
+	return VectorMin(VectorMax(Noise, VectorSetFloat1(-1.0f)), One);
+}
+
+float TerrainNoise::Fbm(const FVector& Position, const FTerrainNoiseSettings& Settings)
+{
+	float Sum = 0.0f;
+	float TotalAmplitude = 0.0f;
+	float Amplitude = 1.0f;
+	FVector P = Position;
+
+	for (int32 Octave = 0; Octave < FMath::Max(Settings.Octaves, 1); Octave++)
+	{
+		const float Noise = Settings.Kernel == ETerrainNoiseKernel::Vectorized
+			? Perlin3D(static_cast<float>(P.X), static_cast<float>(P.Y), static_cast<float>(P.Z))
+			: FMath::PerlinNoise3D(P);
+
+		Sum += Noise * Amplitude;
+		TotalAmplitude += Amplitude;
+		Amplitude *= Settings.Gain;
+		P *= Settings.Lacunarity;
+	}
+
+	return TotalAmplitude > 0.0f ? Sum / TotalAmplitude : 0.0f;
+}
+
+void TerrainNoise::FbmRow(const FVector& Start, double StepX, int32 Count, const FTerrainNoiseSettings& Settings, float* Out)
+{
+	int32 i = 0;
+
+	if (Settings.Kernel == ETerrainNoiseKernel::Vectorized)
+	{
+		const int32 Octaves = FMath::Max(Settings.Octaves, 1);
+
+		float TotalAmplitude = 0.0f;
+		for (int32 Octave = 0; Octave < Octaves; Octave++)
+			TotalAmplitude += FMath::Pow(Settings.Gain, static_cast<float>(Octave));
+		const VectorRegister4Float Normalize = VectorSetFloat1(TotalAmplitude > 0.0f ? 1.0f / TotalAmplitude : 0.0f);
+
+		const VectorRegister4Float LaneOffsets = MakeVectorRegisterFloat(0.0f, static_cast<float>(StepX), static_cast<float>(2.0 * StepX), static_cast<float>(3.0 * StepX));
+
+		for (; i + 4 <= Count; i += 4)
+		{
+			const VectorRegister4Float BaseX = VectorAdd(VectorSetFloat1(static_cast<float>(Start.X + i * StepX)), LaneOffsets);
+
+			VectorRegister4Float Sum = VectorZeroFloat();
+			float Frequency = 1.0f;
+			float Amplitude = 1.0f;
+			for (int32 Octave = 0; Octave < Octaves; Octave++)
+			{
+				const VectorRegister4Float Noise = Perlin3D(
+					VectorMultiply(BaseX, VectorSetFloat1(Frequency)),
+					VectorSetFloat1(static_cast<float>(Start.Y * Frequency)),
+					VectorSetFloat1(static_cast<float>(Start.Z * Frequency)));
+
+				Sum = VectorMultiplyAdd(Noise, VectorSetFloat1(Amplitude), Sum);
+				Frequency *= Settings.Lacunarity;
+				Amplitude *= Settings.Gain;
+			}
+
+			VectorStore(VectorMultiply(Sum, Normalize), Out + i);
+		}
+	}
+
+	// Engine kernel, or the last Count % 4 points of a vectorized row.
+	for (; i < Count; i++)
+	{
+		Out[i] = Fbm(Start + FVector(i * StepX, 0.0, 0.0), Settings);
+	}
+}
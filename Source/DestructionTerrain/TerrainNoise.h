@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+#include "TerrainNoise.generated.h"
+
+/** Noise implementation used for density generation. */
+UENUM(BlueprintType)
+enum class ETerrainNoiseKernel : uint8
+{
+	/** FMath::PerlinNoise3D, one voxel at a time. */
+	Engine,
+
+	/**
+	 * SIMD Perlin noise evaluating 4 voxels per call along X, on the engine's lattice and gradients: the same terrain
+	 * as Engine up to float rounding. Required by GPU generation, which uses the same lattice.
+	 */
+	Vectorized
+};
+
+/** Fractal (fBm) noise parameters shared by chunk generation. */
+USTRUCT(BlueprintType)
+struct FTerrainNoiseSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise")
+	ETerrainNoiseKernel Kernel = ETerrainNoiseKernel::Vectorized;
+
+	/** Number of noise layers summed together (1 = plain Perlin noise, as before). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 Octaves = 1;
+
+	/** Frequency multiplier between two octaves. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (ClampMin = "1.0"))
+	float Lacunarity = 2.0f;
+
+	/** Amplitude multiplier between two octaves. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Gain = 0.5f;
+};
+
+/**
+ * TerrainNoise
+ *
+ * Thread-safe noise functions used by density generation. The fBm sum is normalized by the total
+ * amplitude of its octaves, so its range stays about [-1, 1] and a single octave equals the base noise.
+ */
+namespace TerrainNoise
+{
+	/** Scalar reference of the vectorized kernel's Perlin noise: FMath::PerlinNoise3D, in [-1, 1]. */
+	DESTRUCTIONTERRAIN_API float Perlin3D(float X, float Y, float Z);
+
+	/** Doubled permutation table (512 entries) of Perlin3D(), for the GPU kernel that reproduces it. */
+	DESTRUCTIONTERRAIN_API TConstArrayView<int32> GetPermutationTable();
+
+	/** The same noise for 4 points at once. */
+	DESTRUCTIONTERRAIN_API VectorRegister4Float Perlin3D(const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Float& Z);
+
+	/** Normalized fBm at one point, using the kernel selected in Settings. */
+	DESTRUCTIONTERRAIN_API float Fbm(const FVector& Position, const FTerrainNoiseSettings& Settings);
+
+	/**
+	 * Normalized fBm for Count points along X: Out[i] = Fbm(Start + FVector(i * StepX, 0, 0)).
+	 * The vectorized kernel processes 4 points per iteration and finishes the row with the scalar reference.
+	 */
+	DESTRUCTIONTERRAIN_API void FbmRow(const FVector& Start, double StepX, int32 Count, const FTerrainNoiseSettings& Settings, float* Out);
+}
@@ -0,0 +1,397 @@
+#include "TerrainRegionFile.h"
+#include "DestructionTerrain.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+const TCHAR* const FTerrainRegionStore::FileExtension = TEXT("tregion");
+
+namespace
+{
+	/** 'TRGN' tag identifying a terrain region file. */
+	constexpr uint32 RegionMagic = 0x4E475254;
+	constexpr uint32 RegionVersion = 1;
+
+	constexpr int32 SlotsPerRegion = FTerrainRegionStore::RegionSizeX * FTerrainRegionStore::RegionSizeY * FTerrainRegionStore::RegionSizeZ;
+
+	/** Magic, version, slot count and sector size, then one (Offset, Size, Sectors) entry per slot. */
+	constexpr int64 HeaderBytes = 16;
+	constexpr int64 SlotBytes = 16;
+	constexpr int64 TableBytes = HeaderBytes + SlotsPerRegion * SlotBytes;
+
+	/** Blobs start on the first sector after the table. */
+	constexpr int64 FirstBlobOffset = (TableBytes + FTerrainRegionStore::SectorSize - 1) / FTerrainRegionStore::SectorSize * FTerrainRegionStore::SectorSize;
+
+	struct FRegionSlot
+	{
+		int64 Offset = 0;
+		int32 Size = 0;
+		int32 Sectors = 0;
+	};
+
+	/** Run of unused sectors between blobs. */
+	struct FRegionExtent
+	{
+		int64 Offset = 0;
+		int64 Sectors = 0;
+	};
+
+	int32 FloorDiv(int32 Value, int32 Divisor)
+	{
+		return Value >= 0 ? Value / Divisor : (Value - Divisor + 1) / Divisor;
+	}
+
+	void SerializeSlot(FArchive& Ar, FRegionSlot& Slot)
+	{
+		Ar << Slot.Offset;
+		Ar << Slot.Size;
+		Ar << Slot.Sectors;
+	}
+}
+
+struct FTerrainRegionStore::FRegion
+{
+	FCriticalSection Lock;
+	FString Path;
+
+	/** One entry per chunk of the region (Size 0 = no blob). */
+	TArray<FRegionSlot> Slots;
+
+	/** Free sectors between blobs, rebuilt from the table when it is read. */
+	TArray<FRegionExtent> FreeExtents;
+
+	/** End of the last allocated sector. */
+	int64 FileEnd = FirstBlobOffset;
+
+	/** True once the table exists on disk (the header and table are written with the first blob). */
+	bool bOnDisk = false;
+
+	/** Slots of the table on disk dropped as invalid when it was read; the next write clears them in the file too. */
+	TArray<int32> DroppedSlots;
+
+	/** Read-only mapping of the file, closed before every write (the file may grow). */
+	TUniquePtr<IMappedFileHandle> Mapping;
+
+	/** Reads the table, or starts an empty region if the file does not exist (or is not a region file). */
+	void LoadTable()
+	{
+		Slots.SetNum(SlotsPerRegion);
+
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*Path));
+		if (!Handle)
+			return;
+
+		TArray<uint8> Table;
+		Table.SetNumUninitialized(TableBytes);
+		if (!Handle->Read(Table.GetData(), TableBytes))
+		{
+			UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Truncated terrain region file: %s"), *Path);
+			return;
+		}
+
+		FMemoryReader Ar(Table);
+		uint32 Magic = 0, Version = 0, NumSlots = 0, FileSectorSize = 0;
+		Ar << Magic << Version << NumSlots << FileSectorSize;
+		if (Magic != RegionMagic || Version > RegionVersion || NumSlots != SlotsPerRegion || FileSectorSize != SectorSize)
+		{
+			UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Invalid or unsupported terrain region file: %s"), *Path);
+			return;
+		}
+
+		const int64 FileSize = Handle->Size();
+		TArray<int32> Used;
+		for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); SlotIndex++)
+		{
+			FRegionSlot& Slot = Slots[SlotIndex];
+			SerializeSlot(Ar, Slot);
+			if (Slot.Size == 0 && Slot.Offset == 0 && Slot.Sectors == 0)
+				continue;
+
+			// A slot past the end of the file was never completely written; one whose sectors do not match its
+			// size, or off the sector grid, is corrupt.
+			if (Slot.Size <= 0 || Slot.Offset < FirstBlobOffset || Slot.Offset % SectorSize != 0 || Slot.Offset + Slot.Size > FileSize
+				|| Slot.Sectors != FMath::DivideAndRoundUp<int64>(Slot.Size, SectorSize))
+			{
+				Slot = FRegionSlot();
+				DroppedSlots.Add(SlotIndex);
+				continue;
+			}
+			Used.Add(SlotIndex);
+		}
+		bOnDisk = true;
+
+		// Blobs in file order; one starting inside the previous one would be overwritten by the other's next save.
+		Algo::StableSortBy(Used, [this](int32 SlotIndex) { return Slots[SlotIndex].Offset; });
+		int64 Cursor = FirstBlobOffset;
+		for (const int32 SlotIndex : Used)
+		{
+			FRegionSlot& Slot = Slots[SlotIndex];
+			if (Slot.Offset < Cursor)
+			{
+				Slot = FRegionSlot();
+				DroppedSlots.Add(SlotIndex);
+				continue;
+			}
+
+			if (Slot.Offset > Cursor)
+				FreeExtents.Add({Cursor, (Slot.Offset - Cursor) / SectorSize});
+			Cursor = Slot.Offset + Slot.Sectors * SectorSize;
+		}
+		FileEnd = Cursor;
+
+		if (DroppedSlots.Num() > 0)
+		{
+			UE_LOG(LogDestructionTerrain, Warning, TEXT("⚠️ Dropped %d corrupt chunk slots of terrain region file: %s"),
+				DroppedSlots.Num(), *Path);
+		}
+	}
+
+	/** First-fit allocation of Sectors sectors, at the end of the file if no gap is large enough. */
+	int64 AllocateSectors(int64 Sectors)
+	{
+		for (int32 i = 0; i < FreeExtents.Num(); i++)
+		{
+			FRegionExtent& Extent = FreeExtents[i];
+			if (Extent.Sectors < Sectors)
+				continue;
+
+			const int64 Offset = Extent.Offset;
+			Extent.Offset  += Sectors * SectorSize;
+			Extent.Sectors -= Sectors;
+			if (Extent.Sectors == 0)
+				FreeExtents.RemoveAt(i);
+			return Offset;
+		}
+
+		const int64 Offset = FileEnd;
+		FileEnd += Sectors * SectorSize;
+		return Offset;
+	}
+
+	void FreeSectors(int64 Offset, int64 Sectors)
+	{
+		if (Sectors <= 0)
+			return;
+
+		// Kept sorted, adjacent extents merged.
+		int32 Index = Algo::LowerBoundBy(FreeExtents, Offset, &FRegionExtent::Offset);
+		FreeExtents.Insert({Offset, Sectors}, Index);
+
+		if (Index + 1 < FreeExtents.Num() && FreeExtents[Index].Offset + FreeExtents[Index].Sectors * SectorSize == FreeExtents[Index + 1].Offset)
+		{
+			FreeExtents[Index].Sectors += FreeExtents[Index + 1].Sectors;
+			FreeExtents.RemoveAt(Index + 1);
+		}
+		if (Index > 0 && FreeExtents[Index - 1].Offset + FreeExtents[Index - 1].Sectors * SectorSize == FreeExtents[Index].Offset)
+		{
+			FreeExtents[Index - 1].Sectors += FreeExtents[Index].Sectors;
+			FreeExtents.RemoveAt(Index);
+		}
+	}
+};
+
+FTerrainRegionStore::FTerrainRegionStore(const FString& InDirectory)
+	: Directory(InDirectory)
+{
+}
+
+FTerrainRegionStore::~FTerrainRegionStore() = default;
+
+TSharedRef<FTerrainRegionStore::FRegion, ESPMode::ThreadSafe> FTerrainRegionStore::FindOrLoadRegion(const FIntVector& ChunkCoords, int32& OutSlot)
+{
+	const FIntVector RegionCoords(
+		FloorDiv(ChunkCoords.X, RegionSizeX),
+		FloorDiv(ChunkCoords.Y, RegionSizeY),
+		FloorDiv(ChunkCoords.Z, RegionSizeZ));
+
+	const FIntVector Local = ChunkCoords - FIntVector(RegionCoords.X * RegionSizeX, RegionCoords.Y * RegionSizeY, RegionCoords.Z * RegionSizeZ);
+	OutSlot = Local.X + Local.Y * RegionSizeX + Local.Z * RegionSizeX * RegionSizeY;
+
+	FScopeLock ScopeLock(&RegionsLock);
+	if (const TSharedRef<FRegion, ESPMode::ThreadSafe>* Found = Regions.Find(RegionCoords))
+		return *Found;
+
+	// One table read per region, instead of one open / stat per chunk.
+	TSharedRef<FRegion, ESPMode::ThreadSafe> Region = MakeShared<FRegion, ESPMode::ThreadSafe>();
+	Region->Path = Directory / FString::Printf(TEXT("TerrainRegion_%d_%d_%d.%s"),
+		RegionCoords.X, RegionCoords.Y, RegionCoords.Z, FileExtension);
+	Region->LoadTable();
+
+	Regions.Add(RegionCoords, Region);
+	return Region;
+}
+
+bool FTerrainRegionStore::Contains(const FIntVector& ChunkCoords)
+{
+	int32 SlotIndex = 0;
+	TSharedRef<FRegion, ESPMode::ThreadSafe> Region = FindOrLoadRegion(ChunkCoords, SlotIndex);
+
+	FScopeLock ScopeLock(&Region->Lock);
+	return Region->Slots[SlotIndex].Size > 0;
+}
+
+bool FTerrainRegionStore::Read(const FIntVector& ChunkCoords, TArray<uint8>& OutBytes)
+{
+	TERRAIN_TRACE_SCOPE(IO.Read);
+
+	int32 SlotIndex = 0;
+	TSharedRef<FRegion, ESPMode::ThreadSafe> Region = FindOrLoadRegion(ChunkCoords, SlotIndex);
+
+	FScopeLock ScopeLock(&Region->Lock);
+	const FRegionSlot& Slot = Region->Slots[SlotIndex];
+	if (Slot.Size <= 0)
+		return false;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!Region->Mapping)
+		Region->Mapping.Reset(PlatformFile.OpenMapped(*Region->Path));
+
+	// Only the sectors of this blob are paged in.
+	if (Region->Mapping)
+	{
+		TUniquePtr<IMappedFileRegion> Mapped(Region->Mapping->MapRegion(Slot.Offset, Slot.Size));
+		if (Mapped)
+		{
+			OutBytes.SetNumUninitialized(Slot.Size);
+			FMemory::Memcpy(OutBytes.GetData(), Mapped->GetMappedPtr(), Slot.Size);
+			return true;
+		}
+	}
+
+	// Platforms without file mapping read the blob instead.
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*Region->Path));
+	OutBytes.SetNumUninitialized(Slot.Size);
+	return Handle && Handle->Seek(Slot.Offset) && Handle->Read(OutBytes.GetData(), Slot.Size);
+}
+
+bool FTerrainRegionStore::Write(const FIntVector& ChunkCoords, const TArray<uint8>& Bytes)
+{
+	TERRAIN_TRACE_SCOPE(IO.Write);
+
+	int32 SlotIndex = 0;
+	TSharedRef<FRegion, ESPMode::ThreadSafe> Region = FindOrLoadRegion(ChunkCoords, SlotIndex);
+
+	FScopeLock ScopeLock(&Region->Lock);
+	const FRegionSlot OldSlot = Region->Slots[SlotIndex];
+	if (Bytes.IsEmpty() && OldSlot.Size <= 0)
+		return true;
+
+	// The mapping cannot see a grown file, and some platforms refuse to write a mapped file.
+	Region->Mapping.Reset();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*Directory);
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Region->Path, true, true));
+	if (!Handle)
+	{
+		UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to open terrain region file: %s"), *Region->Path);
+		return false;
+	}
+
+	if (!Region->bOnDisk)
+	{
+		TArray<uint8> Table;
+		FMemoryWriter Ar(Table);
+		uint32 Magic = RegionMagic, Version = RegionVersion, NumSlots = SlotsPerRegion, FileSectorSize = SectorSize;
+		Ar << Magic << Version << NumSlots << FileSectorSize;
+		for (FRegionSlot& Slot : Region->Slots)
+			SerializeSlot(Ar, Slot);
+
+		if (!Handle->Seek(0) || !Handle->Write(Table.GetData(), Table.Num()))
+			return false;
+		Region->bOnDisk = true;
+	}
+
+	// Dropped slots would point into the sectors about to be reused.
+	for (const int32 DroppedSlot : Region->DroppedSlots)
+	{
+		TArray<uint8> Entry;
+		FMemoryWriter Ar(Entry);
+		FRegionSlot Empty;
+		SerializeSlot(Ar, Empty);
+		if (!Handle->Seek(HeaderBytes + DroppedSlot * SlotBytes) || !Handle->Write(Entry.GetData(), Entry.Num()))
+			return false;
+	}
+	Region->DroppedSlots.Reset();
+
+	FRegionSlot NewSlot;
+	if (!Bytes.IsEmpty())
+	{
+		NewSlot.Size    = Bytes.Num();
+		NewSlot.Sectors = static_cast<int32>((Bytes.Num() + SectorSize - 1) / SectorSize);
+		NewSlot.Offset  = Region->AllocateSectors(NewSlot.Sectors);
+
+		// The blob must be on disk before the slot points to it.
+		if (!Handle->Seek(NewSlot.Offset) || !Handle->Write(Bytes.GetData(), Bytes.Num()) || !Handle->Flush())
+		{
+			Region->FreeSectors(NewSlot.Offset, NewSlot.Sectors);
+			UE_LOG(LogDestructionTerrain, Error, TEXT("❌ Failed to write chunk (%d, %d, %d) to %s"),
+				ChunkCoords.X, ChunkCoords.Y, ChunkCoords.Z, *Region->Path);
+			return false;
+		}
+	}
+
+	TArray<uint8> Entry;
+	FMemoryWriter Ar(Entry);
+	SerializeSlot(Ar, NewSlot);
+	if (!Handle->Seek(HeaderBytes + SlotIndex * SlotBytes) || !Handle->Write(Entry.GetData(), Entry.Num()) || !Handle->Flush())
+	{
+		Region->FreeSectors(NewSlot.Offset, NewSlot.Sectors);
+		return false;
+	}
+
+	// The previous blob is only reused once nothing points to it.
+	Region->Slots[SlotIndex] = NewSlot;
+	Region->FreeSectors(OldSlot.Offset, OldSlot.Sectors);
+	return true;
+}
+
+void FTerrainRegionStore::GetStoredChunks(TArray<FIntVector>& OutCoords)
+{
+	// Regions written this session are on disk as well: the directory lists them all.
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(Directory / FString::Printf(TEXT("TerrainRegion_*.%s"), FileExtension)), true, false);
+
+	for (const FString& File : Files)
+	{
+		TArray<FString> Parts;
+		FPaths::GetBaseFilename(File).ParseIntoArray(Parts, TEXT("_"));
+		if (Parts.Num() != 4)
+			continue;
+
+		const FIntVector RegionCoords(FCString::Atoi(*Parts[1]), FCString::Atoi(*Parts[2]), FCString::Atoi(*Parts[3]));
+		const FIntVector FirstChunk(RegionCoords.X * RegionSizeX, RegionCoords.Y * RegionSizeY, RegionCoords.Z * RegionSizeZ);
+
+		int32 FirstSlot = 0;
+		TSharedRef<FRegion, ESPMode::ThreadSafe> Region = FindOrLoadRegion(FirstChunk, FirstSlot);
+
+		FScopeLock ScopeLock(&Region->Lock);
+		for (int32 SlotIndex = 0; SlotIndex < Region->Slots.Num(); SlotIndex++)
+		{
+			if (Region->Slots[SlotIndex].Size <= 0)
+				continue;
+
+			OutCoords.Add(FirstChunk + FIntVector(
+				SlotIndex % RegionSizeX,
+				(SlotIndex / RegionSizeX) % RegionSizeY,
+				SlotIndex / (RegionSizeX * RegionSizeY)));
+		}
+	}
+}
+
+void FTerrainRegionStore::ReleaseHandles()
+{
+	FScopeLock ScopeLock(&RegionsLock);
+	for (TPair<FIntVector, TSharedRef<FRegion, ESPMode::ThreadSafe>>& Entry : Regions)
+	{
+		FScopeLock RegionLock(&Entry.Value->Lock);
+		Entry.Value->Mapping.Reset();
+	}
+}
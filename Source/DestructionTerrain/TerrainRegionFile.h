@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FTerrainRegionStore
+ *
+ * Chunk saves grouped in region files of RegionSizeX × RegionSizeY × RegionSizeZ chunks, instead of one file per chunk.
+ * A region file starts with a table of one slot per chunk (offset and size of its blob), followed by the blobs
+ * (binary chunk files, see TerrainChunkFormat) in SectorSize sectors. The table of a region is read once; chunks
+ * are then looked up without touching the filesystem, and read by mapping only the sectors of their blob.
+ *
+ * Thread-safe: streaming workers read while the save task writes.
+ */
+class DESTRUCTIONTERRAIN_API FTerrainRegionStore
+{
+public:
+	/** Chunks per side of a region. */
+	static constexpr int32 RegionSizeX = 16;
+	static constexpr int32 RegionSizeY = 16;
+	static constexpr int32 RegionSizeZ = 4;
+
+	/** Allocation unit of the blobs (a page, so that a chunk read only maps its own pages). */
+	static constexpr int64 SectorSize = 4096;
+
+	/** File extension (without dot) of region files. */
+	static const TCHAR* const FileExtension;
+
+	/** @param InDirectory - Absolute directory of the region files (created on the first write). */
+	explicit FTerrainRegionStore(const FString& InDirectory);
+	~FTerrainRegionStore();
+
+	/** True if a blob is stored for the chunk at ChunkCoords. */
+	bool Contains(const FIntVector& ChunkCoords);
+
+	/** Copies the blob of a chunk. Returns false if the chunk has none or its region cannot be read. */
+	bool Read(const FIntVector& ChunkCoords, TArray<uint8>& OutBytes);
+
+	/**
+	 * Stores the blob of a chunk; empty bytes remove it. The blob is written to free sectors and flushed before the
+	 * slot points to it, so that a crash mid-write keeps the previous blob.
+	 */
+	bool Write(const FIntVector& ChunkCoords, const TArray<uint8>& Bytes);
+
+	/** Coordinates of every chunk with a blob, in the region files of Directory (reads the tables not read yet). */
+	void GetStoredChunks(TArray<FIntVector>& OutCoords);
+
+	/** Closes the file mappings (regions reopen them on demand). */
+	void ReleaseHandles();
+
+private:
+	struct FRegion;
+
+	/** Returns the region holding ChunkCoords, reading its table the first time. Sets OutSlot to the chunk's slot. */
+	TSharedRef<FRegion, ESPMode::ThreadSafe> FindOrLoadRegion(const FIntVector& ChunkCoords, int32& OutSlot);
+
+	FString Directory;
+
+	FCriticalSection RegionsLock;
+	TMap<FIntVector, TSharedRef<FRegion, ESPMode::ThreadSafe>> Regions;
+};
@@ -0,0 +1,591 @@
+#include "TerrainRenderComponent.h"
+#include "DestructionTerrain.h"
+#include "DynamicMeshBuilder.h"
+#include "Engine/Engine.h"
+#include "LocalVertexFactory.h"
+#include "MaterialDomain.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialRenderProxy.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PrimitiveSceneProxy.h"
+#include "RenderingThread.h"
+#include "SceneInterface.h"
+#include "SceneManagement.h"
+#include "StaticMeshResources.h"
+#include "TerrainGPUGenerator.h"
+
+namespace
+{
+	/** GPU resources of one mesh block. */
+	struct FTerrainRenderBlock
+	{
+		FStaticMeshVertexBuffers VertexBuffers;
+		FDynamicMeshIndexBuffer32 IndexBuffer;
+		FLocalVertexFactory VertexFactory;
+		int32 NumVertices = 0;
+		int32 NumTriangles = 0;
+
+		explicit FTerrainRenderBlock(ERHIFeatureLevel::Type FeatureLevel)
+			: VertexFactory(FeatureLevel, "FTerrainRenderBlock")
+		{
+		}
+
+		/** Fills the CPU side of the buffers from the mesher output (any thread, before InitResources()). */
+		void SetData(const FTerrainMeshData& Mesh)
+		{
+			NumVertices  = Mesh.Vertices.Num();
+			NumTriangles = Mesh.Triangles.Num() / 3;
+
+			VertexBuffers.PositionVertexBuffer.Init(Mesh.Vertices);
+
+			// Same tangent frame as the procedural mesh backend: X tangent along +X, normal from the mesher.
+			const FVector3f TangentX(1.0f, 0.0f, 0.0f);
+			VertexBuffers.StaticMeshVertexBuffer.Init(NumVertices, 1);
+			for (int32 i = 0; i < NumVertices; i++)
+			{
+				const FVector3f& Normal = Mesh.Normals[i];
+				VertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(i, TangentX, FVector3f::CrossProduct(Normal, TangentX), Normal);
+				VertexBuffers.StaticMeshVertexBuffer.SetVertexUV(i, 0, FVector2f::ZeroVector);
+			}
+
+			IndexBuffer.Indices.SetNumUninitialized(Mesh.Triangles.Num());
+			FMemory::Memcpy(IndexBuffer.Indices.GetData(), Mesh.Triangles.GetData(), Mesh.Triangles.Num() * sizeof(int32));
+		}
+
+		void InitResources(FRHICommandListBase& RHICmdList)
+		{
+			VertexBuffers.PositionVertexBuffer.InitResource(RHICmdList);
+			VertexBuffers.StaticMeshVertexBuffer.InitResource(RHICmdList);
+			VertexBuffers.ColorVertexBuffer.InitResource(RHICmdList);
+			IndexBuffer.InitResource(RHICmdList);
+
+			// No color buffer: BindColorVertexBuffer() falls back to the default white stream.
+			FLocalVertexFactory::FDataType Data;
+			VertexBuffers.PositionVertexBuffer.BindPositionVertexBuffer(&VertexFactory, Data);
+			VertexBuffers.StaticMeshVertexBuffer.BindTangentVertexBuffer(&VertexFactory, Data);
+			VertexBuffers.StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(&VertexFactory, Data);
+			VertexBuffers.StaticMeshVertexBuffer.BindLightMapVertexBuffer(&VertexFactory, Data, 0);
+			VertexBuffers.ColorVertexBuffer.BindColorVertexBuffer(&VertexFactory, Data);
+			VertexFactory.SetData(RHICmdList, Data);
+			VertexFactory.InitResource(RHICmdList);
+		}
+
+		void ReleaseResources()
+		{
+			VertexBuffers.PositionVertexBuffer.ReleaseResource();
+			VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+			VertexBuffers.ColorVertexBuffer.ReleaseResource();
+			IndexBuffer.ReleaseResource();
+			VertexFactory.ReleaseResource();
+		}
+	};
+
+	/** Vertex stream over a buffer the GPU generation wrote (the buffer is owned by the FTerrainGPUMesh). */
+	class FTerrainGPUVertexBuffer final : public FVertexBuffer
+	{
+	public:
+		FTerrainGPUVertexBuffer(FRDGPooledBuffer* InBuffer, EPixelFormat InFormat)
+			: Buffer(InBuffer)
+			, Format(InFormat)
+		{
+		}
+
+		virtual void InitRHI(FRHICommandListBase& RHICmdList) override
+		{
+			VertexBufferRHI = Buffer->GetRHI();
+			SRV = RHICmdList.CreateShaderResourceView(VertexBufferRHI,
+				FRHIViewDesc::CreateBufferSRV().SetType(FRHIViewDesc::EBufferType::Typed).SetFormat(Format));
+		}
+
+		virtual void ReleaseRHI() override
+		{
+			SRV.SafeRelease();
+			FVertexBuffer::ReleaseRHI();
+		}
+
+		FShaderResourceViewRHIRef SRV;
+
+	private:
+		FRDGPooledBuffer* Buffer;
+		EPixelFormat Format;
+	};
+
+	/** GPU resources of a mesh generated on the GPU: non-indexed, drawn with its indirect arguments. */
+	struct FTerrainGPURenderBlock
+	{
+		TSharedRef<FTerrainGPUMesh, ESPMode::ThreadSafe> Mesh;
+		FTerrainGPUVertexBuffer PositionBuffer;
+		FTerrainGPUVertexBuffer TangentBuffer;
+		FTerrainGPUVertexBuffer TexCoordBuffer;
+		FLocalVertexFactory VertexFactory;
+
+		FTerrainGPURenderBlock(ERHIFeatureLevel::Type FeatureLevel, const TSharedRef<FTerrainGPUMesh, ESPMode::ThreadSafe>& InMesh)
+			: Mesh(InMesh)
+			, PositionBuffer(InMesh->Positions.GetReference(), PF_R32_FLOAT)
+			, TangentBuffer(InMesh->Tangents.GetReference(), PF_R8G8B8A8_SNORM)
+			, TexCoordBuffer(InMesh->TexCoords.GetReference(), PF_G32R32F)
+			, VertexFactory(FeatureLevel, "FTerrainGPURenderBlock")
+		{
+		}
+
+		void InitResources(FRHICommandListBase& RHICmdList)
+		{
+			PositionBuffer.InitResource(RHICmdList);
+			TangentBuffer.InitResource(RHICmdList);
+			TexCoordBuffer.InitResource(RHICmdList);
+
+			// Same layout as FTerrainRenderBlock: float3 position, two packed normals, one float2 UV, white color.
+			FLocalVertexFactory::FDataType Data;
+			Data.PositionComponent = FVertexStreamComponent(&PositionBuffer, 0, sizeof(FVector3f), VET_Float3);
+			Data.PositionComponentSRV = PositionBuffer.SRV;
+			Data.TangentBasisComponents[0] = FVertexStreamComponent(&TangentBuffer, 0, 2 * sizeof(FPackedNormal), VET_PackedNormal);
+			Data.TangentBasisComponents[1] = FVertexStreamComponent(&TangentBuffer, sizeof(FPackedNormal), 2 * sizeof(FPackedNormal), VET_PackedNormal);
+			Data.TangentsSRV = TangentBuffer.SRV;
+			Data.TextureCoordinates.Add(FVertexStreamComponent(&TexCoordBuffer, 0, sizeof(FVector2f), VET_Float2));
+			Data.TextureCoordinatesSRV = TexCoordBuffer.SRV;
+			Data.NumTexCoords = 1;
+			Data.ColorComponent = FVertexStreamComponent(&GNullColorVertexBuffer, 0, 0, VET_Color, EVertexStreamUsage::ManualFetch);
+			Data.ColorComponentsSRV = GNullColorVertexBuffer.VertexBufferSRV;
+			VertexFactory.SetData(RHICmdList, Data);
+			VertexFactory.InitResource(RHICmdList);
+		}
+
+		void ReleaseResources()
+		{
+			PositionBuffer.ReleaseResource();
+			TangentBuffer.ReleaseResource();
+			TexCoordBuffer.ReleaseResource();
+			VertexFactory.ReleaseResource();
+		}
+	};
+
+	class FTerrainRenderSceneProxy final : public FPrimitiveSceneProxy
+	{
+	public:
+		FTerrainRenderSceneProxy(UTerrainRenderComponent* Component, const TMap<int32, FTerrainMeshData>& Blocks,
+			const TSharedPtr<FTerrainGPUMesh, ESPMode::ThreadSafe>& GPUMesh)
+			: FPrimitiveSceneProxy(Component)
+			, MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+		{
+			Material = Component->GetMaterial(0);
+			if (!Material)
+				Material = UMaterial::GetDefaultMaterial(MD_Surface);
+
+			for (const TPair<int32, FTerrainMeshData>& Pair : Blocks)
+			{
+				FTerrainRenderBlock* Block = new FTerrainRenderBlock(GetScene().GetFeatureLevel());
+				Block->SetData(Pair.Value);
+				RenderBlocks.Add(Pair.Key, TUniquePtr<FTerrainRenderBlock>(Block));
+
+				ENQUEUE_RENDER_COMMAND(InitTerrainRenderBlock)([Block](FRHICommandListImmediate& RHICmdList)
+				{
+					Block->InitResources(RHICmdList);
+				});
+			}
+
+			if (GPUMesh.IsValid())
+			{
+				FTerrainGPURenderBlock* Block = new FTerrainGPURenderBlock(GetScene().GetFeatureLevel(), GPUMesh.ToSharedRef());
+				GPUBlock.Reset(Block);
+
+				// Enqueued after the generation graph: the extracted buffers exist by the time this runs.
+				ENQUEUE_RENDER_COMMAND(InitTerrainGPURenderBlock)([Block](FRHICommandListImmediate& RHICmdList)
+				{
+					Block->InitResources(RHICmdList);
+				});
+			}
+		}
+
+		virtual ~FTerrainRenderSceneProxy() override
+		{
+			for (TPair<int32, TUniquePtr<FTerrainRenderBlock>>& Pair : RenderBlocks)
+				Pair.Value->ReleaseResources();
+			if (GPUBlock)
+				GPUBlock->ReleaseResources();
+		}
+
+		/** Replaces (or removes, when Block is null) one block; takes ownership of Block. */
+		void SetBlock_RenderThread(FRHICommandListBase& RHICmdList, int32 BlockIndex, FTerrainRenderBlock* Block)
+		{
+			check(IsInRenderingThread());
+
+			if (TUniquePtr<FTerrainRenderBlock>* Existing = RenderBlocks.Find(BlockIndex))
+			{
+				(*Existing)->ReleaseResources();
+				RenderBlocks.Remove(BlockIndex);
+			}
+
+			if (Block)
+			{
+				Block->InitResources(RHICmdList);
+				RenderBlocks.Add(BlockIndex, TUniquePtr<FTerrainRenderBlock>(Block));
+			}
+		}
+
+		virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily,
+			uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+		{
+			const bool bWireframe = AllowDebugViewmodes() && ViewFamily.EngineShowFlags.Wireframe;
+
+			FMaterialRenderProxy* MaterialProxy = Material->GetRenderProxy();
+			if (bWireframe)
+			{
+				FColoredMaterialRenderProxy* WireframeMaterialInstance = new FColoredMaterialRenderProxy(
+					GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy() : nullptr,
+					FLinearColor(0.0f, 0.5f, 1.0f));
+				Collector.RegisterOneFrameMaterialProxy(WireframeMaterialInstance);
+				MaterialProxy = WireframeMaterialInstance;
+			}
+
+			for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+			{
+				if (!(VisibilityMap & (1 << ViewIndex)))
+					continue;
+
+				for (const TPair<int32, TUniquePtr<FTerrainRenderBlock>>& Pair : RenderBlocks)
+				{
+					const FTerrainRenderBlock& Block = *Pair.Value;
+					if (Block.NumTriangles == 0)
+						continue;
+
+					FMeshBatch& Mesh = AllocateMeshBatch(Collector, Block.VertexFactory, MaterialProxy, bWireframe);
+					FMeshBatchElement& BatchElement = Mesh.Elements[0];
+					BatchElement.IndexBuffer = &Block.IndexBuffer;
+					BatchElement.FirstIndex = 0;
+					BatchElement.NumPrimitives = Block.NumTriangles;
+					BatchElement.MinVertexIndex = 0;
+					BatchElement.MaxVertexIndex = Block.NumVertices - 1;
+
+					Collector.AddMesh(ViewIndex, Mesh);
+				}
+
+				if (GPUBlock)
+				{
+					// The triangle count only exists on the GPU: DrawPrimitiveIndirect, no index buffer.
+					FMeshBatch& Mesh = AllocateMeshBatch(Collector, GPUBlock->VertexFactory, MaterialProxy, bWireframe);
+					FMeshBatchElement& BatchElement = Mesh.Elements[0];
+					BatchElement.IndexBuffer = nullptr;
+					BatchElement.IndirectArgsBuffer = GPUBlock->Mesh->DrawArgs->GetRHI();
+					BatchElement.IndirectArgsOffset = 0;
+					BatchElement.FirstIndex = 0;
+					BatchElement.NumPrimitives = 0;
+					BatchElement.MinVertexIndex = 0;
+					BatchElement.MaxVertexIndex = GPUBlock->Mesh->MaxVertices - 1;
+
+					Collector.AddMesh(ViewIndex, Mesh);
+				}
+			}
+		}
+
+		virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+		{
+			FPrimitiveViewRelevance Result;
+			Result.bDrawRelevance = IsShown(View);
+			Result.bShadowRelevance = IsShadowCast(View);
+			Result.bDynamicRelevance = true;
+			Result.bRenderInMainPass = ShouldRenderInMainPass();
+			Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+			Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+			Result.bTranslucentSelfShadow = bCastVolumetricTranslucentShadow;
+			MaterialRelevance.SetPrimitiveViewRelevance(Result);
+			Result.bVelocityRelevance = DrawsVelocity() && Result.bOpaque && Result.bRenderInMainPass;
+			return Result;
+		}
+
+		virtual bool CanBeOccluded() const override { return !MaterialRelevance.bDisableDepthTest; }
+
+		virtual SIZE_T GetTypeHash() const override
+		{
+			static size_t UniquePointer;
+			return reinterpret_cast<size_t>(&UniquePointer);
+		}
+
+		virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize(); }
+
+		uint32 GetAllocatedSize() const { return FPrimitiveSceneProxy::GetAllocatedSize() + RenderBlocks.GetAllocatedSize(); }
+
+	private:
+		/** Mesh batch of one block with this primitive's uniform buffer; the caller fills in the geometry of Elements[0]. */
+		FMeshBatch& AllocateMeshBatch(FMeshElementCollector& Collector, const FLocalVertexFactory& VertexFactory,
+			FMaterialRenderProxy* MaterialProxy, bool bWireframe) const
+		{
+			FMeshBatch& Mesh = Collector.AllocateMesh();
+			Mesh.bWireframe = bWireframe;
+			Mesh.VertexFactory = &VertexFactory;
+			Mesh.MaterialRenderProxy = MaterialProxy;
+			Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+			Mesh.Type = PT_TriangleList;
+			Mesh.DepthPriorityGroup = SDPG_World;
+			Mesh.bCanApplyViewModeOverrides = false;
+
+			bool bHasPrecomputedVolumetricLightmap;
+			FMatrix PreviousLocalToWorld;
+			int32 SingleCaptureIndex;
+			bool bOutputVelocity;
+			GetScene().GetPrimitiveUniformShaderParameters_RenderThread(GetPrimitiveSceneInfo(), bHasPrecomputedVolumetricLightmap,
+				PreviousLocalToWorld, SingleCaptureIndex, bOutputVelocity);
+			bOutputVelocity |= AlwaysHasVelocity();
+
+			FDynamicPrimitiveUniformBuffer& DynamicPrimitiveUniformBuffer = Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+			DynamicPrimitiveUniformBuffer.Set(Collector.GetRHICommandList(), GetLocalToWorld(), PreviousLocalToWorld, GetBounds(),
+				GetLocalBounds(), GetLocalBounds(), true, bHasPrecomputedVolumetricLightmap, bOutputVelocity, GetCustomPrimitiveData());
+			Mesh.Elements[0].PrimitiveUniformBufferResource = &DynamicPrimitiveUniformBuffer.UniformBuffer;
+			return Mesh;
+		}
+
+		TMap<int32, TUniquePtr<FTerrainRenderBlock>> RenderBlocks;
+		TUniquePtr<FTerrainGPURenderBlock> GPUBlock;
+		UMaterialInterface* Material = nullptr;
+		FMaterialRelevance MaterialRelevance;
+	};
+}
+
+UTerrainRenderComponent::UTerrainRenderComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UTerrainRenderComponent::UpdateBlocks(const TArray<FTerrainMeshBlock>& InBlocks, bool bReplaceAll)
+{
+	if (bReplaceAll)
+	{
+		Blocks.Reset();
+		BlockBounds.Reset();
+		CollisionMesh.Reset();
+		GPUMesh.Reset();
+		GPUMeshBounds.Init();
+	}
+
+	FTerrainRenderSceneProxy* Proxy = bReplaceAll ? nullptr : static_cast<FTerrainRenderSceneProxy*>(SceneProxy);
+
+	for (const FTerrainMeshBlock& InBlock : InBlocks)
+	{
+		if (InBlock.bCollisionOnly)
+		{
+			CollisionMesh = InBlock.Mesh;
+			continue;
+		}
+
+		const int32 BlockIndex = InBlock.SectionIndex;
+		FTerrainRenderBlock* RenderBlock = nullptr;
+
+		if (InBlock.Mesh.IsEmpty())
+		{
+			Blocks.Remove(BlockIndex);
+			BlockBounds.Remove(BlockIndex);
+		}
+		else
+		{
+			Blocks.Add(BlockIndex, InBlock.Mesh);
+
+			FBox Box(ForceInit);
+			for (const FVector3f& Vertex : InBlock.Mesh.Vertices)
+				Box += FVector(Vertex);
+			BlockBounds.Add(BlockIndex, Box);
+
+			if (Proxy)
+			{
+				RenderBlock = new FTerrainRenderBlock(GetScene()->GetFeatureLevel());
+				RenderBlock->SetData(InBlock.Mesh);
+			}
+		}
+
+		// Partial update: only this block's buffers are replaced, the proxy stays alive.
+		if (Proxy)
+		{
+			ENQUEUE_RENDER_COMMAND(UpdateTerrainRenderBlock)([Proxy, BlockIndex, RenderBlock](FRHICommandListImmediate& RHICmdList)
+			{
+				Proxy->SetBlock_RenderThread(RHICmdList, BlockIndex, RenderBlock);
+			});
+		}
+	}
+
+	UpdateLocalBox();
+	UpdateBounds();
+
+	if (Proxy)
+		MarkRenderTransformDirty();
+	else
+		MarkRenderStateDirty();
+
+	UpdateCollision();
+}
+
+void UTerrainRenderComponent::ClearBlocks()
+{
+	if (Blocks.IsEmpty() && CollisionMesh.IsEmpty() && !GPUMesh.IsValid())
+		return;
+
+	Blocks.Reset();
+	BlockBounds.Reset();
+	CollisionMesh.Reset();
+	GPUMesh.Reset();
+	GPUMeshBounds.Init();
+	UpdateLocalBox();
+	UpdateBounds();
+	MarkRenderStateDirty();
+	UpdateCollision();
+}
+
+void UTerrainRenderComponent::SetGPUMesh(const TSharedPtr<FTerrainGPUMesh, ESPMode::ThreadSafe>& InGPUMesh, const FBox& Bounds,
+	const FTerrainMeshData& InCollisionMesh)
+{
+	Blocks.Reset();
+	BlockBounds.Reset();
+	CollisionMesh = InCollisionMesh;
+	GPUMesh = InGPUMesh;
+	GPUMeshBounds = Bounds;
+
+	// The new proxy picks the buffers up; none of them is ever written again.
+	UpdateLocalBox();
+	UpdateBounds();
+	MarkRenderStateDirty();
+	UpdateCollision();
+}
+
+void UTerrainRenderComponent::UpdateLocalBox()
+{
+	LocalBox = GPUMesh.IsValid() ? GPUMeshBounds : FBox(ForceInit);
+	for (const TPair<int32, FBox>& Pair : BlockBounds)
+		LocalBox += Pair.Value;
+}
+
+FPrimitiveSceneProxy* UTerrainRenderComponent::CreateSceneProxy()
+{
+	if (Blocks.IsEmpty() && !GPUMesh.IsValid())
+		return nullptr;
+	return new FTerrainRenderSceneProxy(this, Blocks, GPUMesh);
+}
+
+FBoxSphereBounds UTerrainRenderComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBox.IsValid)
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0f);
+	return FBoxSphereBounds(LocalBox).TransformBy(LocalToWorld);
+}
+
+UBodySetup* UTerrainRenderComponent::GetBodySetup()
+{
+	return BodySetup;
+}
+
+void UTerrainRenderComponent::SetTerrainCollisionEnabled(bool bEnabled)
+{
+	if (bTerrainCollisionEnabled == bEnabled)
+		return;
+
+	bTerrainCollisionEnabled = bEnabled;
+	UpdateCollision();
+}
+
+UBodySetup* UTerrainRenderComponent::CreateBodySetup()
+{
+	UBodySetup* NewBodySetup = NewObject<UBodySetup>(this, NAME_None, IsTemplate() ? RF_Public | RF_ArchetypeObject : RF_NoFlags);
+	NewBodySetup->BodySetupGuid = FGuid::NewGuid();
+	NewBodySetup->bGenerateMirroredCollision = false;
+	NewBodySetup->bDoubleSidedGeometry = true;
+	NewBodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+	return NewBodySetup;
+}
+
+void UTerrainRenderComponent::UpdateCollision()
+{
+	TERRAIN_TRACE_SCOPE(Cook);
+
+	UWorld* World = GetWorld();
+	if (bUseAsyncCooking && World && World->IsGameWorld())
+	{
+		// Only the latest request matters: older cooks still running are aborted.
+		for (UBodySetup* OldBodySetup : AsyncBodySetupQueue)
+			OldBodySetup->AbortPhysicsMeshAsyncCreation();
+
+		// The triangles are gathered here on the game thread; only the cooking itself runs in the background.
+		UBodySetup* NewBodySetup = CreateBodySetup();
+		AsyncBodySetupQueue.Add(NewBodySetup);
+		NewBodySetup->CreatePhysicsMeshesAsync(
+			FOnAsyncPhysicsCookFinished::CreateUObject(this, &UTerrainRenderComponent::FinishPhysicsAsyncCook, NewBodySetup));
+		return;
+	}
+
+	AsyncBodySetupQueue.Reset();
+	if (!BodySetup)
+		BodySetup = CreateBodySetup();
+
+	BodySetup->InvalidatePhysicsData();
+	BodySetup->CreatePhysicsMeshes();
+	RecreatePhysicsState();
+}
+
+void UTerrainRenderComponent::FinishPhysicsAsyncCook(bool bSuccess, UBodySetup* FinishedBodySetup)
+{
+	TERRAIN_TRACE_SCOPE(Cook.Finish);
+
+	const int32 FoundIndex = AsyncBodySetupQueue.Find(FinishedBodySetup);
+	if (FoundIndex == INDEX_NONE)
+		return;
+
+	if (bSuccess)
+	{
+		// Requests older than this one are obsolete.
+		BodySetup = FinishedBodySetup;
+		RecreatePhysicsState();
+		AsyncBodySetupQueue.RemoveAt(0, FoundIndex + 1);
+	}
+	else
+	{
+		AsyncBodySetupQueue.RemoveAt(FoundIndex);
+	}
+}
+
+bool UTerrainRenderComponent::GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+{
+	if (!bTerrainCollisionEnabled)
+		return false;
+
+	int32 VertexBase = 0;
+	auto AppendMesh = [&](const FTerrainMeshData& Mesh)
+	{
+		CollisionData->Vertices.Append(Mesh.Vertices);
+
+		for (int32 i = 0; i + 2 < Mesh.Triangles.Num(); i += 3)
+		{
+			FTriIndices& Triangle = CollisionData->Indices.AddDefaulted_GetRef();
+			Triangle.v0 = VertexBase + Mesh.Triangles[i];
+			Triangle.v1 = VertexBase + Mesh.Triangles[i + 1];
+			Triangle.v2 = VertexBase + Mesh.Triangles[i + 2];
+			CollisionData->MaterialIndices.Add(0);
+		}
+		VertexBase += Mesh.Vertices.Num();
+	};
+
+	if (!CollisionMesh.IsEmpty())
+	{
+		AppendMesh(CollisionMesh);
+	}
+	else
+	{
+		for (const TPair<int32, FTerrainMeshData>& Pair : Blocks)
+			AppendMesh(Pair.Value);
+	}
+
+	CollisionData->bFlipNormals = true;
+	CollisionData->bDeformableMesh = true;
+	CollisionData->bFastCook = true;
+	return true;
+}
+
+bool UTerrainRenderComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+{
+	if (!bTerrainCollisionEnabled)
+		return false;
+	if (!CollisionMesh.IsEmpty())
+		return true;
+
+	for (const TPair<int32, FTerrainMeshData>& Pair : Blocks)
+	{
+		if (!Pair.Value.IsEmpty())
+			return true;
+	}
+	return false;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "TerrainMesher.h"
+#include "TerrainRenderComponent.generated.h"
+
+class FTerrainGPUMesh;
+class UBodySetup;
+
+/** Component used to draw the mesh blocks of a chunk. */
+UENUM(BlueprintType)
+enum class ETerrainRenderBackend : uint8
+{
+	/** Mesh sections of the chunk's UProceduralMeshComponent (every section change rebuilds its render proxy). */
+	ProceduralMesh,
+
+	/** UTerrainRenderComponent: per-block GPU buffers filled straight from the mesher output. */
+	TerrainRenderer
+};
+
+/**
+ * UTerrainRenderComponent
+ *
+ * Lightweight primitive drawing terrain mesh blocks with one vertex factory per block.
+ * Updating a block only replaces that block's GPU buffers on the render thread; the scene proxy
+ * and the other blocks are untouched. Positions are uploaded as the mesher's FVector3f without
+ * conversion, and the same buffers feed the collision cooking.
+ */
+UCLASS(ClassGroup = (Custom))
+class DESTRUCTIONTERRAIN_API UTerrainRenderComponent : public UMeshComponent, public IInterface_CollisionDataProvider
+{
+	GENERATED_BODY()
+
+public:
+	UTerrainRenderComponent(const FObjectInitializer& ObjectInitializer);
+
+	/**
+	 * Replaces the listed blocks (an empty mesh removes its block) and rebuilds the collision.
+	 * A bCollisionOnly block replaces the collision mesh instead of being drawn.
+	 * @param bReplaceAll - Blocks missing from the list are removed too (full rebuild).
+	 */
+	void UpdateBlocks(const TArray<FTerrainMeshBlock>& InBlocks, bool bReplaceAll);
+
+	/** Removes every block. */
+	void ClearBlocks();
+
+	/**
+	 * Replaces every block with a mesh generated on the GPU (see TerrainGPU), drawn from its own buffers.
+	 * @param Bounds - Component-space bounds of the mesh (the vertices never reach the CPU).
+	 * @param InCollisionMesh - Triangles read back for the collision; empty for none.
+	 */
+	void SetGPUMesh(const TSharedPtr<FTerrainGPUMesh, ESPMode::ThreadSafe>& InGPUMesh, const FBox& Bounds, const FTerrainMeshData& InCollisionMesh);
+
+	bool HasGPUMesh() const { return GPUMesh.IsValid(); }
+
+	int32 GetNumBlocks() const { return Blocks.Num(); }
+
+	/** Enables or disables the cooking of this component's collision (e.g. outside the physics radius). */
+	void SetTerrainCollisionEnabled(bool bEnabled);
+
+	/** Cook collision on a background thread; the previous collision stays in use until the new one is ready. */
+	bool bUseAsyncCooking = false;
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual UBodySetup* GetBodySetup() override;
+	//~ End UPrimitiveComponent Interface
+
+	//~ Begin UMeshComponent Interface
+	virtual int32 GetNumMaterials() const override { return 1; }
+	//~ End UMeshComponent Interface
+
+	//~ Begin USceneComponent Interface
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//~ End USceneComponent Interface
+
+	//~ Begin IInterface_CollisionDataProvider Interface
+	virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData) override;
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override;
+	virtual bool WantsNegXTriMesh() override { return false; }
+	//~ End IInterface_CollisionDataProvider Interface
+
+private:
+	/** Cooks the collision again, synchronously or on a background thread (bUseAsyncCooking). */
+	void UpdateCollision();
+
+	/** Creates an empty body setup for this component's collision. */
+	UBodySetup* CreateBodySetup();
+
+	/** Called when a background cook ends: switches to FinishedBodySetup unless a newer one is already in use. */
+	void FinishPhysicsAsyncCook(bool bSuccess, UBodySetup* FinishedBodySetup);
+
+	/** Recomputes LocalBox from BlockBounds. */
+	void UpdateLocalBox();
+
+	/** CPU copy of the drawn blocks, by mesh block index (source of new scene proxies and collision). */
+	TMap<int32, FTerrainMeshData> Blocks;
+
+	/** Component-space bounds of each block. */
+	TMap<int32, FBox> BlockBounds;
+
+	/** Decimated collision mesh; when empty, the drawn blocks are cooked instead. */
+	FTerrainMeshData CollisionMesh;
+
+	/** Mesh drawn from GPU buffers instead of Blocks, until the next full update. */
+	TSharedPtr<FTerrainGPUMesh, ESPMode::ThreadSafe> GPUMesh;
+
+	/** Component-space bounds of GPUMesh. */
+	FBox GPUMeshBounds = FBox(ForceInit);
+
+	/** Union of BlockBounds (and GPUMeshBounds). */
+	FBox LocalBox = FBox(ForceInit);
+
+	bool bTerrainCollisionEnabled = true;
+
+	UPROPERTY(Transient)
+	UBodySetup* BodySetup = nullptr;
+
+	/** Body setups being cooked in the background, oldest first. */
+	UPROPERTY(Transient)
+	TArray<UBodySetup*> AsyncBodySetupQueue;
+};
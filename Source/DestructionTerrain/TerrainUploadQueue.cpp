@@ -0,0 +1,48 @@
+#include "TerrainUploadQueue.h"
+
+void FTerrainUploadQueue::Enqueue(TUniqueFunction<void()> Upload)
+{
+	check(IsInGameThread());
+	Pending.Add(MoveTemp(Upload));
+}
+
+int32 FTerrainUploadQueue::Drain(double BudgetSeconds, int32 MinUploads)
+{
+	check(IsInGameThread());
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 Executed = 0;
+
+	while (Head < Pending.Num())
+	{
+		if (Executed >= MinUploads && FPlatformTime::Seconds() - StartTime >= BudgetSeconds)
+			break;
+
+		// Move the upload out first: running it may enqueue new uploads and reallocate the array.
+		TUniqueFunction<void()> Upload = MoveTemp(Pending[Head]);
+		++Head;
+		++Executed;
+
+		if (Upload)
+			Upload();
+	}
+
+	if (Head >= Pending.Num())
+	{
+		Pending.Reset();
+		Head = 0;
+	}
+	else if (Head > 64 && Head * 2 > Pending.Num())
+	{
+		Pending.RemoveAt(0, Head, EAllowShrinking::No);
+		Head = 0;
+	}
+
+	return Executed;
+}
+
+void FTerrainUploadQueue::Reset()
+{
+	Pending.Reset();
+	Head = 0;
+}
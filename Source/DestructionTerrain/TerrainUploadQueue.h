@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FTerrainUploadQueue
+ *
+ * Game-thread FIFO of pending chunk mesh uploads. Worker results are pushed here instead of
+ * being uploaded immediately, and the owner drains the queue once per frame within a time budget,
+ * so that many chunks finishing at once never turn into a single long frame.
+ */
+class DESTRUCTIONTERRAIN_API FTerrainUploadQueue
+{
+public:
+	/** Adds an upload to the end of the queue (game thread only). */
+	void Enqueue(TUniqueFunction<void()> Upload);
+
+	/**
+	 * Runs queued uploads in order until the budget is spent.
+	 * @param BudgetSeconds - Time allowed for this call.
+	 * @param MinUploads - Uploads always executed, even over budget, so that the queue keeps moving.
+	 * @return Number of uploads executed.
+	 */
+	int32 Drain(double BudgetSeconds, int32 MinUploads = 1);
+
+	/** Number of uploads still waiting. */
+	int32 Num() const { return Pending.Num() - Head; }
+
+	/** Drops every pending upload without running it. */
+	void Reset();
+
+private:
+	TArray<TUniqueFunction<void()>> Pending;
+
+	// Index of the next upload to run; consumed entries are compacted away during Drain().
+	int32 Head = 0;
+};
@@ -0,0 +1,152 @@
+#include "TerrainVoxelAccess.h"
+#include "ProceduralTerrain.h"
+#include "ProceduralTerrainWorld.h"
+
+namespace
+{
+	/** Integer division rounding towards negative infinity. */
+	int32 FloorDiv(int32 Value, int32 Divisor)
+	{
+		return Value >= 0 ? Value / Divisor : -((-Value + Divisor - 1) / Divisor);
+	}
+}
+
+FTerrainVoxelAccess::FTerrainVoxelAccess(AProceduralTerrainWorld* InWorld, int32 InChunkSize)
+	: World(InWorld)
+	, ChunkSize(InChunkSize)
+{
+}
+
+UProceduralTerrain* FTerrainVoxelAccess::FindLoadedChunk(const FIntVector& Coords) const
+{
+	const AProceduralTerrainWorld* Owner = World.Get();
+	if (!Owner)
+		return nullptr;
+
+	UProceduralTerrain* Chunk = Owner->FindChunk(Coords);
+	// A chunk about to receive a new density is skipped: its current samples are obsolete.
+	return Chunk && Chunk->Density.GetSize() == ChunkSize && !Chunk->IsDensityPending() ? Chunk : nullptr;
+}
+
+void FTerrainVoxelAccess::ForEachCopy(const FIntVector& GlobalVoxel,
+	TFunctionRef<void(UProceduralTerrain*, const FIntVector&)> Func) const
+{
+	if (ChunkSize <= 1)
+		return;
+
+	// Along each axis the voxel belongs to one chunk, and to the previous one too when it is on their shared border.
+	const int32 Cells = ChunkSize - 1;
+	int32 NumCandidates[3];
+	int32 ChunkCandidates[3][2];
+	int32 LocalCandidates[3][2];
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		const int32 Chunk = FloorDiv(GlobalVoxel[Axis], Cells);
+		const int32 Local = GlobalVoxel[Axis] - Chunk * Cells;
+		ChunkCandidates[Axis][0] = Chunk;
+		LocalCandidates[Axis][0] = Local;
+		ChunkCandidates[Axis][1] = Chunk - 1;
+		LocalCandidates[Axis][1] = Cells;
+		NumCandidates[Axis] = Local == 0 ? 2 : 1;
+	}
+
+	for (int32 k = 0; k < NumCandidates[2]; k++)
+	for (int32 j = 0; j < NumCandidates[1]; j++)
+	for (int32 i = 0; i < NumCandidates[0]; i++)
+	{
+		const FIntVector Coords(ChunkCandidates[0][i], ChunkCandidates[1][j], ChunkCandidates[2][k]);
+		if (UProceduralTerrain* Chunk = FindLoadedChunk(Coords))
+			Func(Chunk, FIntVector(LocalCandidates[0][i], LocalCandidates[1][j], LocalCandidates[2][k]));
+	}
+}
+
+bool FTerrainVoxelAccess::GetVoxel(const FIntVector& GlobalVoxel, float& OutValue) const
+{
+	bool bFound = false;
+	ForEachCopy(GlobalVoxel, [&](UProceduralTerrain* Chunk, const FIntVector& Local)
+	{
+		if (!bFound)
+		{
+			OutValue = Chunk->Density.Get(Local.X, Local.Y, Local.Z);
+			bFound = true;
+		}
+	});
+	return bFound;
+}
+
+void FTerrainVoxelAccess::ForEachAffectedChunk(const FIntVector& GlobalMin, const FIntVector& GlobalMax,
+	TFunctionRef<void(UProceduralTerrain*, const FIntVector&, const FIntVector&)> Func) const
+{
+	if (ChunkSize <= 1)
+		return;
+
+	// A changed voxel also changes the gradients of its direct neighbours, possibly in the next chunk.
+	const FIntVector Min = GlobalMin - FIntVector(1);
+	const FIntVector Max = GlobalMax + FIntVector(1);
+	const int32 Cells = ChunkSize - 1;
+
+	for (int32 cz = FloorDiv(Min.Z, Cells) - 1; cz <= FloorDiv(Max.Z, Cells); cz++)
+	for (int32 cy = FloorDiv(Min.Y, Cells) - 1; cy <= FloorDiv(Max.Y, Cells); cy++)
+	for (int32 cx = FloorDiv(Min.X, Cells) - 1; cx <= FloorDiv(Max.X, Cells); cx++)
+	{
+		const FIntVector Coords(cx, cy, cz);
+		const FIntVector Origin = GetChunkOrigin(Coords);
+		const FIntVector LocalMin(
+			FMath::Max(Min.X - Origin.X, 0), FMath::Max(Min.Y - Origin.Y, 0), FMath::Max(Min.Z - Origin.Z, 0));
+		const FIntVector LocalMax(
+			FMath::Min(Max.X - Origin.X, Cells), FMath::Min(Max.Y - Origin.Y, Cells), FMath::Min(Max.Z - Origin.Z, Cells));
+		if (LocalMin.X > LocalMax.X || LocalMin.Y > LocalMax.Y || LocalMin.Z > LocalMax.Z)
+			continue;
+
+		if (UProceduralTerrain* Chunk = FindLoadedChunk(Coords))
+			Func(Chunk, LocalMin, LocalMax);
+	}
+}
+
+void FTerrainVoxelAccess::GetStoringChunks(const FIntVector& GlobalMin, const FIntVector& GlobalMax, FIntVector& OutMin, FIntVector& OutMax) const
+{
+	// Chunk c stores voxels c * Cells to (c + 1) * Cells.
+	const int32 Cells = FMath::Max(ChunkSize - 1, 1);
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		OutMin[Axis] = FloorDiv(GlobalMin[Axis] - 1, Cells);
+		OutMax[Axis] = FloorDiv(GlobalMax[Axis], Cells);
+	}
+}
+
+void FTerrainVoxelAccess::BuildHalo(const FIntVector& Coords, FTerrainDensityHalo& OutHalo) const
+{
+	OutHalo.Size = ChunkSize;
+	for (TArray<float>& Face : OutHalo.Faces)
+		Face.Reset();
+
+	if (ChunkSize <= 1)
+		return;
+
+	// The layer outside a face is the second layer of the neighbour (their first layers are the shared border).
+	const int32 S = ChunkSize;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	for (int32 Side = 0; Side < 2; Side++)
+	{
+		FIntVector Offset = FIntVector::ZeroValue;
+		Offset[Axis] = Side == 0 ? -1 : 1;
+
+		const UProceduralTerrain* Neighbour = FindLoadedChunk(Coords + Offset);
+		if (!Neighbour)
+			continue;
+
+		const int32 Layer = Side == 0 ? S - 2 : 1;
+		TArray<float>& Face = OutHalo.Faces[Axis * 2 + Side];
+		Face.SetNumUninitialized(S * S);
+
+		for (int32 v = 0; v < S; v++)
+		for (int32 u = 0; u < S; u++)
+		{
+			FIntVector Voxel;
+			Voxel[Axis] = Layer;
+			Voxel[Axis == 0 ? 1 : 0] = u;
+			Voxel[Axis == 2 ? 1 : 2] = v;
+			Face[u + v * S] = Neighbour->Density.Get(Voxel.X, Voxel.Y, Voxel.Z);
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainMesher.h"
+
+class AProceduralTerrainWorld;
+class UProceduralTerrain;
+
+/**
+ * FTerrainVoxelAccess
+ *
+ * World-level view of the voxels of the loaded chunks, addressed by global voxel coordinates. Chunk c
+ * covers voxels c * (ChunkSize - 1) to c * (ChunkSize - 1) + ChunkSize - 1, so a border voxel is stored
+ * by up to 8 chunks. Edits go through this layer to reach every copy of a voxel with the same value,
+ * and chunks read their one-voxel halo from their neighbours through it. Game thread only.
+ */
+class DESTRUCTIONTERRAIN_API FTerrainVoxelAccess
+{
+public:
+	FTerrainVoxelAccess(AProceduralTerrainWorld* InWorld, int32 InChunkSize);
+
+	int32 GetChunkSize() const { return ChunkSize; }
+
+	/** Calls Func(Chunk, LocalVoxel) for every loaded chunk storing a copy of GlobalVoxel. */
+	void ForEachCopy(const FIntVector& GlobalVoxel, TFunctionRef<void(UProceduralTerrain*, const FIntVector&)> Func) const;
+
+	/** Reads a voxel from one of its loaded copies. False if no chunk storing it is loaded. */
+	bool GetVoxel(const FIntVector& GlobalVoxel, float& OutValue) const;
+
+	/**
+	 * Calls Func(Chunk, LocalMin, LocalMax) for every loaded chunk affected by a change of the voxels in
+	 * [GlobalMin, GlobalMax]: chunks storing them and chunks reading them in their halo. The local box is
+	 * the part of the chunk whose samples or border gradients change (the box grown by one, clamped).
+	 */
+	void ForEachAffectedChunk(const FIntVector& GlobalMin, const FIntVector& GlobalMax,
+		TFunctionRef<void(UProceduralTerrain*, const FIntVector&, const FIntVector&)> Func) const;
+
+	/** Box of the chunk coordinates storing a copy of a voxel in [GlobalMin, GlobalMax], loaded or not. */
+	void GetStoringChunks(const FIntVector& GlobalMin, const FIntVector& GlobalMax, FIntVector& OutMin, FIntVector& OutMax) const;
+
+	/** Fills the halo of chunk Coords from its loaded neighbours; faces without a loaded neighbour stay empty. */
+	void BuildHalo(const FIntVector& Coords, FTerrainDensityHalo& OutHalo) const;
+
+	/** Returns the chunk at Coords if it holds its final density field of ChunkSize³ voxels. */
+	UProceduralTerrain* FindLoadedChunk(const FIntVector& Coords) const;
+
+	/** Global coordinates of the first voxel of chunk Coords. */
+	FIntVector GetChunkOrigin(const FIntVector& Coords) const { return Coords * (ChunkSize - 1); }
+
+private:
+
+	TWeakObjectPtr<AProceduralTerrainWorld> World;
+	int32 ChunkSize = 0;
+};
@@ -0,0 +1,221 @@
+#include "TerrainTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ProceduralTerrain.h"
+#include "ProceduralTerrainWorld.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	constexpr float BenchmarkScale = 50.0f;
+	constexpr float BenchmarkNoiseScale = 0.003f;
+
+	/** Milliseconds since StartTime (FPlatformTime::Seconds()). */
+	double MsSince(double StartTime)
+	{
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	}
+
+	/** Surface through the middle of the chunk, with relief proportional to its size. */
+	void BuildBenchmarkDensity(UProceduralTerrain* Chunk, int32 Size)
+	{
+		Chunk->BuildDensityField(Size, BenchmarkScale, BenchmarkNoiseScale, Size * 0.5f, Size * 0.25f);
+	}
+
+	/** Size of a file relative to Saved/ (0 if missing). */
+	int64 GetSavedFileSize(const FString& FileName)
+	{
+		return FMath::Max<int64>(IFileManager::Get().FileSize(*(FPaths::ProjectSavedDir() / FileName)), 0);
+	}
+
+	/** Scratch directory of a benchmark, relative to Saved/ (emptied before use). */
+	FString MakeScratchDirectory(const FString& Name)
+	{
+		const FString Directory = FTerrainBenchmarkReport::GetDirectory() / TEXT("Scratch") / Name;
+		IFileManager::Get().DeleteDirectory(*(FPaths::ProjectSavedDir() / Directory), false, true);
+		return Directory;
+	}
+}
+
+//────────────────────────────
+// Single Chunk: Generation, Meshing, Digging, Save / Load
+//────────────────────────────
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FTerrainChunkBenchmark, "DestructionTerrain.Benchmark.Chunk",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FTerrainChunkBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 Size : {16, 32, 64, 128})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("ChunkSize%d"), Size));
+		OutTestCommands.Add(FString::FromInt(Size));
+	}
+}
+
+bool FTerrainChunkBenchmark::RunTest(const FString& Parameters)
+{
+	const int32 Size = FCString::Atoi(*Parameters);
+	if (!TestTrue(TEXT("ChunkSize parameter"), Size > 1))
+		return false;
+
+	FTerrainTestWorld TestWorld;
+	FTerrainBenchmarkReport Report(FString::Printf(TEXT("Chunk_%d"), Size));
+	const FString Scratch = MakeScratchDirectory(FString::Printf(TEXT("Chunk_%d"), Size));
+
+	UProceduralTerrain* Chunk = TestWorld.SpawnChunk();
+
+	double StartTime = FPlatformTime::Seconds();
+	BuildBenchmarkDensity(Chunk, Size);
+	Report.Add(*this, TEXT("BuildDensityField"), Size, MsSince(StartTime), FTerrainChunkStats::Get(Chunk));
+
+	StartTime = FPlatformTime::Seconds();
+	Chunk->RebuildMeshFromCurrentDensity();
+	Report.Add(*this, TEXT("RebuildMeshFromCurrentDensity"), Size, MsSince(StartTime), FTerrainChunkStats::Get(Chunk));
+	TestTrue(TEXT("The benchmark terrain has a surface"), FTerrainChunkStats::Get(Chunk).Triangles > 0);
+
+	// A crater at the surface, remeshed asynchronously: timed until its blocks are uploaded.
+	const FVector SurfaceCenter = Chunk->GetComponentLocation() + FVector(Size * 0.5f * BenchmarkScale);
+	StartTime = FPlatformTime::Seconds();
+	Chunk->DigSphere(SurfaceCenter, Size * 0.25f * BenchmarkScale, -20.0f);
+	TestTrue(TEXT("DigSphere remesh completes"), FTerrainTestWorld::WaitForChunk(Chunk));
+	Report.Add(*this, TEXT("DigSphere"), Size, MsSince(StartTime), FTerrainChunkStats::Get(Chunk));
+
+	// Full save, then the delta against the procedural density (only the dug bricks).
+	const FString FullFile = Scratch / TEXT("Full.tchunk");
+	StartTime = FPlatformTime::Seconds();
+	TestTrue(TEXT("SaveDensityToFile"), Chunk->SaveDensityToFile(FullFile));
+	Report.Add(*this, TEXT("SaveDensityToFile"), Size, MsSince(StartTime), {0, 0, GetSavedFileSize(FullFile)});
+
+	const FString DeltaFile = Scratch / TEXT("Delta.tchunk");
+	StartTime = FPlatformTime::Seconds();
+	TestTrue(TEXT("SaveDeltaToFile"), Chunk->SaveDeltaToFile(DeltaFile));
+	Report.Add(*this, TEXT("SaveDeltaToFile"), Size, MsSince(StartTime), {0, 0, GetSavedFileSize(DeltaFile)});
+
+	const FTerrainChunkStats Edited = FTerrainChunkStats::Get(Chunk);
+	const uint32 EditedHash = Chunk->Density.GetContentHash();
+
+	// Loads are timed until the chunk draws its mesh again.
+	auto BenchmarkLoad = [&](const TCHAR* Step, const FString& FileName)
+	{
+		Chunk->ClearAllMeshSections();
+		const double LoadStartTime = FPlatformTime::Seconds();
+		const bool bLoaded = Chunk->LoadDensityFromFile(FileName);
+		TestTrue(FString::Printf(TEXT("%s loads"), Step), bLoaded && FTerrainTestWorld::WaitForChunk(Chunk));
+		Report.Add(*this, Step, Size, MsSince(LoadStartTime), FTerrainChunkStats::Get(Chunk));
+
+		TestEqual(FString::Printf(TEXT("%s restores the density"), Step), Chunk->Density.GetContentHash(), EditedHash);
+		TestEqual(FString::Printf(TEXT("%s restores the mesh"), Step), FTerrainChunkStats::Get(Chunk).Triangles, Edited.Triangles);
+	};
+
+	BenchmarkLoad(TEXT("LoadDensityFromFile.Full"), FullFile);
+	BenchmarkLoad(TEXT("LoadDensityFromFile.Delta"), DeltaFile);
+
+	// Same delta with its mesh cached: the load uploads it instead of marching the chunk.
+	Chunk->bCacheMeshInSaves = true;
+	const FString CachedFile = Scratch / TEXT("Cached.tchunk");
+	StartTime = FPlatformTime::Seconds();
+	TestTrue(TEXT("SaveDeltaToFile with mesh"), Chunk->SaveDeltaToFile(CachedFile));
+	Report.Add(*this, TEXT("SaveDeltaToFile.CachedMesh"), Size, MsSince(StartTime), {0, 0, GetSavedFileSize(CachedFile)});
+	BenchmarkLoad(TEXT("LoadDensityFromFile.CachedMesh"), CachedFile);
+
+	// The same dig through the world, on the corner shared by 4 chunks (edits every copy of the border voxels).
+	AProceduralTerrainWorld* Terrain = FTerrainWorldTestAccess::Spawn(TestWorld.World, Size, 2, 2, Scratch / TEXT("World"));
+	if (TestTrue(TEXT("World restores its chunks"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+	{
+		const float ChunkWorldSize = FTerrainWorldTestAccess::GetChunkWorldSize(Terrain);
+		StartTime = FPlatformTime::Seconds();
+		Terrain->DigAt(FVector(ChunkWorldSize, ChunkWorldSize, Size * 0.5f * BenchmarkScale), Size * 0.25f * BenchmarkScale, -20.0f);
+		Terrain->FlushTerrainEdits();
+		TestTrue(TEXT("DigAt remesh completes"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain));
+		const double DigMs = MsSince(StartTime);
+
+		FTerrainChunkStats WorldStats;
+		for (UProceduralTerrain* WorldChunk : FTerrainWorldTestAccess::GetChunks(Terrain))
+			if (WorldChunk)
+				WorldStats += FTerrainChunkStats::Get(WorldChunk);
+		Report.Add(*this, TEXT("DigAt"), Size, DigMs, WorldStats);
+	}
+
+	TestTrue(TEXT("Benchmark report written"), Report.Write());
+	return true;
+}
+
+//────────────────────────────
+// World: Streaming Fly-Through
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainStreamingBenchmark, "DestructionTerrain.Benchmark.StreamingFlyThrough",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FTerrainStreamingBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 ChunkSize = 32;
+	constexpr int32 ChunksTravelled = 8;
+	constexpr int32 FramesPerChunk = 30;
+	constexpr float DeltaSeconds = 1.0f / 60.0f;
+
+	// Streaming updates run on a timer every UpdateInterval (0.1 s by default).
+	constexpr int32 FramesPerStreamingUpdate = 6;
+
+	FTerrainTestWorld TestWorld;
+	FTerrainBenchmarkReport Report(TEXT("StreamingFlyThrough"));
+
+	AProceduralTerrainWorld* Terrain = FTerrainWorldTestAccess::Spawn(TestWorld.World, ChunkSize, 1, 1,
+		MakeScratchDirectory(TEXT("StreamingFlyThrough")));
+	if (!TestTrue(TEXT("World restores its chunks"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+		return false;
+
+	// Straight flight along +X at 2 chunks per second, camera looking ahead and slightly down.
+	const float ChunkWorldSize = FTerrainWorldTestAccess::GetChunkWorldSize(Terrain);
+	const FVector Start(ChunkWorldSize * 0.5f, ChunkWorldSize * 0.5f, ChunkWorldSize);
+	const FVector ViewDirection = FVector(1.0f, 0.0f, -0.3f).GetSafeNormal();
+	const int32 Frames = ChunksTravelled * FramesPerChunk;
+
+	TArray<double> FrameMs;
+	FrameMs.Reserve(Frames);
+	const double FlightStartTime = FPlatformTime::Seconds();
+
+	for (int32 Frame = 0; Frame < Frames; Frame++)
+	{
+		const FVector Position = Start + FVector(ChunkWorldSize * Frame / FramesPerChunk, 0.0f, 0.0f);
+
+		const double FrameStartTime = FPlatformTime::Seconds();
+		if (Frame % FramesPerStreamingUpdate == 0)
+			Terrain->UpdateStreamedChunksAround(Position, Position, ViewDirection);
+		TestWorld.Tick(DeltaSeconds);
+		FrameMs.Add(MsSince(FrameStartTime));
+	}
+
+	TestTrue(TEXT("Streaming settles after the flight"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain));
+	const double TotalMs = MsSince(FlightStartTime);
+
+	FTerrainChunkStats Loaded;
+	int32 LoadedChunks = 0;
+	for (UProceduralTerrain* Chunk : FTerrainWorldTestAccess::GetChunks(Terrain))
+	{
+		if (Chunk)
+		{
+			Loaded += FTerrainChunkStats::Get(Chunk);
+			++LoadedChunks;
+		}
+	}
+	TestTrue(TEXT("Chunks were streamed in along the path"), LoadedChunks > 1);
+
+	FrameMs.Sort();
+	double SumMs = 0.0;
+	for (const double Ms : FrameMs)
+		SumMs += Ms;
+
+	Report.Add(*this, TEXT("FlyThrough.FrameAvg"), ChunkSize, SumMs / FrameMs.Num(), Loaded);
+	Report.Add(*this, TEXT("FlyThrough.FrameP95"), ChunkSize, FrameMs[FMath::Min(FrameMs.Num() * 95 / 100, FrameMs.Num() - 1)], Loaded);
+	Report.Add(*this, TEXT("FlyThrough.FrameMax"), ChunkSize, FrameMs.Last(), Loaded);
+	Report.Add(*this, TEXT("FlyThrough.Total"), ChunkSize, TotalMs, Loaded);
+
+	TestTrue(TEXT("Benchmark report written"), Report.Write());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
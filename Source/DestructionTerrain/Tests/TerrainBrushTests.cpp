@@ -0,0 +1,189 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TerrainBrush.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	/** Weights closer to 0 than this are on the brush surface: rounding may put them on either side. */
+	constexpr double SurfaceMargin = 1e-3;
+
+	/** Brute-force weight of a voxel (global coordinates), in doubles: 1 at the center, <= 0 outside. */
+	double GetReferenceWeight(const FTerrainVoxelBrush& Brush, const FIntVector& Voxel)
+	{
+		const FVector P(Voxel - Brush.Anchor);
+		const FVector Start(Brush.Start);
+
+		switch (Brush.Shape)
+		{
+		case ETerrainBrushShape::Box:
+		{
+			const FVector D = (P - Start).GetAbs();
+			return 1.0 - FMath::Max3(D.X / Brush.Extent.X, D.Y / Brush.Extent.Y, D.Z / Brush.Extent.Z);
+		}
+		case ETerrainBrushShape::Capsule:
+		{
+			const FVector End(Brush.End);
+			return 1.0 - FMath::PointDistToSegment(P, Start, End) / Brush.Radius;
+		}
+		default:
+			return 1.0 - FVector::Dist(P, Start) / Brush.Radius;
+		}
+	}
+
+	/** A brush of the given shape away from the origin, with non-integer positions so that few voxels lie on its surface. */
+	FTerrainVoxelBrush MakeTestBrush(ETerrainBrushShape Shape, const FVector3f& Start, const FVector3f& End = FVector3f::ZeroVector)
+	{
+		FTerrainVoxelBrush Brush;
+		Brush.Shape = Shape;
+		Brush.Anchor = FIntVector(100, -40, 7);
+		Brush.Start = Start;
+		Brush.End = Shape == ETerrainBrushShape::Capsule ? End : Start;
+		Brush.Radius = 5.3f;
+		Brush.Extent = FVector3f(4.6f, 3.2f, 2.7f);
+		Brush.Strength = -10.0f;
+		return Brush;
+	}
+
+	/** Every voxel the reference weight may reach, with a border of voxels outside. */
+	void GetSearchBox(const FTerrainVoxelBrush& Brush, FIntVector& OutMin, FIntVector& OutMax)
+	{
+		const FVector3f Reach = Brush.Shape == ETerrainBrushShape::Box ? Brush.Extent : FVector3f(Brush.Radius);
+		const FVector3f Min = Brush.Start.ComponentMin(Brush.End) - Reach;
+		const FVector3f Max = Brush.Start.ComponentMax(Brush.End) + Reach;
+		OutMin = Brush.Anchor + FIntVector(FMath::FloorToInt(Min.X), FMath::FloorToInt(Min.Y), FMath::FloorToInt(Min.Z)) - FIntVector(2);
+		OutMax = Brush.Anchor + FIntVector(FMath::CeilToInt(Max.X), FMath::CeilToInt(Max.Y), FMath::CeilToInt(Max.Z)) + FIntVector(2);
+	}
+
+	bool IsInBox(const FIntVector& Voxel, const FIntVector& Min, const FIntVector& Max)
+	{
+		return Voxel.X >= Min.X && Voxel.Y >= Min.Y && Voxel.Z >= Min.Z
+			&& Voxel.X <= Max.X && Voxel.Y <= Max.Y && Voxel.Z <= Max.Z;
+	}
+
+	/**
+	 * Checks GetBounds(), ClipRow() and Evaluate() against the reference weights: voxels clearly inside the brush are
+	 * in its bounds and row spans and get a delta, voxels clearly outside are in no span and get none. The spans must
+	 * be exact: a voxel clearly outside that a span keeps is an error even though its weight would be 0.
+	 */
+	void TestAgainstReference(FAutomationTestBase& Test, const TCHAR* Name, const FTerrainVoxelBrush& Brush)
+	{
+		if (!Test.TestTrue(*FString::Printf(TEXT("%s is valid"), Name), Brush.IsValid()))
+			return;
+
+		FIntVector BoundsMin, BoundsMax;
+		Brush.GetBounds(BoundsMin, BoundsMax);
+
+		FTerrainBrushDelta Delta;
+		const bool bChanged = TerrainBrush::Evaluate(Brush, FIntVector(MIN_int32), FIntVector(MAX_int32),
+			[](const FIntVector&, float&) { return false; }, Delta);
+		Test.TestTrue(*FString::Printf(TEXT("%s changes voxels"), Name), bChanged);
+
+		FIntVector SearchMin, SearchMax;
+		GetSearchBox(Brush, SearchMin, SearchMax);
+
+		int32 NumInside = 0, NumSurface = 0, NumErrors = 0;
+		for (int32 z = SearchMin.Z; z <= SearchMax.Z; z++)
+		for (int32 y = SearchMin.Y; y <= SearchMax.Y; y++)
+		{
+			// Rows are clipped within the bounds, as Evaluate() does (a box's bounds are its spans).
+			int32 SpanMin = BoundsMin.X, SpanMax = BoundsMax.X;
+			const bool bRowHit = y >= BoundsMin.Y && y <= BoundsMax.Y && z >= BoundsMin.Z && z <= BoundsMax.Z
+				&& Brush.ClipRow(y, z, SpanMin, SpanMax);
+
+			for (int32 x = SearchMin.X; x <= SearchMax.X; x++)
+			{
+				const FIntVector Voxel(x, y, z);
+				const double Weight = GetReferenceWeight(Brush, Voxel);
+				const bool bInSpan = bRowHit && x >= SpanMin && x <= SpanMax;
+				const bool bInBounds = IsInBox(Voxel, BoundsMin, BoundsMax);
+				const float VoxelDelta = IsInBox(Voxel, Delta.Min, Delta.Min + Delta.Size - FIntVector(1)) ? Delta.Get(x, y, z) : 0.0f;
+
+				if (Weight > SurfaceMargin)
+				{
+					NumInside++;
+					if (!bInSpan || !bInBounds || VoxelDelta == 0.0f || !IsInBox(Voxel, Delta.DirtyMin, Delta.DirtyMax))
+					{
+						if (NumErrors++ < 8)
+							Test.AddError(FString::Printf(TEXT("%s: voxel %s (weight %.4f) is missed (span %d, bounds %d, delta %g)"),
+								Name, *Voxel.ToString(), Weight, bInSpan, bInBounds, VoxelDelta));
+					}
+				}
+				else if (Weight < -SurfaceMargin)
+				{
+					if (bInSpan || VoxelDelta != 0.0f)
+					{
+						if (NumErrors++ < 8)
+							Test.AddError(FString::Printf(TEXT("%s: voxel %s (weight %.4f) is outside but covered (span %d, delta %g)"),
+								Name, *Voxel.ToString(), Weight, bInSpan, VoxelDelta));
+					}
+				}
+				else
+				{
+					NumSurface++;
+				}
+			}
+		}
+
+		Test.TestTrue(*FString::Printf(TEXT("%s covers voxels"), Name), NumInside > 0);
+		Test.TestTrue(*FString::Printf(TEXT("%s modifies %d voxels (%d inside, %d on the surface)"), Name, Delta.NumModified, NumInside, NumSurface),
+			Delta.NumModified >= NumInside && Delta.NumModified <= NumInside + NumSurface);
+		Test.TestTrue(*FString::Printf(TEXT("%s dirty box lies in its bounds"), Name),
+			IsInBox(Delta.DirtyMin, BoundsMin, BoundsMax) && IsInBox(Delta.DirtyMax, BoundsMin, BoundsMax));
+	}
+}
+
+//────────────────────────────
+// Row Spans
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainBrushReferenceTest, "DestructionTerrain.Brush.MatchesReferenceShapes",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainBrushReferenceTest::RunTest(const FString& Parameters)
+{
+	TestAgainstReference(*this, TEXT("Sphere"), MakeTestBrush(ETerrainBrushShape::Sphere, FVector3f(0.37f, -0.21f, 0.58f)));
+	TestAgainstReference(*this, TEXT("Box"), MakeTestBrush(ETerrainBrushShape::Box, FVector3f(0.37f, -0.21f, 0.58f)));
+
+	// A slanted stroke, one along the rows (X), and one standing on its end.
+	TestAgainstReference(*this, TEXT("Slanted capsule"),
+		MakeTestBrush(ETerrainBrushShape::Capsule, FVector3f(0.3f, 0.1f, -0.4f), FVector3f(7.8f, 4.2f, 2.9f)));
+	TestAgainstReference(*this, TEXT("Capsule along X"),
+		MakeTestBrush(ETerrainBrushShape::Capsule, FVector3f(0.25f, 0.4f, 0.1f), FVector3f(9.25f, 0.4f, 0.1f)));
+	TestAgainstReference(*this, TEXT("Vertical capsule"),
+		MakeTestBrush(ETerrainBrushShape::Capsule, FVector3f(-0.15f, 0.35f, -3.2f), FVector3f(-0.15f, 0.35f, 6.7f)));
+
+	// A capsule whose ends meet is a sphere.
+	TestAgainstReference(*this, TEXT("Point capsule"),
+		MakeTestBrush(ETerrainBrushShape::Capsule, FVector3f(0.37f, -0.21f, 0.58f), FVector3f(0.37f, -0.21f, 0.58f)));
+
+	// Clipping the evaluation keeps the deltas of the voxels inside the clip box only.
+	{
+		const FTerrainVoxelBrush Brush = MakeTestBrush(ETerrainBrushShape::Sphere, FVector3f(0.37f, -0.21f, 0.58f));
+		const FIntVector ClipMin = Brush.Anchor, ClipMax = Brush.Anchor + FIntVector(10);
+
+		FTerrainBrushDelta Full, Clipped;
+		TerrainBrush::Evaluate(Brush, FIntVector(MIN_int32), FIntVector(MAX_int32), [](const FIntVector&, float&) { return false; }, Full);
+		TerrainBrush::Evaluate(Brush, ClipMin, ClipMax, [](const FIntVector&, float&) { return false; }, Clipped);
+
+		int32 NumInClip = 0;
+		bool bMatches = IsInBox(Clipped.Min, ClipMin, ClipMax) && IsInBox(Clipped.Min + Clipped.Size - FIntVector(1), ClipMin, ClipMax);
+		for (int32 z = Full.Min.Z; z < Full.Min.Z + Full.Size.Z && bMatches; z++)
+		for (int32 y = Full.Min.Y; y < Full.Min.Y + Full.Size.Y; y++)
+		for (int32 x = Full.Min.X; x < Full.Min.X + Full.Size.X; x++)
+		{
+			if (!IsInBox(FIntVector(x, y, z), ClipMin, ClipMax))
+				continue;
+
+			NumInClip += Full.Get(x, y, z) != 0.0f;
+			bMatches = bMatches && Clipped.Get(x, y, z) == Full.Get(x, y, z);
+		}
+		TestTrue(TEXT("Clipped deltas match the full evaluation"), bMatches);
+		TestEqual(TEXT("Clipped modified voxels"), Clipped.NumModified, NumInClip);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,323 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TerrainChunkFormat.h"
+#include "TerrainMesher.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	/** Byte offsets of the header fields in a chunk blob, after the 'TCHK' tag (see SerializeHeader()). */
+	namespace HeaderOffset
+	{
+		constexpr int32 Size                  = 8;
+		constexpr int32 Compression           = 21;
+		constexpr int32 UncompressedBytes     = 26;
+		constexpr int32 MeshUncompressedBytes = 39;
+	}
+
+	void PatchInt32(TArray<uint8>& Bytes, int32 Offset, int32 Value)
+	{
+		FMemory::Memcpy(Bytes.GetData() + Offset, &Value, sizeof(int32));
+	}
+
+	/** A smooth Size³ field crossing zero halfway up. */
+	void MakeTestDensity(int32 Size, TArray<float>& OutDensity)
+	{
+		OutDensity.SetNum(Size * Size * Size);
+		for (int32 z = 0; z < Size; z++)
+			for (int32 y = 0; y < Size; y++)
+				for (int32 x = 0; x < Size; x++)
+					OutDensity[x + y * Size + z * Size * Size] = (z - Size * 0.5f) + FMath::Sin(x * 0.7f) * 2.0f + FMath::Cos(y * 0.4f);
+	}
+
+	/** Uncompressed Float32 blob of a Size³ test field. */
+	TArray<uint8> MakeTestBlob(int32 Size)
+	{
+		TArray<float> Density;
+		MakeTestDensity(Size, Density);
+
+		FTerrainChunkHeader Header;
+		Header.Size = Size;
+		TArray<uint8> Bytes;
+		TerrainChunkFormat::Write(Header, Density, Bytes);
+		return Bytes;
+	}
+
+	/** Largest difference between two fields of the same size (MAX_flt if their sizes differ). */
+	float GetMaxError(const TArray<float>& A, const TArray<float>& B)
+	{
+		if (A.Num() != B.Num())
+			return MAX_flt;
+
+		float MaxError = 0.0f;
+		for (int32 i = 0; i < A.Num(); i++)
+			MaxError = FMath::Max(MaxError, FMath::Abs(A[i] - B[i]));
+		return MaxError;
+	}
+
+	const TCHAR* LexCompression(ETerrainChunkCompression Compression)
+	{
+		switch (Compression)
+		{
+		case ETerrainChunkCompression::LZ4:   return TEXT("LZ4");
+		case ETerrainChunkCompression::Oodle: return TEXT("Oodle");
+		default:                              return TEXT("None");
+		}
+	}
+}
+
+//────────────────────────────
+// Round Trips
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainChunkFormatRoundTripTest, "DestructionTerrain.ChunkFormat.RoundTrip",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainChunkFormatRoundTripTest::RunTest(const FString& Parameters)
+{
+	// Odd size: the field does not fill its last brick.
+	constexpr int32 Size = 17;
+	TArray<float> Density;
+	MakeTestDensity(Size, Density);
+
+	float MaxAbs = 0.0f;
+	for (float V : Density)
+		MaxAbs = FMath::Max(MaxAbs, FMath::Abs(V));
+
+	for (const ETerrainChunkCompression Compression : {ETerrainChunkCompression::None, ETerrainChunkCompression::LZ4})
+	{
+		const TCHAR* CompressionName = LexCompression(Compression);
+
+		// Floats come back bit for bit, along with the header fields the writer was given.
+		{
+			FTerrainChunkHeader Header;
+			Header.Size = Size;
+			Header.Scale = 25.0f;
+			Header.IsoLevel = 0.5f;
+			Header.Compression = Compression;
+			TArray<uint8> Bytes;
+			if (!TestTrue(*FString::Printf(TEXT("Float32 / %s blob is written"), CompressionName), TerrainChunkFormat::Write(Header, Density, Bytes)))
+				continue;
+
+			FTerrainChunkHeader Decoded;
+			TArray<float> DecodedDensity;
+			if (!TestTrue(*FString::Printf(TEXT("Float32 / %s blob reads"), CompressionName), TerrainChunkFormat::Read(Bytes, Decoded, DecodedDensity, Size)))
+				continue;
+
+			TestEqual(*FString::Printf(TEXT("Float32 / %s size"), CompressionName), Decoded.Size, Size);
+			TestEqual(*FString::Printf(TEXT("Float32 / %s scale"), CompressionName), Decoded.Scale, 25.0f);
+			TestEqual(*FString::Printf(TEXT("Float32 / %s iso-level"), CompressionName), Decoded.IsoLevel, 0.5f);
+			TestTrue(*FString::Printf(TEXT("Float32 / %s samples are exact"), CompressionName), DecodedDensity == Density);
+		}
+
+		// Quantized samples stay within half a step of the source, whether the step is derived or given.
+		for (const ETerrainDensityEncoding Encoding : {ETerrainDensityEncoding::Quantized16, ETerrainDensityEncoding::Quantized8})
+		{
+			const int32 MaxQuantized = Encoding == ETerrainDensityEncoding::Quantized16 ? MAX_int16 : MAX_int8;
+			const TCHAR* EncodingName = Encoding == ETerrainDensityEncoding::Quantized16 ? TEXT("Quantized16") : TEXT("Quantized8");
+
+			for (const float RequestedStep : {0.0f, 0.25f})
+			{
+				FTerrainChunkHeader Header;
+				Header.Size = Size;
+				Header.Encoding = Encoding;
+				Header.Compression = Compression;
+				Header.QuantizationStep = RequestedStep;
+				const FString Label = FString::Printf(TEXT("%s / %s, step %g"), EncodingName, CompressionName, RequestedStep);
+
+				TArray<uint8> Bytes;
+				FTerrainChunkHeader Decoded;
+				TArray<float> DecodedDensity;
+				if (!TestTrue(*FString::Printf(TEXT("%s round trip"), *Label), TerrainChunkFormat::Write(Header, Density, Bytes)
+					&& TerrainChunkFormat::Read(Bytes, Decoded, DecodedDensity, Size)))
+					continue;
+
+				const float Step = RequestedStep > 0.0f ? RequestedStep : MaxAbs / MaxQuantized;
+				TestNearlyEqual(*FString::Printf(TEXT("%s stored step"), *Label), Decoded.QuantizationStep, Step, Step * 1e-4f);
+
+				// A given step clamps past its range; compare against the clamped source there.
+				TArray<float> Expected = Density;
+				for (float& V : Expected)
+					V = FMath::Clamp(V, -Step * MaxQuantized, Step * MaxQuantized);
+				const float MaxError = GetMaxError(DecodedDensity, Expected);
+				TestTrue(*FString::Printf(TEXT("%s error %g is within half a step (%g)"), *Label, MaxError, Step * 0.5f),
+					MaxError <= Step * 0.5f * (1.0f + 1e-4f));
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainChunkFormatDeltaTest, "DestructionTerrain.ChunkFormat.DeltaRoundTrip",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainChunkFormatDeltaTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Size = 17;
+
+	// Three bricks of a 3³-brick chunk, the last one at the far corner (partly outside the field).
+	FTerrainChunkDelta Delta;
+	Delta.BrickIndices = {0, 4, 26};
+	Delta.Samples.SetNum(Delta.BrickIndices.Num() * FTerrainChunkDelta::SamplesPerBrick);
+	for (int32 i = 0; i < Delta.Samples.Num(); i++)
+		Delta.Samples[i] = FMath::Sin(i * 0.37f) * 6.0f;
+
+	for (const ETerrainChunkCompression Compression : {ETerrainChunkCompression::None, ETerrainChunkCompression::LZ4})
+	{
+		const TCHAR* CompressionName = LexCompression(Compression);
+
+		FTerrainChunkHeader Header;
+		Header.Size = Size;
+		Header.Compression = Compression;
+		Header.BaselineHash = 0xC0FFEE;
+		TArray<uint8> Bytes;
+		if (!TestTrue(*FString::Printf(TEXT("%s delta is written"), CompressionName), TerrainChunkFormat::WriteDelta(Header, Delta, Bytes)))
+			continue;
+
+		FTerrainChunkHeader Decoded;
+		FTerrainChunkDelta DecodedDelta;
+		if (!TestTrue(*FString::Printf(TEXT("%s delta reads"), CompressionName), TerrainChunkFormat::ReadDelta(Bytes, Decoded, DecodedDelta, Size)))
+			continue;
+
+		TestTrue(*FString::Printf(TEXT("%s delta content"), CompressionName), Decoded.Content == ETerrainChunkContent::Delta);
+		TestEqual(*FString::Printf(TEXT("%s baseline hash"), CompressionName), Decoded.BaselineHash, 0xC0FFEEu);
+		TestTrue(*FString::Printf(TEXT("%s brick indices"), CompressionName), DecodedDelta.BrickIndices == Delta.BrickIndices);
+		TestTrue(*FString::Printf(TEXT("%s brick samples"), CompressionName), DecodedDelta.Samples == Delta.Samples);
+
+		// A delta is not a full density, nor the reverse.
+		TArray<float> Density;
+		TestFalse(*FString::Printf(TEXT("%s delta is not read as a density"), CompressionName), TerrainChunkFormat::Read(Bytes, Decoded, Density, Size));
+		TestFalse(*FString::Printf(TEXT("%s delta of another size is rejected"), CompressionName), TerrainChunkFormat::ReadDelta(Bytes, Decoded, DecodedDelta, Size + 1));
+	}
+
+	const TArray<uint8> Full = MakeTestBlob(Size);
+	FTerrainChunkHeader Header;
+	FTerrainChunkDelta DecodedDelta;
+	TestFalse(TEXT("Density is not read as a delta"), TerrainChunkFormat::ReadDelta(Full, Header, DecodedDelta, Size));
+
+	// Bricks outside the chunk, or samples that do not fill the bricks, are refused.
+	{
+		FTerrainChunkHeader DeltaHeader;
+		DeltaHeader.Size = Size;
+		TArray<uint8> Bytes;
+
+		FTerrainChunkDelta Short = Delta;
+		Short.Samples.SetNum(Short.Samples.Num() - 1);
+		TestFalse(TEXT("Delta with missing samples is not written"), TerrainChunkFormat::WriteDelta(DeltaHeader, Short, Bytes));
+
+		FTerrainChunkDelta Outside = Delta;
+		Outside.BrickIndices.Last() = 27;
+		TestTrue(TEXT("Delta with a brick outside the chunk is written"), TerrainChunkFormat::WriteDelta(DeltaHeader, Outside, Bytes));
+		TestFalse(TEXT("Delta with a brick outside the chunk is rejected"), TerrainChunkFormat::ReadDelta(Bytes, Header, DecodedDelta, Size));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainChunkFormatMeshTest, "DestructionTerrain.ChunkFormat.MeshRoundTrip",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainChunkFormatMeshTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Size = 17;
+	TArray<float> Density;
+	MakeTestDensity(Size, Density);
+
+	TArray<FTerrainMeshBlock> Blocks;
+	const TArray<int32> BlockIndices = {0, 1, 2, 3, 4, 5, 6, 7};
+	if (!TestTrue(TEXT("Blocks are extracted"), TerrainMesher::ExtractBlocks(Density, Size, 1.0f, 0.0f, true, 8, BlockIndices, Blocks)))
+		return false;
+
+	FTerrainChunkHeader Header;
+	Header.Size = Size;
+	Header.Compression = ETerrainChunkCompression::LZ4;
+	Header.MeshHash = 1234;
+	TArray<uint8> Bytes;
+	if (!TestTrue(TEXT("Blob with a mesh is written"), TerrainChunkFormat::Write(Header, Density, Bytes, &Blocks)))
+		return false;
+
+	FTerrainChunkHeader Decoded;
+	TArray<FTerrainMeshBlock> DecodedBlocks;
+	if (!TestTrue(TEXT("Cached mesh reads"), TerrainChunkFormat::ReadMesh(Bytes, Decoded, DecodedBlocks, Size)))
+		return false;
+
+	TestEqual(TEXT("Mesh hash"), Decoded.MeshHash, 1234u);
+	if (!TestEqual(TEXT("Block count"), DecodedBlocks.Num(), Blocks.Num()))
+		return false;
+
+	for (int32 i = 0; i < Blocks.Num(); i++)
+	{
+		TestEqual(*FString::Printf(TEXT("Block %d section"), i), DecodedBlocks[i].SectionIndex, Blocks[i].SectionIndex);
+		TestTrue(*FString::Printf(TEXT("Block %d vertices"), i), DecodedBlocks[i].Mesh.Vertices == Blocks[i].Mesh.Vertices);
+		TestTrue(*FString::Printf(TEXT("Block %d triangles"), i), DecodedBlocks[i].Mesh.Triangles == Blocks[i].Mesh.Triangles);
+	}
+
+	// The density next to the mesh is untouched, and a reader of another chunk size never reaches the mesh.
+	TArray<float> DecodedDensity;
+	TestTrue(TEXT("Density next to the mesh reads"), TerrainChunkFormat::Read(Bytes, Decoded, DecodedDensity, Size) && DecodedDensity == Density);
+	TestFalse(TEXT("Mesh of another chunk size is rejected"), TerrainChunkFormat::ReadMesh(Bytes, Decoded, DecodedBlocks, Size + 1));
+	TestFalse(TEXT("Mesh without an expected size is rejected"), TerrainChunkFormat::ReadMesh(Bytes, Decoded, DecodedBlocks, 0));
+	return true;
+}
+
+//────────────────────────────
+// Hostile Headers
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainChunkFormatHostileHeaderTest, "DestructionTerrain.ChunkFormat.RejectsHostileHeaders",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainChunkFormatHostileHeaderTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Size = 16;
+	const TArray<uint8> Valid = MakeTestBlob(Size);
+
+	FTerrainChunkHeader Header;
+	TArray<float> Density;
+	if (!TestTrue(TEXT("Valid blob reads"), TerrainChunkFormat::Read(Valid, Header, Density, Size)))
+		return false;
+	TestEqual(TEXT("Header field layout"), *reinterpret_cast<const int32*>(Valid.GetData() + HeaderOffset::Size), Size);
+
+	// Cut inside the tag, the header and the payload.
+	for (const int32 Length : {0, 3, HeaderOffset::Size + 2, HeaderOffset::MeshUncompressedBytes, Valid.Num() / 2, Valid.Num() - 1})
+	{
+		TArray<uint8> Truncated(Valid.GetData(), Length);
+		TestFalse(*FString::Printf(TEXT("Blob truncated to %d bytes is rejected"), Length), TerrainChunkFormat::Read(Truncated, Header, Density));
+		TestFalse(*FString::Printf(TEXT("Header truncated to %d bytes is rejected"), Length), TerrainChunkFormat::ReadHeader(Truncated, Header));
+	}
+
+	// Sizes past the cap, or other than the reader's chunk.
+	for (const int32 HostileSize : {0, -1, FTerrainChunkHeader::MaxSize + 1, 1024, MAX_int32})
+	{
+		TArray<uint8> Hostile = Valid;
+		PatchInt32(Hostile, HeaderOffset::Size, HostileSize);
+		TestFalse(*FString::Printf(TEXT("Size %d is rejected"), HostileSize), TerrainChunkFormat::ReadHeader(Hostile, Header));
+	}
+	TestFalse(TEXT("Size other than the expected one is rejected"), TerrainChunkFormat::ReadHeader(Valid, Header, Size * 2));
+
+	// A compressed payload claiming to uncompress to 2 GB, at the largest size a header may declare.
+	{
+		TArray<uint8> Hostile = Valid;
+		PatchInt32(Hostile, HeaderOffset::Size, FTerrainChunkHeader::MaxSize);
+		Hostile[HeaderOffset::Compression] = static_cast<uint8>(ETerrainChunkCompression::LZ4);
+		PatchInt32(Hostile, HeaderOffset::UncompressedBytes, MAX_int32);
+		TestFalse(TEXT("Oversize uncompressed payload is rejected"), TerrainChunkFormat::ReadHeader(Hostile, Header));
+	}
+	{
+		TArray<uint8> Hostile = Valid;
+		PatchInt32(Hostile, HeaderOffset::MeshUncompressedBytes, MAX_int32);
+		TestFalse(TEXT("Oversize uncompressed mesh is rejected"), TerrainChunkFormat::ReadHeader(Hostile, Header, Size));
+	}
+
+	// Writers refuse what readers would reject.
+	{
+		FTerrainChunkHeader Oversize;
+		Oversize.Size = FTerrainChunkHeader::MaxSize + 1;
+		TArray<uint8> Bytes;
+		TestFalse(TEXT("Oversize chunk is not written"), TerrainChunkFormat::Write(Oversize, TArray<float>(), Bytes));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
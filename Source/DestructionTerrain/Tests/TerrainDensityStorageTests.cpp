@@ -0,0 +1,157 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ProceduralTerrain.h"
+#include "TerrainDensityStorage.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	constexpr int32 BrickBytes = FTerrainDensityStorage::BrickSize * FTerrainDensityStorage::BrickSize * FTerrainDensityStorage::BrickSize * sizeof(float);
+
+	/** A Size³ field buried below z = 8, in the air from z = 16, with a slope between: only the middle bricks vary. */
+	void MakeLayeredDensity(int32 Size, TArray<float>& OutDensity)
+	{
+		OutDensity.SetNum(Size * Size * Size);
+		for (int32 z = 0; z < Size; z++)
+			for (int32 y = 0; y < Size; y++)
+				for (int32 x = 0; x < Size; x++)
+					OutDensity[x + y * Size + z * Size * Size] = z < 8 ? -4.0f : z >= 16 ? 4.0f : (z - 12) + (x % 3) * 0.25f;
+	}
+}
+
+//────────────────────────────
+// Collapse / Expand
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainDensityStorageCollapseTest, "DestructionTerrain.DensityStorage.CollapsesUniformBricks",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainDensityStorageCollapseTest::RunTest(const FString& Parameters)
+{
+	// A uniform field keeps no brick; writing a voxel expands its brick only.
+	{
+		FTerrainDensityStorage Storage;
+		Storage.InitUniform(17, 3.0f);
+		TestTrue(TEXT("Uniform field"), Storage.IsUniform());
+		TestEqual(TEXT("Uniform field allocates nothing"), Storage.GetAllocatedSize(), (SIZE_T)0);
+		TestFalse(TEXT("Uniform field has no surface"), Storage.CanContainSurface(0.0f));
+
+		Storage.Set(5, 6, 7, -1.0f);
+		TestFalse(TEXT("Edited field is no longer uniform"), Storage.IsUniform());
+		TestEqual(TEXT("Edited voxel"), Storage.Get(5, 6, 7), -1.0f);
+		TestEqual(TEXT("Voxel of the edited brick"), Storage.Get(4, 6, 7), 3.0f);
+		TestEqual(TEXT("Voxel of another brick"), Storage.Get(16, 16, 16), 3.0f);
+		TestTrue(TEXT("Edited field may have a surface"), Storage.CanContainSurface(0.0f));
+		TestTrue(*FString::Printf(TEXT("One brick is expanded (%d bytes)"), (int32)Storage.GetAllocatedSize()),
+			Storage.GetAllocatedSize() >= (SIZE_T)BrickBytes && Storage.GetAllocatedSize() < (SIZE_T)(2 * BrickBytes));
+
+		// Undoing the edit and compacting collapses the field again.
+		Storage.Set(5, 6, 7, 3.0f);
+		Storage.Compact(FIntVector(5, 6, 7), FIntVector(5, 6, 7));
+		TestTrue(TEXT("Field collapses after the undo"), Storage.IsUniform());
+		TestEqual(TEXT("Collapsed value"), Storage.GetUniformValue(), 3.0f);
+		TestEqual(TEXT("Collapsed field allocates nothing"), Storage.GetAllocatedSize(), (SIZE_T)0);
+	}
+
+	// A dense field keeps samples for its varying bricks only, and expands back unchanged.
+	{
+		constexpr int32 Size = 24;
+		TArray<float> Dense;
+		MakeLayeredDensity(Size, Dense);
+
+		FTerrainDensityStorage Storage;
+		Storage.SetFromDense(Size, Dense);
+		TestFalse(TEXT("Layered field is not uniform"), Storage.IsUniform());
+
+		const SIZE_T Allocated = Storage.GetAllocatedSize();
+		TestTrue(*FString::Printf(TEXT("Only the 9 middle bricks keep samples (%d bytes)"), (int32)Allocated),
+			Allocated >= (SIZE_T)(9 * BrickBytes) && Allocated < (SIZE_T)(10 * BrickBytes));
+
+		TArray<float> Expanded;
+		Storage.ToDense(Expanded);
+		TestTrue(TEXT("Layered field expands unchanged"), Expanded == Dense);
+
+		// The top layer of cell bricks only reads air: its cells cannot cross the surface.
+		TArray<uint8> Active;
+		TestEqual(TEXT("Active cell bricks"), Storage.GetActiveCellBricks(0.0f, Active), 18);
+		TestEqual(TEXT("Top cell brick is inactive"), (int32)Active[Active.Num() - 1], 0);
+
+		// A brick copied into a uniform field matches its source; writing the fill value back collapses it.
+		const int32 MiddleBrick = 1 + 3 + 9;
+		float Samples[FTerrainChunkDelta::SamplesPerBrick];
+		Storage.GetBrickSamples(MiddleBrick, Samples);
+
+		FTerrainDensityStorage Copy;
+		Copy.InitUniform(Size, 4.0f);
+		Copy.SetBrickSamples(MiddleBrick, Samples);
+		TestTrue(TEXT("Copied brick matches its source"), Copy.IsBrickEqual(MiddleBrick, Storage, 0.0f));
+		TestFalse(TEXT("Copied brick expands the copy"), Copy.IsUniform());
+
+		for (float& Sample : Samples)
+			Sample = 4.0f;
+		Copy.SetBrickSamples(MiddleBrick, Samples);
+		TestTrue(TEXT("Refilled brick collapses the copy"), Copy.IsUniform());
+	}
+	return true;
+}
+
+//────────────────────────────
+// Truncation and Quantization
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainDensityStorageTruncationTest, "DestructionTerrain.DensityStorage.TruncationClamp",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainDensityStorageTruncationTest::RunTest(const FString& Parameters)
+{
+	// Surface around z = 16 with ±2 of noise: a truncation of 4 flattens the bricks below z = 8 and from z = 24.
+	constexpr int32 Size = 33;
+	constexpr float Truncation = 4.0f;
+	const FVector Origin(1234.0, -5678.0, 250.0);
+	TArray<float> Full, Truncated;
+	UProceduralTerrain::GenerateDensity(Origin, Size, 50.0f, 0.003f, 16.0f, 2.0f, Full);
+	UProceduralTerrain::GenerateDensity(Origin, Size, 50.0f, 0.003f, 16.0f, 2.0f, Truncated, Truncation);
+
+	bool bClamped = true;
+	for (int32 i = 0; i < Full.Num(); i++)
+		bClamped = bClamped && Truncated[i] == FMath::Clamp(Full[i], -Truncation, Truncation);
+	TestTrue(TEXT("Truncated density is the clamped density"), bClamped);
+
+	FTerrainDensityStorage FullStorage, TruncatedStorage;
+	FullStorage.SetFromDense(Size, Full);
+	TruncatedStorage.SetFromDense(Size, Truncated);
+	TestTrue(*FString::Printf(TEXT("Truncation collapses bricks (%d bytes, %d untruncated)"),
+			(int32)TruncatedStorage.GetAllocatedSize(), (int32)FullStorage.GetAllocatedSize()),
+		TruncatedStorage.GetAllocatedSize() < FullStorage.GetAllocatedSize() / 2);
+
+	// Quantized storage ranged by the truncation: samples round to the step and clamp to the range.
+	for (const ETerrainDensityEncoding Encoding : {ETerrainDensityEncoding::Quantized16, ETerrainDensityEncoding::Quantized8})
+	{
+		const TCHAR* EncodingName = Encoding == ETerrainDensityEncoding::Quantized16 ? TEXT("Quantized16") : TEXT("Quantized8");
+		const float Step = Truncation / (Encoding == ETerrainDensityEncoding::Quantized16 ? MAX_int16 : MAX_int8);
+
+		FTerrainDensityStorage Storage;
+		Storage.SetEncoding(Encoding, Truncation);
+		Storage.SetFromDense(Size, Truncated);
+		TestNearlyEqual(*FString::Printf(TEXT("%s step"), EncodingName), Storage.GetQuantizationStep(), Step, Step * 1e-4f);
+
+		TArray<float> Expanded;
+		Storage.ToDense(Expanded);
+		float MaxError = 0.0f;
+		for (int32 i = 0; i < Expanded.Num(); i++)
+			MaxError = FMath::Max(MaxError, FMath::Abs(Expanded[i] - Truncated[i]));
+		TestTrue(*FString::Printf(TEXT("%s error %g is within half a step (%g)"), EncodingName, MaxError, Step * 0.5f),
+			MaxError <= Step * 0.5f * (1.0f + 1e-4f));
+
+		// Edits past the range clamp to it, which is why quantized chunks need a truncation.
+		Storage.Set(10, 10, 16, Truncation * 3.0f);
+		TestNearlyEqual(*FString::Printf(TEXT("%s clamps to the range"), EncodingName), Storage.Get(10, 10, 16), Truncation, Step * 0.5f);
+		Storage.Set(10, 10, 16, -Truncation * 3.0f);
+		TestNearlyEqual(*FString::Printf(TEXT("%s clamps to minus the range"), EncodingName), Storage.Get(10, 10, 16), -Truncation, Step * 0.5f);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
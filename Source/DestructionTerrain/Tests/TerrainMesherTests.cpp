@@ -0,0 +1,296 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TerrainDensityStorage.h"
+#include "TerrainMesher.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	/** Vertex positions closer than this are the same surface point, interpolated from either end of its edge. */
+	constexpr float PositionTolerance = 1e-3f;
+
+	/**
+	 * A smooth Size³ field crossing zero halfway up, clamped to ±Truncation so that the bricks away from the
+	 * surface are uniform (0: unclamped).
+	 */
+	void MakeSurfaceDensity(int32 Size, float Truncation, TArray<float>& OutDensity)
+	{
+		OutDensity.SetNum(Size * Size * Size);
+		for (int32 z = 0; z < Size; z++)
+			for (int32 y = 0; y < Size; y++)
+				for (int32 x = 0; x < Size; x++)
+				{
+					float Value = (z - Size * 0.5f) + FMath::Sin(x * 0.7f) * 2.0f + FMath::Cos(y * 0.4f);
+					if (Truncation > 0.0f)
+						Value = FMath::Clamp(Value, -Truncation, Truncation);
+					OutDensity[x + y * Size + z * Size * Size] = Value;
+				}
+	}
+
+	FVector3f GetCorner(const FTerrainMeshData& Mesh, int32 Triangle, int32 Corner)
+	{
+		return Mesh.Vertices[Mesh.Triangles[Triangle * 3 + Corner]];
+	}
+
+	/**
+	 * True if A and B hold the same triangles with the same winding, in any order and however their vertices are
+	 * shared. Triangles are matched through a grid of their centroids.
+	 */
+	bool HaveSameTriangles(const FTerrainMeshData& A, const FTerrainMeshData& B, FString& OutError)
+	{
+		const int32 NumTriangles = A.Triangles.Num() / 3;
+		if (B.Triangles.Num() / 3 != NumTriangles)
+		{
+			OutError = FString::Printf(TEXT("%d triangles against %d"), NumTriangles, B.Triangles.Num() / 3);
+			return false;
+		}
+
+		constexpr float CellSize = 0.01f;
+		auto GetCell = [](const FTerrainMeshData& Mesh, int32 Triangle)
+		{
+			const FVector3f Centroid = (GetCorner(Mesh, Triangle, 0) + GetCorner(Mesh, Triangle, 1) + GetCorner(Mesh, Triangle, 2)) / 3.0f;
+			return FIntVector(FMath::FloorToInt(Centroid.X / CellSize), FMath::FloorToInt(Centroid.Y / CellSize), FMath::FloorToInt(Centroid.Z / CellSize));
+		};
+
+		TMultiMap<FIntVector, int32> Cells;
+		for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+			Cells.Add(GetCell(B, Triangle), Triangle);
+
+		auto IsSameTriangle = [&](int32 TriangleA, int32 TriangleB)
+		{
+			for (int32 Rotation = 0; Rotation < 3; Rotation++)
+			{
+				bool bSame = true;
+				for (int32 Corner = 0; Corner < 3 && bSame; Corner++)
+					bSame = FVector3f::DistSquared(GetCorner(A, TriangleA, Corner), GetCorner(B, TriangleB, (Corner + Rotation) % 3)) <= FMath::Square(PositionTolerance);
+				if (bSame)
+					return true;
+			}
+			return false;
+		};
+
+		TBitArray<> Matched(false, NumTriangles);
+		TArray<int32> Candidates;
+		for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+		{
+			// Centroids a rounding error apart may fall in neighbouring cells.
+			const FIntVector Cell = GetCell(A, Triangle);
+			bool bFound = false;
+			for (int32 z = -1; z <= 1 && !bFound; z++)
+			for (int32 y = -1; y <= 1 && !bFound; y++)
+			for (int32 x = -1; x <= 1 && !bFound; x++)
+			{
+				Candidates.Reset();
+				Cells.MultiFind(Cell + FIntVector(x, y, z), Candidates);
+				for (int32 Candidate : Candidates)
+				{
+					if (!Matched[Candidate] && IsSameTriangle(Triangle, Candidate))
+					{
+						Matched[Candidate] = true;
+						bFound = true;
+						break;
+					}
+				}
+			}
+
+			if (!bFound)
+			{
+				OutError = FString::Printf(TEXT("triangle %d (%s, %s, %s) has no match"), Triangle,
+					*GetCorner(A, Triangle, 0).ToString(), *GetCorner(A, Triangle, 1).ToString(), *GetCorner(A, Triangle, 2).ToString());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void TestSameTriangles(FAutomationTestBase& Test, const FString& What, const FTerrainMeshData& A, const FTerrainMeshData& B)
+	{
+		FString Error;
+		if (!HaveSameTriangles(A, B, Error))
+			Test.AddError(FString::Printf(TEXT("%s: %s"), *What, *Error));
+	}
+
+	TArray<int32> GetAllBlocks(int32 Size, int32 BlockSize)
+	{
+		const int32 NumBlocks = TerrainMesher::GetNumBlocksPerAxis(Size, BlockSize);
+		TArray<int32> Blocks;
+		for (int32 i = 0; i < NumBlocks * NumBlocks * NumBlocks; i++)
+			Blocks.Add(i);
+		return Blocks;
+	}
+
+	bool AreMeshesIdentical(const FTerrainMeshData& A, const FTerrainMeshData& B)
+	{
+		return A.Vertices == B.Vertices && A.Normals == B.Normals && A.Triangles == B.Triangles;
+	}
+}
+
+//────────────────────────────
+// Indexed / Unindexed
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainMesherIndexedTest, "DestructionTerrain.Mesher.IndexedMatchesUnindexed",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainMesherIndexedTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Size = 33;
+	TArray<float> Density;
+	MakeSurfaceDensity(Size, 0.0f, Density);
+
+	FTerrainMeshData Indexed, Unindexed;
+	TestTrue(TEXT("Indexed extraction"), TerrainMesher::ExtractSurface(Density, Size, 1.0f, 0.0f, true, Indexed));
+	TestTrue(TEXT("Unindexed extraction"), TerrainMesher::ExtractSurface(Density, Size, 1.0f, 0.0f, false, Unindexed));
+	if (!TestFalse(TEXT("Surface is not empty"), Indexed.IsEmpty()))
+		return false;
+
+	TestEqual(TEXT("Unindexed vertices are not shared"), Unindexed.Vertices.Num(), Unindexed.Triangles.Num());
+	TestTrue(*FString::Printf(TEXT("Indexed vertices are shared (%d vertices, %d indices)"), Indexed.Vertices.Num(), Indexed.Triangles.Num()),
+		Indexed.Vertices.Num() * 3 < Indexed.Triangles.Num());
+	TestEqual(TEXT("Indexed normals"), Indexed.Normals.Num(), Indexed.Vertices.Num());
+	TestEqual(TEXT("Unindexed normals"), Unindexed.Normals.Num(), Unindexed.Vertices.Num());
+
+	bool bValidIndices = true;
+	for (int32 Index : Indexed.Triangles)
+		bValidIndices = bValidIndices && Indexed.Vertices.IsValidIndex(Index);
+	TestTrue(TEXT("Indexed triangles reference existing vertices"), bValidIndices);
+
+	TestSameTriangles(*this, TEXT("Indexed against unindexed"), Indexed, Unindexed);
+	return true;
+}
+
+//────────────────────────────
+// Serial / Parallel
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainMesherParallelTest, "DestructionTerrain.Mesher.ParallelMatchesSerial",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainMesherParallelTest::RunTest(const FString& Parameters)
+{
+	// 64 cell layers: enough for several slabs on any machine with worker threads.
+	constexpr int32 Size = 65;
+	TArray<float> Density;
+	MakeSurfaceDensity(Size, 0.0f, Density);
+
+	for (const bool bSharedVertices : {false, true})
+	{
+		const TCHAR* Mode = bSharedVertices ? TEXT("Indexed") : TEXT("Unindexed");
+
+		FTerrainMeshData Serial, Parallel;
+		TestTrue(*FString::Printf(TEXT("%s serial extraction"), Mode), TerrainMesher::ExtractSurface(Density, Size, 1.0f, 0.0f, bSharedVertices, Serial));
+		TestTrue(*FString::Printf(TEXT("%s parallel extraction"), Mode),
+			TerrainMesher::ExtractSurface(Density, Size, 1.0f, 0.0f, bSharedVertices, Parallel, [] { return false; }, true));
+
+		// Slabs are appended in Z order: unindexed output is the serial one, indexed output only repeats slab boundary vertices.
+		if (bSharedVertices)
+		{
+			TestTrue(*FString::Printf(TEXT("%s parallel vertices (%d, %d serial)"), Mode, Parallel.Vertices.Num(), Serial.Vertices.Num()),
+				Parallel.Vertices.Num() >= Serial.Vertices.Num());
+			TestSameTriangles(*this, FString::Printf(TEXT("%s parallel against serial"), Mode), Parallel, Serial);
+		}
+		else
+		{
+			TestTrue(*FString::Printf(TEXT("%s parallel output is the serial output"), Mode), AreMeshesIdentical(Parallel, Serial));
+		}
+	}
+
+	// Blocks marched in parallel match the blocks marched one after the other.
+	const TArray<int32> Blocks = GetAllBlocks(Size, 16);
+	TArray<FTerrainMeshBlock> SerialBlocks, ParallelBlocks;
+	TestTrue(TEXT("Serial blocks"), TerrainMesher::ExtractBlocks(Density, Size, 1.0f, 0.0f, true, 16, Blocks, SerialBlocks));
+	TestTrue(TEXT("Parallel blocks"), TerrainMesher::ExtractBlocks(Density, Size, 1.0f, 0.0f, true, 16, Blocks, ParallelBlocks, [] { return false; }, true));
+	if (TestEqual(TEXT("Block count"), ParallelBlocks.Num(), SerialBlocks.Num()))
+	{
+		for (int32 i = 0; i < SerialBlocks.Num(); i++)
+		{
+			TestEqual(*FString::Printf(TEXT("Block %d section"), i), ParallelBlocks[i].SectionIndex, Blocks[i]);
+			TestTrue(*FString::Printf(TEXT("Block %d mesh"), i), AreMeshesIdentical(ParallelBlocks[i].Mesh, SerialBlocks[i].Mesh));
+		}
+	}
+	return true;
+}
+
+//────────────────────────────
+// Brick Skipping
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainMesherBrickSkipTest, "DestructionTerrain.Mesher.BrickSkipMatchesFull",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainMesherBrickSkipTest::RunTest(const FString& Parameters)
+{
+	// Clamped to ±2: the bricks away from the surface are uniform and skipped by the storage extraction.
+	constexpr int32 Size = 33;
+	TArray<float> Density;
+	MakeSurfaceDensity(Size, 2.0f, Density);
+
+	FTerrainDensityStorage Storage;
+	Storage.SetFromDense(Size, Density);
+
+	TArray<uint8> Active;
+	const int32 NumActive = Storage.GetActiveCellBricks(0.0f, Active);
+	TestTrue(*FString::Printf(TEXT("Some cell bricks are skipped (%d of %d active)"), NumActive, Active.Num()),
+		NumActive > 0 && NumActive < Active.Num());
+
+	for (const int32 BlockSize : {8, 16, 0})
+	{
+		const TArray<int32> Blocks = GetAllBlocks(Size, BlockSize);
+
+		for (const bool bSharedVertices : {false, true})
+		{
+			const FString Label = FString::Printf(TEXT("%s blocks of %d"), bSharedVertices ? TEXT("Indexed") : TEXT("Unindexed"), BlockSize);
+
+			TArray<FTerrainMeshBlock> Full, Skipped;
+			TestTrue(*FString::Printf(TEXT("%s: full extraction"), *Label),
+				TerrainMesher::ExtractBlocks(Density, Size, 1.0f, 0.0f, bSharedVertices, BlockSize, Blocks, Full));
+			TestTrue(*FString::Printf(TEXT("%s: storage extraction"), *Label),
+				TerrainMesher::ExtractBlocks(Storage, 1.0f, 0.0f, bSharedVertices, BlockSize, Blocks, Skipped));
+			if (!TestEqual(*FString::Printf(TEXT("%s: block count"), *Label), Skipped.Num(), Full.Num()))
+				continue;
+
+			// Skipped cells never produce a triangle, so the walk emits the same vertices in the same order.
+			for (int32 i = 0; i < Full.Num(); i++)
+			{
+				TestEqual(*FString::Printf(TEXT("%s: block %d section"), *Label, i), Skipped[i].SectionIndex, Full[i].SectionIndex);
+				TestTrue(*FString::Printf(TEXT("%s: block %d mesh"), *Label, i), AreMeshesIdentical(Skipped[i].Mesh, Full[i].Mesh));
+			}
+		}
+	}
+
+	// Quantized storage marches its samples as they expand.
+	{
+		FTerrainDensityStorage Quantized;
+		Quantized.SetEncoding(ETerrainDensityEncoding::Quantized16, 2.0f);
+		Quantized.SetFromDense(Size, Density);
+		TArray<float> Expanded;
+		Quantized.ToDense(Expanded);
+
+		const TArray<int32> Blocks = GetAllBlocks(Size, 16);
+		TArray<FTerrainMeshBlock> Full, Skipped;
+		TerrainMesher::ExtractBlocks(Expanded, Size, 1.0f, 0.0f, true, 16, Blocks, Full);
+		TerrainMesher::ExtractBlocks(Quantized, 1.0f, 0.0f, true, 16, Blocks, Skipped);
+		bool bSame = Full.Num() == Skipped.Num();
+		for (int32 i = 0; i < Full.Num() && bSame; i++)
+			bSame = AreMeshesIdentical(Skipped[i].Mesh, Full[i].Mesh);
+		TestTrue(TEXT("Quantized storage blocks match its expanded field"), bSame);
+	}
+
+	// A chunk without surface clears every block.
+	{
+		FTerrainDensityStorage Buried;
+		Buried.InitUniform(Size, -2.0f);
+		const TArray<int32> Blocks = GetAllBlocks(Size, 16);
+		TArray<FTerrainMeshBlock> Empty;
+		TestTrue(TEXT("Buried chunk extraction"), TerrainMesher::ExtractBlocks(Buried, 1.0f, 0.0f, true, 16, Blocks, Empty));
+		bool bAllEmpty = Empty.Num() == Blocks.Num();
+		for (int32 i = 0; i < Empty.Num() && bAllEmpty; i++)
+			bAllEmpty = Empty[i].SectionIndex == Blocks[i] && Empty[i].Mesh.IsEmpty();
+		TestTrue(TEXT("Buried chunk blocks are empty"), bAllEmpty);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
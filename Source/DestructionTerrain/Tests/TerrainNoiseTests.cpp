@@ -0,0 +1,201 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ProceduralTerrain.h"
+#include "TerrainNoise.h"
+#include "Misc/AutomationTest.h"
+
+namespace
+{
+	/** Every kernel, with and without fBm octaves. */
+	TArray<FTerrainNoiseSettings> GetNoiseVariants()
+	{
+		TArray<FTerrainNoiseSettings> Variants;
+		for (const ETerrainNoiseKernel Kernel : {ETerrainNoiseKernel::Engine, ETerrainNoiseKernel::Vectorized})
+		{
+			for (const int32 Octaves : {1, 4})
+			{
+				FTerrainNoiseSettings& Settings = Variants.AddDefaulted_GetRef();
+				Settings.Kernel = Kernel;
+				Settings.Octaves = Octaves;
+			}
+		}
+		return Variants;
+	}
+
+	FString DescribeNoise(const FTerrainNoiseSettings& Settings)
+	{
+		return FString::Printf(TEXT("%s, %d octaves"),
+			Settings.Kernel == ETerrainNoiseKernel::Vectorized ? TEXT("Vectorized") : TEXT("Engine"), Settings.Octaves);
+	}
+
+	/** Density of a 33³ chunk away from the origin (odd size: vectorized rows end with the scalar path). */
+	void GenerateTestDensity(const FTerrainNoiseSettings& Noise, bool bParallel, TArray<float>& OutDensity)
+	{
+		UProceduralTerrain::GenerateDensity(FVector(1234.0, -5678.0, 250.0), 33, 50.0f, 0.003f, 16.0f, 8.0f,
+			OutDensity, 8.0f, Noise, bParallel);
+	}
+}
+
+//────────────────────────────
+// Reference Values
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainNoiseReferenceTest, "DestructionTerrain.Noise.ReferenceValues",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainNoiseReferenceTest::RunTest(const FString& Parameters)
+{
+	// The noise has no seed: its permutation table (the engine's) is fixed, so these values pin the terrain every
+	// save's baseline is generated from. A change here invalidates the delta saves.
+	struct FReference
+	{
+		FVector3f Position;
+		float Value;
+	};
+	const FReference References[] = {
+		{FVector3f(1.25f, 2.5f, 3.75f),      -0.43746975f},
+		{FVector3f(-3.3f, 7.1f, 0.6f),       -0.48139897f},
+		{FVector3f(12.34f, -5.67f, 8.9f),     0.21925552f},
+		{FVector3f(100.1f, 200.2f, -300.3f),  0.46702185f},
+	};
+
+	for (const FReference& Reference : References)
+	{
+		const FVector3f& P = Reference.Position;
+		TestNearlyEqual(FString::Printf(TEXT("Perlin3D(%s)"), *P.ToString()), TerrainNoise::Perlin3D(P.X, P.Y, P.Z), Reference.Value, 1e-4f);
+	}
+
+	// Perlin noise is zero on its lattice.
+	for (const FIntVector& Lattice : {FIntVector(0, 0, 0), FIntVector(3, -7, 12), FIntVector(255, 256, -1)})
+	{
+		TestNearlyEqual(FString::Printf(TEXT("Perlin3D on lattice point %s"), *Lattice.ToString()),
+			TerrainNoise::Perlin3D(Lattice.X, Lattice.Y, Lattice.Z), 0.0f, 1e-6f);
+	}
+
+	// The 4-lane version evaluates the same function as the scalar reference.
+	alignas(16) float Lanes[4];
+	VectorStoreAligned(TerrainNoise::Perlin3D(
+		MakeVectorRegisterFloat(References[0].Position.X, References[1].Position.X, References[2].Position.X, References[3].Position.X),
+		MakeVectorRegisterFloat(References[0].Position.Y, References[1].Position.Y, References[2].Position.Y, References[3].Position.Y),
+		MakeVectorRegisterFloat(References[0].Position.Z, References[1].Position.Z, References[2].Position.Z, References[3].Position.Z)),
+		Lanes);
+	for (int32 Lane = 0; Lane < 4; Lane++)
+	{
+		const FVector3f& P = References[Lane].Position;
+		TestNearlyEqual(FString::Printf(TEXT("Vector Perlin3D lane %d"), Lane), Lanes[Lane], TerrainNoise::Perlin3D(P.X, P.Y, P.Z), 1e-5f);
+	}
+
+	return true;
+}
+
+//────────────────────────────
+// Engine Equivalence
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainNoiseEngineMatchTest, "DestructionTerrain.Noise.MatchesEngine",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainNoiseEngineMatchTest::RunTest(const FString& Parameters)
+{
+	// Both kernels must draw the same terrain: saves of one load over the baseline of the other.
+	constexpr float Tolerance = 1e-5f;
+
+	// Points spread over several lattice periods (256), negative coordinates included.
+	FRandomStream Random(0x7E44A1);
+	for (int32 Group = 0; Group < 256; Group++)
+	{
+		FVector3f Points[4];
+		for (FVector3f& Point : Points)
+			Point = FVector3f(Random.FRandRange(-600.0f, 600.0f), Random.FRandRange(-600.0f, 600.0f), Random.FRandRange(-600.0f, 600.0f));
+
+		alignas(16) float Lanes[4];
+		VectorStoreAligned(TerrainNoise::Perlin3D(
+			MakeVectorRegisterFloat(Points[0].X, Points[1].X, Points[2].X, Points[3].X),
+			MakeVectorRegisterFloat(Points[0].Y, Points[1].Y, Points[2].Y, Points[3].Y),
+			MakeVectorRegisterFloat(Points[0].Z, Points[1].Z, Points[2].Z, Points[3].Z)),
+			Lanes);
+
+		for (int32 Lane = 0; Lane < 4; Lane++)
+		{
+			const FVector3f& P = Points[Lane];
+			const float Engine = FMath::PerlinNoise3D(FVector(P));
+			if (!TestNearlyEqual(FString::Printf(TEXT("Perlin3D(%s) matches FMath::PerlinNoise3D"), *P.ToString()),
+					TerrainNoise::Perlin3D(P.X, P.Y, P.Z), Engine, Tolerance)
+				|| !TestNearlyEqual(FString::Printf(TEXT("Vector Perlin3D(%s) matches FMath::PerlinNoise3D"), *P.ToString()),
+					Lanes[Lane], Engine, Tolerance))
+			{
+				return true;
+			}
+		}
+	}
+
+	// Whole chunks, fBm octaves included (the density scales the noise by NoiseStrength).
+	for (const int32 Octaves : {1, 4})
+	{
+		FTerrainNoiseSettings Engine;
+		Engine.Kernel = ETerrainNoiseKernel::Engine;
+		Engine.Octaves = Octaves;
+		FTerrainNoiseSettings Vectorized = Engine;
+		Vectorized.Kernel = ETerrainNoiseKernel::Vectorized;
+
+		TArray<float> EngineDensity, VectorizedDensity;
+		GenerateTestDensity(Engine, false, EngineDensity);
+		GenerateTestDensity(Vectorized, false, VectorizedDensity);
+		if (!TestEqual(TEXT("Same density size"), VectorizedDensity.Num(), EngineDensity.Num()))
+			continue;
+
+		float MaxError = 0.0f;
+		for (int32 i = 0; i < EngineDensity.Num(); i++)
+			MaxError = FMath::Max(MaxError, FMath::Abs(VectorizedDensity[i] - EngineDensity[i]));
+		TestTrue(FString::Printf(TEXT("%d octaves: Vectorized density matches Engine (max error %g)"), Octaves, MaxError), MaxError < 1e-3f);
+	}
+
+	return true;
+}
+
+//────────────────────────────
+// Determinism
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainNoiseDeterminismTest, "DestructionTerrain.Noise.Determinism",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainNoiseDeterminismTest::RunTest(const FString& Parameters)
+{
+	for (const FTerrainNoiseSettings& Noise : GetNoiseVariants())
+	{
+		const FString Name = DescribeNoise(Noise);
+
+		// Delta saves are applied over a regenerated baseline: generation must be bit-exact across runs and threads.
+		TArray<float> Reference, Repeat, Parallel;
+		GenerateTestDensity(Noise, false, Reference);
+		GenerateTestDensity(Noise, false, Repeat);
+		GenerateTestDensity(Noise, true, Parallel);
+
+		TestTrue(FString::Printf(TEXT("%s: repeated generation is identical"), *Name),
+			Reference.Num() == Repeat.Num() && FMemory::Memcmp(Reference.GetData(), Repeat.GetData(), Reference.Num() * sizeof(float)) == 0);
+		TestTrue(FString::Printf(TEXT("%s: parallel generation matches serial"), *Name),
+			Reference.Num() == Parallel.Num() && FMemory::Memcmp(Reference.GetData(), Parallel.GetData(), Reference.Num() * sizeof(float)) == 0);
+
+		// Rows (4 points per call) against the per-point fBm, 4-point groups and scalar tail included. Vectorized
+		// rows scale float positions per octave where Fbm() scales doubles, hence the tolerance.
+		const FVector Start(12.5, -3.25, 0.75);
+		constexpr double StepX = 0.15;
+		constexpr int32 Count = 19;
+
+		float Row[Count];
+		TerrainNoise::FbmRow(Start, StepX, Count, Noise, Row);
+		for (int32 i = 0; i < Count; i++)
+		{
+			const float Point = TerrainNoise::Fbm(Start + FVector(i * StepX, 0.0, 0.0), Noise);
+			if (!TestNearlyEqual(FString::Printf(TEXT("%s: FbmRow[%d] matches Fbm"), *Name, i), Row[i], Point, 1e-4f))
+				break;
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
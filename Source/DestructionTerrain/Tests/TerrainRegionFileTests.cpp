@@ -0,0 +1,217 @@
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "TerrainRegionFile.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/** Table layout of a region file (see TerrainRegionFile.cpp): a 16-byte header, then (Offset, Size, Sectors) per slot. */
+	constexpr int64 RegionHeaderBytes = 16;
+	constexpr int64 RegionSlotBytes = 16;
+
+	/** Slot of a chunk of region (0, 0, 0). */
+	int32 GetSlotIndex(const FIntVector& ChunkCoords)
+	{
+		return ChunkCoords.X + ChunkCoords.Y * FTerrainRegionStore::RegionSizeX
+			+ ChunkCoords.Z * FTerrainRegionStore::RegionSizeX * FTerrainRegionStore::RegionSizeY;
+	}
+
+	/** A blob of NumBytes bytes that tells its chunk apart. */
+	TArray<uint8> MakeBlob(int32 NumBytes, uint8 Seed)
+	{
+		TArray<uint8> Bytes;
+		Bytes.SetNumUninitialized(NumBytes);
+		for (int32 i = 0; i < NumBytes; i++)
+			Bytes[i] = static_cast<uint8>(Seed + i * 7);
+		return Bytes;
+	}
+
+	FString GetTestDirectory(const TCHAR* Name)
+	{
+		const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Automation/TerrainTests") / Name);
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+		return Directory;
+	}
+
+	FString GetRegionPath(const FString& Directory)
+	{
+		return Directory / FString::Printf(TEXT("TerrainRegion_0_0_0.%s"), FTerrainRegionStore::FileExtension);
+	}
+
+	/** Reads one slot of the table. */
+	void ReadSlot(const TArray<uint8>& File, const FIntVector& ChunkCoords, int64& OutOffset, int32& OutSize, int32& OutSectors)
+	{
+		const uint8* Entry = File.GetData() + RegionHeaderBytes + GetSlotIndex(ChunkCoords) * RegionSlotBytes;
+		FMemory::Memcpy(&OutOffset, Entry, sizeof(int64));
+		FMemory::Memcpy(&OutSize, Entry + 8, sizeof(int32));
+		FMemory::Memcpy(&OutSectors, Entry + 12, sizeof(int32));
+	}
+
+	void WriteSlot(TArray<uint8>& File, const FIntVector& ChunkCoords, int64 Offset, int32 Size, int32 Sectors)
+	{
+		uint8* Entry = File.GetData() + RegionHeaderBytes + GetSlotIndex(ChunkCoords) * RegionSlotBytes;
+		FMemory::Memcpy(Entry, &Offset, sizeof(int64));
+		FMemory::Memcpy(Entry + 8, &Size, sizeof(int32));
+		FMemory::Memcpy(Entry + 12, &Sectors, sizeof(int32));
+	}
+}
+
+//────────────────────────────
+// Sector Reuse
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainRegionSectorReuseTest, "DestructionTerrain.RegionFile.ReusesFreedSectors",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainRegionSectorReuseTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = GetTestDirectory(TEXT("RegionSectorReuse"));
+	const FString Path = GetRegionPath(Directory);
+	constexpr int64 SectorSize = FTerrainRegionStore::SectorSize;
+	const FIntVector A(0, 0, 0), B(1, 0, 0), C(2, 0, 0), D(0, 1, 0), E(5, 3, 2);
+	const TArray<uint8> BlobA = MakeBlob(SectorSize * 3 - 10, 1);
+	const TArray<uint8> SmallA = MakeBlob(200, 2);
+	const TArray<uint8> BlobB = MakeBlob(500, 3);
+	const TArray<uint8> BlobC = MakeBlob(SectorSize + 904, 4);
+	const TArray<uint8> BlobD = MakeBlob(SectorSize * 2, 5);
+	const TArray<uint8> BlobE = MakeBlob(SectorSize + 1, 6);
+
+	int64 FirstOffset = 0, Offset = 0;
+	int32 Size = 0, Sectors = 0;
+	TArray<uint8> File;
+	auto ReadSlotOnDisk = [&](const FIntVector& ChunkCoords)
+	{
+		Offset = INDEX_NONE;
+		if (FFileHelper::LoadFileToArray(File, *Path))
+			ReadSlot(File, ChunkCoords, Offset, Size, Sectors);
+		return Offset;
+	};
+
+	int64 FileSize = 0;
+	{
+		FTerrainRegionStore Store(Directory);
+		TestTrue(TEXT("A is written"), Store.Write(A, BlobA));
+		TestTrue(TEXT("B is written"), Store.Write(B, BlobB));
+		FirstOffset = ReadSlotOnDisk(A);
+		TestEqual(TEXT("A sectors"), Sectors, 3);
+		TestEqual(TEXT("B follows A"), ReadSlotOnDisk(B), FirstOffset + 3 * SectorSize);
+
+		// A shrinks: its new blob goes to the end (the old one is only freed once the slot points elsewhere).
+		TestTrue(TEXT("A is overwritten"), Store.Write(A, SmallA));
+		TestEqual(TEXT("Smaller A is appended"), ReadSlotOnDisk(A), FirstOffset + 4 * SectorSize);
+		FileSize = IFileManager::Get().FileSize(*Path);
+
+		// C takes two of the three sectors A freed, and the file does not grow.
+		TestTrue(TEXT("C is written"), Store.Write(C, BlobC));
+		TestEqual(TEXT("C reuses the sectors of A"), ReadSlotOnDisk(C), FirstOffset);
+		TestEqual(TEXT("File size after C"), IFileManager::Get().FileSize(*Path), FileSize);
+
+		// Removing B merges its sector with the one left after C: D fits in both.
+		TestTrue(TEXT("B is removed"), Store.Write(B, TArray<uint8>()));
+		TestFalse(TEXT("B is gone"), Store.Contains(B));
+		TestTrue(TEXT("D is written"), Store.Write(D, BlobD));
+		TestEqual(TEXT("D reuses the merged free sectors"), ReadSlotOnDisk(D), FirstOffset + 2 * SectorSize);
+		TestEqual(TEXT("File size after D"), IFileManager::Get().FileSize(*Path), FileSize);
+		Store.ReleaseHandles();
+	}
+
+	// A new store reads the same blobs back, and rebuilds its free sectors from the table.
+	{
+		FTerrainRegionStore Store(Directory);
+		TArray<FIntVector> Stored;
+		Store.GetStoredChunks(Stored);
+		Stored.Sort([](const FIntVector& L, const FIntVector& R) { return GetSlotIndex(L) < GetSlotIndex(R); });
+		TestTrue(TEXT("Stored chunks after reload"), Stored == TArray<FIntVector>({A, C, D}));
+
+		TArray<uint8> Bytes;
+		TestTrue(TEXT("A reads after reload"), Store.Read(A, Bytes) && Bytes == SmallA);
+		TestTrue(TEXT("C reads after reload"), Store.Read(C, Bytes) && Bytes == BlobC);
+		TestTrue(TEXT("D reads after reload"), Store.Read(D, Bytes) && Bytes == BlobD);
+		TestFalse(TEXT("B stays removed after reload"), Store.Read(B, Bytes));
+
+		TestTrue(TEXT("C is removed"), Store.Write(C, TArray<uint8>()));
+		TestTrue(TEXT("E is written"), Store.Write(E, BlobE));
+		TestEqual(TEXT("E reuses the sectors of C"), ReadSlotOnDisk(E), FirstOffset);
+		TestEqual(TEXT("File size after E"), IFileManager::Get().FileSize(*Path), FileSize);
+		Store.ReleaseHandles();
+	}
+
+	{
+		FTerrainRegionStore Store(Directory);
+		TArray<uint8> Bytes;
+		TestTrue(TEXT("E reads after a second reload"), Store.Read(E, Bytes) && Bytes == BlobE);
+		TestTrue(TEXT("D reads after a second reload"), Store.Read(D, Bytes) && Bytes == BlobD);
+		TestFalse(TEXT("C stays removed"), Store.Contains(C));
+	}
+	return true;
+}
+
+//────────────────────────────
+// Corrupt Tables
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainRegionCorruptTableTest, "DestructionTerrain.RegionFile.DropsCorruptSlots",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainRegionCorruptTableTest::RunTest(const FString& Parameters)
+{
+	const FString Directory = GetTestDirectory(TEXT("RegionCorruptTable"));
+	const FIntVector Kept(0, 0, 0), Overlapping(1, 0, 0), Missized(2, 0, 0), Added(3, 0, 0);
+	const TArray<uint8> KeptBlob = MakeBlob(FTerrainRegionStore::SectorSize + 100, 1);
+	const TArray<uint8> AddedBlob = MakeBlob(FTerrainRegionStore::SectorSize * 3, 4);
+
+	{
+		FTerrainRegionStore Store(Directory);
+		TestTrue(TEXT("Kept blob is written"), Store.Write(Kept, KeptBlob));
+		TestTrue(TEXT("Overlapping blob is written"), Store.Write(Overlapping, MakeBlob(100, 2)));
+		TestTrue(TEXT("Missized blob is written"), Store.Write(Missized, MakeBlob(100, 3)));
+	}
+
+	// One slot points into the second sector of another blob, one claims more sectors than its size needs.
+	TArray<uint8> File;
+	if (!TestTrue(TEXT("Region file exists"), FFileHelper::LoadFileToArray(File, *GetRegionPath(Directory))))
+		return false;
+
+	int64 KeptOffset = 0, MissizedOffset = 0;
+	int32 Size = 0, Sectors = 0;
+	ReadSlot(File, Kept, KeptOffset, Size, Sectors);
+	TestEqual(TEXT("Blob sectors"), Sectors, 2);
+	WriteSlot(File, Overlapping, KeptOffset + FTerrainRegionStore::SectorSize, 100, 1);
+	ReadSlot(File, Missized, MissizedOffset, Size, Sectors);
+	WriteSlot(File, Missized, MissizedOffset, Size, 8);
+	FFileHelper::SaveArrayToFile(File, *GetRegionPath(Directory));
+
+	{
+		FTerrainRegionStore Store(Directory);
+		TestTrue(TEXT("Valid slot is kept"), Store.Contains(Kept));
+		TestFalse(TEXT("Overlapping slot is dropped"), Store.Contains(Overlapping));
+		TestFalse(TEXT("Slot with mismatched sectors is dropped"), Store.Contains(Missized));
+
+		// The freed sectors are reused without touching the live blob.
+		TestTrue(TEXT("New blob is written"), Store.Write(Added, AddedBlob));
+		TArray<uint8> Bytes;
+		TestTrue(TEXT("Kept blob reads"), Store.Read(Kept, Bytes) && Bytes == KeptBlob);
+	}
+
+	// The dropped slots were cleared on disk by that write.
+	{
+		FTerrainRegionStore Store(Directory);
+		TArray<FIntVector> Stored;
+		Store.GetStoredChunks(Stored);
+		TestEqual(TEXT("Stored chunks after reload"), Stored.Num(), 2);
+		TestFalse(TEXT("Overlapping slot stays dropped"), Store.Contains(Overlapping));
+		TestFalse(TEXT("Missized slot stays dropped"), Store.Contains(Missized));
+
+		TArray<uint8> Bytes;
+		TestTrue(TEXT("Kept blob reads after reload"), Store.Read(Kept, Bytes) && Bytes == KeptBlob);
+		TestTrue(TEXT("New blob reads after reload"), Store.Read(Added, Bytes) && Bytes == AddedBlob);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
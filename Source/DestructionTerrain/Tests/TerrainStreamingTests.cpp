@@ -0,0 +1,74 @@
+#include "TerrainTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ProceduralTerrain.h"
+#include "ProceduralTerrainWorld.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+//────────────────────────────
+// Streaming: Saved Chunks Back In While Loading
+//────────────────────────────
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTerrainStreamingRestoreTest, "DestructionTerrain.Streaming.RestoreWhileLoading",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTerrainStreamingRestoreTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 ChunkSize = 32;
+	const FIntVector Edited(3, 0, 0);
+	const FIntVector Away(6, 0, 0);
+
+	const FString SaveDirectory = TEXT("Automation/TerrainTests/StreamingRestore");
+	IFileManager::Get().DeleteDirectory(*(FPaths::ProjectSavedDir() / SaveDirectory), false, true);
+
+	// A single persistent chunk at the origin, and only the player's chunk streamed around it.
+	FTerrainTestWorld TestWorld;
+	AProceduralTerrainWorld* Terrain = FTerrainWorldTestAccess::Spawn(TestWorld.World, ChunkSize, 1, 1, SaveDirectory, 0);
+	if (!TestTrue(TEXT("World restores its chunks"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+		return false;
+
+	FTerrainWorldTestAccess::StreamAround(Terrain, Edited);
+	if (!TestTrue(TEXT("Chunk streams in"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+		return false;
+
+	UProceduralTerrain* Chunk = FTerrainWorldTestAccess::FindChunk(Terrain, Edited);
+	if (!TestNotNull(TEXT("Streamed chunk"), Chunk))
+		return false;
+	const uint32 ProceduralHash = Chunk->Density.GetContentHash();
+
+	const float ChunkWorldSize = FTerrainWorldTestAccess::GetChunkWorldSize(Terrain);
+	Terrain->DigAt((FVector(Edited) + FVector(0.5f)) * ChunkWorldSize, ChunkWorldSize * 0.25f, -20.0f);
+	Terrain->FlushTerrainEdits();
+	if (!TestTrue(TEXT("Dig remesh completes"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+		return false;
+
+	const uint32 EditedHash = Chunk->Density.GetContentHash();
+	TestNotEqual(TEXT("Dig changes the density"), EditedHash, ProceduralHash);
+
+	// Streaming out saves the edits.
+	FTerrainWorldTestAccess::StreamAround(Terrain, Away);
+	if (!TestTrue(TEXT("Edited chunk is saved"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+		return false;
+
+	// Back in, out again before its load landed, and back in: the pooled component returns to the same coordinates,
+	// and the completions of the first load must not touch the second.
+	FTerrainWorldTestAccess::StreamAround(Terrain, Edited);
+	TestNotNull(TEXT("Chunk is loading"), FTerrainWorldTestAccess::FindChunk(Terrain, Edited));
+	FTerrainWorldTestAccess::StreamAround(Terrain, Away);
+	TestNull(TEXT("Loading chunk is released"), FTerrainWorldTestAccess::FindChunk(Terrain, Edited));
+	FTerrainWorldTestAccess::StreamAround(Terrain, Edited);
+	if (!TestTrue(TEXT("Chunk streams back in"), FTerrainWorldTestAccess::WaitUntilIdle(TestWorld, Terrain)))
+		return false;
+
+	Chunk = FTerrainWorldTestAccess::FindChunk(Terrain, Edited);
+	if (!TestNotNull(TEXT("Restored chunk"), Chunk))
+		return false;
+
+	TestEqual(TEXT("Restored chunk keeps its edits"), Chunk->Density.GetContentHash(), EditedHash);
+	TestFalse(TEXT("Restored chunk matches its save"), Chunk->HasUnsavedEdits());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
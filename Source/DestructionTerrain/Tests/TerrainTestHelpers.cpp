@@ -0,0 +1,257 @@
+#include "TerrainTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ProceduralTerrain.h"
+#include "ProceduralTerrainWorld.h"
+#include "TerrainUploadQueue.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+//────────────────────────────
+// Test World
+//────────────────────────────
+
+FTerrainTestWorld::FTerrainTestWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TerrainTestWorld"));
+	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+	Context.SetCurrentWorld(World);
+
+	// A game mode is needed for BeginPlay to reach the actors; no player ever logs in.
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+}
+
+FTerrainTestWorld::~FTerrainTestWorld()
+{
+	if (!World)
+		return;
+
+	// EndPlay writes the edited chunks to the world's own save directory.
+	for (TActorIterator<AProceduralTerrainWorld> It(World); It; ++It)
+		It->Destroy();
+	UProceduralTerrain::WaitForPendingSaves();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World = nullptr;
+}
+
+UProceduralTerrain* FTerrainTestWorld::SpawnChunk(const FVector& Location)
+{
+	AActor* Host = World->SpawnActor<AActor>(Location, FRotator::ZeroRotator);
+	UProceduralTerrain* Chunk = NewObject<UProceduralTerrain>(Host);
+	Host->SetRootComponent(Chunk);
+	Chunk->RegisterComponent();
+	Chunk->SetWorldLocation(Location);
+	return Chunk;
+}
+
+void FTerrainTestWorld::Tick(float DeltaSeconds)
+{
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+}
+
+bool FTerrainTestWorld::WaitForChunk(UProceduralTerrain* Chunk, double TimeoutSeconds)
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (Chunk->HasPendingRebuild())
+	{
+		if (FPlatformTime::Seconds() > Deadline)
+			return false;
+
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FPlatformProcess::Sleep(0.0f);
+	}
+	return true;
+}
+
+//────────────────────────────
+// Terrain World Access
+//────────────────────────────
+
+AProceduralTerrainWorld* FTerrainWorldTestAccess::Spawn(UWorld* World, int32 ChunkSize, int32 ChunksX, int32 ChunksY,
+	const FString& SaveDirectory, int32 StreamRadius)
+{
+	FActorSpawnParameters Params;
+	Params.bDeferConstruction = true;
+	AProceduralTerrainWorld* Terrain = World->SpawnActor<AProceduralTerrainWorld>(FVector::ZeroVector, FRotator::ZeroRotator, Params);
+
+	Terrain->ChunkSize = ChunkSize;
+	Terrain->ChunksX = ChunksX;
+	Terrain->ChunksY = ChunksY;
+	Terrain->ChunksZ = 1;
+	Terrain->HeightBias = ChunkSize * 0.5f;
+	Terrain->NoiseStrength = ChunkSize * 0.25f;
+	Terrain->StreamRadius = StreamRadius;
+	Terrain->SaveDirectory = SaveDirectory;
+	Terrain->bShowChunkBounds = false;
+	Terrain->AutosaveInterval = 0.0f;
+
+	Terrain->FinishSpawning(FTransform::Identity);
+	return Terrain;
+}
+
+bool FTerrainWorldTestAccess::IsIdle(const AProceduralTerrainWorld* Terrain)
+{
+	if (Terrain->bIsGenerating || Terrain->StreamingQueue.Num() > 0 || Terrain->StreamingInFlight.Num() > 0
+		|| Terrain->EditedChunkCoords.Num() > 0 || (Terrain->UploadQueue.IsValid() && Terrain->UploadQueue->Num() > 0))
+	{
+		return false;
+	}
+
+	for (const UProceduralTerrain* Chunk : Terrain->Chunks)
+		if (Chunk && Chunk->HasPendingRebuild())
+			return false;
+
+	for (const TPair<FIntVector, UE::Tasks::FTask>& Save : Terrain->PendingChunkSaves)
+		if (!Save.Value.IsCompleted())
+			return false;
+
+	return true;
+}
+
+bool FTerrainWorldTestAccess::WaitUntilIdle(FTerrainTestWorld& TestWorld, AProceduralTerrainWorld* Terrain, double TimeoutSeconds)
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (!IsIdle(Terrain))
+	{
+		if (FPlatformTime::Seconds() > Deadline)
+			return false;
+
+		TestWorld.Tick(1.0f / 60.0f);
+		FPlatformProcess::Sleep(0.0f);
+	}
+	return true;
+}
+
+void FTerrainWorldTestAccess::StreamAround(AProceduralTerrainWorld* Terrain, const FIntVector& Coords)
+{
+	const FVector Center = (FVector(Coords) + FVector(0.5f, 0.5f, 0.0f)) * GetChunkWorldSize(Terrain);
+	Terrain->UpdateStreamedChunksAround(Center, Center, FVector::ForwardVector);
+	Terrain->TickStreaming();
+}
+
+UProceduralTerrain* FTerrainWorldTestAccess::FindChunk(const AProceduralTerrainWorld* Terrain, const FIntVector& Coords)
+{
+	return Terrain->FindChunk(Coords);
+}
+
+const TArray<UProceduralTerrain*>& FTerrainWorldTestAccess::GetChunks(const AProceduralTerrainWorld* Terrain)
+{
+	return Terrain->Chunks;
+}
+
+float FTerrainWorldTestAccess::GetChunkWorldSize(const AProceduralTerrainWorld* Terrain)
+{
+	return (Terrain->ChunkSize - 1) * Terrain->TerrainScale;
+}
+
+//────────────────────────────
+// Chunk Stats
+//────────────────────────────
+
+FTerrainChunkStats FTerrainChunkStats::Get(UProceduralTerrain* Chunk)
+{
+	FTerrainChunkStats Stats;
+	Stats.Bytes = Chunk->Density.GetAllocatedSize();
+
+	// Hidden sections only hold the decimated collision mesh (see CollisionStride).
+	for (int32 SectionIndex = 0; SectionIndex < Chunk->GetNumSections(); SectionIndex++)
+	{
+		const FProcMeshSection* Section = Chunk->GetProcMeshSection(SectionIndex);
+		if (!Section)
+			continue;
+
+		Stats.Bytes += Section->ProcVertexBuffer.GetAllocatedSize() + Section->ProcIndexBuffer.GetAllocatedSize();
+		if (Section->bSectionVisible)
+		{
+			Stats.Vertices  += Section->ProcVertexBuffer.Num();
+			Stats.Triangles += Section->ProcIndexBuffer.Num() / 3;
+		}
+	}
+	return Stats;
+}
+
+FTerrainChunkStats& FTerrainChunkStats::operator+=(const FTerrainChunkStats& Other)
+{
+	Vertices  += Other.Vertices;
+	Triangles += Other.Triangles;
+	Bytes     += Other.Bytes;
+	return *this;
+}
+
+//────────────────────────────
+// Benchmark Report
+//────────────────────────────
+
+void FTerrainBenchmarkReport::Add(FAutomationTestBase& Test, const FString& Step, int32 ChunkSize, double Ms,
+	const FTerrainChunkStats& Stats)
+{
+	Rows.Add({Step, ChunkSize, Ms, Stats});
+	Test.AddInfo(FString::Printf(TEXT("%s [%d] %.3f ms, %lld vertices, %lld triangles, %lld bytes"),
+		*Step, ChunkSize, Ms, Stats.Vertices, Stats.Triangles, Stats.Bytes));
+}
+
+bool FTerrainBenchmarkReport::Write() const
+{
+	const FString BaseName = FPaths::ProjectSavedDir() / GetDirectory() / Name;
+	const FString Timestamp = FDateTime::UtcNow().ToIso8601();
+
+	// CSV history: the header is only written with the first run.
+	const FString CsvPath = BaseName + TEXT(".csv");
+	FString Csv;
+	if (!IFileManager::Get().FileExists(*CsvPath))
+		Csv += TEXT("Timestamp,Test,ChunkSize,Ms,Vertices,Triangles,Bytes\n");
+	for (const FRow& Row : Rows)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%d,%.3f,%lld,%lld,%lld\n"),
+			*Timestamp, *Row.Step, Row.ChunkSize, Row.Ms, Row.Stats.Vertices, Row.Stats.Triangles, Row.Stats.Bytes);
+	}
+
+	// JSON: the last run only.
+	TArray<TSharedPtr<FJsonValue>> JsonRows;
+	for (const FRow& Row : Rows)
+	{
+		TSharedRef<FJsonObject> JsonRow = MakeShared<FJsonObject>();
+		JsonRow->SetStringField(TEXT("Test"), Row.Step);
+		JsonRow->SetNumberField(TEXT("ChunkSize"), Row.ChunkSize);
+		JsonRow->SetNumberField(TEXT("Ms"), Row.Ms);
+		JsonRow->SetNumberField(TEXT("Vertices"), static_cast<double>(Row.Stats.Vertices));
+		JsonRow->SetNumberField(TEXT("Triangles"), static_cast<double>(Row.Stats.Triangles));
+		JsonRow->SetNumberField(TEXT("Bytes"), static_cast<double>(Row.Stats.Bytes));
+		JsonRows.Add(MakeShared<FJsonValueObject>(JsonRow));
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Benchmark"), Name);
+	Root->SetStringField(TEXT("Timestamp"), Timestamp);
+	Root->SetArrayField(TEXT("Rows"), JsonRows);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+
+	const bool bCsvWritten = FFileHelper::SaveStringToFile(Csv, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+		&IFileManager::Get(), FILEWRITE_Append);
+	const bool bJsonWritten = FFileHelper::SaveStringToFile(Json, *(BaseName + TEXT(".json")));
+	return bCsvWritten && bJsonWritten;
+}
+
+FString FTerrainBenchmarkReport::GetDirectory()
+{
+	return TEXT("Automation/TerrainBenchmarks");
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
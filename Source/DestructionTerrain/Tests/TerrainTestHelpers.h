@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+
+class AProceduralTerrainWorld;
+class UProceduralTerrain;
+class UWorld;
+
+/**
+ * FTerrainTestWorld
+ *
+ * Game world created for one automation test and ticked by hand (no player: streaming is driven through
+ * AProceduralTerrainWorld::UpdateStreamedChunksAround()). The terrain worlds spawned in it are destroyed,
+ * and their pending saves written, along with it.
+ */
+struct FTerrainTestWorld
+{
+	UWorld* World = nullptr;
+
+	FTerrainTestWorld();
+	~FTerrainTestWorld();
+
+	/** Creates a registered chunk component on a new actor, with the component defaults. */
+	UProceduralTerrain* SpawnChunk(const FVector& Location = FVector::ZeroVector);
+
+	/** Ticks the world once, then runs the work queued on the game thread (finished extractions, loads). */
+	void Tick(float DeltaSeconds);
+
+	/** Runs the game thread's queued tasks until Chunk has no rebuild in flight. Returns false after TimeoutSeconds. */
+	static bool WaitForChunk(UProceduralTerrain* Chunk, double TimeoutSeconds = 60.0);
+};
+
+/** Friend of AProceduralTerrainWorld: sets up its grid and reads its streaming state. */
+struct FTerrainWorldTestAccess
+{
+	/**
+	 * Spawns a terrain world of ChunksX × ChunksY × 1 chunks saving to Saved/SaveDirectory, without debug
+	 * drawing nor autosaves, its surface halfway up the chunks. Construction starts restoring the chunks.
+	 */
+	static AProceduralTerrainWorld* Spawn(UWorld* World, int32 ChunkSize, int32 ChunksX, int32 ChunksY,
+		const FString& SaveDirectory, int32 StreamRadius = 2);
+
+	/** True once nothing is restoring, streaming, saving, uploading, remeshing or waiting for an edit flush. */
+	static bool IsIdle(const AProceduralTerrainWorld* Terrain);
+
+	/** Ticks the world until IsIdle(). Returns false after TimeoutSeconds. */
+	static bool WaitUntilIdle(FTerrainTestWorld& TestWorld, AProceduralTerrainWorld* Terrain, double TimeoutSeconds = 120.0);
+
+	/**
+	 * Moves the streaming center to the chunk at Coords, then dispatches the queued chunks right away: the restores it
+	 * starts are still in flight on return (their completions run on the game thread).
+	 */
+	static void StreamAround(AProceduralTerrainWorld* Terrain, const FIntVector& Coords);
+
+	/** The chunk loaded at Coords, or nullptr. */
+	static UProceduralTerrain* FindChunk(const AProceduralTerrainWorld* Terrain, const FIntVector& Coords);
+
+	/** Every chunk currently loaded by Terrain. */
+	static const TArray<UProceduralTerrain*>& GetChunks(const AProceduralTerrainWorld* Terrain);
+
+	/** World size of a chunk, (ChunkSize - 1) × TerrainScale. */
+	static float GetChunkWorldSize(const AProceduralTerrainWorld* Terrain);
+};
+
+/** Drawn geometry and memory of a chunk; Bytes counts its density storage and vertex / index buffers. */
+struct FTerrainChunkStats
+{
+	int64 Vertices = 0;
+	int64 Triangles = 0;
+	int64 Bytes = 0;
+
+	static FTerrainChunkStats Get(UProceduralTerrain* Chunk);
+
+	FTerrainChunkStats& operator+=(const FTerrainChunkStats& Other);
+};
+
+/**
+ * FTerrainBenchmarkReport
+ *
+ * Results of a benchmark, written to Saved/Automation/TerrainBenchmarks/: Name.csv gets one line per row and
+ * per run (the history to track regressions), Name.json holds the rows of the last run.
+ */
+class FTerrainBenchmarkReport
+{
+public:
+	explicit FTerrainBenchmarkReport(const FString& InName) : Name(InName) {}
+
+	/** Records a row and logs it to the test output. */
+	void Add(FAutomationTestBase& Test, const FString& Step, int32 ChunkSize, double Ms, const FTerrainChunkStats& Stats);
+
+	/** Appends the rows to the CSV history and replaces the JSON file. Returns false if either cannot be written. */
+	bool Write() const;
+
+	/** Directory of the reports relative to Saved/, also holding the scratch saves of the benchmarks. */
+	static FString GetDirectory();
+
+private:
+	struct FRow
+	{
+		FString Step;
+		int32 ChunkSize = 0;
+		double Ms = 0.0;
+		FTerrainChunkStats Stats;
+	};
+
+	FString Name;
+	TArray<FRow> Rows;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
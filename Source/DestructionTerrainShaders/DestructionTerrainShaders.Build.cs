@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Global shader types of the terrain compute pipeline. They have to be registered before the engine
+// initializes its shader maps, so this module loads at PostConfigInit (see DestructionTerrain.uproject).
+public class DestructionTerrainShaders : ModuleRules
+{
+	public DestructionTerrainShaders(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "RenderCore", "RHI" });
+	}
+}
@@ -0,0 +1,74 @@
+#include "TerrainComputeShaders.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "ShaderCore.h"
+
+namespace
+{
+	// The pipeline relies on typed UAV loads / atomics and 3D dispatches.
+	bool SupportsTerrainCompute(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	void SetGroupSize(FShaderCompilerEnvironment& OutEnvironment)
+	{
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), TerrainComputeShaders::GroupSize);
+	}
+}
+
+bool FTerrainDensityCS::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return SupportsTerrainCompute(Parameters);
+}
+
+void FTerrainDensityCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	SetGroupSize(OutEnvironment);
+}
+
+bool FTerrainBrushCS::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return SupportsTerrainCompute(Parameters);
+}
+
+void FTerrainBrushCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	SetGroupSize(OutEnvironment);
+}
+
+bool FTerrainMarchCS::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return SupportsTerrainCompute(Parameters);
+}
+
+void FTerrainMarchCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	SetGroupSize(OutEnvironment);
+}
+
+bool FTerrainDrawArgsCS::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return SupportsTerrainCompute(Parameters);
+}
+
+IMPLEMENT_GLOBAL_SHADER(FTerrainDensityCS,  "/DestructionTerrain/Private/TerrainCompute.usf", "DensityCS",  SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FTerrainBrushCS,    "/DestructionTerrain/Private/TerrainCompute.usf", "BrushCS",    SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FTerrainMarchCS,    "/DestructionTerrain/Private/TerrainCompute.usf", "MarchCS",    SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FTerrainDrawArgsCS, "/DestructionTerrain/Private/TerrainCompute.usf", "DrawArgsCS", SF_Compute);
+
+/** Maps /DestructionTerrain to the project's Shaders directory before the global shaders are compiled. */
+class FDestructionTerrainShadersModule : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override
+	{
+		const FString ShaderDirectory = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectDir(), TEXT("Shaders")));
+		AddShaderSourceDirectoryMapping(TEXT("/DestructionTerrain"), ShaderDirectory);
+	}
+};
+
+IMPLEMENT_MODULE(FDestructionTerrainShadersModule, DestructionTerrainShaders);
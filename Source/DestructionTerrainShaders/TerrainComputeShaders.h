@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+
+/**
+ * Compute shaders of the GPU chunk pipeline (Shaders/Private/TerrainCompute.usf, virtual path /DestructionTerrain).
+ * The density field they work on has a one-voxel halo: field voxel (x, y, z) is chunk voxel (x - 1, y - 1, z - 1),
+ * so border gradients read the neighbouring noise instead of being clamped.
+ */
+namespace TerrainComputeShaders
+{
+	/** Threads per side of the 3D thread groups. */
+	constexpr int32 GroupSize = 4;
+}
+
+/** Evaluates the fBm noise density of a (Size + 2)³ field (same formula as UProceduralTerrain::GenerateDensity()). */
+class FTerrainDensityCS : public FGlobalShader
+{
+public:
+	DECLARE_EXPORTED_GLOBAL_SHADER(FTerrainDensityCS, DESTRUCTIONTERRAINSHADERS_API);
+	SHADER_USE_PARAMETER_STRUCT(FTerrainDensityCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, DESTRUCTIONTERRAINSHADERS_API)
+		SHADER_PARAMETER(FVector3f, NoiseOrigin)
+		SHADER_PARAMETER(float, NoiseStep)
+		SHADER_PARAMETER(uint32, FieldSize)
+		SHADER_PARAMETER(float, HeightBias)
+		SHADER_PARAMETER(float, NoiseStrength)
+		SHADER_PARAMETER(float, Truncation)
+		SHADER_PARAMETER(uint32, Octaves)
+		SHADER_PARAMETER(float, Lacunarity)
+		SHADER_PARAMETER(float, Gain)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint>, Permutation)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<float>, OutDensity)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+/** Applies one dig brush to the voxels of its box (same falloff and truncation as a CPU dig). */
+class FTerrainBrushCS : public FGlobalShader
+{
+public:
+	DECLARE_EXPORTED_GLOBAL_SHADER(FTerrainBrushCS, DESTRUCTIONTERRAINSHADERS_API);
+	SHADER_USE_PARAMETER_STRUCT(FTerrainBrushCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, DESTRUCTIONTERRAINSHADERS_API)
+		SHADER_PARAMETER(FIntVector, BoxMin)
+		SHADER_PARAMETER(FIntVector, BoxSize)
+		SHADER_PARAMETER(FVector3f, BrushCenter)
+		SHADER_PARAMETER(float, BrushRadius)
+		SHADER_PARAMETER(float, BrushStrength)
+		SHADER_PARAMETER(float, Truncation)
+		SHADER_PARAMETER(uint32, FieldSize)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<float>, OutDensity)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+/**
+ * Marching Cubes over the (Size - 1)³ cells of the field. Each surface cell reserves its vertices with an atomic
+ * counter and writes a non-indexed triangle list (positions, packed tangents) straight into vertex buffers.
+ */
+class FTerrainMarchCS : public FGlobalShader
+{
+public:
+	DECLARE_EXPORTED_GLOBAL_SHADER(FTerrainMarchCS, DESTRUCTIONTERRAINSHADERS_API);
+	SHADER_USE_PARAMETER_STRUCT(FTerrainMarchCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, DESTRUCTIONTERRAINSHADERS_API)
+		SHADER_PARAMETER(uint32, FieldSize)
+		SHADER_PARAMETER(float, Scale)
+		SHADER_PARAMETER(float, IsoLevel)
+		SHADER_PARAMETER(uint32, MaxVertices)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float>, Density)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<int>, EdgeTable)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<int>, TriTable)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, VertexCounter)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<float>, OutPositions)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<uint>, OutTangents)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+/** Turns the vertex counter into the arguments of the chunk's indirect draw (clamped to the buffer capacity). */
+class FTerrainDrawArgsCS : public FGlobalShader
+{
+public:
+	DECLARE_EXPORTED_GLOBAL_SHADER(FTerrainDrawArgsCS, DESTRUCTIONTERRAINSHADERS_API);
+	SHADER_USE_PARAMETER_STRUCT(FTerrainDrawArgsCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, DESTRUCTIONTERRAINSHADERS_API)
+		SHADER_PARAMETER(uint32, MaxVertices)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint>, VertexCount)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWBuffer<uint>, OutDrawArgs)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+};